@@ -0,0 +1,105 @@
+"""
+Sammelt Anfragen der Flipper zu Micro-Batches für den Server
+
+Eine Anfrage wartet höchstens BATCH_WINDOW_MS auf weitere, bei
+BATCH_MAX_MESSAGES geht der Batch sofort. Mehrere Batches dürfen gleichzeitig
+unterwegs sein; die Antworten werden trotzdem in Eingangsreihenfolge
+zugestellt, damit sie in derselben Reihenfolge auf die serielle Leitung gehen.
+Kennt der Server den Batch-Endpunkt nicht, gehen die Anfragen einzeln.
+"""
+
+import asyncio
+import logging
+import time
+from collections import deque
+from typing import Optional
+
+from config import BATCH_MAX_MESSAGES, BATCH_WINDOW_MS
+
+
+class PendingBatch:
+    def __init__(self):
+        self.requests = []
+        self.futures = []
+        self.results: Optional[list] = None
+        self.sent = 0.0
+        self.answered = 0.0
+
+
+class RequestBatcher:
+    def __init__(self, server_client, max_messages: int = BATCH_MAX_MESSAGES,
+                 window_ms: float = BATCH_WINDOW_MS):
+        self.server_client = server_client
+        self.max_messages = max_messages
+        self.window = window_ms / 1000
+        self.current: Optional[PendingBatch] = None
+        self.timer: Optional[asyncio.TimerHandle] = None
+        self.in_flight = deque()  # Gesendete Batches in Reihenfolge
+        self.tasks = set()
+        self.batch_supported = True
+        # Statistik
+        self.batches = 0
+        self.messages = 0
+        self.largest = 0
+
+    async def submit(self, request: dict):
+        """Anfrage in den laufenden Batch; liefert (Antwort, gesendet,
+        beantwortet) mit den time.monotonic()-Zeiten des Server-Aufrufs"""
+        if self.current is None:
+            self.current = PendingBatch()
+            self.timer = asyncio.get_running_loop().call_later(self.window, self.flush)
+        future = asyncio.get_running_loop().create_future()
+        self.current.requests.append(request)
+        self.current.futures.append(future)
+        if len(self.current.requests) >= self.max_messages:
+            self.flush()
+        return await future
+
+    def flush(self):
+        """Laufenden Batch sofort senden"""
+        if self.timer:
+            self.timer.cancel()
+            self.timer = None
+        batch, self.current = self.current, None
+        if not batch:
+            return
+        self.batches += 1
+        self.messages += len(batch.requests)
+        self.largest = max(self.largest, len(batch.requests))
+        self.in_flight.append(batch)
+        task = asyncio.get_running_loop().create_task(self._send(batch))
+        self.tasks.add(task)
+        task.add_done_callback(self.tasks.discard)
+
+    async def _send(self, batch: PendingBatch):
+        batch.sent = time.monotonic()
+        results = None
+        try:
+            if self.batch_supported and len(batch.requests) > 1:
+                results = await self.server_client.send_batch(batch.requests)
+                if results is None:
+                    logging.warning("Server kennt keinen Batch-Endpunkt, sende einzeln")
+                    self.batch_supported = False
+            if results is None:
+                results = await asyncio.gather(
+                    *(self.server_client.send_tag_data(request) for request in batch.requests)
+                )
+        except Exception as e:
+            # Die Reihenfolge hängt an jedem Batch, er muss eine Antwort bekommen
+            logging.error(f"Fehler beim Senden des Batches: {e}")
+            results = [{"error": str(e)}] * len(batch.requests)
+        batch.answered = time.monotonic()
+        batch.results = results
+        self._deliver()
+
+    def _deliver(self):
+        # Nur fertige Batches am Anfang, ein langsamer Batch hält die späteren
+        while self.in_flight and self.in_flight[0].results is not None:
+            batch = self.in_flight.popleft()
+            for future, result in zip(batch.futures, batch.results):
+                if not future.done():
+                    future.set_result((result, batch.sent, batch.answered))
+
+    @property
+    def average(self) -> float:
+        return self.messages / self.batches if self.batches else 0.0
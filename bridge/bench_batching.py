@@ -0,0 +1,102 @@
+"""
+Micro-Batching der Bridge gegen einen simulierten Server
+
+Mehrere Flipper schicken Tag-Scans wie flipper_http mit bis zu 16 offenen
+Anfragen. Der Server bearbeitet wie ein Flask-Prozess mit wenigen Threads
+nur SERVER_WORKERS Anfragen gleichzeitig; jede kostet eine feste Zeit
+(HTTP, Verbindung, Commit) plus etwas pro Eintrag. Gemessen wird
+Nachrichten/s und die Latenz pro Scan, ohne Batches und mit verschiedenen
+Fenstern. Jeder Flipper muss seine Antworten in Sendereihenfolge bekommen.
+
+    python3 bridge/bench_batching.py --devices 4 --scans 2000
+"""
+
+import argparse
+import asyncio
+import os
+import sys
+import time
+
+sys.path.insert(0, os.path.dirname(os.path.abspath(__file__)))
+
+from batcher import RequestBatcher  # noqa: E402
+from config import BATCH_MAX_MESSAGES  # noqa: E402
+from link_metrics import percentile  # noqa: E402
+
+SERVER_WORKERS = 4
+REQUEST_MS = 8.0     # Pro HTTP-Anfrage
+ITEM_MS = 0.25       # Pro Scan in der Anfrage
+DEVICE_QUEUE = 16    # FLIPPER_HTTP_QUEUE_SIZE
+
+
+class FakeServer:
+    def __init__(self):
+        self.workers = asyncio.Semaphore(SERVER_WORKERS)
+        self.requests = 0
+
+    async def handle(self, count: int):
+        async with self.workers:
+            self.requests += 1
+            await asyncio.sleep((REQUEST_MS + ITEM_MS * count) / 1000)
+
+    async def send_tag_data(self, tag_data: dict) -> dict:
+        await self.handle(1)
+        return {"points": 10, "seq": tag_data["seq"]}
+
+    async def send_batch(self, items: list) -> list:
+        await self.handle(len(items))
+        return [{"points": 10, "seq": item["seq"]} for item in items]
+
+
+async def run(name: str, devices: int, scans: int, max_messages: int, window_ms: float):
+    server = FakeServer()
+    batcher = RequestBatcher(server, max_messages=max_messages, window_ms=window_ms)
+    latencies = []
+    out_of_order = 0
+
+    async def device(device_id: int):
+        nonlocal out_of_order
+        slots = asyncio.Semaphore(DEVICE_QUEUE)
+        last = -1
+        tasks = []
+
+        async def scan(seq: int):
+            nonlocal last, out_of_order
+            sent = time.monotonic()
+            response, _, _ = await batcher.submit({"tag_id": f"{device_id:02X}{seq:06X}", "seq": seq})
+            latencies.append(time.monotonic() - sent)
+            if response["seq"] != last + 1:
+                out_of_order += 1
+            last = response["seq"]
+            slots.release()
+
+        for seq in range(scans):
+            await slots.acquire()
+            tasks.append(asyncio.create_task(scan(seq)))
+        await asyncio.gather(*tasks)
+
+    start = time.monotonic()
+    await asyncio.gather(*(device(i) for i in range(devices)))
+    elapsed = time.monotonic() - start
+
+    count = devices * scans
+    print(
+        f"{name:<18} {count:>7} scans {count / elapsed:>8.0f} scans/s  latency p50/p99 "
+        f"{percentile(latencies, 50) * 1000:>6.1f}/{percentile(latencies, 99) * 1000:>6.1f} ms  "
+        f"{server.requests:>6} requests, avg batch {batcher.average:.1f}, out of order {out_of_order}"
+    )
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__.split("\n\n")[0])
+    parser.add_argument("--devices", type=int, default=4)
+    parser.add_argument("--scans", type=int, default=2000, help="Pro Flipper")
+    args = parser.parse_args()
+
+    asyncio.run(run("unbatched", args.devices, args.scans, 1, 0))
+    for window in (2, 5, 10, 20):
+        asyncio.run(run(f"window {window} ms", args.devices, args.scans, BATCH_MAX_MESSAGES, window))
+
+
+if __name__ == "__main__":
+    main()
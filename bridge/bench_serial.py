@@ -0,0 +1,410 @@
+"""
+Durchsatz der seriellen Anbindung über ein Pseudo-Terminal
+
+Ein Thread spielt den Flipper und schreibt Tag-Scans so schnell es geht in
+das Master-Ende, SerialHandler liest am Slave-Ende wie an einem echten Port.
+Zum Vergleich läuft die frühere Leseschleife (Zeichen für Zeichen, Zeile per
+String-Verkettung) über dieselben Daten. Gemessen wird Nachrichten/s und die
+Latenz vom Schreiben bis zum Aufruf von message_callback. Der Fairness-Lauf
+hängt mehrere Geräte an einen DeviceManager: eines flutet, die anderen müssen
+trotzdem schnell bedient werden; dazu kommen Stecken und Ziehen im Betrieb.
+Zuletzt startet die App eines Geräts im Binärmodus neu und schickt wieder
+Zeilen, bis die Bridge das Hello erneut sendet.
+
+    python3 bridge/bench_serial.py --messages 20000
+"""
+
+import argparse
+import asyncio
+import json
+import logging
+import os
+import shutil
+import sys
+import tempfile
+import threading
+import time
+import tty
+
+sys.path.insert(0, os.path.dirname(os.path.abspath(__file__)))
+
+from config import WIRE_SCHEMA_PATH  # noqa: E402
+from device_manager import DeviceManager  # noqa: E402
+from link_metrics import percentile  # noqa: E402
+from wire_codec import WireDecoder, WireSchema, WIRE_VERSION  # noqa: E402
+
+UID = "04A1B2C3D4E5F6"
+
+
+class PtyTransport(asyncio.Transport):
+    """Lese- und Schreibrichtung eines pty als ein Transport wie bei
+    serial_asyncio"""
+
+    def __init__(self, reader: asyncio.ReadTransport, writer: asyncio.WriteTransport):
+        super().__init__()
+        self.reader = reader
+        self.writer = writer
+
+    def write(self, data):
+        self.writer.write(data)
+
+    def pause_reading(self):
+        self.reader.pause_reading()
+
+    def resume_reading(self):
+        self.reader.resume_reading()
+
+    def close(self):
+        self.reader.close()
+        self.writer.close()
+
+
+def open_pty():
+    master, slave = os.openpty()
+    tty.setraw(master)
+    tty.setraw(slave)
+    return master, slave
+
+
+def pty_opener(port: str):
+    """Öffnet den Slave hinter port (Symlink auf /dev/pts/N) wie einen Port"""
+    async def opener(protocol_factory):
+        loop = asyncio.get_running_loop()
+        fd = os.open(port, os.O_RDWR | os.O_NOCTTY)
+        protocol = protocol_factory()
+        reader, _ = await loop.connect_read_pipe(lambda: protocol, os.fdopen(fd, 'rb', buffering=0))
+        writer, _ = await loop.connect_write_pipe(
+            asyncio.BaseProtocol, os.fdopen(os.dup(fd), 'wb', buffering=0)
+        )
+        return PtyTransport(reader, writer)
+    return opener
+
+
+class FakeDevice:
+    """Ein Flipper an einem eigenen pty: schreibt count Scans in Blöcken von
+    chunk Bytes, mit interval Sekunden Pause dazwischen. sent[i] = Zeitpunkt"""
+
+    def __init__(self, count: int, chunk: int, schema: WireSchema = None, interval: float = 0):
+        self.master, self.slave = open_pty()
+        self.port = os.ttyname(self.slave)
+        self.count = count
+        self.chunk = chunk
+        self.schema = schema
+        self.interval = interval
+        self.sent = [0.0] * count
+        self.latencies = []
+        self.replies = 0
+        self.tx_bytes = 0
+        self.thread = threading.Thread(target=self.run, daemon=True)
+
+    def close(self):
+        os.close(self.master)
+        os.close(self.slave)
+
+    def encode(self, seq: int) -> bytes:
+        if self.schema:
+            return self.schema.encode({
+                "type": "tag_scan", "_id": seq & 0xFFFF, "timestamp": seq,
+                "uid_len": 7, "uid": UID, "player_id": "bench",
+            })
+        return (json.dumps({"tag_id": UID, "player_id": "bench", "seq": seq}) + "\n").encode('utf-8')
+
+    def await_hello(self):
+        decoder = WireDecoder(self.schema)
+        while True:
+            for message in decoder.feed(os.read(self.master, 256)):
+                if message["type"] == "hello":
+                    os.write(self.master, self.schema.encode({"type": "hello", "version": WIRE_VERSION}))
+                    return
+
+    def read_replies(self):
+        decoder = WireDecoder(self.schema)
+        try:
+            while self.replies < self.count:
+                self.replies += len(decoder.feed(os.read(self.master, 4096)))
+        except OSError:
+            pass
+
+    def run(self):
+        if self.schema:
+            self.await_hello()
+            threading.Thread(target=self.read_replies, daemon=True).start()
+        pending = bytearray()
+        first = 0
+        for seq in range(self.count):
+            pending += self.encode(seq)
+            if len(pending) >= self.chunk or seq == self.count - 1:
+                now = time.monotonic()
+                for i in range(first, seq + 1):
+                    self.sent[i] = now
+                first = seq + 1
+                self.write(pending)
+                pending.clear()
+                if self.interval:
+                    time.sleep(self.interval)
+
+    def write(self, data: bytes):
+        with memoryview(data) as view:
+            offset = 0
+            while offset < len(view):
+                offset += os.write(self.master, view[offset:])
+        self.tx_bytes += len(data)
+
+    def received(self, message: dict) -> bool:
+        """Latenz eines Scans festhalten; True = alle da"""
+        seq = message["seq"] if "seq" in message else message["timestamp"]
+        self.latencies.append(time.monotonic() - self.sent[seq])
+        return len(self.latencies) == self.count
+
+
+class RestartingDevice(FakeDevice):
+    """Handelt Binärrahmen aus und startet nach der Hälfte der Scans neu:
+    die neue App schickt lines Scans als JSON-Zeilen und den Rest erst nach
+    dem erneuten Hello der Bridge wieder als Rahmen"""
+
+    def __init__(self, count: int, schema: WireSchema, lines: int = 5, interval: float = 0.001):
+        super().__init__(count, 1, schema, interval)
+        self.lines = lines
+        self.renegotiated = 0.0  # Erste Zeile bis zum neuen Hello, s
+
+    def run(self):
+        self.await_hello()
+        restart = self.count // 2
+        for seq in range(self.count):
+            if seq == restart:
+                restarted = time.monotonic()
+            if restart <= seq < restart + self.lines:
+                data = (json.dumps({"tag_id": UID, "player_id": "bench", "seq": seq}) + "\n").encode('utf-8')
+            else:
+                if seq == restart + self.lines:
+                    self.await_hello()
+                    self.renegotiated = time.monotonic() - restarted
+                data = self.encode(seq)
+            self.sent[seq] = time.monotonic()
+            self.write(data)
+            time.sleep(self.interval)
+
+
+def report(name: str, count: int, elapsed: float, latencies: list, tx_bytes: int, extra: str = ""):
+    print(
+        f"{name:<16} {count:>7} msgs {count / elapsed:>10.0f} msg/s "
+        f"{tx_bytes / elapsed / 1024:>8.0f} KB/s  latency p50/p99/max "
+        f"{percentile(latencies, 50) * 1000:.2f}/{percentile(latencies, 99) * 1000:.2f}/"
+        f"{max(latencies) * 1000:.2f} ms{extra}"
+    )
+
+
+def bench_legacy(count: int, chunk: int):
+    """Die frühere _read_loop ohne pyserial: ein Zeichen pro Aufruf"""
+    device = FakeDevice(count, chunk)
+    start = time.monotonic()
+    device.thread.start()
+
+    buffer = ""
+    while len(device.latencies) < count:
+        char = os.read(device.slave, 1).decode('utf-8')
+        if char == '\n':
+            if buffer:
+                device.received(json.loads(buffer))
+                buffer = ""
+        else:
+            buffer += char
+    elapsed = time.monotonic() - start
+
+    device.thread.join()
+    device.close()
+    report("legacy/lines", count, elapsed, device.latencies, device.tx_bytes)
+
+
+class BenchPorts:
+    """Symlinks auf die pty-Slaves in einem eigenen Verzeichnis, das der
+    DeviceManager wie /dev/serial/by-id per Glob durchsucht"""
+
+    def __init__(self):
+        self.dir = tempfile.mkdtemp(prefix="tagracer-ports-")
+        self.pattern = os.path.join(self.dir, "flipper*")
+        self.devices = {}
+
+    def plug(self, name: str, device: FakeDevice):
+        path = os.path.join(self.dir, name)
+        os.symlink(device.port, path)
+        self.devices[path] = device
+
+    def unplug(self, name: str):
+        os.unlink(os.path.join(self.dir, name))
+
+    def close(self):
+        shutil.rmtree(self.dir)
+
+
+async def run_devices(ports: BenchPorts, wire: bool, cost: float = 0, until=None):
+    """DeviceManager über alle gesteckten Geräte, bis until() oder alle
+    Scans angekommen sind. cost = simulierte Bearbeitungszeit pro Nachricht"""
+    done = asyncio.Event()
+    complete = set()
+
+    async def on_message(handler, message: dict):
+        if wire and message["type"] != "tag_scan":
+            return
+        if cost:
+            await asyncio.sleep(cost)
+        if wire:
+            handler.send_message({"type": "scan_result", "points": 10, "_id": message["_id"]})
+        if ports.devices[handler.port].received(message):
+            complete.add(handler.port)
+            if len(complete) == len(ports.devices):
+                done.set()
+
+    manager = DeviceManager(
+        on_message, [ports.pattern], opener_factory=pty_opener, wire_protocol=wire, scan_interval=0.1
+    )
+    manager.start()
+    start = time.monotonic()
+    if until:
+        await until(manager)
+    await done.wait()
+    elapsed = time.monotonic() - start
+    stats = {device["port"]: device for device in manager.stats()}
+
+    # Antworten laufen noch über den pty zurück
+    deadline = time.monotonic() + 5
+    while wire and time.monotonic() < deadline and \
+            any(device.replies < device.count for device in ports.devices.values()):
+        await asyncio.sleep(0.01)
+    await manager.stop()
+    return elapsed, stats
+
+
+async def bench_async(count: int, chunk: int, wire: bool):
+    ports = BenchPorts()
+    schema = WireSchema(WIRE_SCHEMA_PATH) if wire else None
+    device = FakeDevice(count, chunk, schema)
+    ports.plug("flipper0", device)
+    device.thread.start()
+    elapsed, stats = await run_devices(ports, wire)
+    device.thread.join()
+    device.close()
+    ports.close()
+
+    stat = stats[ports.pattern.replace("*", "0")]
+    extra = f", {stat['pauses']} pauses, {stat['invalid']} invalid"
+    if wire:
+        extra += f", {device.replies} replies"
+    report("async/wire" if wire else "async/lines", count, elapsed, device.latencies, device.tx_bytes, extra)
+
+
+async def bench_fairness(count: int, chunk: int):
+    """Ein Gerät flutet, drei senden alle 5 ms einen Scan. Jede Nachricht
+    kostet 5 ms, die Worker reichen also nicht für die Flut. Das vierte
+    leise Gerät wird erst während des Laufs gesteckt, danach wird eines
+    gezogen"""
+    schema = WireSchema(WIRE_SCHEMA_PATH)
+    ports = BenchPorts()
+    chatty = FakeDevice(count, chunk, schema)
+    quiet = [FakeDevice(200, 1, schema, interval=0.005) for _ in range(4)]
+    ports.plug("flipper_chatty", chatty)
+    for i, device in enumerate(quiet[:3]):
+        ports.plug(f"flipper_quiet{i}", device)
+    for device in [chatty] + quiet:
+        device.thread.start()
+
+    hotplug = {}
+
+    async def plug_late(manager):
+        await asyncio.sleep(0.5)
+        plugged = time.monotonic()
+        ports.plug("flipper_quiet3", quiet[3])
+        while not quiet[3].latencies:
+            await asyncio.sleep(0.005)
+        hotplug["added"] = time.monotonic() - plugged
+
+    elapsed, stats = await run_devices(ports, True, cost=0.005, until=plug_late)
+
+    print(f"fairness         {len(ports.devices)} devices in {elapsed * 1000:.0f} ms, hot-plugged in {hotplug['added'] * 1000:.0f} ms")
+    for path, device in ports.devices.items():
+        stat = stats[path]
+        print(
+            f"  {os.path.basename(path):<16} {device.count:>6} msgs {stat['rate']:>8.0f} msg/s  "
+            f"latency p50/p99 {percentile(device.latencies, 50) * 1000:.1f}/"
+            f"{percentile(device.latencies, 99) * 1000:.1f} ms  queue lag p99 {stat['lag_p99_ms']:.1f} ms, "
+            f"{stat['pauses']} pauses, {device.replies} replies"
+        )
+
+    # Ziehen: der nächste Suchlauf trennt das Gerät
+    manager = DeviceManager(
+        lambda handler, message: asyncio.sleep(0), [ports.pattern],
+        opener_factory=pty_opener, wire_protocol=False
+    )
+    await manager.scan()
+    await asyncio.sleep(0.1)
+    before = len(manager.connected())
+    ports.unplug("flipper_quiet0")
+    unplugged = time.monotonic()
+    await manager.scan()
+    print(f"  unplug: {before} -> {len(manager.connected())} devices in {(time.monotonic() - unplugged) * 1000:.1f} ms")
+    await manager.stop()
+
+    for device in [chatty] + quiet:
+        device.thread.join()
+        device.close()
+    ports.close()
+
+
+async def bench_restart(count: int):
+    """Gerät startet im Binärmodus neu: seine Zeilen müssen ankommen und die
+    Bridge muss ohne neues Stecken wieder Rahmen aushandeln"""
+    schema = WireSchema(WIRE_SCHEMA_PATH)
+    ports = BenchPorts()
+    device = RestartingDevice(count, schema)
+    ports.plug("flipper0", device)
+    done = asyncio.Event()
+    kinds = {"frames": 0, "lines": 0}
+
+    async def on_message(handler, message: dict):
+        if message.get("type", "tag_scan") != "tag_scan":
+            return
+        kinds["frames" if "_id" in message else "lines"] += 1
+        if device.received(message):
+            done.set()
+
+    manager = DeviceManager(
+        on_message, [ports.pattern], opener_factory=pty_opener, wire_protocol=True, scan_interval=0.1
+    )
+    manager.start()
+    device.thread.start()
+    start = time.monotonic()
+    try:
+        await asyncio.wait_for(done.wait(), 30)
+    except asyncio.TimeoutError:
+        pass
+    elapsed = time.monotonic() - start
+    stat = manager.stats()[0]
+    await manager.stop()
+    device.thread.join(1)
+    device.close()
+    ports.close()
+
+    ok = len(device.latencies) == count and kinds["lines"] == device.lines and stat["renegotiations"] == 1
+    print(
+        f"restart          {len(device.latencies)}/{count} scans in {elapsed * 1000:.0f} ms, "
+        f"{kinds['frames']} frames + {kinds['lines']} lines, renegotiated in {device.renegotiated * 1000:.1f} ms, "
+        f"{stat['renegotiations']} renegotiations, mode {stat['mode']}: {'ok' if ok else 'FAILED'}"
+    )
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__.split("\n\n")[0])
+    parser.add_argument("--messages", type=int, default=20000)
+    parser.add_argument("--chunk", type=int, default=256, help="Bytes pro Schreibaufruf des Geräts")
+    args = parser.parse_args()
+    logging.basicConfig(level=logging.WARNING)
+
+    bench_legacy(args.messages, args.chunk)
+    asyncio.run(bench_async(args.messages, args.chunk, False))
+    asyncio.run(bench_async(args.messages, args.chunk, True))
+    asyncio.run(bench_fairness(args.messages, args.chunk))
+    asyncio.run(bench_restart(min(args.messages, 2000)))
+
+
+if __name__ == "__main__":
+    main()
@@ -2,14 +2,39 @@
 TagRacer Bridge Konfiguration
 """
 
-# Flipper Zero Verbindungseinstellungen
-FLIPPER_SERIAL_PORT = "COM3"  # Ändern Sie dies entsprechend Ihrem System
+import os
+
+# Flipper Zero Verbindungseinstellungen. Glob-Muster, jeder passende Port
+# ist ein Flipper; ohne Platzhalter (z.B. "COM3") wird der Port fest genommen
+FLIPPER_SERIAL_PORTS = ["/dev/serial/by-id/usb-Flipper_Devices*"]
 FLIPPER_BAUD_RATE = 115200
+DEVICE_SCAN_INTERVAL = 2.0  # Sekunden zwischen zwei Portsuchen (Hot-Plug)
+DEVICE_STATS_INTERVAL = 60  # Sekunden, 0 = keine Gerätestatistik
+DEVICE_STATS_FILE = "devices.json"  # Letzte Gerätestatistik, None = nur Log
+SERIAL_WORKERS = 64      # Nachrichten aller Geräte gleichzeitig in Arbeit, >= BATCH_MAX_MESSAGES
+SERIAL_MAX_LINE = 4096   # Längere JSON-Zeilen werden verworfen
+
+# Binärprotokoll, beim Verbinden ausgehandelt; sonst JSON-Zeilen
+WIRE_PROTOCOL_ENABLED = True
+WIRE_HELLO_TIMEOUT = 1.0  # Sekunden bis zum Rückfall auf JSON-Zeilen
+WIRE_SCHEMA_PATH = os.path.join(os.path.dirname(__file__), "..", "flipper_http", "wire_schema.def")
+
+# Leitungsmessung: eigene und Serverzeiten der letzten Anfragen für die
+# Aufschlüsselung, wenn der Flipper link_stats meldet
+LINK_METRICS_WINDOW = 64
 
 # Server-Einstellungen
 SERVER_URL = "http://localhost:5000"
 API_ENDPOINT = "/api/tag"
+BATCH_ENDPOINT = "/api/tag/batch"
 WEBSOCKET_ENDPOINT = "ws://localhost:5000/ws"
+SERVER_CONNECTIONS = 8  # HTTP-Verbindungen zum Server, für alle Geräte gemeinsam
+
+# Micro-Batches zum Server: eine Anfrage wartet höchstens BATCH_WINDOW_MS
+# auf weitere, volle Batches gehen sofort. BATCH_MAX_MESSAGES = 1 schaltet
+# das Sammeln ab
+BATCH_MAX_MESSAGES = 32
+BATCH_WINDOW_MS = 10
 
 # Logging-Einstellungen
 LOG_LEVEL = "INFO"
@@ -20,4 +45,4 @@ MAX_RECONNECT_ATTEMPTS = 5
 RECONNECT_DELAY = 5  # Sekunden
 
 # Buffer-Einstellungen
-MAX_QUEUE_SIZE = 100  # Maximale Anzahl von gepufferten Nachrichten
+MAX_QUEUE_SIZE = 100  # Maximale Anzahl von gepufferten Nachrichten pro Gerät
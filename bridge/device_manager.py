@@ -0,0 +1,156 @@
+"""
+Verwaltet alle Flipper an einer Bridge in einem Event-Loop
+
+Die Ports kommen aus den Glob-Mustern in FLIPPER_SERIAL_PORTS und werden alle
+DEVICE_SCAN_INTERVAL Sekunden neu gesucht: neue Geräte werden verbunden,
+verschwundene oder abgebrochene getrennt. Jedes Gerät hat eine eigene
+Warteschlange (SerialHandler); die SERIAL_WORKERS Worker holen reihum je eine
+Nachricht pro Gerät, ein gesprächiges Gerät füllt nur seine eigene
+Warteschlange und wird dann gebremst.
+"""
+
+import asyncio
+import glob
+import json
+import logging
+import time
+from collections import deque
+from typing import Awaitable, Callable, Dict, List, Optional
+from config import (
+    FLIPPER_SERIAL_PORTS, SERIAL_WORKERS, WIRE_PROTOCOL_ENABLED,
+    DEVICE_SCAN_INTERVAL, DEVICE_STATS_INTERVAL, DEVICE_STATS_FILE
+)
+from serial_handler import SerialHandler, TransportOpener
+
+
+class DeviceManager:
+    def __init__(self, message_callback: Callable[[SerialHandler, dict], Awaitable[None]],
+                 patterns: List[str] = FLIPPER_SERIAL_PORTS,
+                 opener_factory: Optional[Callable[[str], TransportOpener]] = None,
+                 wire_protocol: bool = WIRE_PROTOCOL_ENABLED,
+                 scan_interval: float = DEVICE_SCAN_INTERVAL):
+        self.message_callback = message_callback
+        self.patterns = patterns
+        self.opener_factory = opener_factory  # None = echter serieller Port
+        self.wire_protocol = wire_protocol
+        self.scan_interval = scan_interval
+        self.devices: Dict[str, SerialHandler] = {}
+        self.connecting = set()
+        self.ready = deque()  # Geräte mit offenen Nachrichten, reihum
+        self.work = asyncio.Event()
+        self.tasks = []
+        # Nachrichtenzahl beim letzten Bericht, für die Rate
+        self.reported: Dict[str, tuple] = {}
+
+    def start(self):
+        """Worker, Portsuche und Statistik starten"""
+        self.tasks = [asyncio.create_task(self._worker()) for _ in range(SERIAL_WORKERS)]
+        self.tasks.append(asyncio.create_task(self._scan_loop()))
+        if DEVICE_STATS_INTERVAL:
+            self.tasks.append(asyncio.create_task(self._stats_loop()))
+
+    async def stop(self):
+        for task in self.tasks:
+            task.cancel()
+        await asyncio.gather(*[t for t in self.tasks if not t.done()], return_exceptions=True)
+        self.tasks = []
+        for device in self.devices.values():
+            device.disconnect()
+        self.devices.clear()
+
+    def connected(self) -> List[SerialHandler]:
+        return [d for d in self.devices.values() if d.connected.is_set()]
+
+    def broadcast(self, message: dict):
+        """Nachricht vom Server an alle verbundenen Flipper"""
+        for device in self.connected():
+            device.send_message(message)
+
+    def _find_ports(self) -> set:
+        ports = set()
+        for pattern in self.patterns:
+            # Ohne Platzhalter (z.B. "COM3") gilt der Port immer als vorhanden
+            ports.update(glob.glob(pattern) if glob.has_magic(pattern) else [pattern])
+        return ports
+
+    async def scan(self):
+        """Einmal suchen: neue Ports verbinden, verschwundene trennen"""
+        ports = self._find_ports()
+        for port, device in list(self.devices.items()):
+            if port in self.connecting:
+                continue
+            if port not in ports or not device.connected.is_set():
+                logging.info(f"Flipper auf {port} getrennt")
+                device.disconnect()
+                del self.devices[port]
+        for port in sorted(ports - self.devices.keys()):
+            device = SerialHandler(port, self._on_ready, self.wire_protocol)
+            self.devices[port] = device
+            self.reported[port] = (0, time.monotonic())
+            self.connecting.add(port)
+            asyncio.create_task(self._connect(device))
+
+    async def _connect(self, device: SerialHandler):
+        opener = self.opener_factory(device.port) if self.opener_factory else None
+        try:
+            ok = await device.connect(opener)
+        finally:
+            self.connecting.discard(device.port)
+        if not ok and self.devices.get(device.port) is device:
+            # Beim nächsten Suchen erneut versuchen
+            del self.devices[device.port]
+
+    async def _scan_loop(self):
+        while True:
+            await self.scan()
+            await asyncio.sleep(self.scan_interval)
+
+    def _on_ready(self, device: SerialHandler):
+        self.ready.append(device)
+        self.work.set()
+
+    async def _worker(self):
+        while True:
+            while not self.ready:
+                self.work.clear()
+                await self.work.wait()
+            device = self.ready.popleft()
+            message = device.take()
+            # Hinten wieder anstellen, damit jedes Gerät reihum drankommt
+            if device.pending:
+                self.ready.append(device)
+            if message is None:
+                continue
+            try:
+                await self.message_callback(device, message)
+            except Exception as e:
+                logging.error(f"Fehler bei Nachricht von {device.port}: {e}")
+
+    def stats(self) -> List[dict]:
+        """Pro Gerät: Zähler, Warteschlange, Verzögerung bis zur Abholung
+        und Nachrichten/s seit dem letzten Aufruf bzw. dem Stecken"""
+        now = time.monotonic()
+        result = []
+        for port, device in sorted(self.devices.items()):
+            stats = device.stats()
+            messages, since = self.reported.get(port, (0, now))
+            stats["rate"] = (device.messages - messages) / (now - since) if now > since else 0.0
+            self.reported[port] = (device.messages, now)
+            result.append(stats)
+        for port in self.reported.keys() - self.devices.keys():
+            del self.reported[port]
+        return result
+
+    async def _stats_loop(self):
+        while True:
+            await asyncio.sleep(DEVICE_STATS_INTERVAL)
+            stats = self.stats()
+            for device in stats:
+                logging.info(
+                    f"{device['port']}: {device['rate']:.1f} Nachrichten/s, "
+                    f"Verzögerung p50/p99 {device['lag_p50_ms']:.0f}/{device['lag_p99_ms']:.0f} ms, "
+                    f"wartend {device['queued']}, gebremst {device['pauses']}x"
+                )
+            if DEVICE_STATS_FILE:
+                with open(DEVICE_STATS_FILE, "w", encoding="utf-8") as out:
+                    json.dump({"time": time.time(), "devices": stats}, out, indent=1)
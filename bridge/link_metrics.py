@@ -0,0 +1,73 @@
+"""
+Laufzeiten pro Abschnitt zwischen Flipper und Server
+
+Der Flipper misst Warteschlange und RTT bis zur Antwort und meldet sie im
+Binärmodus alle paar Sekunden als link_stats. Die Bridge kennt ihre eigene
+Zeit und die des Servers pro Rahmen-ID; zusammen ergibt das die
+Aufschlüsselung Warteschlange / Leitung / Bridge / Server.
+"""
+
+import logging
+from collections import OrderedDict, deque
+from typing import Optional
+
+from config import LINK_METRICS_WINDOW
+
+
+def percentile(values, percent: int) -> float:
+    """Wie flipper_http_get_link_stats: Rang (n - 1) * p / 100"""
+    if not values:
+        return 0.0
+    ordered = sorted(values)
+    return ordered[(len(ordered) - 1) * percent // 100]
+
+
+class LinkMetrics:
+    def __init__(self, window: int = LINK_METRICS_WINDOW):
+        self.bridge_ms = deque(maxlen=window)  # Empfang bis Antwort, ohne Server
+        self.server_ms = deque(maxlen=window)
+        # Rahmen-ID -> (Bridge, Server) der letzten Anfragen
+        self.by_id: "OrderedDict[int, tuple]" = OrderedDict()
+        self.window = window
+
+    def record(self, frame_id: Optional[int], received: float, server_start: float,
+               server_end: float, replied: float):
+        """Zeiten aus time.monotonic() einer beantworteten Anfrage"""
+        server = (server_end - server_start) * 1000
+        bridge = max((replied - received) * 1000 - server, 0.0)
+        self.bridge_ms.append(bridge)
+        self.server_ms.append(server)
+        if frame_id:
+            self.by_id[frame_id] = (bridge, server)
+            while len(self.by_id) > self.window:
+                self.by_id.popitem(last=False)
+
+    def report(self, stats: dict) -> str:
+        """link_stats des Flipper mit den eigenen Zeiten zu einer Logzeile"""
+        line = (
+            f"Leitung: RTT p50/p90/p99 {stats['rtt_p50']}/{stats['rtt_p90']}/{stats['rtt_p99']} ms, "
+            f"Warteschlange p99 {stats['queue_p99']} ms, "
+            f"TX {stats['tx_rate']} B/s, RX {stats['rx_rate']} B/s, "
+            f"wartend {stats['queue_depth']}, unterwegs {stats['in_flight']}, "
+            f"Timeouts {stats['timeouts']}, Wiederholungen {stats['retries']}, "
+            f"abgewiesen {stats['rejected']}"
+        )
+
+        last = self.by_id.get(stats["last_id"])
+        if last:
+            bridge, server = last
+            link = max(stats["last_rtt_ms"] - bridge - server, 0)
+            line += (
+                f" | Anfrage {stats['last_id']}: Warteschlange {stats['last_queue_ms']} ms, "
+                f"Leitung {link:.0f} ms, Bridge {bridge:.0f} ms, Server {server:.0f} ms"
+            )
+
+        if self.server_ms:
+            line += (
+                f" | Bridge p50/p99 {percentile(self.bridge_ms, 50):.0f}/{percentile(self.bridge_ms, 99):.0f} ms, "
+                f"Server p50/p99 {percentile(self.server_ms, 50):.0f}/{percentile(self.server_ms, 99):.0f} ms"
+            )
+        return line
+
+    def log_report(self, stats: dict):
+        logging.info(self.report(stats))
@@ -6,17 +6,23 @@ import asyncio
 import logging
 import signal
 import json
-from typing import Optional
+import time
+from typing import Dict, Optional
 from serial_handler import SerialHandler
+from device_manager import DeviceManager
 from server_client import ServerClient
+from link_metrics import LinkMetrics
+from batcher import RequestBatcher
 from config import LOG_LEVEL, LOG_FILE
 
 class TagRacerBridge:
     def __init__(self):
         self.setup_logging()
         self.running = False
-        self.serial_handler: Optional[SerialHandler] = None
+        self.devices: Optional[DeviceManager] = None
         self.server_client: Optional[ServerClient] = None
+        self.batcher: Optional[RequestBatcher] = None
+        self.link_metrics: Dict[str, LinkMetrics] = {}  # Pro Port, Rahmen-IDs gelten je Gerät
         
     def setup_logging(self):
         """Logging-Konfiguration"""
@@ -29,20 +35,59 @@ class TagRacerBridge:
             ]
         )
         
-    async def handle_serial_message(self, message: dict):
-        """Verarbeitet Nachrichten vom Flipper Zero"""
-        logging.debug(f"Nachricht von Flipper Zero empfangen: {message}")
-        if self.server_client:
-            response = await self.server_client.send_tag_data(message)
-            if response and not "error" in response:
-                # Erfolgreiche Antwort zurück zum Flipper Zero senden
-                self.serial_handler.send_message(response)
+    def metrics(self, device: SerialHandler) -> LinkMetrics:
+        if device.port not in self.link_metrics:
+            self.link_metrics[device.port] = LinkMetrics()
+        return self.link_metrics[device.port]
+        
+    async def handle_serial_message(self, device: SerialHandler, message: dict):
+        """Verarbeitet Nachrichten eines Flipper Zero"""
+        logging.debug(f"Nachricht von {device.port} empfangen: {message}")
+        if not self.server_client:
+            return
+        if "_id" in message:
+            await self.handle_wire_message(device, message)
+            return
+        received = time.monotonic()
+        response, server_start, server_end = await self.batcher.submit(message)
+        self.metrics(device).record(None, received, server_start, server_end, time.monotonic())
+        if response and not "error" in response:
+            # Erfolgreiche Antwort zurück an denselben Flipper senden
+            device.send_message(response)
+                
+    async def handle_wire_message(self, device: SerialHandler, message: dict):
+        """Binärrahmen: für den Server wie JSON-Zeilen aufbereiten, die Antwort
+        geht mit derselben ID als Rahmen zurück"""
+        frame_id = message.pop("_id")
+        received = message.pop("_rx", time.monotonic())
+        if message["type"] == "link_stats":
+            # Nur fürs Log, nicht an den Server
+            logging.info(f"{device.port}: {self.metrics(device).report(message)}")
+            return
+        if message["type"] == "tag_scan":
+            request = {
+                "tag_id": message["uid"][:message["uid_len"] * 2],
+                "player_id": message["player_id"],
+            }
+        else:
+            request = message
+        response, server_start, server_end = await self.batcher.submit(request)
+        
+        if not response or "error" in response:
+            reply = {"type": "ack", "status": 502}
+        elif message["type"] == "tag_scan":
+            reply = {"type": "scan_result", "points": response.get("points", 0)}
+        else:
+            reply = {"type": "ack", "status": 200}
+        reply["_id"] = frame_id
+        device.send_message(reply)
+        self.metrics(device).record(frame_id, received, server_start, server_end, time.monotonic())
                 
     async def handle_server_message(self, message: dict):
         """Verarbeitet Nachrichten vom Server"""
         logging.debug(f"Nachricht vom Server empfangen: {message}")
-        if self.serial_handler:
-            self.serial_handler.send_message(message)
+        if self.devices:
+            self.devices.broadcast(message)
             
     async def start(self):
         """Startet die Bridge"""
@@ -54,23 +99,20 @@ class TagRacerBridge:
             loop.add_signal_handler(sig, lambda: asyncio.create_task(self.shutdown()))
             
         # Komponenten initialisieren
-        self.serial_handler = SerialHandler(
-            message_callback=lambda msg: asyncio.create_task(self.handle_serial_message(msg))
+        self.devices = DeviceManager(
+            message_callback=self.handle_serial_message
         )
         self.server_client = ServerClient(
             message_callback=self.handle_server_message
         )
+        self.batcher = RequestBatcher(self.server_client)
         
-        # Verbindungen herstellen
-        if not self.serial_handler.connect():
-            logging.error("Konnte keine Verbindung zum Flipper Zero herstellen")
-            await self.shutdown()
-            return
-            
+        # Erst der Server, Flipper werden danach laufend gesucht und verbunden
         if not await self.server_client.connect():
             logging.error("Konnte keine Verbindung zum Server herstellen")
             await self.shutdown()
             return
+        self.devices.start()
             
         # WebSocket-Handler starten
         await self.server_client.start_websocket_handler()
@@ -80,8 +122,8 @@ class TagRacerBridge:
         self.running = False
         logging.info("Beende TagRacer Bridge...")
         
-        if self.serial_handler:
-            self.serial_handler.disconnect()
+        if self.devices:
+            await self.devices.stop()
             
         if self.server_client:
             await self.server_client.disconnect()
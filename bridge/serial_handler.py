@@ -1,102 +1,277 @@
 """
-Behandelt die serielle Kommunikation mit dem Flipper Zero
+Behandelt die serielle Kommunikation mit einem Flipper Zero
+
+Der Port läuft als asyncio-Protokoll im Event-Loop der Bridge: data_received
+bekommt ganze Blöcke, zerlegt sie in JSON-Zeilen oder Binärrahmen und legt die
+Nachrichten in die Warteschlange dieses Geräts. Abgeholt werden sie mit take()
+vom DeviceManager, der alle Geräte reihum bedient. Sind MAX_QUEUE_SIZE
+Nachrichten offen, wird das Lesen pausiert, bis die Hälfte abgearbeitet ist.
+
+Der Binärmodus wird beim Öffnen ausgehandelt. Startet die App auf dem Flipper
+neu, spricht das Gerät wieder Textzeilen; sobald zwischen den Rahmen eine
+JSON-Zeile oder eine HTTP-Anfragezeile auftaucht, werden die Zeilen wie im
+Zeilenmodus zugestellt und das Hello erneut gesendet.
 """
 
-import serial
+import asyncio
 import json
 import logging
-from queue import Queue
-from threading import Thread, Event
-from typing import Optional, Callable
-from config import FLIPPER_SERIAL_PORT, FLIPPER_BAUD_RATE
-
-class SerialHandler:
-    def __init__(self, message_callback: Callable[[dict], None]):
-        self.port = FLIPPER_SERIAL_PORT
+import re
+import time
+from collections import deque
+from typing import Awaitable, Callable, Optional
+from config import (
+    FLIPPER_BAUD_RATE, MAX_QUEUE_SIZE, SERIAL_MAX_LINE, LINK_METRICS_WINDOW,
+    WIRE_PROTOCOL_ENABLED, WIRE_HELLO_TIMEOUT, WIRE_SCHEMA_PATH
+)
+from link_metrics import percentile
+from wire_codec import WireSchema, WireDecoder, WIRE_VERSION
+
+# Anfragezeile eines Flipper im HTTP-Modus
+HTTP_REQUEST_LINE = re.compile(rb'^(GET|POST|PUT|PATCH|DELETE) \S+ HTTP/1\.[01]$')
+
+# Öffnet den Port für ein Protokoll und liefert dessen Transport
+TransportOpener = Callable[[Callable[[], asyncio.Protocol]], Awaitable[asyncio.BaseTransport]]
+
+
+class SerialHandler(asyncio.Protocol):
+    def __init__(self, port: str, ready_callback: Callable[["SerialHandler"], None],
+                 wire_protocol: bool = WIRE_PROTOCOL_ENABLED):
+        self.port = port
         self.baud_rate = FLIPPER_BAUD_RATE
-        self.serial: Optional[serial.Serial] = None
+        self.transport: Optional[asyncio.Transport] = None
         self.running = False
-        self.message_callback = message_callback
-        self.read_thread: Optional[Thread] = None
-        self.write_queue = Queue()
-        self.write_thread: Optional[Thread] = None
-        self.connected = Event()
-        
-    def connect(self) -> bool:
-        """Verbindung zum Flipper Zero herstellen"""
+        # Wird aufgerufen, sobald die leere Warteschlange eine Nachricht hat
+        self.ready_callback = ready_callback
+        self.connected = asyncio.Event()
+        self.pending = deque()  # (Empfangszeit, Nachricht)
+        self.paused = False
+        self.line_buffer = bytearray()
+        # Binärrahmen statt JSON-Zeilen, wenn der Flipper das Hello beantwortet
+        self.wire_schema: Optional[WireSchema] = None
+        self.wire_decoder: Optional[WireDecoder] = None
+        self.hello: Optional[asyncio.Future] = None
+        if wire_protocol:
+            self.wire_schema = WireSchema(WIRE_SCHEMA_PATH)
+        # Statistik
+        self.rx_bytes = 0
+        self.messages = 0
+        self.invalid = 0
+        self.pauses = 0
+        self.renegotiations = 0
+        self.lag = deque(maxlen=LINK_METRICS_WINDOW)  # Empfang bis Abholung, s
+
+    async def connect(self, opener: Optional[TransportOpener] = None) -> bool:
+        """Verbindung zum Flipper Zero herstellen; opener ersetzt den echten
+        Port, z.B. durch ein Pseudo-Terminal im Benchmark"""
         try:
-            self.serial = serial.Serial(
-                port=self.port,
-                baudrate=self.baud_rate,
-                timeout=1
-            )
+            self.transport = await (opener or self._open_serial)(lambda: self)
+            if self.wire_schema:
+                await self._negotiate_wire()
             self.running = True
             self.connected.set()
-            self._start_threads()
-            logging.info(f"Verbunden mit Flipper Zero auf {self.port}")
+            logging.info(f"Verbunden mit Flipper Zero auf {self.port} ({self.mode})")
             return True
         except Exception as e:
-            logging.error(f"Verbindungsfehler: {e}")
+            logging.error(f"Verbindungsfehler auf {self.port}: {e}")
+            if self.transport:
+                self.transport.close()
             return False
-            
+
+    @property
+    def mode(self) -> str:
+        return "Binärrahmen" if self.wire_decoder else "JSON-Zeilen"
+
+    async def _open_serial(self, protocol_factory) -> asyncio.BaseTransport:
+        # Erst hier importiert, der Benchmark über ein Pseudo-Terminal braucht es nicht
+        import serial_asyncio
+        transport, _ = await serial_asyncio.create_serial_connection(
+            asyncio.get_running_loop(), protocol_factory, self.port, baudrate=self.baud_rate
+        )
+        return transport
+
+    async def _negotiate_wire(self):
+        """Hello senden und auf das Hello des Flipper warten; ohne Antwort
+        bleibt es bei JSON-Zeilen"""
+        self._send_hello()
+        await self._await_hello()
+
+    def _send_hello(self):
+        # Angefangene Textzeile des alten Decoders übernehmen
+        previous = self.wire_decoder
+        self.wire_decoder = WireDecoder(self.wire_schema)
+        if previous:
+            self.wire_decoder.unframed += previous.unframed
+        self.hello = asyncio.get_running_loop().create_future()
+        self.transport.write(self.wire_schema.encode({"type": "hello", "version": WIRE_VERSION}))
+
+    async def _await_hello(self):
+        try:
+            version = await asyncio.wait_for(self.hello, WIRE_HELLO_TIMEOUT)
+        except asyncio.TimeoutError:
+            # Angefangene Zeile gehört in den Zeilenpuffer
+            self.line_buffer += self.wire_decoder.unframed
+            self.hello = None
+            self.wire_decoder = None
+            return
+        if version != WIRE_VERSION:
+            logging.warning(f"Flipper auf {self.port} spricht Protokollversion {version}, nutze JSON-Zeilen")
+
+    async def _renegotiate(self):
+        await self._await_hello()
+        logging.info(f"{self.port} neu ausgehandelt ({self.mode})")
+
+    def _unframed_lines(self) -> list:
+        """Vollständige Textzeilen zwischen den Rahmen: JSON-Nachrichten, für
+        HTTP-Anfragezeilen nur eine Markierung. Alles andere ist Leitungsrauschen"""
+        unframed = self.wire_decoder.unframed
+        end = unframed.rfind(b'\n')
+        if end < 0:
+            return []
+        lines = bytes(unframed[:end]).split(b'\n')
+        del unframed[:end + 1]
+        messages = []
+        for line in lines:
+            line = line.strip()
+            if HTTP_REQUEST_LINE.match(line):
+                messages.append(None)
+                continue
+            try:
+                message = json.loads(line)
+            except (json.JSONDecodeError, UnicodeDecodeError):
+                continue
+            if isinstance(message, dict):
+                messages.append(message)
+        return messages
+
+    def _hello_received(self, version: int):
+        # Ab dem nächsten Byte gilt der ausgehandelte Modus; Nachrichten
+        # dahinter dürfen beantwortet werden, bevor connect() zurückkehrt
+        self.hello.set_result(version)
+        self.hello = None
+        if version != WIRE_VERSION:
+            self.wire_decoder = None
+        self.connected.set()
+
     def disconnect(self):
-        """Verbindung trennen und Threads beenden"""
+        """Verbindung trennen, offene Nachrichten verfallen"""
         self.running = False
         self.connected.clear()
-        if self.serial and self.serial.is_open:
-            self.serial.close()
-        if self.read_thread:
-            self.read_thread.join()
-        if self.write_thread:
-            self.write_thread.join()
-            
+        self.pending.clear()
+        if self.transport:
+            self.transport.close()
+
     def send_message(self, message: dict):
-        """Nachricht in die Warteschlange einfügen"""
-        if self.connected.is_set():
-            self.write_queue.put(message)
-            
-    def _start_threads(self):
-        """Lese- und Schreib-Threads starten"""
-        self.read_thread = Thread(target=self._read_loop, daemon=True)
-        self.write_thread = Thread(target=self._write_loop, daemon=True)
-        self.read_thread.start()
-        self.write_thread.start()
-        
-    def _read_loop(self):
-        """Kontinuierliches Lesen von der seriellen Schnittstelle"""
-        buffer = ""
-        while self.running:
-            if self.serial and self.serial.is_open:
-                try:
-                    if self.serial.in_waiting:
-                        char = self.serial.read().decode('utf-8')
-                        if char == '\n':
-                            if buffer:
-                                try:
-                                    message = json.loads(buffer)
-                                    self.message_callback(message)
-                                except json.JSONDecodeError:
-                                    logging.warning(f"Ungültige JSON-Nachricht: {buffer}")
-                                buffer = ""
-                        else:
-                            buffer += char
-                except Exception as e:
-                    logging.error(f"Fehler beim Lesen: {e}")
-                    self.connected.clear()
-                    break
-                    
-    def _write_loop(self):
-        """Kontinuierliches Schreiben zur seriellen Schnittstelle"""
-        while self.running:
-            try:
-                message = self.write_queue.get(timeout=1)
-                if self.serial and self.serial.is_open:
-                    json_str = json.dumps(message) + '\n'
-                    self.serial.write(json_str.encode('utf-8'))
-                    logging.debug(f"Gesendet: {message}")
-            except Queue.Empty:
-                continue
-            except Exception as e:
-                logging.error(f"Fehler beim Schreiben: {e}")
-                self.connected.clear()
+        """Nachricht senden, der Transport puffert bis der Port frei ist"""
+        if not self.connected.is_set():
+            return
+        # Während eines neuen Hello spricht das Gerät noch Zeilen
+        if self.wire_decoder and self.hello is None:
+            if message.get("type") not in self.wire_schema.by_name:
+                logging.debug(f"Nicht im Binärschema, verworfen: {message}")
+                return
+            self.transport.write(self.wire_schema.encode(message))
+        else:
+            self.transport.write(json.dumps(message).encode('utf-8') + b'\n')
+        logging.debug(f"Gesendet an {self.port}: {message}")
+
+    def take(self) -> Optional[dict]:
+        """Älteste Nachricht, None = Warteschlange leer"""
+        if not self.pending:
+            return None
+        received, message = self.pending.popleft()
+        self.messages += 1
+        self.lag.append(time.monotonic() - received)
+        if self.paused and len(self.pending) <= MAX_QUEUE_SIZE // 2:
+            self.paused = False
+            self.transport.resume_reading()
+        return message
+
+    def stats(self) -> dict:
+        return {
+            "port": self.port,
+            "mode": self.mode,
+            "messages": self.messages,
+            "rx_bytes": self.rx_bytes,
+            "queued": len(self.pending),
+            "pauses": self.pauses,
+            "invalid": self.invalid,
+            "renegotiations": self.renegotiations,
+            "lag_p50_ms": percentile(self.lag, 50) * 1000,
+            "lag_p99_ms": percentile(self.lag, 99) * 1000,
+        }
+
+    # asyncio.Protocol
+
+    def connection_made(self, transport: asyncio.BaseTransport):
+        self.transport = transport
+
+    def connection_lost(self, exc: Optional[Exception]):
+        if self.running:
+            logging.error(f"Serielle Verbindung auf {self.port} verloren: {exc}")
+        self.running = False
+        self.connected.clear()
+
+    def data_received(self, data: bytes):
+        self.rx_bytes += len(data)
+        received = time.monotonic()
+        if self.wire_decoder:
+            # Binärrahmen: dekodierte Nachrichten tragen "type", "_id"
+            # und den Empfangszeitpunkt "_rx" für die Leitungsmessung.
+            # Vor dem Hello des Flipper zählt nur dieses
+            messages = []
+            for message in self.wire_decoder.feed(data):
+                if self.hello is not None:
+                    if message["type"] == "hello":
+                        self._hello_received(message["version"])
+                    continue
+                message["_rx"] = received
+                messages.append(message)
+            if self.wire_decoder:
+                lines = self._unframed_lines()
+                messages.extend(message for message in lines if message is not None)
+                if lines and self.hello is None and self.running:
+                    # Gerät ist wieder im Textmodus, z.B. nach Neustart der App
+                    self.renegotiations += 1
+                    logging.warning(f"{self.port} sendet wieder Zeilen, handle Binärrahmen neu aus")
+                    self._send_hello()
+                    asyncio.get_running_loop().create_task(self._renegotiate())
+        else:
+            messages = self._split_lines(data)
+        if not messages:
+            return
+
+        was_empty = not self.pending
+        self.pending.extend((received, message) for message in messages)
+        if len(self.pending) >= MAX_QUEUE_SIZE and not self.paused:
+            self.paused = True
+            self.pauses += 1
+            self.transport.pause_reading()
+        if was_empty:
+            self.ready_callback(self)
+
+    def _split_lines(self, data: bytes) -> list:
+        """Alle vollständigen Zeilen eines Blocks, der Rest bleibt im Puffer"""
+        buffer = self.line_buffer
+        buffer += data
+        messages = []
+        start = 0
+        while True:
+            end = buffer.find(b'\n', start)
+            if end < 0:
                 break
+            line = buffer[start:end].strip()
+            start = end + 1
+            if not line:
+                continue
+            try:
+                messages.append(json.loads(line))
+            except (json.JSONDecodeError, UnicodeDecodeError):
+                self.invalid += 1
+                logging.warning(f"Ungültige JSON-Nachricht von {self.port}: {bytes(line)!r}")
+        del buffer[:start]
+        if len(buffer) > SERIAL_MAX_LINE:
+            self.invalid += 1
+            logging.warning(f"Zeile ohne Ende von {self.port} nach {len(buffer)} Bytes verworfen")
+            buffer.clear()
+        return messages
@@ -7,7 +7,10 @@ import aiohttp
 import json
 import logging
 from typing import Optional, Callable
-from config import SERVER_URL, API_ENDPOINT, WEBSOCKET_ENDPOINT, MAX_RECONNECT_ATTEMPTS, RECONNECT_DELAY
+from config import (
+    SERVER_URL, API_ENDPOINT, BATCH_ENDPOINT, WEBSOCKET_ENDPOINT, SERVER_CONNECTIONS,
+    MAX_RECONNECT_ATTEMPTS, RECONNECT_DELAY
+)
 
 class ServerClient:
     def __init__(self, message_callback: Callable[[dict], None]):
@@ -20,7 +23,10 @@ class ServerClient:
     async def connect(self) -> bool:
         """Verbindung zum Server herstellen"""
         try:
-            self.session = aiohttp.ClientSession()
+            # Eine Sitzung für alle Flipper, die Verbindungen werden wiederverwendet
+            self.session = aiohttp.ClientSession(
+                connector=aiohttp.TCPConnector(limit=SERVER_CONNECTIONS)
+            )
             self.ws = await self.session.ws_connect(WEBSOCKET_ENDPOINT)
             self.running = True
             logging.info("Verbunden mit TagRacer Server")
@@ -51,6 +57,24 @@ class ServerClient:
             logging.error(f"Fehler beim Senden der Tag-Daten: {e}")
             return {"error": str(e)}
             
+    async def send_batch(self, items: list) -> Optional[list]:
+        """Mehrere Anfragen als {"items": [...]}, der Server antwortet mit
+        {"results": [...]} in derselben Reihenfolge. None = Endpunkt fehlt"""
+        try:
+            async with self.session.post(
+                f"{SERVER_URL}{BATCH_ENDPOINT}",
+                json={"items": items}
+            ) as response:
+                if response.status in (404, 405):
+                    return None
+                results = (await response.json()).get("results")
+                if not isinstance(results, list) or len(results) != len(items):
+                    raise ValueError(f"{len(items)} Anfragen, Antwort passt nicht")
+                return results
+        except Exception as e:
+            logging.error(f"Fehler beim Senden des Batches: {e}")
+            return [{"error": str(e)}] * len(items)
+            
     async def start_websocket_handler(self):
         """WebSocket-Verbindung verwalten und Nachrichten empfangen"""
         attempt = 0
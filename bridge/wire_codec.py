@@ -0,0 +1,175 @@
+"""
+Binäres Leitungsprotokoll zum Flipper Zero (Gegenstück zu flipper_http/wire_protocol.c)
+
+Rahmen: 0xA5 | Typ (1) | ID (2) | Länge (2) | Nutzdaten | CRC-16 (2), Little Endian.
+Die Nutzdaten-Layouts kommen aus flipper_http/wire_schema.def, derselben Datei,
+aus der die Firmware ihre C-Strukturen erzeugt.
+"""
+
+import binascii
+import re
+import struct
+from typing import Dict, List, Optional
+
+WIRE_SYNC = 0xA5
+WIRE_VERSION = 3
+
+HEADER = struct.Struct('<BBHH')  # Sync, Typ, ID, Länge
+CRC = struct.Struct('<H')
+
+_BEGIN = re.compile(r'^\s*WIRE_BEGIN\((\w+),\s*(0x[0-9A-Fa-f]+|\d+),\s*"(\w+)"\)')
+_FIELD = re.compile(r'^\s*WIRE_(U8|U16|U32|STR|BYTES)\((\w+)(?:,\s*(\d+))?\)')
+_END = re.compile(r'^\s*WIRE_END\((\w+)\)')
+_FORMATS = {"U8": "B", "U16": "H", "U32": "I", "STR": "s", "BYTES": "s"}
+
+
+def crc16(data: bytes) -> int:
+    """CRC-16/CCITT, Start 0xFFFF"""
+    return binascii.crc_hqx(data, 0xFFFF)
+
+
+class WireMessage:
+    def __init__(self, name: str, type_id: int, json_name: str):
+        self.name = name
+        self.type_id = type_id
+        self.json_name = json_name
+        self.fields = []  # (Name, Art, Größe)
+        self.layout: Optional[struct.Struct] = None
+
+    def finish(self):
+        fmt = '<' + ''.join(
+            f"{size}s" if kind in ("STR", "BYTES") else _FORMATS[kind]
+            for _, kind, size in self.fields
+        )
+        self.layout = struct.Struct(fmt)
+
+    def pack(self, values: dict) -> bytes:
+        """Fehlende Felder werden 0 bzw. leer"""
+        items = []
+        for name, kind, size in self.fields:
+            value = values.get(name)
+            if kind == "STR":
+                items.append((value or "").encode('utf-8')[:size])
+            elif kind == "BYTES":
+                if isinstance(value, str):
+                    value = bytes.fromhex(value)
+                items.append(bytes(value or b"")[:size])
+            else:
+                items.append(int(value or 0))
+        return self.layout.pack(*items)
+
+    def unpack(self, payload: bytes) -> dict:
+        values = {}
+        for (name, kind, _), value in zip(self.fields, self.layout.unpack(payload)):
+            if kind == "STR":
+                value = value.split(b'\0', 1)[0].decode('utf-8', errors='replace')
+            elif kind == "BYTES":
+                value = value.hex().upper()  # JSON-tauglich, wie tag_id_format_hex
+            values[name] = value
+        return values
+
+
+class WireSchema:
+    """Liest wire_schema.def"""
+
+    def __init__(self, path: str):
+        self.by_type: Dict[int, WireMessage] = {}
+        self.by_name: Dict[str, WireMessage] = {}
+        current: Optional[WireMessage] = None
+
+        with open(path, encoding='utf-8') as schema:
+            for number, line in enumerate(schema, 1):
+                line = line.split('//', 1)[0]
+                if not line.strip():
+                    continue
+                begin = _BEGIN.match(line)
+                field = _FIELD.match(line)
+                end = _END.match(line)
+                if begin and current is None:
+                    current = WireMessage(begin.group(1), int(begin.group(2), 0), begin.group(3))
+                elif field and current is not None:
+                    kind = field.group(1)
+                    size = int(field.group(3)) if field.group(3) else 0
+                    current.fields.append((field.group(2), kind, size))
+                elif end and current is not None and end.group(1) == current.name:
+                    current.finish()
+                    self.by_type[current.type_id] = current
+                    self.by_name[current.json_name] = current
+                    current = None
+                else:
+                    raise ValueError(f"{path}:{number}: unerwartete Zeile: {line.strip()}")
+
+        if current is not None:
+            raise ValueError(f"{path}: WIRE_END für {current.name} fehlt")
+
+    def payload_size(self, type_id: int) -> int:
+        message = self.by_type.get(type_id)
+        return message.layout.size if message else 0
+
+    def encode(self, message: dict) -> bytes:
+        """Dict mit "type" (json_name) und optional "_id" als Rahmen"""
+        spec = self.by_name[message["type"]]
+        payload = spec.pack(message)
+        body = struct.pack('<BHH', spec.type_id, message.get("_id", 0), len(payload)) + payload
+        return bytes([WIRE_SYNC]) + body + CRC.pack(crc16(body))
+
+
+class WireDecoder:
+    """Inkrementell wie der C-Decoder: Bytes außerhalb von Rahmen werden
+    übersprungen, nach einem Fehler wird am nächsten Sync-Byte aufgesetzt.
+    Übersprungene Bytes sammelt unframed (höchstens UNFRAMED_MAX), der
+    Aufrufer erkennt daran ein Gerät, das wieder Textzeilen schickt"""
+
+    UNFRAMED_MAX = 4096
+
+    def __init__(self, schema: WireSchema):
+        self.schema = schema
+        self.buffer = bytearray()
+        self.unframed = bytearray()
+        self.frames = 0
+        self.errors = 0
+
+    def _skip(self, size: int):
+        self.unframed += self.buffer[:size]
+        del self.buffer[:size]
+        if len(self.unframed) > self.UNFRAMED_MAX:
+            del self.unframed[:-self.UNFRAMED_MAX]
+
+    def feed(self, data: bytes) -> List[dict]:
+        self.buffer += data
+        messages = []
+
+        while True:
+            start = self.buffer.find(WIRE_SYNC)
+            if start < 0:
+                self._skip(len(self.buffer))
+                break
+            self._skip(start)
+            if len(self.buffer) < HEADER.size:
+                break
+
+            _, type_id, frame_id, length = HEADER.unpack_from(self.buffer)
+            if length == 0 or self.schema.payload_size(type_id) != length:
+                self.errors += 1
+                self._skip(HEADER.size)
+                continue
+
+            frame_size = HEADER.size + length + CRC.size
+            if len(self.buffer) < frame_size:
+                break
+
+            frame = bytes(self.buffer[:frame_size])
+            del self.buffer[:frame_size]
+            (received,) = CRC.unpack_from(frame, frame_size - CRC.size)
+            if crc16(frame[1:-CRC.size]) != received:
+                self.errors += 1
+                continue
+
+            spec = self.schema.by_type[type_id]
+            message = spec.unpack(frame[HEADER.size:-CRC.size])
+            message["type"] = spec.json_name
+            message["_id"] = frame_id
+            self.frames += 1
+            messages.append(message)
+
+        return messages
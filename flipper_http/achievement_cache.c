@@ -8,7 +8,7 @@ AchievementCache* achievement_cache_alloc(void) {
     cache->entry_count = 0;
     cache->last_update = 0;
     cache->needs_sync = false;
-    cache->mutex = furi_mutex_alloc(FuriMutexTypeNormal);
+    cache->mutex = furi_mutex_alloc(FuriMutexTypeRecursive);
     
     return cache;
 }
@@ -147,6 +147,11 @@ void achievement_cache_compact(AchievementCache* cache) {
     
     furi_mutex_acquire(cache->mutex, FuriWaitForever);
     
+    if(cache->entry_count < 2) {
+        furi_mutex_release(cache->mutex);
+        return;
+    }
+    
     // Einträge nach ID sortieren
     for(uint32_t i = 0; i < cache->entry_count - 1; i++) {
         for(uint32_t j = 0; j < cache->entry_count - i - 1; j++) {
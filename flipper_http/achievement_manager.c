@@ -1,5 +1,5 @@
 #include "achievement_manager.h"
-#include <notification/notification_messages.h>
+#include "notifier.h"
 #include <furi_hal_rtc.h>
 
 // Standard-Achievements
@@ -122,10 +122,7 @@ bool achievement_manager_unlock_achievement(
     manager->completed_achievements++;
     
     // Benachrichtigung
-    NotificationApp* notifications = furi_record_open(RECORD_NOTIFICATION);
-    notification_message(notifications, &sequence_success);
-    notification_message(notifications, &sequence_blink_magenta_100);
-    furi_record_close(RECORD_NOTIFICATION);
+    notifier_post(NotifyAchievement);
     
     // Callback aufrufen
     if(manager->unlock_callback) {
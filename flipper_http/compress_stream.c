@@ -0,0 +1,151 @@
+#include "compress_stream.h"
+#include <toolbox/compression.h>
+#include "wire_protocol.h"
+
+CompressStream* compress_stream_alloc(size_t window_size) {
+    CompressStream* stream = malloc(sizeof(CompressStream));
+    memset(stream, 0, sizeof(CompressStream));
+    stream->window_size = MIN(MAX(window_size, COMPRESS_STREAM_WINDOW_MIN), COMPRESS_STREAM_WINDOW_MAX);
+    stream->window = malloc(stream->window_size);
+    stream->block = malloc(COMPRESS_STREAM_BLOCK_HEADER + stream->window_size);
+    compression_init();
+    return stream;
+}
+
+void compress_stream_free(CompressStream* stream) {
+    if(!stream) return;
+    compression_free();
+    free(stream->block);
+    free(stream->window);
+    free(stream);
+}
+
+static void compress_stream_reset(CompressStream* stream) {
+    stream->fill = 0;
+    stream->length = 0;
+    stream->file = NULL;
+    stream->buffer = NULL;
+    stream->capacity = 0;
+    stream->left = 0;
+    stream->in = 0;
+    stream->out = 0;
+    stream->crc = 0xFFFF;
+    stream->ok = true;
+}
+
+void compress_stream_begin_file(CompressStream* stream, File* file) {
+    compress_stream_reset(stream);
+    stream->file = file;
+}
+
+void compress_stream_begin_buffer(CompressStream* stream, uint8_t* buffer, size_t capacity) {
+    compress_stream_reset(stream);
+    stream->buffer = buffer;
+    stream->capacity = capacity;
+}
+
+static bool compress_stream_emit(CompressStream* stream, const uint8_t* data, size_t size) {
+    if(stream->file) {
+        if(storage_file_write(stream->file, data, size) != size) return false;
+    } else {
+        if(stream->out + size > stream->capacity) return false;
+        memcpy(stream->buffer + stream->out, data, size);
+    }
+    stream->crc = wire_crc16(stream->crc, data, size);
+    stream->out += size;
+    return true;
+}
+
+// Fenster als einen Block ausgeben; gepackt nur, wenn es kleiner wird
+static bool compress_stream_flush_window(CompressStream* stream) {
+    if(stream->fill == 0) return true;
+
+    uint8_t* block = stream->block;
+    size_t stored = stream->fill - 1;
+    bool packed = compression_encode(
+        stream->window, stream->fill, block + COMPRESS_STREAM_BLOCK_HEADER, &stored, 9);
+    if(!packed) stored = stream->fill;
+
+    block[0] = stream->fill & 0xFF;
+    block[1] = stream->fill >> 8;
+    block[2] = stored & 0xFF;
+    block[3] = stored >> 8;
+    bool success = packed ? compress_stream_emit(stream, block, COMPRESS_STREAM_BLOCK_HEADER + stored) :
+                            compress_stream_emit(stream, block, COMPRESS_STREAM_BLOCK_HEADER) &&
+                                compress_stream_emit(stream, stream->window, stored);
+    stream->fill = 0;
+    return success;
+}
+
+bool compress_stream_write(CompressStream* stream, const void* data, size_t size) {
+    const uint8_t* bytes = data;
+    while(stream->ok && size > 0) {
+        size_t chunk = MIN(size, stream->window_size - stream->fill);
+        memcpy(stream->window + stream->fill, bytes, chunk);
+        stream->fill += chunk;
+        stream->in += chunk;
+        bytes += chunk;
+        size -= chunk;
+        if(stream->fill == stream->window_size) stream->ok = compress_stream_flush_window(stream);
+    }
+    return stream->ok;
+}
+
+bool compress_stream_finish(CompressStream* stream) {
+    if(stream->ok) stream->ok = compress_stream_flush_window(stream);
+    return stream->ok;
+}
+
+void compress_stream_open_file(CompressStream* stream, File* file, uint32_t stored) {
+    compress_stream_reset(stream);
+    stream->file = file;
+    stream->left = stored;
+}
+
+static bool compress_stream_take(CompressStream* stream, uint8_t* data, size_t size) {
+    if(size > stream->left || storage_file_read(stream->file, data, size) != size) return false;
+    stream->crc = wire_crc16(stream->crc, data, size);
+    stream->left -= size;
+    stream->out += size;
+    return true;
+}
+
+// Nächsten Block ins Fenster entpacken
+static bool compress_stream_fill_window(CompressStream* stream) {
+    uint8_t* block = stream->block;
+    if(!compress_stream_take(stream, block, COMPRESS_STREAM_BLOCK_HEADER)) return false;
+    size_t length = block[0] | (block[1] << 8);
+    size_t stored = block[2] | (block[3] << 8);
+    if(length == 0 || length > stream->window_size || stored > length) return false;
+
+    if(stored == length) {
+        if(!compress_stream_take(stream, stream->window, length)) return false;
+    } else {
+        size_t size = length;
+        if(!compress_stream_take(stream, block, stored) ||
+           !compression_decode(block, stored, stream->window, &size) || size != length) {
+            return false;
+        }
+    }
+    stream->fill = 0;
+    stream->length = length;
+    return true;
+}
+
+size_t compress_stream_read(CompressStream* stream, void* data, size_t size) {
+    uint8_t* bytes = data;
+    size_t done = 0;
+    while(stream->ok && done < size) {
+        if(stream->fill == stream->length) {
+            if(stream->left == 0) break;
+            stream->ok = compress_stream_fill_window(stream);
+            continue;
+        }
+        size_t chunk = MIN(size - done, stream->length - stream->fill);
+        memcpy(bytes + done, stream->window + stream->fill, chunk);
+        stream->fill += chunk;
+        stream->in += chunk;
+        done += chunk;
+    }
+    return done;
+}
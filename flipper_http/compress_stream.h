@@ -0,0 +1,52 @@
+#pragma once
+
+#include <furi.h>
+#include <storage/storage.h>
+
+// Kompression in Blöcken fester Fenstergröße, direkt in eine Datei oder
+// einen Puffer, und beim Lesen ebenso zurück. Der Kontext bleibt über viele
+// Ströme bestehen: ein compression_init, zwei Puffer in Fenstergröße statt
+// Ein- und Ausgabe in voller Länge.
+//
+//   Rohlänge (2) | gespeicherte Länge (2) | Daten
+//
+// Little Endian. Sind beide Längen gleich, liegt der Block roh, weil Packen
+// nichts gebracht hat.
+
+#define COMPRESS_STREAM_WINDOW_MIN 512
+#define COMPRESS_STREAM_WINDOW_MAX 4096
+#define COMPRESS_STREAM_BLOCK_HEADER 4
+
+typedef struct {
+    size_t window_size;
+    uint8_t* window;  // Rohdaten eines Blocks
+    uint8_t* block;   // Kopf und gepackte Daten
+    size_t fill;      // Schreiben: Bytes im Fenster, Lesen: gelesene davon
+    size_t length;    // Lesen: entpackte Bytes im Fenster
+
+    File* file;
+    uint8_t* buffer;  // Statt file, nur zum Schreiben
+    size_t capacity;
+    uint32_t left;    // Lesen: noch nicht gelesene gespeicherte Bytes
+
+    uint32_t in;      // Rohbytes
+    uint32_t out;     // Gespeicherte Bytes mit Köpfen
+    uint16_t crc;     // wire_crc16 über die gespeicherten Bytes
+    bool ok;          // false nach dem ersten Fehler im Strom
+} CompressStream;
+
+// window_size wird auf COMPRESS_STREAM_WINDOW_MIN..MAX begrenzt
+CompressStream* compress_stream_alloc(size_t window_size);
+void compress_stream_free(CompressStream* stream);
+
+// Neuer Strom ab der aktuellen Dateiposition bzw. an den Pufferanfang
+void compress_stream_begin_file(CompressStream* stream, File* file);
+void compress_stream_begin_buffer(CompressStream* stream, uint8_t* buffer, size_t capacity);
+bool compress_stream_write(CompressStream* stream, const void* data, size_t size);
+// Letzten Block schreiben; danach stehen out und crc fest
+bool compress_stream_finish(CompressStream* stream);
+
+// stored gespeicherte Bytes ab der aktuellen Dateiposition entpacken
+void compress_stream_open_file(CompressStream* stream, File* file, uint32_t stored);
+// Weniger als size am Ende des Stroms oder nach einem Fehler (ok = false)
+size_t compress_stream_read(CompressStream* stream, void* data, size_t size);
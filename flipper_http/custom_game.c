@@ -0,0 +1,122 @@
+#include "game_modes.h"
+#include <storage/storage.h>
+#include "notifier.h"
+
+#define CUSTOM_RULES_DIR OFFLINE_DATA_DIR "/rules"
+#define CUSTOM_RULES_VERSION 1
+
+typedef struct {
+    uint32_t version;
+    GameRules rules;
+} CustomRulesFile;
+
+// GameRules in einen Modus-Deskriptor übersetzen. Danach arbeitet der
+// Spielkern ausschließlich mit dem Deskriptor.
+static bool custom_game_compile(const GameRules* rules, GameModeDescriptor* mode) {
+    if(rules->min_players > rules->max_players) return false;
+    if(rules->time_limit_enabled && rules->time_limit == 0) return false;
+
+    *mode = *game_state_get_mode(GameModeCustom);
+
+    mode->duration_sec = rules->time_limit_enabled ? rules->time_limit : 0;
+    mode->base_points *= MAX(rules->tag_multiplier, 1U);
+    if(rules->combo_multiplier > 0) {
+        mode->max_combo = rules->combo_multiplier;
+    }
+    mode->win_score = rules->win_score;
+    mode->power_ups_enabled = rules->power_ups_enabled;
+
+    return true;
+}
+
+bool custom_game_create(GameContext* game, const GameRules* rules) {
+    if(!game || !rules) return false;
+    if(game->state == GameStateRunning) return false;
+
+    GameModeDescriptor mode;
+    if(!custom_game_compile(rules, &mode)) return false;
+
+    game->custom_mode = mode;
+    game->mode = GameModeCustom;
+    game->state = GameStateIdle;
+    game_state_set_status(game, "Eigene Regeln geladen");
+
+    return true;
+}
+
+bool custom_game_start(GameContext* game) {
+    if(!game) return false;
+    return game_state_start(game, GameModeCustom);
+}
+
+bool custom_game_update(GameContext* game) {
+    if(!game || game->mode != GameModeCustom) return false;
+
+    game_state_update(game);
+    return !game_state_is_finished(game);
+}
+
+bool custom_game_end(GameContext* game) {
+    if(!game || game->state != GameStateRunning) return false;
+
+    game->state = GameStateFinished;
+    game_state_set_status(game, "Spiel beendet!");
+
+    notifier_post(NotifyGameEnd);
+
+    return true;
+}
+
+bool custom_game_save_rules(const GameRules* rules, const char* name) {
+    if(!rules || !name) return false;
+
+    Storage* storage = furi_record_open(RECORD_STORAGE);
+    if(!storage) return false;
+
+    char path[128];
+    snprintf(path, sizeof(path), "%s/%s.bin", CUSTOM_RULES_DIR, name);
+
+    CustomRulesFile data = {
+        .version = CUSTOM_RULES_VERSION,
+        .rules = *rules,
+    };
+
+    bool success = false;
+    storage_mkdir(storage, CUSTOM_RULES_DIR);
+    File* file = storage_file_alloc(storage);
+    if(storage_file_open(file, path, FSAM_WRITE, FSOM_CREATE_ALWAYS)) {
+        success = storage_file_write(file, &data, sizeof(data)) == sizeof(data);
+    }
+    storage_file_close(file);
+    storage_file_free(file);
+
+    furi_record_close(RECORD_STORAGE);
+    return success;
+}
+
+bool custom_game_load_rules(GameRules* rules, const char* name) {
+    if(!rules || !name) return false;
+
+    Storage* storage = furi_record_open(RECORD_STORAGE);
+    if(!storage) return false;
+
+    char path[128];
+    snprintf(path, sizeof(path), "%s/%s.bin", CUSTOM_RULES_DIR, name);
+
+    CustomRulesFile data;
+    bool success = false;
+    File* file = storage_file_alloc(storage);
+    if(storage_file_open(file, path, FSAM_READ, FSOM_OPEN_EXISTING)) {
+        success = storage_file_read(file, &data, sizeof(data)) == sizeof(data) &&
+                  data.version == CUSTOM_RULES_VERSION;
+    }
+    storage_file_close(file);
+    storage_file_free(file);
+
+    if(success) {
+        *rules = data.rules;
+    }
+
+    furi_record_close(RECORD_STORAGE);
+    return success;
+}
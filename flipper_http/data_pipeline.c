@@ -1,7 +1,35 @@
 #include "data_pipeline.h"
-#include <toolbox/compression.h>
 #include <furi_hal_rtc.h>
 
+static const RetryConfig pipeline_retry_config = {
+    .base_ms = PIPELINE_RETRY_BASE_MS,
+    .max_ms = PIPELINE_RETRY_MAX_MS,
+    .max_attempts = PIPELINE_RETRY_ATTEMPTS,
+    .failure_threshold = PIPELINE_BREAKER_THRESHOLD,
+    .open_ms = PIPELINE_BREAKER_OPEN_MS,
+};
+
+// Batch leeren und Item-Daten freigeben, mutex muss gehalten werden
+static void pipeline_clear_batch(DataPipeline* pipeline) {
+    for(uint32_t i = 0; i < pipeline->batch.count; i++) {
+        free(pipeline->batch.items[i].data);
+    }
+    pipeline->batch.count = 0;
+    pipeline->batch.total_size = 0;
+    pipeline->retry_count = 0;
+}
+
+// Batch aufgeben: offline ablegen statt verwerfen
+static void pipeline_spill_batch(DataPipeline* pipeline) {
+    if(pipeline->spill_callback &&
+       pipeline->spill_callback(&pipeline->batch, pipeline->spill_context)) {
+        pipeline->spilled_items += pipeline->batch.count;
+    } else {
+        pipeline->dropped_items += pipeline->batch.count;
+    }
+    pipeline_clear_batch(pipeline);
+}
+
 // Worker-Thread
 static int32_t pipeline_worker(void* context) {
     DataPipeline* pipeline = (DataPipeline*)context;
@@ -12,30 +40,38 @@ static int32_t pipeline_worker(void* context) {
         uint32_t now = furi_get_tick();
         bool should_process = false;
         
-        // Prüfen ob Batch-Verarbeitung nötig
-        if(pipeline->batch.count >= MAX_BATCH_SIZE ||
-           pipeline->batch.total_size >= PIPELINE_BUFFER_SIZE / 2 ||
-           (now - pipeline->last_sync >= 5000 && pipeline->batch.count > 0)) {
+        // Prüfen ob Batch-Verarbeitung nötig, im Backoff erst danach
+        if((pipeline->batch.count >= MAX_BATCH_SIZE ||
+            pipeline->batch.total_size >= PIPELINE_BUFFER_SIZE / 2 ||
+            (now - pipeline->last_sync >= 5000 && pipeline->batch.count > 0)) &&
+           (int32_t)(now - pipeline->next_attempt) >= 0) {
             should_process = true;
         }
         
+        RetryDecision decision = RetryWait;
         if(should_process) {
-            // Batch verarbeiten
-            if(data_pipeline_process_batch(pipeline)) {
-                // Batch hochladen
-                if(data_pipeline_upload_batch(pipeline)) {
-                    pipeline->last_sync = now;
-                    pipeline->retry_count = 0;
+            decision = retry_policy_check(&pipeline->retry, now);
+        }
+        
+        if(decision == RetryReject) {
+            // Server gilt als ausgefallen: nicht senden, offline ablegen
+            pipeline_spill_batch(pipeline);
+        } else if(decision == RetryAllow && data_pipeline_process_batch(pipeline)) {
+            // Batch hochladen
+            if(data_pipeline_upload_batch(pipeline)) {
+                retry_policy_success(&pipeline->retry);
+                pipeline->last_sync = now;
+                pipeline->retry_count = 0;
+            } else {
+                pipeline->failed_items += pipeline->batch.count;
+                pipeline->retry_count++;
+                retry_policy_failure(&pipeline->retry, now);
+                
+                if(retry_policy_can_retry(&pipeline->retry, pipeline->retry_count)) {
+                    pipeline->next_attempt =
+                        now + retry_policy_backoff(&pipeline->retry, pipeline->retry_count);
                 } else {
-                    pipeline->failed_items += pipeline->batch.count;
-                    pipeline->retry_count++;
-                    
-                    // Nach zu vielen Fehlversuchen Batch verwerfen
-                    if(pipeline->retry_count >= RETRY_COUNT) {
-                        pipeline->batch.count = 0;
-                        pipeline->batch.total_size = 0;
-                        pipeline->retry_count = 0;
-                    }
+                    pipeline_spill_batch(pipeline);
                 }
             }
         }
@@ -75,14 +111,21 @@ DataPipeline* data_pipeline_alloc(void) {
     pipeline->processed_items = 0;
     pipeline->failed_items = 0;
     pipeline->retry_count = 0;
+    pipeline->spilled_items = 0;
+    pipeline->dropped_items = 0;
     pipeline->last_sync = 0;
+    pipeline->next_attempt = 0;
+    retry_policy_init(&pipeline->retry, &pipeline_retry_config);
+    pipeline->compressor = compress_stream_alloc(COMPRESSION_CHUNK);
     
     // Callbacks initialisieren
     pipeline->process_callback = NULL;
     pipeline->upload_callback = NULL;
     pipeline->callback_context = NULL;
+    pipeline->spill_callback = NULL;
+    pipeline->spill_context = NULL;
     
-    pipeline->mutex = furi_mutex_alloc(FuriMutexTypeNormal);
+    pipeline->mutex = furi_mutex_alloc(FuriMutexTypeRecursive);
     
     // Worker-Thread starten
     pipeline->running = true;
@@ -107,6 +150,7 @@ void data_pipeline_free(DataPipeline* pipeline) {
     // Buffer freigeben
     free(pipeline->input.buffer);
     free(pipeline->output.buffer);
+    compress_stream_free(pipeline->compressor);
     
     // Items freigeben
     for(uint32_t i = 0; i < pipeline->batch.count; i++) {
@@ -224,31 +268,29 @@ bool data_pipeline_process_batch(DataPipeline* pipeline) {
     for(uint32_t i = 0; i < pipeline->batch.count; i++) {
         DataItem* item = &pipeline->batch.items[i];
         
-        // Komprimierung wenn sinnvoll
+        // Komprimierung wenn sinnvoll; behalten nur, wenn kleiner. Kleine
+        // Items gehen über output.buffer, nur größere brauchen einen Puffer
         if(!item->compressed && item->size > COMPRESSION_CHUNK) {
-            size_t comp_size = item->size * 2; // Worst case
-            uint8_t* comp_data = malloc(comp_size);
+            size_t capacity = item->size - 1;
+            uint8_t* comp_data = (capacity <= pipeline->output.capacity) ?
+                                     pipeline->output.buffer :
+                                     malloc(capacity);
+            CompressStream* stream = pipeline->compressor;
+            compress_stream_begin_buffer(stream, comp_data, capacity);
             
-            if(comp_data) {
-                if(compression_encode(
-                    item->data,
-                    item->size,
-                    comp_data,
-                    &comp_size,
-                    9 // Max compression
-                )) {
-                    // Komprimierte Daten verwenden wenn kleiner
-                    if(comp_size < item->size) {
-                        free(item->data);
-                        item->data = comp_data;
-                        item->size = comp_size;
-                        item->compressed = true;
-                    } else {
-                        free(comp_data);
-                    }
+            if(compress_stream_write(stream, item->data, item->size) &&
+               compress_stream_finish(stream)) {
+                free(item->data);
+                if(comp_data == pipeline->output.buffer) {
+                    item->data = malloc(stream->out);
+                    memcpy(item->data, comp_data, stream->out);
                 } else {
-                    free(comp_data);
+                    item->data = comp_data;
                 }
+                item->size = stream->out;
+                item->compressed = true;
+            } else if(comp_data != pipeline->output.buffer) {
+                free(comp_data);
             }
         }
         
@@ -281,19 +323,42 @@ bool data_pipeline_upload_batch(DataPipeline* pipeline) {
     );
     
     if(success) {
-        // Batch leeren
-        for(uint32_t i = 0; i < pipeline->batch.count; i++) {
-            free(pipeline->batch.items[i].data);
-        }
-        
-        pipeline->batch.count = 0;
-        pipeline->batch.total_size = 0;
+        pipeline_clear_batch(pipeline);
     }
     
     furi_mutex_release(pipeline->mutex);
     return success;
 }
 
+void data_pipeline_write_batch_json(const DataBatch* batch, JsonWriter* writer) {
+    json_writer_begin_object(writer);
+    json_writer_key(writer, "items");
+    json_writer_begin_array(writer);
+    for(uint32_t i = 0; i < batch->count; i++) {
+        const DataItem* item = &batch->items[i];
+        json_writer_begin_object(writer);
+        json_writer_add_uint(writer, "type", item->type);
+        json_writer_add_uint(writer, "id", item->id);
+        json_writer_add_uint(writer, "timestamp", item->timestamp);
+        json_writer_add_uint(writer, "priority", item->priority);
+        json_writer_add_bool(writer, "compressed", item->compressed);
+        json_writer_key(writer, "data");
+        json_writer_hex(writer, item->data, item->size);
+        json_writer_end_object(writer);
+    }
+    json_writer_end_array(writer);
+    json_writer_end_object(writer);
+}
+
+static void pipeline_write_batch_body(JsonWriter* writer, void* context) {
+    data_pipeline_write_batch_json(context, writer);
+}
+
+bool data_pipeline_spill_offline(DataBatch* batch, void* context) {
+    UNUSED(context);
+    return offline_data_queue_upload("POST", PIPELINE_SPILL_URL, pipeline_write_batch_body, batch);
+}
+
 void data_pipeline_get_stats(
     DataPipeline* pipeline,
     uint32_t* processed,
@@ -310,3 +375,69 @@ void data_pipeline_get_stats(
     
     furi_mutex_release(pipeline->mutex);
 }
+
+void data_pipeline_set_filter(
+    DataPipeline* pipeline,
+    FilterType type,
+    uint32_t value
+) {
+    if(!pipeline) return;
+    
+    furi_mutex_acquire(pipeline->mutex, FuriWaitForever);
+    pipeline->filter.type = type;
+    pipeline->filter.value = value;
+    furi_mutex_release(pipeline->mutex);
+}
+
+void data_pipeline_set_custom_filter(
+    DataPipeline* pipeline,
+    bool (*filter)(const DataItem* item, void* context),
+    void* context
+) {
+    if(!pipeline) return;
+    
+    furi_mutex_acquire(pipeline->mutex, FuriWaitForever);
+    pipeline->filter.type = FilterTypeCustom;
+    pipeline->filter.custom_filter = filter;
+    pipeline->filter.context = context;
+    furi_mutex_release(pipeline->mutex);
+}
+
+void data_pipeline_set_process_callback(
+    DataPipeline* pipeline,
+    bool (*callback)(DataItem* item, void* context),
+    void* context
+) {
+    if(!pipeline) return;
+    
+    furi_mutex_acquire(pipeline->mutex, FuriWaitForever);
+    pipeline->process_callback = callback;
+    pipeline->callback_context = context;
+    furi_mutex_release(pipeline->mutex);
+}
+
+void data_pipeline_set_upload_callback(
+    DataPipeline* pipeline,
+    bool (*callback)(DataBatch* batch, void* context),
+    void* context
+) {
+    if(!pipeline) return;
+    
+    furi_mutex_acquire(pipeline->mutex, FuriWaitForever);
+    pipeline->upload_callback = callback;
+    pipeline->callback_context = context;
+    furi_mutex_release(pipeline->mutex);
+}
+
+void data_pipeline_set_spill_callback(
+    DataPipeline* pipeline,
+    bool (*callback)(DataBatch* batch, void* context),
+    void* context
+) {
+    if(!pipeline) return;
+    
+    furi_mutex_acquire(pipeline->mutex, FuriWaitForever);
+    pipeline->spill_callback = callback;
+    pipeline->spill_context = context;
+    furi_mutex_release(pipeline->mutex);
+}
@@ -3,11 +3,22 @@
 #include <furi.h>
 #include "game_state.h"
 #include "offline_data.h"
+#include "json_writer.h"
+#include "retry_policy.h"
+#include "compress_stream.h"
 
 #define PIPELINE_BUFFER_SIZE 4096
 #define MAX_BATCH_SIZE 32
 #define COMPRESSION_CHUNK 512
-#define RETRY_COUNT 3
+// Upload-Wiederholung (retry_policy.h): statt bei jedem Worker-Takt erneut
+// zu senden, wartet der Batch den Backoff ab. Nach dem letzten Versuch oder
+// bei offenem Breaker geht er an spill_callback statt verloren
+#define PIPELINE_RETRY_BASE_MS 2000
+#define PIPELINE_RETRY_MAX_MS 60000
+#define PIPELINE_RETRY_ATTEMPTS 4
+#define PIPELINE_BREAKER_THRESHOLD 3
+#define PIPELINE_BREAKER_OPEN_MS 60000
+#define PIPELINE_SPILL_URL "/api/batch"
 
 typedef enum {
     DataTypeGameState,
@@ -65,12 +76,21 @@ typedef struct {
     
     uint32_t processed_items;
     uint32_t failed_items;
-    uint32_t retry_count;
+    uint32_t retry_count;   // Fehlversuche des aktuellen Batches
+    uint32_t spilled_items; // An spill_callback abgegeben
+    uint32_t dropped_items; // Verloren: kein spill_callback oder dieser scheiterte
     uint32_t last_sync;
+    uint32_t next_attempt;  // Backoff: frühestens dann erneut hochladen
+    RetryPolicy retry;
+    // Packt Items blockweise nach output.buffer, lebt so lange wie die Pipeline
+    CompressStream* compressor;
     
     bool (*process_callback)(DataItem* item, void* context);
     bool (*upload_callback)(DataBatch* batch, void* context);
     void* callback_context;
+    // Batch, der nicht hochgeladen werden konnte, offline ablegen
+    bool (*spill_callback)(DataBatch* batch, void* context);
+    void* spill_context;
     
     FuriMutex* mutex;
     FuriThread* worker_thread;
@@ -102,6 +122,9 @@ bool data_pipeline_get_item(
 // Batch-Verarbeitung
 bool data_pipeline_process_batch(DataPipeline* pipeline);
 bool data_pipeline_upload_batch(DataPipeline* pipeline);
+// Upload-Body {"items":[...]}, Nutzdaten als Hex. Für große Batches den
+// Writer mit flush betreiben, dann reicht ein kleiner Puffer
+void data_pipeline_write_batch_json(const DataBatch* batch, JsonWriter* writer);
 
 // Filter-Management
 void data_pipeline_set_filter(
@@ -129,6 +152,16 @@ void data_pipeline_set_upload_callback(
     void* context
 );
 
+void data_pipeline_set_spill_callback(
+    DataPipeline* pipeline,
+    bool (*callback)(DataBatch* batch, void* context),
+    void* context
+);
+
+// Fertiger spill_callback: Batch als Zeile in PENDING_UPLOAD_FILE
+// (offline_data_queue_upload), context wird nicht benutzt
+bool data_pipeline_spill_offline(DataBatch* batch, void* context);
+
 // Statistik und Status
 void data_pipeline_get_stats(
     DataPipeline* pipeline,
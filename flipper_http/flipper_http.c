@@ -1,108 +1,726 @@
 #include "flipper_http.h"
+#include "http_parser.h"
+#include "wire_protocol.h"
 #include <furi_hal_uart.h>
 #include <string.h>
 #include <stdlib.h>
 
 #define HTTP_BUFFER_SIZE 2048
-#define JSON_BUFFER_SIZE 512
+#define HTTP_RX_RING_SIZE 1024  // Zweierpotenz, Antworten dürfen größer sein
+
+#define HTTP_WAKE_QUEUE_SIZE 4
+#define HTTP_TOKEN_TX 1
+#define HTTP_TOKEN_RX 2
+#define HTTP_TOKEN_STOP 3
+
+typedef enum {
+    HttpSlotFree,
+    HttpSlotQueued,  // Wartet auf den UART
+    HttpSlotSent,    // Wartet auf die Antwort
+} HttpSlotState;
+
+// Was der Worker mit der laufenden GET-Antwort im Cache macht
+typedef enum {
+    HttpCacheFillNone,
+    HttpCacheFillStore,       // 200, Body geht auch in die Arena
+    HttpCacheFillRevalidate,  // 304, Body kommt aus der Arena
+} HttpCacheFill;
+
+typedef struct {
+    HttpSlotState state;
+    FlipperHTTPRequestId id;
+    uint32_t deadline;
+    uint8_t wire_type;      // 0 = HTTP-Request, sonst Binärnachricht
+    uint16_t payload_size;  // Nutzdaten der Binärnachricht in body
+    FlipperHTTPTimings timings;
+    uint8_t attempts;       // Gesendete Versuche
+    uint32_t not_before;    // Backoff: frühestens dann (wieder) senden
+    char method[8];
+    char url[FLIPPER_HTTP_URL_SIZE];
+    char body[FLIPPER_HTTP_BODY_SIZE];
+    char etag[HTTP_CACHE_ETAG_SIZE];  // If-None-Match, "" = keiner
+    void (*callback)(FlipperHTTPResponse* response, void* context);
+    void (*body_callback)(const uint8_t* data, size_t size, size_t offset, void* context);
+    void* context;
+} HttpSlot;
+
+// Leitungsmessung: Zeitfenster der letzten Antworten und Byte-Zähler
+typedef struct {
+    uint16_t rtt[FLIPPER_HTTP_RTT_WINDOW];    // Ring, Position samples % Fenster
+    uint16_t queue[FLIPPER_HTTP_RTT_WINDOW];
+    uint32_t samples;
+    uint32_t tx_bytes;
+    uint32_t rx_bytes;
+    uint32_t second_start;  // Laufende Sekunde für die Raten
+    uint32_t second_tx;
+    uint32_t second_rx;
+    uint32_t tx_rate;       // Letzte volle Sekunde
+    uint32_t rx_rate;
+    uint32_t last_rx;       // Tick des letzten empfangenen Bytes
+    FlipperHTTPRequestId last_id;
+    FlipperHTTPTimings last;
+    uint32_t reported;      // samples beim letzten LinkStats-Rahmen
+    uint32_t report_tick;
+} HttpLinkMeter;
 
 struct FlipperHTTP {
     FuriThread* worker_thread;
-    FuriStreamBuffer* rx_stream;
-    FuriStreamBuffer* tx_stream;
-    FlipperHTTPRequest* current_request;
+    FuriMutex* mutex;             // Schützt slots, next_id, stats, link, retry und mode
+    FuriMessageQueue* wakeup;     // Neue Requests, empfangene Bytes, Stopp
+    bool rx_signaled;             // RX-Token liegt bereits in wakeup
     bool is_running;
-    bool request_pending;
+
+    HttpSlot slots[FLIPPER_HTTP_QUEUE_SIZE];
+    FlipperHTTPRequestId next_id;
+    FlipperHTTPStats stats;
+    HttpLinkMeter link;
+    RetryPolicy retry;
+    FlipperHTTPMode mode;
+    void (*undelivered)(const FlipperHTTPUndelivered* request, void* context);
+    void* undelivered_context;
+
+    // Eigener Mutex, rekursiv: Callbacks eines Treffers laufen darunter und
+    // dürfen erneut senden. Reihenfolge cache_mutex vor mutex, nie umgekehrt
+    FuriMutex* cache_mutex;
+    HttpCache cache;
+
+    // UART-Interrupt -> Worker, geparst wird direkt im Ring
+    uint8_t rx_data[HTTP_RX_RING_SIZE];
+    HttpRxRing rx_ring;
+
+    // Nur im Worker-Thread
+    char tx_buffer[HTTP_BUFFER_SIZE];
+    HttpParser parser;
+    WireDecoder decoder;
+    HttpSlot current;  // Antwort in Arbeit, aus der Warteschlange gelöst
+    HttpSlot failed;   // Endgültig gescheitert, wird gerade gemeldet
+    HttpCacheFill cache_fill;  // Zu current
+    bool receiving;
+    uint32_t rx_start;  // Erstes Byte der Antwort in Arbeit
 };
 
-typedef struct {
-    FlipperHTTP* http;
-    FlipperHTTPRequest request;
-} WorkerContext;
+static const RetryConfig http_retry_config = {
+    .base_ms = FLIPPER_HTTP_RETRY_BASE_MS,
+    .max_ms = FLIPPER_HTTP_RETRY_MAX_MS,
+    .max_attempts = FLIPPER_HTTP_RETRY_ATTEMPTS,
+    .failure_threshold = FLIPPER_HTTP_BREAKER_THRESHOLD,
+    .open_ms = FLIPPER_HTTP_BREAKER_OPEN_MS,
+};
 
-// Worker Thread
-static int32_t http_worker(void* context) {
-    WorkerContext* worker_ctx = context;
-    FlipperHTTP* http = worker_ctx->http;
-    uint8_t rx_buffer[HTTP_BUFFER_SIZE];
-    size_t rx_len;
-    
-    while(http->is_running) {
-        if(http->request_pending) {
-            // Request senden
-            const char* method = worker_ctx->request.method;
-            const char* url = worker_ctx->request.url;
-            const char* body = worker_ctx->request.body;
-            
-            // HTTP Request formatieren
-            char request_buffer[HTTP_BUFFER_SIZE];
-            snprintf(request_buffer, sizeof(request_buffer),
-                    "%s %s HTTP/1.1\r\n"
-                    "Host: localhost\r\n"
-                    "Content-Type: application/json\r\n"
-                    "Content-Length: %d\r\n"
-                    "\r\n"
-                    "%s",
-                    method, url,
-                    body ? strlen(body) : 0,
-                    body ? body : "");
-            
-            // Request über UART senden
-            furi_stream_buffer_send(
-                http->tx_stream,
-                request_buffer,
-                strlen(request_buffer),
-                FuriWaitForever);
-            
-            // Auf Antwort warten
-            rx_len = furi_stream_buffer_receive(
-                http->rx_stream,
-                rx_buffer,
-                sizeof(rx_buffer),
-                1000);
-            
-            if(rx_len > 0) {
-                // Response parsen
-                FlipperHTTPResponse response = {0};
-                char* status_line = strtok((char*)rx_buffer, "\r\n");
-                if(status_line) {
-                    char* status_code_str = strchr(status_line, ' ');
-                    if(status_code_str) {
-                        response.status_code = atoi(status_code_str + 1);
-                    }
-                }
-                
-                // Body finden
-                char* body_start = strstr((char*)rx_buffer, "\r\n\r\n");
-                if(body_start) {
-                    body_start += 4;
-                    response.body = body_start;
-                    response.body_size = rx_len - (body_start - (char*)rx_buffer);
-                }
-                
-                // Callback aufrufen
-                if(worker_ctx->request.callback) {
-                    worker_ctx->request.callback(&response, worker_ctx->request.context);
-                }
+static void http_wake(FlipperHTTP* http, uint8_t token) {
+    // Liegt schon ein Token, wacht der Worker ohnehin auf
+    furi_message_queue_put(http->wakeup, &token, 0);
+}
+
+// UART-Interrupt: Byte weiterreichen, den Worker nur einmal wecken
+static void http_uart_irq(UartIrqEvent event, uint8_t data, void* context) {
+    FlipperHTTP* http = context;
+    if(event != UartIrqEventRXNE) return;
+
+    http_rx_ring_push(&http->rx_ring, data);
+    if(!__atomic_exchange_n(&http->rx_signaled, true, __ATOMIC_ACQ_REL)) {
+        http_wake(http, HTTP_TOKEN_RX);
+    }
+}
+
+static HttpSlot* http_find_slot(FlipperHTTP* http, FlipperHTTPRequestId id) {
+    for(size_t i = 0; i < FLIPPER_HTTP_QUEUE_SIZE; i++) {
+        if(http->slots[i].state != HttpSlotFree && http->slots[i].id == id) {
+            return &http->slots[i];
+        }
+    }
+    return NULL;
+}
+
+// Binärrahmen tragen nur die unteren 16 Bit der ID
+static HttpSlot* http_find_wire_slot(FlipperHTTP* http, uint16_t id) {
+    for(size_t i = 0; i < FLIPPER_HTTP_QUEUE_SIZE; i++) {
+        HttpSlot* slot = &http->slots[i];
+        if(slot->state != HttpSlotFree && slot->wire_type && (uint16_t)slot->id == id) {
+            return slot;
+        }
+    }
+    return NULL;
+}
+
+// Raten über ganze Sekunden; nach einer Pause ohne Verkehr sind sie 0.
+// mutex muss gehalten werden
+static void http_link_second(HttpLinkMeter* link, uint32_t now) {
+    uint32_t elapsed = now - link->second_start;
+    if(elapsed < 1000) return;
+
+    link->tx_rate = elapsed < 2000 ? link->second_tx : 0;
+    link->rx_rate = elapsed < 2000 ? link->second_rx : 0;
+    link->second_tx = 0;
+    link->second_rx = 0;
+    link->second_start = now - elapsed % 1000;
+}
+
+static void http_link_count(HttpLinkMeter* link, uint32_t now, size_t tx, size_t rx) {
+    http_link_second(link, now);
+    link->tx_bytes += tx;
+    link->second_tx += tx;
+    link->rx_bytes += rx;
+    link->second_rx += rx;
+    if(rx) link->last_rx = now;
+}
+
+static uint16_t http_link_clamp(uint32_t value) {
+    return value > UINT16_MAX ? UINT16_MAX : value;
+}
+
+// Beantworteter Request ins Fenster, mutex muss gehalten werden
+static void http_link_record(HttpLinkMeter* link, FlipperHTTPRequestId id, const FlipperHTTPTimings* timings) {
+    size_t position = link->samples % FLIPPER_HTTP_RTT_WINDOW;
+    link->rtt[position] = http_link_clamp(timings->completed - timings->sent);
+    link->queue[position] = http_link_clamp(timings->sent - timings->enqueued);
+    link->samples++;
+    link->last_id = id;
+    link->last = *timings;
+}
+
+// Darf nach einem Timeout erneut gesendet werden. Die Bridge erkennt
+// Wiederholungen nicht an der ID; hat der Server einen Scan schon verbucht,
+// gäbe ein zweites POST /api/tag oder ein zweiter TagScan-Rahmen einen
+// zweiten Datensatz. Die übrigen Rahmen tragen absolute Stände
+static bool http_slot_idempotent(const HttpSlot* slot) {
+    if(slot->wire_type) return slot->wire_type != WireTypeTagScan;
+    return strcmp(slot->method, "POST") != 0 && strcmp(slot->method, "PATCH") != 0;
+}
+
+// Ausfall: Timeout, unlesbare Antwort oder Serverfehler
+static bool http_status_failed(int status_code) {
+    return status_code <= 0 || status_code >= 500;
+}
+
+// Ergebnis eines Versuchs an den Breaker melden. Bei Ausfall (0 oder ab 500)
+// einen idempotenten Request nach dem Backoff erneut einreihen, solange
+// Versuche übrig sind und der Breaker geschlossen ist. mutex muss gehalten
+// werden. true = Request bleibt in der Warteschlange
+static bool http_attempt_done(FlipperHTTP* http, HttpSlot* slot, int status_code, uint32_t now) {
+    if(!http_status_failed(status_code)) {
+        retry_policy_success_job(&http->retry, slot->id);
+        return false;
+    }
+
+    retry_policy_failure_job(&http->retry, slot->id, now);
+    if(!http_slot_idempotent(slot) || !retry_policy_can_retry(&http->retry, slot->attempts)) return false;
+
+    slot->state = HttpSlotQueued;
+    slot->not_before = now + retry_policy_backoff(&http->retry, slot->attempts);
+    http->stats.retries++;
+    return true;
+}
+
+// Endgültig gescheiterten Request nach http->failed übernehmen und den Slot
+// freigeben; danach ohne mutex http_deliver_failed. mutex muss gehalten werden
+static void http_fail_slot(FlipperHTTP* http, HttpSlot* slot) {
+    http->failed = *slot;
+    slot->state = HttpSlotFree;
+    http->stats.undelivered++;
+}
+
+// Endgültig gescheiterten Request (Kopie in http->failed) melden: erst
+// offline ablegen lassen, dann den Callback mit dem letzten Status (0 =
+// Timeout oder nie gesendet)
+static void http_deliver_failed(FlipperHTTP* http, uint32_t now, int status_code, bool circuit_open) {
+    HttpSlot* slot = &http->failed;
+    if(http->undelivered) {
+        FlipperHTTPUndelivered request = {
+            .id = slot->id,
+            .wire_type = slot->wire_type,
+            .circuit_open = circuit_open,
+        };
+        if(slot->wire_type) {
+            request.payload = slot->body;
+            request.size = slot->payload_size;
+        } else {
+            request.method = slot->method;
+            request.url = slot->url;
+            request.body = slot->body;
+        }
+        http->undelivered(&request, http->undelivered_context);
+    }
+
+    FlipperHTTPResponse response = {
+        .id = slot->id,
+        .status_code = status_code,
+        .timings = slot->timings,
+        .attempts = slot->attempts,
+        .circuit_open = circuit_open,
+    };
+    response.timings.completed = now;
+    if(slot->callback) slot->callback(&response, slot->context);
+}
+
+// Kopf einer GET-Antwort: eine cachebare 200 wird beim Empfang in die Arena
+// mitgeschrieben, ein 304 auf If-None-Match verlängert den Eintrag. Ohne
+// max-age ist ein Eintrag mit ETag sofort abgelaufen und wird jedes Mal
+// bestätigt
+static void http_cache_on_headers(FlipperHTTP* http, const HttpParser* parser, uint32_t now) {
+    const HttpSlot* current = &http->current;
+    http->cache_fill = HttpCacheFillNone;
+    if(current->wire_type || strcmp(current->method, "GET") != 0) return;
+
+    uint32_t max_age = parser->max_age > 0 ? MIN((uint32_t)parser->max_age, FLIPPER_HTTP_CACHE_MAX_AGE) : 0;
+    uint32_t expires = now + max_age * 1000;
+    furi_mutex_acquire(http->cache_mutex, FuriWaitForever);
+    if(parser->status_code == 304 && current->etag[0]) {
+        if(http_cache_refresh(&http->cache, current->url, expires)) {
+            http->cache_fill = HttpCacheFillRevalidate;
+        }
+    } else if(
+        parser->status_code == 200 && !parser->no_store && !parser->chunked &&
+        (parser->etag[0] || max_age > 0)) {
+        if(http_cache_begin(&http->cache, current->url, parser->content_length, parser->etag, expires)) {
+            http->cache_fill = HttpCacheFillStore;
+        }
+    }
+    furi_mutex_release(http->cache_mutex);
+}
+
+// Kopf da: Request aus der Warteschlange lösen, damit kein Timeout dazwischenkommt.
+// Fehlerantworten mit übrigen Versuchen bleiben eingereiht, ohne gehen sie
+// offline ab; ihr Body wird in beiden Fällen verworfen
+static void http_on_headers(HttpParser* parser, void* context) {
+    FlipperHTTP* http = context;
+    uint32_t now = furi_get_tick();
+    bool failed = false;
+    bool circuit_open = false;
+
+    furi_mutex_acquire(http->mutex, FuriWaitForever);
+    HttpSlot* slot = http_find_slot(http, parser->request_id);
+    http->receiving = slot && slot->state == HttpSlotSent;
+    if(http->receiving && http_attempt_done(http, slot, parser->status_code, now)) {
+        http->receiving = false;
+    } else if(http->receiving && http_status_failed(parser->status_code)) {
+        http->receiving = false;
+        http_fail_slot(http, slot);
+        circuit_open = http->retry.state == RetryBreakerOpen;
+        failed = true;
+    } else if(http->receiving) {
+        http->current = *slot;
+        http->current.timings.first_rx = http->rx_start;
+        slot->state = HttpSlotFree;
+    } else {
+        http->stats.unmatched++;
+    }
+    furi_mutex_release(http->mutex);
+
+    if(failed) http_deliver_failed(http, now, parser->status_code, circuit_open);
+    if(http->receiving) http_cache_on_headers(http, parser, now);
+}
+
+static void http_on_body(HttpParser* parser, const uint8_t* data, size_t size, void* context) {
+    FlipperHTTP* http = context;
+    if(http->cache_fill == HttpCacheFillStore) {
+        furi_mutex_acquire(http->cache_mutex, FuriWaitForever);
+        http_cache_append(&http->cache, data, size, parser->body_size);
+        furi_mutex_release(http->cache_mutex);
+    }
+    if(http->receiving && http->current.body_callback) {
+        http->current.body_callback(data, size, parser->body_size, http->current.context);
+    }
+}
+
+// Mitgeschriebene Antwort übernehmen oder verwerfen; bei 304 den Body aus
+// dem Cache an body_callback und die Antwort zu einer 200 machen
+static void http_cache_finish(FlipperHTTP* http, FlipperHTTPResponse* response) {
+    if(http->cache_fill == HttpCacheFillNone) return;
+
+    furi_mutex_acquire(http->cache_mutex, FuriWaitForever);
+    if(http->cache_fill == HttpCacheFillStore) {
+        if(response->status_code == 200) {
+            http_cache_commit(&http->cache);
+        } else {
+            http_cache_abort(&http->cache);
+        }
+    } else if(response->status_code == 304) {
+        // Inzwischen verdrängt: der Aufrufer bekommt den 304 ohne Body
+        const HttpCacheEntry* entry = http_cache_lookup(&http->cache, http->current.url);
+        if(entry) {
+            if(http->current.body_callback) {
+                http->current.body_callback(
+                    http_cache_body(&http->cache, entry), entry->body_size, 0, http->current.context);
             }
-            
-            http->request_pending = false;
+            response->status_code = 200;
+            response->body_size = entry->body_size;
+            response->from_cache = true;
         }
-        
-        furi_delay_ms(10);
     }
-    
-    free(worker_ctx);
+    http->cache_fill = HttpCacheFillNone;
+    furi_mutex_release(http->cache_mutex);
+}
+
+static void http_finish_current(FlipperHTTP* http, int status_code, size_t body_size) {
+    if(!http->receiving) return;
+    http->receiving = false;
+    http->current.timings.completed = furi_get_tick();
+
+    FlipperHTTPResponse response = {
+        .id = http->current.id,
+        .status_code = status_code,
+        .body_size = body_size,
+        .timings = http->current.timings,
+        .attempts = http->current.attempts,
+    };
+    http_cache_finish(http, &response);
+
+    // Unlesbare Antworten zählen nicht zur RTT
+    if(status_code) {
+        furi_mutex_acquire(http->mutex, FuriWaitForever);
+        http_link_record(&http->link, response.id, &response.timings);
+        furi_mutex_release(http->mutex);
+    }
+    if(http->current.callback) {
+        http->current.callback(&response, http->current.context);
+    }
+}
+
+static void http_on_complete(HttpParser* parser, void* context) {
+    FlipperHTTP* http = context;
+    furi_mutex_acquire(http->mutex, FuriWaitForever);
+    if(http->receiving) http->stats.completed++;
+    // Die Bridge spricht (wieder) HTTP
+    http->mode = FlipperHTTPModeHttp;
+    furi_mutex_release(http->mutex);
+    http_finish_current(http, parser->status_code, parser->body_size);
+}
+
+static const HttpParserCallbacks http_parser_callbacks = {
+    .on_headers = http_on_headers,
+    .on_body = http_on_body,
+    .on_complete = http_on_complete,
+};
+
+// Bridge bietet Binärrahmen an: mit der eigenen Version antworten, bei
+// gleicher Version umschalten. Sonst bleibt es bei HTTP, die Bridge sieht
+// die abweichende Version und fällt ebenfalls zurück
+static void http_wire_hello(FlipperHTTP* http, const WireHello* hello) {
+    WireHello reply = {
+        .version = WIRE_VERSION,
+        .max_payload = WIRE_MAX_PAYLOAD,
+    };
+
+    size_t length = wire_encode(
+        (uint8_t*)http->tx_buffer, sizeof(http->tx_buffer), WireTypeHello, 0, &reply, sizeof(reply));
+
+    furi_mutex_acquire(http->mutex, FuriWaitForever);
+    if(hello->version == WIRE_VERSION) http->mode = FlipperHTTPModeWire;
+    http_link_count(&http->link, furi_get_tick(), length, 0);
+    furi_mutex_release(http->mutex);
+
+    furi_hal_uart_tx(FLIPPER_HTTP_UART, (uint8_t*)http->tx_buffer, length);
+}
+
+// Vollständiger Binärrahmen: Antwort per ID zuordnen und wie eine
+// HTTP-Antwort mit einem einzigen Body-Stück abschließen
+static void http_on_frame(WireDecoder* decoder, const WireFrame* frame, void* context) {
+    UNUSED(decoder);
+    FlipperHTTP* http = context;
+    uint32_t now = furi_get_tick();
+    int status_code = frame->type == WireTypeAck ? frame->payload->Ack.status : 200;
+    bool failed = false;
+    bool circuit_open = false;
+
+    furi_mutex_acquire(http->mutex, FuriWaitForever);
+    http->stats.frames++;
+    HttpSlot* slot = NULL;
+    if(frame->type != WireTypeHello && frame->id) {
+        slot = http_find_wire_slot(http, frame->id);
+    }
+    http->receiving = slot && slot->state == HttpSlotSent;
+    if(http->receiving && http_attempt_done(http, slot, status_code, now)) {
+        http->receiving = false;
+    } else if(http->receiving && http_status_failed(status_code)) {
+        // Ack 502 der Bridge bei Serverfehler: wie ein Timeout offline ablegen
+        http->receiving = false;
+        http_fail_slot(http, slot);
+        circuit_open = http->retry.state == RetryBreakerOpen;
+        failed = true;
+    } else if(http->receiving) {
+        http->current = *slot;
+        http->current.timings.first_rx = http->rx_start;
+        slot->state = HttpSlotFree;
+        http->stats.completed++;
+    } else if(frame->type != WireTypeHello) {
+        http->stats.unmatched++;
+    }
+    furi_mutex_release(http->mutex);
+
+    if(failed) {
+        http_deliver_failed(http, now, status_code, circuit_open);
+    } else if(frame->type == WireTypeHello) {
+        http_wire_hello(http, &frame->payload->Hello);
+    } else if(frame->type == WireTypeAck) {
+        http_finish_current(http, status_code, 0);
+    } else if(http->receiving) {
+        if(http->current.body_callback) {
+            http->current.body_callback(
+                (const uint8_t*)frame->payload, frame->size, 0, http->current.context);
+        }
+        http_finish_current(http, 200, frame->size);
+    }
+}
+
+// Empfangene Bytes direkt im Ring verarbeiten, danach freigeben. Zwischen
+// zwei HTTP-Antworten beginnt mit dem Sync-Byte ein Binärrahmen
+static void http_receive(FlipperHTTP* http) {
+    __atomic_store_n(&http->rx_signaled, false, __ATOMIC_RELEASE);
+
+    uint32_t now = furi_get_tick();
+    size_t received = 0;
+    const uint8_t* data;
+    size_t size;
+    while((size = http_rx_ring_peek(&http->rx_ring, &data)) > 0) {
+        // Parser und Decoder halten nach jeder Antwort an, hier beginnt also
+        // höchstens eine neue
+        if(http_parser_is_idle(&http->parser) && http->decoder.state == WireDecodeSync) {
+            http->rx_start = now;
+        }
+
+        size_t consumed;
+        if(http->decoder.state != WireDecodeSync ||
+           (http_parser_is_idle(&http->parser) && data[0] == WIRE_SYNC)) {
+            uint32_t errors = http->decoder.errors;
+            consumed = wire_decoder_feed(&http->decoder, data, size);
+            if(http->decoder.errors != errors) {
+                furi_mutex_acquire(http->mutex, FuriWaitForever);
+                http->stats.frame_errors++;
+                furi_mutex_release(http->mutex);
+            }
+        } else {
+            consumed = http_parser_feed(&http->parser, data, size);
+        }
+        http_rx_ring_release(&http->rx_ring, consumed);
+        received += consumed;
+
+        if(http->parser.state == HttpParseError) {
+            // Kein Wiederaufsetzen mitten im Strom: Rest verwerfen
+            if(http->receiving) {
+                furi_mutex_acquire(http->mutex, FuriWaitForever);
+                retry_policy_failure_job(&http->retry, http->current.id, now);
+                furi_mutex_release(http->mutex);
+            }
+            http_finish_current(http, 0, 0);
+            http_rx_ring_clear(&http->rx_ring);
+            http_parser_reset(&http->parser);
+        }
+    }
+
+    if(received) {
+        furi_mutex_acquire(http->mutex, FuriWaitForever);
+        http_link_count(&http->link, now, 0, received);
+        furi_mutex_release(http->mutex);
+    }
+}
+
+// Abgelaufene Requests erneut einreihen oder mit status_code 0 beenden
+static void http_expire(FlipperHTTP* http) {
+    uint32_t now = furi_get_tick();
+
+    while(true) {
+        bool failed = false;
+        bool circuit_open = false;
+
+        furi_mutex_acquire(http->mutex, FuriWaitForever);
+        for(size_t i = 0; i < FLIPPER_HTTP_QUEUE_SIZE && !failed; i++) {
+            HttpSlot* slot = &http->slots[i];
+            if(slot->state != HttpSlotSent || (int32_t)(now - slot->deadline) < 0) continue;
+
+            http->stats.timeouts++;
+            if(http_attempt_done(http, slot, 0, now)) continue;
+            http_fail_slot(http, slot);
+            circuit_open = http->retry.state == RetryBreakerOpen;
+            failed = true;
+        }
+        furi_mutex_release(http->mutex);
+
+        if(!failed) return;
+        http_deliver_failed(http, now, 0, circuit_open);
+    }
+}
+
+// Wartende Requests in ID-Reihenfolge direkt nacheinander senden
+static void http_transmit(FlipperHTTP* http) {
+    while(true) {
+        uint32_t now = furi_get_tick();
+        furi_mutex_acquire(http->mutex, FuriWaitForever);
+        HttpSlot* next = NULL;
+        uint32_t in_flight = 0;
+        for(size_t i = 0; i < FLIPPER_HTTP_QUEUE_SIZE; i++) {
+            HttpSlot* slot = &http->slots[i];
+            if(slot->state == HttpSlotSent) in_flight++;
+            if(slot->state == HttpSlotQueued && (int32_t)(now - slot->not_before) >= 0 &&
+               (!next || (int32_t)(slot->id - next->id) < 0)) {
+                next = slot;
+            }
+        }
+
+        // Breaker offen: ohne Versuch abweisen; halb offen: auf die Probe warten
+        RetryDecision decision = next ? retry_policy_check_job(&http->retry, next->id, now) : RetryWait;
+        if(decision == RetryReject) {
+            http_fail_slot(http, next);
+            http->stats.short_circuited++;
+            furi_mutex_release(http->mutex);
+            http_deliver_failed(http, now, 0, true);
+            continue;
+        }
+        if(decision == RetryWait) next = NULL;
+
+        int length = 0;
+        if(next && next->wire_type) {
+            // Binärnachricht: Schemagröße wurde beim Einreihen geprüft
+            length = wire_encode(
+                (uint8_t*)http->tx_buffer,
+                sizeof(http->tx_buffer),
+                next->wire_type,
+                (uint16_t)next->id,
+                next->body,
+                next->payload_size);
+        } else if(next) {
+            size_t body_size = strlen(next->body);
+            length = snprintf(
+                http->tx_buffer,
+                sizeof(http->tx_buffer),
+                "%s %s HTTP/1.1\r\n"
+                "Host: localhost\r\n"
+                "X-Request-Id: %lu\r\n"
+                "Content-Type: application/json\r\n"
+                "Content-Length: %zu\r\n"
+                "%s%s%s"
+                "\r\n"
+                "%s",
+                next->method,
+                next->url,
+                next->id,
+                body_size,
+                next->etag[0] ? "If-None-Match: " : "",
+                next->etag,
+                next->etag[0] ? "\r\n" : "",
+                next->body);
+        }
+        if(next) {
+            next->state = HttpSlotSent;
+            next->attempts++;
+            next->deadline = now + FLIPPER_HTTP_TIMEOUT_MS;
+            next->timings.sent = now;
+            http_link_count(&http->link, now, length, 0);
+            http->stats.sent++;
+            http->stats.max_in_flight = MAX(http->stats.max_in_flight, in_flight + 1);
+        }
+        furi_mutex_release(http->mutex);
+
+        if(!next) return;
+        // Blockiert mit Leitungsgeschwindigkeit, Antworten laufen parallel ein
+        furi_hal_uart_tx(FLIPPER_HTTP_UART, (uint8_t*)http->tx_buffer, length);
+    }
+}
+
+// Im Binärmodus alle FLIPPER_HTTP_LINK_REPORT_MS den Leitungszustand an
+// die Bridge, sofern seitdem Antworten kamen. Die Bridge ergänzt ihre und
+// die Serverzeiten und loggt die Aufschlüsselung pro Abschnitt
+static void http_report_link(FlipperHTTP* http) {
+    uint32_t now = furi_get_tick();
+
+    furi_mutex_acquire(http->mutex, FuriWaitForever);
+    bool due = http->mode == FlipperHTTPModeWire && http->link.samples != http->link.reported &&
+               now - http->link.report_tick >= FLIPPER_HTTP_LINK_REPORT_MS;
+    if(due) {
+        http->link.reported = http->link.samples;
+        http->link.report_tick = now;
+    }
+    uint32_t timeouts = http->stats.timeouts;
+    uint32_t rejected = http->stats.rejected;
+    uint32_t retries = http->stats.retries;
+    furi_mutex_release(http->mutex);
+    if(!due) return;
+
+    FlipperHTTPLinkStats stats;
+    flipper_http_get_link_stats(http, &stats);
+    WireLinkStats report = {
+        .last_id = (uint16_t)stats.last_id,
+        .last_queue_ms = http_link_clamp(stats.last.sent - stats.last.enqueued),
+        .last_wait_ms = stats.last.first_rx ? http_link_clamp(stats.last.first_rx - stats.last.sent) : 0,
+        .last_rtt_ms = http_link_clamp(stats.last.completed - stats.last.sent),
+        .rtt_p50 = http_link_clamp(stats.rtt_p50),
+        .rtt_p90 = http_link_clamp(stats.rtt_p90),
+        .rtt_p99 = http_link_clamp(stats.rtt_p99),
+        .queue_p99 = http_link_clamp(stats.queue_p99),
+        .tx_rate = stats.tx_rate,
+        .rx_rate = stats.rx_rate,
+        .timeouts = timeouts,
+        .rejected = rejected,
+        .retries = retries,
+        .queue_depth = MIN(stats.queue_depth, UINT8_MAX),
+        .in_flight = MIN(stats.in_flight, UINT8_MAX),
+    };
+    size_t length = wire_encode(
+        (uint8_t*)http->tx_buffer, sizeof(http->tx_buffer), WireTypeLinkStats, 0, &report, sizeof(report));
+
+    furi_mutex_acquire(http->mutex, FuriWaitForever);
+    http_link_count(&http->link, now, length, 0);
+    furi_mutex_release(http->mutex);
+
+    furi_hal_uart_tx(FLIPPER_HTTP_UART, (uint8_t*)http->tx_buffer, length);
+}
+
+// Millisekunden bis zum nächsten Timeout oder Backoff-Ende, FuriWaitForever ohne Requests
+static uint32_t http_next_timeout(FlipperHTTP* http) {
+    uint32_t now = furi_get_tick();
+    uint32_t timeout = FuriWaitForever;
+
+    furi_mutex_acquire(http->mutex, FuriWaitForever);
+    // Während der Probe wartet die Warteschlange auf deren Antwort oder Timeout
+    bool probing = http->retry.state == RetryBreakerHalfOpen;
+    for(size_t i = 0; i < FLIPPER_HTTP_QUEUE_SIZE; i++) {
+        HttpSlot* slot = &http->slots[i];
+        int32_t remaining;
+        if(slot->state == HttpSlotSent) {
+            remaining = slot->deadline - now;
+        } else if(slot->state == HttpSlotQueued && !probing) {
+            remaining = slot->not_before - now;  // Backoff
+        } else {
+            continue;
+        }
+        timeout = MIN(timeout, remaining > 0 ? (uint32_t)remaining : 0);
+    }
+    furi_mutex_release(http->mutex);
+
+    return timeout;
+}
+
+// Worker Thread: schläft bis Request, Antwort oder Timeout
+static int32_t http_worker(void* context) {
+    FlipperHTTP* http = context;
+    uint8_t token;
+
+    while(true) {
+        furi_message_queue_get(http->wakeup, &token, http_next_timeout(http));
+        if(!http->is_running) break;
+
+        http_receive(http);
+        http_expire(http);
+        http_transmit(http);
+        http_report_link(http);
+    }
+
     return 0;
 }
 
 // Öffentliche Funktionen
 FlipperHTTP* flipper_http_alloc() {
     FlipperHTTP* http = malloc(sizeof(FlipperHTTP));
-    http->rx_stream = furi_stream_buffer_alloc(HTTP_BUFFER_SIZE);
-    http->tx_stream = furi_stream_buffer_alloc(HTTP_BUFFER_SIZE);
-    http->is_running = false;
-    http->request_pending = false;
+    memset(http, 0, sizeof(FlipperHTTP));
+    http->mutex = furi_mutex_alloc(FuriMutexTypeNormal);
+    http->cache_mutex = furi_mutex_alloc(FuriMutexTypeRecursive);
+    http_cache_init(&http->cache);
+    http_rx_ring_init(&http->rx_ring, http->rx_data, HTTP_RX_RING_SIZE);
+    http_parser_init(&http->parser, &http_parser_callbacks, http);
+    wire_decoder_init(&http->decoder, http_on_frame, http);
+    retry_policy_init(&http->retry, &http_retry_config);
+    http->wakeup = furi_message_queue_alloc(HTTP_WAKE_QUEUE_SIZE, sizeof(uint8_t));
+    http->next_id = 1;
     return http;
 }
 
@@ -110,8 +728,9 @@ void flipper_http_free(FlipperHTTP* http) {
     if(http->is_running) {
         flipper_http_deinit(http);
     }
-    furi_stream_buffer_free(http->rx_stream);
-    furi_stream_buffer_free(http->tx_stream);
+    furi_message_queue_free(http->wakeup);
+    furi_mutex_free(http->cache_mutex);
+    furi_mutex_free(http->mutex);
     free(http);
 }
 
@@ -120,14 +739,15 @@ bool flipper_http_init(FlipperHTTP* http) {
         return false;
     }
     
-    // Worker Thread erstellen
-    WorkerContext* worker_ctx = malloc(sizeof(WorkerContext));
-    worker_ctx->http = http;
+    furi_hal_uart_set_br(FLIPPER_HTTP_UART, FLIPPER_HTTP_BAUD_RATE);
+    furi_hal_uart_init(FLIPPER_HTTP_UART, FLIPPER_HTTP_BAUD_RATE);
+    furi_hal_uart_set_irq_cb(FLIPPER_HTTP_UART, http_uart_irq, http);
     
+    // Worker Thread erstellen
     http->worker_thread = furi_thread_alloc();
     furi_thread_set_name(http->worker_thread, "HTTPWorker");
     furi_thread_set_stack_size(http->worker_thread, 2048);
-    furi_thread_set_context(http->worker_thread, worker_ctx);
+    furi_thread_set_context(http->worker_thread, http);
     furi_thread_set_callback(http->worker_thread, http_worker);
     
     http->is_running = true;
@@ -142,56 +762,268 @@ void flipper_http_deinit(FlipperHTTP* http) {
     }
     
     http->is_running = false;
+    uint8_t token = HTTP_TOKEN_STOP;
+    furi_message_queue_put(http->wakeup, &token, FuriWaitForever);
     furi_thread_join(http->worker_thread);
     furi_thread_free(http->worker_thread);
+    
+    furi_hal_uart_set_irq_cb(FLIPPER_HTTP_UART, NULL, NULL);
+    furi_hal_uart_deinit(FLIPPER_HTTP_UART);
+    
+    // Offene Requests verfallen ohne Callback, der Cache bleibt
+    memset(http->slots, 0, sizeof(http->slots));
+    http->receiving = false;
+    furi_mutex_acquire(http->cache_mutex, FuriWaitForever);
+    http_cache_abort(&http->cache);
+    http->cache_fill = HttpCacheFillNone;
+    furi_mutex_release(http->cache_mutex);
+    http_rx_ring_clear(&http->rx_ring);
+    http_parser_reset(&http->parser);
+    wire_decoder_reset(&http->decoder);
+    http->mode = FlipperHTTPModeHttp;
+    memset(&http->link, 0, sizeof(http->link));
 }
 
-bool flipper_http_send_request(FlipperHTTP* http, FlipperHTTPRequest* request) {
-    if(!http->is_running || http->request_pending) {
-        return false;
+// Nächste ID, mutex muss gehalten werden
+static FlipperHTTPRequestId http_next_id(FlipperHTTP* http) {
+    FlipperHTTPRequestId id = http->next_id++;
+    // Untere 16 Bit 0 sind in Binärrahmen unaufgefordert, deckt auch NONE ab
+    if((uint16_t)http->next_id == 0) http->next_id++;
+    return id;
+}
+
+// Freien Platz belegen und eine ID vergeben, mutex muss gehalten werden
+static HttpSlot* http_claim_slot(FlipperHTTP* http, bool fits) {
+    HttpSlot* slot = NULL;
+    for(size_t i = 0; fits && i < FLIPPER_HTTP_QUEUE_SIZE && !slot; i++) {
+        if(http->slots[i].state == HttpSlotFree) slot = &http->slots[i];
+    }
+    if(!slot) {
+        http->stats.rejected++;
+        return NULL;
     }
     
-    WorkerContext* worker_ctx = furi_thread_get_context(http->worker_thread);
-    memcpy(&worker_ctx->request, request, sizeof(FlipperHTTPRequest));
-    http->request_pending = true;
+    memset(slot, 0, sizeof(HttpSlot));
+    slot->state = HttpSlotQueued;
+    slot->timings.enqueued = furi_get_tick();
+    slot->not_before = slot->timings.enqueued;
+    slot->id = http_next_id(http);
+    http->stats.queued++;
+    return slot;
+}
+
+// GET mit frischem Eintrag sofort beantworten. Sonst NONE und bei einem
+// abgelaufenen Eintrag dessen ETag für If-None-Match
+static FlipperHTTPRequestId http_cache_answer(FlipperHTTP* http, const FlipperHTTPRequest* request, char* etag) {
+    uint32_t now = furi_get_tick();
+
+    furi_mutex_acquire(http->cache_mutex, FuriWaitForever);
+    const HttpCacheEntry* entry = http_cache_lookup(&http->cache, request->url);
+    if(!entry || !http_cache_is_fresh(entry, now)) {
+        if(entry) strcpy(etag, entry->etag);
+        http->cache.stats.misses++;
+        furi_mutex_release(http->cache_mutex);
+        return FLIPPER_HTTP_REQUEST_NONE;
+    }
+    http->cache.stats.hits++;
+
+    furi_mutex_acquire(http->mutex, FuriWaitForever);
+    FlipperHTTPRequestId id = http_next_id(http);
+    furi_mutex_release(http->mutex);
+
+    FlipperHTTPResponse response = {
+        .id = id,
+        .status_code = 200,
+        .body_size = entry->body_size,
+        .timings = {.enqueued = now, .sent = now, .completed = now},
+        .from_cache = true,
+    };
+    // Unter cache_mutex, der Body zeigt in die Arena
+    if(request->body_callback) {
+        request->body_callback(http_cache_body(&http->cache, entry), entry->body_size, 0, request->context);
+    }
+    if(request->callback) request->callback(&response, request->context);
+    furi_mutex_release(http->cache_mutex);
+    return id;
+}
+
+FlipperHTTPRequestId flipper_http_send_request(FlipperHTTP* http, const FlipperHTTPRequest* request) {
+    if(!http->is_running) {
+        return FLIPPER_HTTP_REQUEST_NONE;
+    }
     
-    return true;
+    char etag[HTTP_CACHE_ETAG_SIZE] = "";
+    if(strcmp(request->method, "GET") == 0) {
+        FlipperHTTPRequestId id = http_cache_answer(http, request, etag);
+        if(id != FLIPPER_HTTP_REQUEST_NONE) return id;
+    } else {
+        flipper_http_cache_invalidate(http, request->url);
+    }
+    
+    const char* body = request->body ? request->body : "";
+    bool fits = strlen(request->method) < sizeof(((HttpSlot*)0)->method) &&
+                strlen(request->url) < FLIPPER_HTTP_URL_SIZE &&
+                strlen(body) < FLIPPER_HTTP_BODY_SIZE;
+    
+    furi_mutex_acquire(http->mutex, FuriWaitForever);
+    HttpSlot* slot = http_claim_slot(http, fits);
+    FlipperHTTPRequestId id = FLIPPER_HTTP_REQUEST_NONE;
+    if(slot) {
+        id = slot->id;
+        strcpy(slot->method, request->method);
+        strcpy(slot->url, request->url);
+        strcpy(slot->body, body);
+        strcpy(slot->etag, etag);
+        slot->callback = request->callback;
+        slot->body_callback = request->body_callback;
+        slot->context = request->context;
+    }
+    furi_mutex_release(http->mutex);
+    
+    if(slot) {
+        http_wake(http, HTTP_TOKEN_TX);
+    }
+    return id;
 }
 
-void flipper_http_cancel_request(FlipperHTTP* http) {
-    http->request_pending = false;
+FlipperHTTPRequestId flipper_http_send_message(FlipperHTTP* http, const FlipperHTTPMessage* message) {
+    if(!http->is_running) {
+        return FLIPPER_HTTP_REQUEST_NONE;
+    }
+    
+    bool fits = message->size > 0 && message->size <= FLIPPER_HTTP_BODY_SIZE &&
+                wire_payload_size(message->type) == message->size;
+    
+    furi_mutex_acquire(http->mutex, FuriWaitForever);
+    HttpSlot* slot = http_claim_slot(http, fits);
+    FlipperHTTPRequestId id = FLIPPER_HTTP_REQUEST_NONE;
+    if(slot) {
+        id = slot->id;
+        slot->wire_type = message->type;
+        slot->payload_size = message->size;
+        memcpy(slot->body, message->payload, message->size);
+        slot->callback = message->callback;
+        slot->body_callback = message->body_callback;
+        slot->context = message->context;
+    }
+    furi_mutex_release(http->mutex);
+    
+    if(slot) {
+        http_wake(http, HTTP_TOKEN_TX);
+    }
+    return id;
 }
 
-// JSON Hilfsfunktionen
-char* flipper_http_json_create_object() {
-    char* json = malloc(JSON_BUFFER_SIZE);
-    strcpy(json, "{");
-    return json;
+FlipperHTTPMode flipper_http_get_mode(FlipperHTTP* http) {
+    furi_mutex_acquire(http->mutex, FuriWaitForever);
+    FlipperHTTPMode mode = http->mode;
+    furi_mutex_release(http->mutex);
+    return mode;
 }
 
-void flipper_http_json_add_string(char* json, const char* key, const char* value) {
-    char buffer[JSON_BUFFER_SIZE];
-    snprintf(buffer, sizeof(buffer), "\"%s\":\"%s\",", key, value);
-    strcat(json, buffer);
+size_t flipper_http_get_queue_free(FlipperHTTP* http) {
+    size_t count = 0;
+    furi_mutex_acquire(http->mutex, FuriWaitForever);
+    for(size_t i = 0; i < FLIPPER_HTTP_QUEUE_SIZE; i++) {
+        if(http->slots[i].state == HttpSlotFree) count++;
+    }
+    furi_mutex_release(http->mutex);
+    return count;
 }
 
-void flipper_http_json_add_int(char* json, const char* key, int value) {
-    char buffer[32];
-    snprintf(buffer, sizeof(buffer), "\"%s\":%d,", key, value);
-    strcat(json, buffer);
+bool flipper_http_cancel_request(FlipperHTTP* http, FlipperHTTPRequestId id) {
+    furi_mutex_acquire(http->mutex, FuriWaitForever);
+    HttpSlot* slot = http_find_slot(http, id);
+    if(slot) {
+        // Abgebrochene Probe: Breaker wieder öffnen statt ewig auf sie zu warten
+        retry_policy_abandon(&http->retry, id, furi_get_tick());
+        slot->state = HttpSlotFree;
+    }
+    furi_mutex_release(http->mutex);
+    return slot != NULL;
 }
 
-void flipper_http_json_add_bool(char* json, const char* key, bool value) {
-    char buffer[32];
-    snprintf(buffer, sizeof(buffer), "\"%s\":%s,", key, value ? "true" : "false");
-    strcat(json, buffer);
+void flipper_http_get_stats(FlipperHTTP* http, FlipperHTTPStats* stats) {
+    furi_mutex_acquire(http->cache_mutex, FuriWaitForever);
+    HttpCacheStats cache = http->cache.stats;
+    furi_mutex_release(http->cache_mutex);
+
+    furi_mutex_acquire(http->mutex, FuriWaitForever);
+    *stats = http->stats;
+    stats->breaker_opened = http->retry.stats.opened;
+    furi_mutex_release(http->mutex);
+    stats->cache_hits = cache.hits;
+    stats->cache_misses = cache.misses;
+    stats->cache_revalidated = cache.revalidated;
+    stats->cache_stored = cache.stored;
+    stats->cache_evicted = cache.evicted;
 }
 
-void flipper_http_json_close_object(char* json) {
-    size_t len = strlen(json);
-    if(json[len-1] == ',') {
-        json[len-1] = '}';
-    } else {
-        strcat(json, "}");
+void flipper_http_cache_invalidate(FlipperHTTP* http, const char* url) {
+    furi_mutex_acquire(http->cache_mutex, FuriWaitForever);
+    http_cache_invalidate(&http->cache, url);
+    furi_mutex_release(http->cache_mutex);
+}
+
+void flipper_http_set_undelivered_callback(
+    FlipperHTTP* http,
+    void (*callback)(const FlipperHTTPUndelivered* request, void* context),
+    void* context) {
+    furi_mutex_acquire(http->mutex, FuriWaitForever);
+    http->undelivered = callback;
+    http->undelivered_context = context;
+    furi_mutex_release(http->mutex);
+}
+
+// Perzentil einer aufsteigend sortierten Liste
+static uint32_t http_link_percentile(const uint16_t* sorted, size_t count, uint32_t percent) {
+    return sorted[(count - 1) * percent / 100];
+}
+
+static void http_link_sort(uint16_t* values, size_t count) {
+    for(size_t i = 1; i < count; i++) {
+        uint16_t value = values[i];
+        size_t j = i;
+        for(; j > 0 && values[j - 1] > value; j--) values[j] = values[j - 1];
+        values[j] = value;
+    }
+}
+
+void flipper_http_get_link_stats(FlipperHTTP* http, FlipperHTTPLinkStats* stats) {
+    uint16_t rtt[FLIPPER_HTTP_RTT_WINDOW];
+    uint16_t queue[FLIPPER_HTTP_RTT_WINDOW];
+    uint32_t now = furi_get_tick();
+    memset(stats, 0, sizeof(FlipperHTTPLinkStats));
+
+    // Unter dem Mutex nur kopieren, sortiert wird danach
+    furi_mutex_acquire(http->mutex, FuriWaitForever);
+    HttpLinkMeter* link = &http->link;
+    http_link_second(link, now);
+    size_t count = MIN(link->samples, FLIPPER_HTTP_RTT_WINDOW);
+    memcpy(rtt, link->rtt, count * sizeof(uint16_t));
+    memcpy(queue, link->queue, count * sizeof(uint16_t));
+    stats->samples = link->samples;
+    stats->tx_rate = link->tx_rate;
+    stats->rx_rate = link->rx_rate;
+    stats->tx_bytes = link->tx_bytes;
+    stats->rx_bytes = link->rx_bytes;
+    stats->idle_ms = link->rx_bytes ? now - link->last_rx : 0;
+    stats->last_id = link->last_id;
+    stats->last = link->last;
+    stats->breaker = http->retry.state;
+    for(size_t i = 0; i < FLIPPER_HTTP_QUEUE_SIZE; i++) {
+        if(http->slots[i].state == HttpSlotQueued) stats->queue_depth++;
+        if(http->slots[i].state == HttpSlotSent) stats->in_flight++;
     }
+    furi_mutex_release(http->mutex);
+
+    if(count == 0) return;
+    http_link_sort(rtt, count);
+    http_link_sort(queue, count);
+    stats->rtt_p50 = http_link_percentile(rtt, count, 50);
+    stats->rtt_p90 = http_link_percentile(rtt, count, 90);
+    stats->rtt_p99 = http_link_percentile(rtt, count, 99);
+    stats->rtt_max = rtt[count - 1];
+    stats->queue_p50 = http_link_percentile(queue, count, 50);
+    stats->queue_p99 = http_link_percentile(queue, count, 99);
 }
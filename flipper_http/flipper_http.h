@@ -2,6 +2,8 @@
 
 #include <furi.h>
 #include <furi_hal.h>
+#include "retry_policy.h"
+#include "http_cache.h"
 
 // HTTP Methoden
 typedef enum {
@@ -11,22 +13,138 @@ typedef enum {
     HTTP_DELETE
 } HTTPMethod;
 
-// HTTP Response
+// Warteschlange: wartende und gesendete Requests zusammen. Alle wartenden
+// Requests gehen direkt nacheinander über den UART, Antworten werden über
+// X-Request-Id zugeordnet und dürfen in beliebiger Reihenfolge kommen.
+#define FLIPPER_HTTP_QUEUE_SIZE 16
+#define FLIPPER_HTTP_URL_SIZE 96
+#define FLIPPER_HTTP_BODY_SIZE 256
+#define FLIPPER_HTTP_TIMEOUT_MS 5000  // Ab dem Senden
+#define FLIPPER_HTTP_UART FuriHalUartIdLPUART1
+#define FLIPPER_HTTP_BAUD_RATE 115200
+#define FLIPPER_HTTP_RTT_WINDOW 64            // Letzte Antworten für die Perzentile
+#define FLIPPER_HTTP_LINK_REPORT_MS 10000     // LinkStats-Rahmen an die Bridge
+#define FLIPPER_HTTP_CACHE_MAX_AGE 3600       // Obergrenze für max-age in s
+
+// Wiederholung bei Timeout, unlesbarer Antwort oder Status ab 500 mit
+// derselben ID, nur für idempotente Requests (nicht POST/PATCH, kein
+// TagScan-Rahmen); der Breaker gilt für die ganze Leitung (retry_policy.h)
+#define FLIPPER_HTTP_RETRY_BASE_MS 500
+#define FLIPPER_HTTP_RETRY_MAX_MS 8000
+#define FLIPPER_HTTP_RETRY_ATTEMPTS 3
+#define FLIPPER_HTTP_BREAKER_THRESHOLD 5
+#define FLIPPER_HTTP_BREAKER_OPEN_MS 15000
+
+typedef uint32_t FlipperHTTPRequestId;
+#define FLIPPER_HTTP_REQUEST_NONE 0
+
+// Zeitpunkte eines Requests in Ticks (ms)
 typedef struct {
-    int status_code;
-    char* body;
+    uint32_t enqueued;   // Angenommen
+    uint32_t sent;       // Erstes Byte auf dem UART
+    uint32_t first_rx;   // Erstes Byte der Antwort, 0 = keine Antwort
+    uint32_t completed;  // Antwort vollständig oder Timeout
+} FlipperHTTPTimings;
+
+// HTTP Response, der Body kam vorher in Stücken an body_callback
+typedef struct {
+    FlipperHTTPRequestId id;
+    int status_code;  // 0 = Timeout oder unlesbare Antwort
     size_t body_size;
+    FlipperHTTPTimings timings;  // Des letzten Versuchs
+    uint8_t attempts;            // 0 = nie gesendet
+    bool circuit_open;           // Abgewiesen oder aufgegeben, weil der Breaker offen ist
+    bool from_cache;             // Body aus dem Antwort-Cache: Treffer ohne Leitung oder 304
 } FlipperHTTPResponse;
 
-// HTTP Request
+// HTTP Request, method, url und body werden beim Einreihen kopiert
 typedef struct {
     const char* method;
     const char* url;
     const char* body;
     void (*callback)(FlipperHTTPResponse* response, void* context);
+    // Optional: Body-Ausschnitte ohne Kopie, direkt aus dem Empfangsring.
+    // offset = Position im Body, 0 beginnt eine neue Antwort
+    void (*body_callback)(const uint8_t* data, size_t size, size_t offset, void* context);
     void* context;
 } FlipperHTTPRequest;
 
+// Binärnachricht nach wire_schema.def, payload wird beim Einreihen kopiert.
+// Die Nutzdaten der Antwort kommen in einem Stück an body_callback,
+// status_code ist 200 oder der Status eines Ack-Rahmens
+typedef struct {
+    uint8_t type;  // WireType
+    const void* payload;
+    size_t size;   // Muss der Schemagröße des Typs entsprechen
+    void (*callback)(FlipperHTTPResponse* response, void* context);
+    void (*body_callback)(const uint8_t* data, size_t size, size_t offset, void* context);
+    void* context;
+} FlipperHTTPMessage;
+
+// Request, der endgültig nicht zugestellt wurde, vor dessen Callback. HTTP:
+// method, url, body; Binärnachricht: wire_type, payload, size
+typedef struct {
+    FlipperHTTPRequestId id;
+    const char* method;
+    const char* url;
+    const char* body;
+    uint8_t wire_type;  // 0 = HTTP
+    const void* payload;
+    size_t size;
+    bool circuit_open;
+} FlipperHTTPUndelivered;
+
+// Leitungsformat zur Bridge. Ein Hello-Rahmen der Bridge schaltet auf
+// Binärrahmen um (wire_protocol.h), jede HTTP-Antwort wieder zurück
+typedef enum {
+    FlipperHTTPModeHttp,
+    FlipperHTTPModeWire,
+} FlipperHTTPMode;
+
+typedef struct {
+    uint32_t queued;         // Angenommene Requests
+    uint32_t rejected;       // Warteschlange voll oder Request zu groß
+    uint32_t sent;
+    uint32_t completed;      // Antwort zugeordnet
+    uint32_t timeouts;
+    uint32_t unmatched;      // Antwort ohne wartenden Request
+    uint32_t max_in_flight;  // Höchstens gleichzeitig gesendete Requests
+    uint32_t frames;         // Empfangene Binärrahmen
+    uint32_t frame_errors;   // Unbekannter Typ, falsche Länge oder CRC
+    uint32_t retries;        // Erneut eingereihte Versuche
+    uint32_t undelivered;    // Endgültig gescheitert, davon short_circuited
+    uint32_t short_circuited;  // Ohne Versuch abgewiesen, Breaker offen
+    uint32_t breaker_opened;
+    uint32_t cache_hits;         // GET ohne Leitung beantwortet
+    uint32_t cache_misses;
+    uint32_t cache_revalidated;  // 304 auf If-None-Match
+    uint32_t cache_stored;
+    uint32_t cache_evicted;
+} FlipperHTTPStats;
+
+// Zustand der Leitung zur Bridge. Zeiten in ms über die letzten
+// FLIPPER_HTTP_RTT_WINDOW Antworten, RTT = erstes Byte raus bis Antwort
+// vollständig, Warteschlange = angenommen bis erstes Byte raus
+typedef struct {
+    uint32_t samples;
+    uint32_t rtt_p50;
+    uint32_t rtt_p90;
+    uint32_t rtt_p99;
+    uint32_t rtt_max;
+    uint32_t queue_p50;
+    uint32_t queue_p99;
+    uint32_t tx_rate;      // Bytes/s in der letzten vollen Sekunde
+    uint32_t rx_rate;
+    uint32_t tx_bytes;     // Gesamt
+    uint32_t rx_bytes;
+    uint32_t queue_depth;  // Wartet auf den UART
+    uint32_t in_flight;    // Gesendet, ohne Antwort
+    uint32_t idle_ms;      // Seit dem letzten empfangenen Byte
+    FlipperHTTPRequestId last_id;  // Letzte beantwortete Anfrage
+    FlipperHTTPTimings last;
+    RetryBreakerState breaker;
+} FlipperHTTPLinkStats;
+
 // HTTP Client
 typedef struct FlipperHTTP FlipperHTTP;
 
@@ -35,12 +153,32 @@ FlipperHTTP* flipper_http_alloc();
 void flipper_http_free(FlipperHTTP* http);
 bool flipper_http_init(FlipperHTTP* http);
 void flipper_http_deinit(FlipperHTTP* http);
-bool flipper_http_send_request(FlipperHTTP* http, FlipperHTTPRequest* request);
-void flipper_http_cancel_request(FlipperHTTP* http);
-
-// Hilfsfunktionen für JSON
-char* flipper_http_json_create_object();
-void flipper_http_json_add_string(char* json, const char* key, const char* value);
-void flipper_http_json_add_int(char* json, const char* key, int value);
-void flipper_http_json_add_bool(char* json, const char* key, bool value);
-void flipper_http_json_close_object(char* json);
+// Reiht den Request ein. FLIPPER_HTTP_REQUEST_NONE = nicht angenommen
+// (Warteschlange voll oder Client gestoppt); der Aufrufer entscheidet,
+// ob er später erneut sendet. Der Callback läuft im Worker-Thread.
+// GET geht über den Antwort-Cache (http_cache.h): ein frischer Eintrag wird
+// sofort beantwortet, beide Callbacks laufen dann im Thread des Aufrufers,
+// bevor die Funktion zurückkehrt. Gecacht werden 200-Antworten mit ETag
+// oder Cache-Control: max-age und Content-Length. Andere Methoden
+// entfernen den Eintrag ihrer URL
+FlipperHTTPRequestId flipper_http_send_request(FlipperHTTP* http, const FlipperHTTPRequest* request);
+// Wie flipper_http_send_request, nur im Modus FlipperHTTPModeWire sinnvoll
+FlipperHTTPRequestId flipper_http_send_message(FlipperHTTP* http, const FlipperHTTPMessage* message);
+FlipperHTTPMode flipper_http_get_mode(FlipperHTTP* http);
+// Freie Plätze in der Warteschlange
+size_t flipper_http_get_queue_free(FlipperHTTP* http);
+// Request verwerfen, der Callback wird nicht mehr aufgerufen
+bool flipper_http_cancel_request(FlipperHTTP* http, FlipperHTTPRequestId id);
+void flipper_http_get_stats(FlipperHTTP* http, FlipperHTTPStats* stats);
+// Gecachte Antwort der URL verwerfen, NULL = alle
+void flipper_http_cache_invalidate(FlipperHTTP* http, const char* url);
+void flipper_http_get_link_stats(FlipperHTTP* http, FlipperHTTPLinkStats* stats);
+// Optional: nicht zugestellte Requests offline ablegen (offline_data_queue_upload).
+// Nicht zugestellt = Timeout, abgewiesen oder Serverfehler (ab 500, auch Ack 502)
+// ohne weiteren Versuch. Läuft im Worker-Thread, die Zeiger gelten nur während des Aufrufs
+void flipper_http_set_undelivered_callback(
+    FlipperHTTP* http,
+    void (*callback)(const FlipperHTTPUndelivered* request, void* context),
+    void* context);
+
+// Request-Bodies ohne Heap: json_writer.h
@@ -100,7 +100,7 @@ GameOptimizer* game_optimizer_alloc(
     optimizer->cache_misses = 0;
     optimizer->avg_prediction_error = 0;
     
-    optimizer->mutex = furi_mutex_alloc(FuriMutexTypeNormal);
+    optimizer->mutex = furi_mutex_alloc(FuriMutexTypeRecursive);
     
     // Optimizer-Thread starten
     optimizer->running = true;
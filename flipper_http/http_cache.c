@@ -0,0 +1,149 @@
+#include "http_cache.h"
+
+void http_cache_init(HttpCache* cache) {
+    memset(cache, 0, sizeof(HttpCache));
+}
+
+static uint32_t http_cache_hash(const char* url) {
+    uint32_t hash = 2166136261u;
+    for(; *url; url++) {
+        hash = (hash ^ (uint8_t)*url) * 16777619u;
+    }
+    return hash;
+}
+
+static HttpCacheEntry* http_cache_find(HttpCache* cache, const char* url) {
+    uint32_t hash = http_cache_hash(url);
+    size_t url_len = strlen(url);
+    for(size_t i = 0; i < cache->count; i++) {
+        HttpCacheEntry* entry = &cache->entries[i];
+        if(entry->hash == hash && entry->url_len == url_len &&
+           memcmp(cache->arena + entry->offset, url, url_len) == 0) {
+            return entry;
+        }
+    }
+    return NULL;
+}
+
+// Eintrag entfernen und alles dahinter nachrücken lassen, auch eine
+// Antwort in Arbeit
+static void http_cache_remove(HttpCache* cache, HttpCacheEntry* entry) {
+    size_t size = entry->url_len + entry->body_size;
+    size_t end = cache->used;
+    if(cache->filling) end += cache->fill.url_len + cache->written;
+    memmove(
+        cache->arena + entry->offset,
+        cache->arena + entry->offset + size,
+        end - entry->offset - size);
+
+    size_t index = entry - cache->entries;
+    memmove(entry, entry + 1, (cache->count - index - 1) * sizeof(HttpCacheEntry));
+    cache->count--;
+    for(size_t i = index; i < cache->count; i++) {
+        cache->entries[i].offset -= size;
+    }
+    cache->used -= size;
+    cache->fill.offset -= cache->filling ? size : 0;
+}
+
+static HttpCacheEntry* http_cache_oldest(HttpCache* cache) {
+    HttpCacheEntry* oldest = &cache->entries[0];
+    for(size_t i = 1; i < cache->count; i++) {
+        if((int32_t)(cache->entries[i].used - oldest->used) < 0) oldest = &cache->entries[i];
+    }
+    return oldest;
+}
+
+const HttpCacheEntry* http_cache_lookup(HttpCache* cache, const char* url) {
+    HttpCacheEntry* entry = http_cache_find(cache, url);
+    if(entry) entry->used = ++cache->clock;
+    return entry;
+}
+
+bool http_cache_is_fresh(const HttpCacheEntry* entry, uint32_t now) {
+    return (int32_t)(entry->expires - now) > 0;
+}
+
+const uint8_t* http_cache_body(const HttpCache* cache, const HttpCacheEntry* entry) {
+    return cache->arena + entry->offset + entry->url_len;
+}
+
+bool http_cache_begin(HttpCache* cache, const char* url, size_t body_size, const char* etag, uint32_t expires) {
+    http_cache_abort(cache);
+    size_t url_len = strlen(url);
+    size_t size = url_len + body_size;
+    if(size > HTTP_CACHE_ARENA_SIZE) {
+        cache->stats.too_large++;
+        return false;
+    }
+
+    HttpCacheEntry* old = http_cache_find(cache, url);
+    if(old) http_cache_remove(cache, old);
+    // Ist used > 0, gibt es auch einen Eintrag zum Verdrängen
+    while(cache->count == HTTP_CACHE_ENTRIES || cache->used + size > HTTP_CACHE_ARENA_SIZE) {
+        http_cache_remove(cache, http_cache_oldest(cache));
+        cache->stats.evicted++;
+    }
+
+    HttpCacheEntry* fill = &cache->fill;
+    memset(fill, 0, sizeof(HttpCacheEntry));
+    fill->hash = http_cache_hash(url);
+    fill->offset = cache->used;
+    fill->url_len = url_len;
+    fill->body_size = body_size;
+    fill->expires = expires;
+    snprintf(fill->etag, sizeof(fill->etag), "%s", etag);
+    memcpy(cache->arena + fill->offset, url, url_len);
+    cache->written = 0;
+    cache->filling = true;
+    return true;
+}
+
+void http_cache_append(HttpCache* cache, const uint8_t* data, size_t size, size_t offset) {
+    if(!cache->filling) return;
+    // Nur lückenlos und nicht über die angekündigte Länge hinaus
+    if(offset != cache->written || offset + size > cache->fill.body_size) {
+        http_cache_abort(cache);
+        return;
+    }
+    memcpy(cache->arena + cache->fill.offset + cache->fill.url_len + offset, data, size);
+    cache->written += size;
+}
+
+void http_cache_commit(HttpCache* cache) {
+    if(!cache->filling) return;
+    cache->filling = false;
+    if(cache->written != cache->fill.body_size) return;
+
+    cache->fill.used = ++cache->clock;
+    cache->entries[cache->count++] = cache->fill;
+    cache->used += cache->fill.url_len + cache->fill.body_size;
+    cache->stats.stored++;
+}
+
+void http_cache_abort(HttpCache* cache) {
+    cache->filling = false;
+}
+
+const HttpCacheEntry* http_cache_refresh(HttpCache* cache, const char* url, uint32_t expires) {
+    HttpCacheEntry* entry = http_cache_find(cache, url);
+    if(entry) {
+        entry->expires = expires;
+        entry->used = ++cache->clock;
+        cache->stats.revalidated++;
+    }
+    return entry;
+}
+
+void http_cache_invalidate(HttpCache* cache, const char* url) {
+    if(!url) {
+        cache->count = 0;
+        cache->used = 0;
+        cache->filling = false;
+        return;
+    }
+    HttpCacheEntry* entry = http_cache_find(cache, url);
+    if(entry) http_cache_remove(cache, entry);
+    // Eine Antwort in Arbeit zur selben URL wäre schon wieder veraltet
+    if(cache->filling && cache->fill.hash == http_cache_hash(url)) http_cache_abort(cache);
+}
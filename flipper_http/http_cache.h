@@ -0,0 +1,72 @@
+#pragma once
+
+#include <furi.h>
+#include "http_parser.h"
+
+// Antwort-Cache für idempotente GETs (Bestenliste, Tag-Register, Regeln),
+// Schlüssel ist die URL. Alles liegt in einer festen Arena ohne Heap: pro
+// Eintrag die URL und direkt dahinter der Body, lückenlos in
+// Einfügereihenfolge. Fehlt Platz oder ein freier Eintrag, wird der am
+// längsten nicht benutzte verdrängt und der Rest zusammengeschoben.
+//
+//   Frisch (vor expires)   Antwort aus der Arena, ohne Leitung
+//   Abgelaufen mit ETag    Request mit If-None-Match, 304 verlängert
+//   Abgelaufen ohne ETag   Normaler Request, die Antwort ersetzt den Eintrag
+//
+// Eine Antwort wird beim Empfang direkt in die Arena geschrieben und erst
+// mit http_cache_commit sichtbar. Nicht threadsicher, der Aufrufer schützt
+// die Struktur mit seinem Mutex.
+
+#define HTTP_CACHE_ARENA_SIZE 4096
+#define HTTP_CACHE_ENTRIES 8
+#define HTTP_CACHE_ETAG_SIZE HTTP_PARSER_ETAG_SIZE
+
+typedef struct {
+    uint32_t hash;       // FNV-1a der URL
+    uint16_t offset;     // In der Arena: URL ohne '\0', danach der Body
+    uint16_t url_len;
+    uint16_t body_size;
+    uint32_t expires;    // Tick, ab dem der Eintrag abgelaufen ist
+    uint32_t used;       // LRU-Zähler des letzten Zugriffs
+    char etag[HTTP_CACHE_ETAG_SIZE];  // "" = keiner
+} HttpCacheEntry;
+
+typedef struct {
+    uint32_t hits;         // Frisch beantwortet
+    uint32_t misses;       // Kein oder abgelaufener Eintrag
+    uint32_t revalidated;  // 304, Body aus dem Cache
+    uint32_t stored;
+    uint32_t evicted;      // Für Platz verdrängt
+    uint32_t too_large;    // Passt nicht in die Arena
+} HttpCacheStats;
+
+typedef struct {
+    HttpCacheEntry entries[HTTP_CACHE_ENTRIES];  // Nach offset sortiert
+    uint8_t count;
+    uint16_t used;        // Belegte Bytes ab Arena-Anfang
+    uint32_t clock;       // LRU
+    // Antwort in Arbeit, liegt ab used und gehört noch keinem Eintrag
+    bool filling;
+    HttpCacheEntry fill;
+    uint16_t written;
+    HttpCacheStats stats;
+    uint8_t arena[HTTP_CACHE_ARENA_SIZE];
+} HttpCache;
+
+void http_cache_init(HttpCache* cache);
+// Eintrag zur URL, zählt als Zugriff für LRU. NULL = nicht im Cache
+const HttpCacheEntry* http_cache_lookup(HttpCache* cache, const char* url);
+bool http_cache_is_fresh(const HttpCacheEntry* entry, uint32_t now);
+const uint8_t* http_cache_body(const HttpCache* cache, const HttpCacheEntry* entry);
+// Neue Antwort zur URL annehmen; ein alter Eintrag der URL fällt weg.
+// false = passt nicht, dann bleibt alles unverändert
+bool http_cache_begin(HttpCache* cache, const char* url, size_t body_size, const char* etag, uint32_t expires);
+// Body-Ausschnitt ab offset, wie FlipperHTTPRequest.body_callback
+void http_cache_append(HttpCache* cache, const uint8_t* data, size_t size, size_t offset);
+// Sichtbar machen, wenn der Body vollständig ist; sonst verwerfen
+void http_cache_commit(HttpCache* cache);
+void http_cache_abort(HttpCache* cache);
+// 304: Eintrag bis expires verlängern. NULL = inzwischen verdrängt
+const HttpCacheEntry* http_cache_refresh(HttpCache* cache, const char* url, uint32_t expires);
+// Eintrag der URL entfernen, NULL = alle
+void http_cache_invalidate(HttpCache* cache, const char* url);
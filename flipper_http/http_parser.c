@@ -0,0 +1,228 @@
+#include "http_parser.h"
+#include <strings.h>
+
+void http_rx_ring_init(HttpRxRing* ring, uint8_t* buffer, size_t size) {
+    furi_assert((size & (size - 1)) == 0);
+    memset(ring, 0, sizeof(HttpRxRing));
+    ring->data = buffer;
+    ring->mask = size - 1;
+}
+
+bool http_rx_ring_push(HttpRxRing* ring, uint8_t byte) {
+    uint32_t head = ring->head;
+    uint32_t tail = __atomic_load_n(&ring->tail, __ATOMIC_ACQUIRE);
+    if(head - tail > ring->mask) {
+        ring->dropped++;
+        return false;
+    }
+    ring->data[head & ring->mask] = byte;
+    __atomic_store_n(&ring->head, head + 1, __ATOMIC_RELEASE);
+    return true;
+}
+
+size_t http_rx_ring_write(HttpRxRing* ring, const uint8_t* data, size_t size) {
+    size_t written = 0;
+    while(written < size && http_rx_ring_push(ring, data[written])) {
+        written++;
+    }
+    return written;
+}
+
+size_t http_rx_ring_peek(HttpRxRing* ring, const uint8_t** data) {
+    uint32_t head = __atomic_load_n(&ring->head, __ATOMIC_ACQUIRE);
+    uint32_t tail = ring->tail;
+    uint32_t offset = tail & ring->mask;
+    *data = ring->data + offset;
+    return MIN(head - tail, ring->mask + 1 - offset);
+}
+
+void http_rx_ring_release(HttpRxRing* ring, size_t size) {
+    __atomic_store_n(&ring->tail, ring->tail + size, __ATOMIC_RELEASE);
+}
+
+void http_rx_ring_clear(HttpRxRing* ring) {
+    __atomic_store_n(&ring->tail, __atomic_load_n(&ring->head, __ATOMIC_ACQUIRE), __ATOMIC_RELEASE);
+}
+
+void http_parser_init(HttpParser* parser, const HttpParserCallbacks* callbacks, void* context) {
+    memset(parser, 0, sizeof(HttpParser));
+    parser->callbacks = callbacks;
+    parser->context = context;
+}
+
+// Neue Antwort beginnen, Statistik bleibt erhalten
+static void http_parser_begin(HttpParser* parser) {
+    parser->state = HttpParseStatusLine;
+    parser->line_len = 0;
+    parser->status_code = 0;
+    parser->request_id = 0;
+    parser->content_length = 0;
+    parser->chunked = false;
+    parser->etag[0] = '\0';
+    parser->max_age = HTTP_PARSER_NO_MAX_AGE;
+    parser->no_store = false;
+    parser->remaining = 0;
+    parser->body_size = 0;
+}
+
+void http_parser_reset(HttpParser* parser) {
+    http_parser_begin(parser);
+}
+
+static void http_parser_fail(HttpParser* parser) {
+    parser->state = HttpParseError;
+    parser->errors++;
+}
+
+static void http_parser_complete(HttpParser* parser) {
+    parser->responses++;
+    if(parser->callbacks->on_complete) {
+        parser->callbacks->on_complete(parser, parser->context);
+    }
+    http_parser_begin(parser);
+}
+
+// Kopfzeile "Name: Wert", true wenn name passt; value zeigt auf den Wert
+static bool http_parser_header(const char* line, const char* name, const char** value) {
+    size_t length = strlen(name);
+    if(strncasecmp(line, name, length) != 0 || line[length] != ':') return false;
+    *value = line + length + 1;
+    while(**value == ' ') (*value)++;
+    return true;
+}
+
+// Cache-Control: nur max-age und no-store (klein geschrieben wie von
+// Flask), andere Angaben werden übergangen
+static void http_parser_cache_control(HttpParser* parser, const char* value) {
+    const char* max_age = strstr(value, "max-age=");
+    if(max_age) parser->max_age = strtol(max_age + 8, NULL, 10);
+    if(strstr(value, "no-store")) parser->no_store = true;
+}
+
+static void http_parser_headers_done(HttpParser* parser) {
+    if(parser->callbacks->on_headers) {
+        parser->callbacks->on_headers(parser, parser->context);
+    }
+
+    if(parser->chunked) {
+        parser->state = HttpParseChunkSize;
+    } else if(parser->content_length > 0) {
+        parser->remaining = parser->content_length;
+        parser->state = HttpParseBody;
+    } else {
+        // Ohne Länge kein Body: die Leitung bleibt für die nächste Antwort offen
+        http_parser_complete(parser);
+    }
+}
+
+// Vollständige Zeile (ohne CRLF) im aktuellen Zustand auswerten
+static void http_parser_line(HttpParser* parser) {
+    const char* line = parser->line;
+    const char* value;
+
+    switch(parser->state) {
+        case HttpParseStatusLine:
+            // Leerzeilen zwischen Antworten überspringen
+            if(parser->line_len == 0) break;
+            if(strncmp(line, "HTTP/", 5) != 0 || !(value = strchr(line, ' '))) {
+                http_parser_fail(parser);
+                break;
+            }
+            parser->status_code = atoi(value + 1);
+            parser->state = HttpParseHeaderLine;
+            break;
+
+        case HttpParseHeaderLine:
+            if(parser->line_len == 0) {
+                http_parser_headers_done(parser);
+            } else if(http_parser_header(line, "Content-Length", &value)) {
+                parser->content_length = strtoul(value, NULL, 10);
+            } else if(http_parser_header(line, "Transfer-Encoding", &value)) {
+                parser->chunked = strncasecmp(value, "chunked", 7) == 0;
+            } else if(http_parser_header(line, "X-Request-Id", &value)) {
+                parser->request_id = strtoul(value, NULL, 10);
+            } else if(http_parser_header(line, "ETag", &value)) {
+                // Abgeschnittene Zeile: ein halber ETag passt nie, lieber keiner
+                if(parser->line_len < HTTP_PARSER_LINE_SIZE && strlen(value) < HTTP_PARSER_ETAG_SIZE) {
+                    strcpy(parser->etag, value);
+                }
+            } else if(http_parser_header(line, "Cache-Control", &value)) {
+                http_parser_cache_control(parser, value);
+            }
+            break;
+
+        case HttpParseChunkSize: {
+            // Hex-Länge, Erweiterungen nach ';' werden ignoriert
+            char* end;
+            parser->remaining = strtoul(line, &end, 16);
+            if(end == line) {
+                http_parser_fail(parser);
+            } else {
+                parser->state = parser->remaining ? HttpParseChunkData : HttpParseTrailer;
+            }
+            break;
+        }
+
+        case HttpParseChunkEnd:
+            if(parser->line_len != 0) {
+                http_parser_fail(parser);
+            } else {
+                parser->state = HttpParseChunkSize;
+            }
+            break;
+
+        case HttpParseTrailer:
+            if(parser->line_len == 0) http_parser_complete(parser);
+            break;
+
+        default:
+            break;
+    }
+}
+
+bool http_parser_is_idle(const HttpParser* parser) {
+    return parser->state == HttpParseStatusLine && parser->line_len == 0;
+}
+
+size_t http_parser_feed(HttpParser* parser, const uint8_t* data, size_t size) {
+    size_t offset = 0;
+    uint32_t responses = parser->responses;
+
+    // Nach jeder vollständigen Antwort anhalten
+    while(offset < size && parser->state != HttpParseError && parser->responses == responses) {
+        if(parser->state == HttpParseBody || parser->state == HttpParseChunkData) {
+            // Body direkt aus der Eingabe weiterreichen
+            size_t count = MIN(parser->remaining, size - offset);
+            if(parser->callbacks->on_body) {
+                parser->callbacks->on_body(parser, data + offset, count, parser->context);
+            }
+            parser->body_size += count;
+            parser->remaining -= count;
+            offset += count;
+
+            if(parser->remaining == 0) {
+                if(parser->state == HttpParseBody) {
+                    http_parser_complete(parser);
+                } else {
+                    parser->state = HttpParseChunkEnd;
+                }
+            }
+            continue;
+        }
+
+        // Zeilenweise Zustände: bis '\n' sammeln, '\r' verwerfen
+        uint8_t byte = data[offset++];
+        if(byte == '\n') {
+            parser->line[MIN(parser->line_len, HTTP_PARSER_LINE_SIZE - 1)] = '\0';
+            http_parser_line(parser);
+            parser->line_len = 0;
+        } else if(byte != '\r') {
+            if(parser->line_len < HTTP_PARSER_LINE_SIZE - 1) {
+                parser->line[parser->line_len] = byte;
+            }
+            parser->line_len++;
+        }
+    }
+
+    return offset;
+}
@@ -0,0 +1,85 @@
+#pragma once
+
+#include <furi.h>
+
+// Inkrementeller Parser für HTTP/1.1-Antworten. Verarbeitet beliebig
+// zerstückelte Eingaben Byte für Byte: Statuszeile, Kopfzeilen, Body mit
+// Content-Length oder Transfer-Encoding: chunked. Body-Daten werden nicht
+// kopiert, on_body zeigt direkt in den übergebenen Eingabepuffer.
+
+#define HTTP_PARSER_LINE_SIZE 64  // Längere Kopfzeilen werden abgeschnitten
+#define HTTP_PARSER_ETAG_SIZE 40  // Mit Anführungszeichen, längere ETags werden ignoriert
+#define HTTP_PARSER_NO_MAX_AGE -1
+
+// Byte-Ring zwischen UART-Interrupt (ein Schreiber) und Worker (ein Leser).
+// Der Leser parst direkt im Ring und gibt erst danach frei.
+typedef struct {
+    uint8_t* data;
+    uint32_t mask;     // Größe - 1, Größe ist eine Zweierpotenz
+    uint32_t head;     // Nur der Schreiber
+    uint32_t tail;     // Nur der Leser
+    uint32_t dropped;  // Ring voll
+} HttpRxRing;
+
+void http_rx_ring_init(HttpRxRing* ring, uint8_t* buffer, size_t size);
+bool http_rx_ring_push(HttpRxRing* ring, uint8_t byte);
+size_t http_rx_ring_write(HttpRxRing* ring, const uint8_t* data, size_t size);
+// Zusammenhängender lesbarer Abschnitt (höchstens bis zum Ringende)
+size_t http_rx_ring_peek(HttpRxRing* ring, const uint8_t** data);
+void http_rx_ring_release(HttpRxRing* ring, size_t size);
+void http_rx_ring_clear(HttpRxRing* ring);
+
+typedef enum {
+    HttpParseStatusLine,
+    HttpParseHeaderLine,
+    HttpParseBody,
+    HttpParseChunkSize,
+    HttpParseChunkData,
+    HttpParseChunkEnd,  // CRLF nach den Chunk-Daten
+    HttpParseTrailer,
+    HttpParseError,
+} HttpParseState;
+
+typedef struct HttpParser HttpParser;
+
+typedef struct {
+    // Kopf vollständig: status_code, request_id, content_length, chunked und
+    // die Cache-Angaben gesetzt
+    void (*on_headers)(HttpParser* parser, void* context);
+    // Body-Ausschnitt, nur während des Aufrufs gültig
+    void (*on_body)(HttpParser* parser, const uint8_t* data, size_t size, void* context);
+    void (*on_complete)(HttpParser* parser, void* context);
+} HttpParserCallbacks;
+
+struct HttpParser {
+    HttpParseState state;
+    const HttpParserCallbacks* callbacks;
+    void* context;
+
+    char line[HTTP_PARSER_LINE_SIZE];
+    size_t line_len;
+
+    // Aktuelle Antwort
+    int status_code;
+    uint32_t request_id;      // X-Request-Id, 0 = keine
+    uint32_t content_length;
+    bool chunked;
+    char etag[HTTP_PARSER_ETAG_SIZE];  // "" = keiner
+    int32_t max_age;          // Cache-Control: max-age in s, HTTP_PARSER_NO_MAX_AGE = keine Angabe
+    bool no_store;            // Cache-Control: no-store
+    uint32_t remaining;       // Restbytes im Body bzw. Chunk
+    uint32_t body_size;       // Bisher an on_body geliefert
+
+    uint32_t responses;
+    uint32_t errors;
+};
+
+void http_parser_init(HttpParser* parser, const HttpParserCallbacks* callbacks, void* context);
+// Nach einem Fehler: wieder auf eine Statuszeile warten
+void http_parser_reset(HttpParser* parser);
+// Zwischen zwei Antworten, noch kein Byte der nächsten gelesen
+bool http_parser_is_idle(const HttpParser* parser);
+// Liefert die verbrauchten Bytes. Hält nach jeder vollständigen Antwort an,
+// damit der Aufrufer auf ein anderes Format umschalten kann; bei einem
+// Fehler ebenfalls weniger als size
+size_t http_parser_feed(HttpParser* parser, const uint8_t* data, size_t size);
@@ -0,0 +1,81 @@
+#include "item_ring.h"
+
+void item_ring_init(ItemRing* ring, void* buffer, size_t item_size, uint32_t capacity) {
+    ring->items = buffer;
+    ring->item_size = item_size;
+    ring->capacity = capacity;
+    item_ring_clear(ring);
+}
+
+void item_ring_clear(ItemRing* ring) {
+    ring->head = 0;
+    ring->count = 0;
+}
+
+static uint8_t* item_ring_slot(const ItemRing* ring, uint32_t index) {
+    uint32_t slot = ring->head + index;
+    if(slot >= ring->capacity) slot -= ring->capacity;
+    return ring->items + (size_t)slot * ring->item_size;
+}
+
+void* item_ring_push(ItemRing* ring, const void* item) {
+    uint8_t* slot;
+    if(ring->count == ring->capacity) {
+        // Voll: der Platz des ältesten wird der des neuesten
+        slot = item_ring_slot(ring, 0);
+        ring->head = (ring->head + 1) % ring->capacity;
+    } else {
+        slot = item_ring_slot(ring, ring->count);
+        ring->count++;
+    }
+
+    if(item) {
+        memcpy(slot, item, ring->item_size);
+    } else {
+        memset(slot, 0, ring->item_size);
+    }
+    return slot;
+}
+
+void* item_ring_get(const ItemRing* ring, uint32_t index) {
+    if(index >= ring->count) return NULL;
+    return item_ring_slot(ring, index);
+}
+
+void* item_ring_back(const ItemRing* ring) {
+    if(ring->count == 0) return NULL;
+    return item_ring_slot(ring, ring->count - 1);
+}
+
+static void item_ring_swap(ItemRing* ring, uint32_t a, uint32_t b) {
+    uint8_t* x = ring->items + (size_t)a * ring->item_size;
+    uint8_t* y = ring->items + (size_t)b * ring->item_size;
+    for(size_t i = 0; i < ring->item_size; i++) {
+        uint8_t byte = x[i];
+        x[i] = y[i];
+        y[i] = byte;
+    }
+}
+
+static void item_ring_reverse(ItemRing* ring, uint32_t first, uint32_t end) {
+    while(first + 1 < end) {
+        item_ring_swap(ring, first++, --end);
+    }
+}
+
+const void* item_ring_linearize(ItemRing* ring) {
+    if(ring->head == 0) return ring->items;
+
+    // head wandert nur bei vollem Ring: Drehung des ganzen Puffers um head
+    // per dreifacher Umkehrung
+    item_ring_reverse(ring, 0, ring->head);
+    item_ring_reverse(ring, ring->head, ring->capacity);
+    item_ring_reverse(ring, 0, ring->capacity);
+    ring->head = 0;
+    return ring->items;
+}
+
+void item_ring_load(ItemRing* ring, uint32_t count) {
+    ring->head = 0;
+    ring->count = MIN(count, ring->capacity);
+}
@@ -0,0 +1,33 @@
+#pragma once
+
+#include <furi.h>
+
+// Ring fester Kapazität für Elemente gleicher Größe. Ist er voll, ersetzt
+// ein neues Element das älteste, ohne etwas zu verschieben. Index 0 ist
+// immer das älteste Element. Den Puffer stellt der Aufrufer.
+//
+// Serialisiert wird nur das lebende Fenster, ältestes zuerst und am Stück:
+// item_ring_linearize ordnet den Puffer dafür an Ort und Stelle um,
+// item_ring_load übernimmt so abgelegte Elemente wieder.
+
+typedef struct {
+    uint8_t* items;
+    size_t item_size;
+    uint32_t capacity;
+    uint32_t head;   // Ältestes Element
+    uint32_t count;  // Das nächste kommt an (head + count) % capacity
+} ItemRing;
+
+void item_ring_init(ItemRing* ring, void* buffer, size_t item_size, uint32_t capacity);
+void item_ring_clear(ItemRing* ring);
+// Kopiert item (NULL = mit Nullen) ans Ende und liefert seinen Platz
+void* item_ring_push(ItemRing* ring, const void* item);
+// NULL = index >= count
+void* item_ring_get(const ItemRing* ring, uint32_t index);
+// Neuestes Element, NULL bei leerem Ring
+void* item_ring_back(const ItemRing* ring);
+// Fenster an den Pufferanfang drehen; danach liegen count Elemente am Stück
+// ab items. Dauert O(count), ohne zweiten Puffer
+const void* item_ring_linearize(ItemRing* ring);
+// count Elemente ab Pufferanfang übernehmen, etwa nach dem Einlesen
+void item_ring_load(ItemRing* ring, uint32_t count);
@@ -0,0 +1,307 @@
+#include "json_writer.h"
+
+static const char json_hex_digits[] = "0123456789ABCDEF";
+
+void json_writer_init(JsonWriter* writer, char* buffer, size_t capacity) {
+    furi_assert(capacity > 1);
+    memset(writer, 0, sizeof(JsonWriter));
+    writer->buffer = buffer;
+    writer->capacity = capacity;
+    buffer[0] = '\0';
+}
+
+void json_writer_set_flush(
+    JsonWriter* writer,
+    bool (*flush)(const char* data, size_t size, void* context),
+    void* context) {
+    writer->flush = flush;
+    writer->context = context;
+}
+
+static bool json_writer_failed(const JsonWriter* writer) {
+    return writer->truncated || writer->invalid;
+}
+
+// Ohne flush wird nur ganz oder gar nicht geschrieben, mit flush in Stücken
+static void json_write(JsonWriter* writer, const char* data, size_t size) {
+    if(json_writer_failed(writer)) return;
+
+    while(size > 0) {
+        size_t space = writer->capacity - 1 - writer->length;
+        if(space == 0 || (!writer->flush && space < size)) {
+            if(!writer->flush || writer->length == 0 ||
+               !writer->flush(writer->buffer, writer->length, writer->context)) {
+                writer->truncated = true;
+                break;
+            }
+            writer->flushed += writer->length;
+            writer->length = 0;
+            continue;
+        }
+
+        size_t count = MIN(space, size);
+        memcpy(writer->buffer + writer->length, data, count);
+        writer->length += count;
+        data += count;
+        size -= count;
+    }
+    writer->buffer[writer->length] = '\0';
+}
+
+// Häufigster Fall ohne Schleife: ein Zeichen, Platz vorhanden
+static void json_put(JsonWriter* writer, char c) {
+    if(writer->length + 2 <= writer->capacity && !json_writer_failed(writer)) {
+        writer->buffer[writer->length++] = c;
+        writer->buffer[writer->length] = '\0';
+    } else {
+        json_write(writer, &c, 1);
+    }
+}
+
+static void json_write_string(JsonWriter* writer, const char* value) {
+    json_put(writer, '"');
+
+    // Unverdächtige Abschnitte am Stück kopieren
+    const char* run = value;
+    const char* p = value;
+    for(; *p; p++) {
+        unsigned char c = *p;
+        if(c >= 0x20 && c != '"' && c != '\\') continue;
+
+        json_write(writer, run, p - run);
+        char escape[6] = {'\\', 'u', '0', '0'};
+        size_t length = 2;
+        switch(c) {
+            case '"':
+            case '\\':
+                escape[1] = c;
+                break;
+            case '\n':
+                escape[1] = 'n';
+                break;
+            case '\r':
+                escape[1] = 'r';
+                break;
+            case '\t':
+                escape[1] = 't';
+                break;
+            case '\b':
+                escape[1] = 'b';
+                break;
+            case '\f':
+                escape[1] = 'f';
+                break;
+            default:
+                escape[4] = json_hex_digits[c >> 4];
+                escape[5] = json_hex_digits[c & 0x0F];
+                length = 6;
+                break;
+        }
+        json_write(writer, escape, length);
+        run = p + 1;
+    }
+    json_write(writer, run, p - run);
+
+    json_put(writer, '"');
+}
+
+static void json_write_uint(JsonWriter* writer, uint32_t value) {
+    char digits[10];
+    size_t position = sizeof(digits);
+    do {
+        digits[--position] = '0' + value % 10;
+        value /= 10;
+    } while(value);
+    json_write(writer, digits + position, sizeof(digits) - position);
+}
+
+// Komma setzen; im Objekt muss vorher ein Schlüssel stehen
+static bool json_begin_value(JsonWriter* writer) {
+    if(json_writer_failed(writer)) return false;
+
+    if(writer->depth > 0) {
+        uint16_t level = 1 << (writer->depth - 1);
+        if(writer->arrays & level) {
+            if(writer->has_items & level) json_put(writer, ',');
+            writer->has_items |= level;
+        } else if(!writer->after_key) {
+            writer->invalid = true;
+            return false;
+        }
+    }
+    writer->after_key = false;
+    return !json_writer_failed(writer);
+}
+
+static void json_begin_container(JsonWriter* writer, bool array) {
+    if(!json_begin_value(writer)) return;
+    if(writer->depth == JSON_WRITER_MAX_DEPTH) {
+        writer->invalid = true;
+        return;
+    }
+
+    uint16_t level = 1 << writer->depth;
+    writer->depth++;
+    writer->has_items &= ~level;
+    if(array) {
+        writer->arrays |= level;
+    } else {
+        writer->arrays &= ~level;
+    }
+    json_put(writer, array ? '[' : '{');
+}
+
+static void json_end_container(JsonWriter* writer, bool array) {
+    if(json_writer_failed(writer)) return;
+
+    uint16_t level = writer->depth ? 1 << (writer->depth - 1) : 0;
+    if(!level || writer->after_key || !!(writer->arrays & level) != array) {
+        writer->invalid = true;
+        return;
+    }
+    writer->depth--;
+    json_put(writer, array ? ']' : '}');
+}
+
+void json_writer_begin_object(JsonWriter* writer) {
+    json_begin_container(writer, false);
+}
+
+void json_writer_end_object(JsonWriter* writer) {
+    json_end_container(writer, false);
+}
+
+void json_writer_begin_array(JsonWriter* writer) {
+    json_begin_container(writer, true);
+}
+
+void json_writer_end_array(JsonWriter* writer) {
+    json_end_container(writer, true);
+}
+
+void json_writer_key(JsonWriter* writer, const char* key) {
+    if(json_writer_failed(writer)) return;
+
+    uint16_t level = writer->depth ? 1 << (writer->depth - 1) : 0;
+    if(!level || (writer->arrays & level) || writer->after_key) {
+        writer->invalid = true;
+        return;
+    }
+    if(writer->has_items & level) json_put(writer, ',');
+    writer->has_items |= level;
+
+    json_write_string(writer, key);
+    json_put(writer, ':');
+    writer->after_key = true;
+}
+
+void json_writer_string(JsonWriter* writer, const char* value) {
+    if(!json_begin_value(writer)) return;
+    json_write_string(writer, value);
+}
+
+void json_writer_hex(JsonWriter* writer, const uint8_t* data, size_t size) {
+    if(!json_begin_value(writer)) return;
+
+    char chunk[32];
+    json_put(writer, '"');
+    for(size_t i = 0; i < size;) {
+        size_t length = 0;
+        for(; i < size && length < sizeof(chunk); i++) {
+            chunk[length++] = json_hex_digits[data[i] >> 4];
+            chunk[length++] = json_hex_digits[data[i] & 0x0F];
+        }
+        json_write(writer, chunk, length);
+    }
+    json_put(writer, '"');
+}
+
+void json_writer_int(JsonWriter* writer, int32_t value) {
+    if(!json_begin_value(writer)) return;
+    if(value < 0) json_put(writer, '-');
+    json_write_uint(writer, value < 0 ? 0U - (uint32_t)value : (uint32_t)value);
+}
+
+void json_writer_uint(JsonWriter* writer, uint32_t value) {
+    if(!json_begin_value(writer)) return;
+    json_write_uint(writer, value);
+}
+
+void json_writer_fixed(JsonWriter* writer, int32_t value, uint8_t decimals) {
+    if(!json_begin_value(writer)) return;
+    furi_assert(decimals <= 9);
+
+    uint32_t scale = 1;
+    for(uint8_t i = 0; i < decimals; i++) scale *= 10;
+    uint32_t magnitude = value < 0 ? 0U - (uint32_t)value : (uint32_t)value;
+
+    if(value < 0) json_put(writer, '-');
+    json_write_uint(writer, magnitude / scale);
+    if(decimals == 0) return;
+
+    // Nachkommastellen mit führenden Nullen
+    char digits[10];
+    uint32_t fraction = magnitude % scale;
+    digits[0] = '.';
+    for(uint8_t i = decimals; i > 0; i--) {
+        digits[i] = '0' + fraction % 10;
+        fraction /= 10;
+    }
+    json_write(writer, digits, decimals + 1);
+}
+
+void json_writer_bool(JsonWriter* writer, bool value) {
+    if(!json_begin_value(writer)) return;
+    if(value) {
+        json_write(writer, "true", 4);
+    } else {
+        json_write(writer, "false", 5);
+    }
+}
+
+void json_writer_null(JsonWriter* writer) {
+    if(!json_begin_value(writer)) return;
+    json_write(writer, "null", 4);
+}
+
+void json_writer_raw(JsonWriter* writer, const char* json) {
+    if(!json_begin_value(writer)) return;
+    json_write(writer, json, strlen(json));
+}
+
+void json_writer_add_string(JsonWriter* writer, const char* key, const char* value) {
+    json_writer_key(writer, key);
+    json_writer_string(writer, value);
+}
+
+void json_writer_add_int(JsonWriter* writer, const char* key, int32_t value) {
+    json_writer_key(writer, key);
+    json_writer_int(writer, value);
+}
+
+void json_writer_add_uint(JsonWriter* writer, const char* key, uint32_t value) {
+    json_writer_key(writer, key);
+    json_writer_uint(writer, value);
+}
+
+void json_writer_add_bool(JsonWriter* writer, const char* key, bool value) {
+    json_writer_key(writer, key);
+    json_writer_bool(writer, value);
+}
+
+size_t json_writer_finish(JsonWriter* writer) {
+    if(json_writer_failed(writer) || writer->depth != 0 || writer->after_key) {
+        return 0;
+    }
+
+    if(writer->flush && writer->length > 0) {
+        if(!writer->flush(writer->buffer, writer->length, writer->context)) {
+            writer->truncated = true;
+            return 0;
+        }
+        writer->flushed += writer->length;
+        writer->length = 0;
+        writer->buffer[0] = '\0';
+    }
+    return writer->flushed + writer->length;
+}
@@ -0,0 +1,66 @@
+#pragma once
+
+#include <furi.h>
+
+// JSON direkt in einen Puffer des Aufrufers, ohne Heap. Der Writer führt
+// den Cursor mit (Anhängen in O(1)), setzt Kommas selbst, maskiert Strings
+// und erlaubt verschachtelte Objekte und Arrays. Fehler sind klebrig: nach
+// einem Überlauf oder falscher Verschachtelung schreiben weitere Aufrufe
+// nichts mehr, json_writer_finish liefert dann 0.
+//
+// Mit flush wird ein voller Puffer abgegeben und von vorn beschrieben, so
+// passt beliebig viel JSON durch einen kleinen Puffer oder Ringabschnitt.
+
+#define JSON_WRITER_MAX_DEPTH 16
+
+typedef struct {
+    char* buffer;
+    size_t capacity;
+    size_t length;   // Cursor im Puffer, buffer[length] ist immer '\0'
+    size_t flushed;  // Bereits an flush übergeben
+
+    // Optional: vollen Puffer abgeben, false = abbrechen (zählt als Überlauf)
+    bool (*flush)(const char* data, size_t size, void* context);
+    void* context;
+
+    uint8_t depth;
+    uint16_t arrays;     // Bit pro Ebene: Array statt Objekt
+    uint16_t has_items;  // Bit pro Ebene: Komma vor dem nächsten Eintrag
+    bool after_key;
+    bool truncated;      // Puffer voll
+    bool invalid;        // Falsche Verschachtelung oder Wert ohne Schlüssel
+} JsonWriter;
+
+void json_writer_init(JsonWriter* writer, char* buffer, size_t capacity);
+void json_writer_set_flush(
+    JsonWriter* writer,
+    bool (*flush)(const char* data, size_t size, void* context),
+    void* context);
+
+void json_writer_begin_object(JsonWriter* writer);
+void json_writer_end_object(JsonWriter* writer);
+void json_writer_begin_array(JsonWriter* writer);
+void json_writer_end_array(JsonWriter* writer);
+void json_writer_key(JsonWriter* writer, const char* key);
+
+void json_writer_string(JsonWriter* writer, const char* value);
+// Bytes als Hex-String in Großbuchstaben, wie tag_id_format_hex
+void json_writer_hex(JsonWriter* writer, const uint8_t* data, size_t size);
+void json_writer_int(JsonWriter* writer, int32_t value);
+void json_writer_uint(JsonWriter* writer, uint32_t value);
+// Festkomma: value / 10^decimals, z.B. Koordinaten in 1e-7 Grad
+void json_writer_fixed(JsonWriter* writer, int32_t value, uint8_t decimals);
+void json_writer_bool(JsonWriter* writer, bool value);
+void json_writer_null(JsonWriter* writer);
+// Fertiges JSON unverändert als Wert übernehmen, der Aufrufer bürgt dafür
+void json_writer_raw(JsonWriter* writer, const char* json);
+
+// Schlüssel und Wert in einem Aufruf
+void json_writer_add_string(JsonWriter* writer, const char* key, const char* value);
+void json_writer_add_int(JsonWriter* writer, const char* key, int32_t value);
+void json_writer_add_uint(JsonWriter* writer, const char* key, uint32_t value);
+void json_writer_add_bool(JsonWriter* writer, const char* key, bool value);
+
+// Gibt den Rest an flush ab. Liefert die Gesamtlänge, 0 bei Überlauf,
+// Fehler oder offenen Objekten/Arrays
+size_t json_writer_finish(JsonWriter* writer);
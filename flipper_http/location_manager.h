@@ -8,6 +8,7 @@ typedef struct {
     float longitude;
     float distance;
     float bearing;
+    float speed;
 } LocationInfo;
 
 typedef struct {
@@ -1,7 +1,10 @@
 #include "map_manager.h"
 #include <furi_hal.h>
 #include <storage/storage.h>
+#include <math.h>
 
+#define EARTH_RADIUS 6371000.0
+#define DEG_TO_RAD (M_PI / 180.0)
 #define MAP_TILE_SIZE 256
 #define MAP_CACHE_DIR "/ext/tagracer/maps"
 #define TRACK_FILE_EXT ".gpx"
@@ -64,6 +67,18 @@ bool map_manager_add_waypoint(
     return true;
 }
 
+Waypoint* map_manager_get_waypoint(MapManager* manager, uint32_t id) {
+    if(!manager) return NULL;
+    
+    for(uint32_t i = 0; i < manager->waypoint_count; i++) {
+        if(manager->waypoints[i].id == id) {
+            return &manager->waypoints[i];
+        }
+    }
+    
+    return NULL;
+}
+
 bool map_manager_create_route(
     MapManager* manager,
     const char* name,
@@ -368,3 +383,51 @@ bool map_manager_calculate_distance(
     
     return true;
 }
+
+bool map_manager_find_nearby_tags(
+    MapManager* manager,
+    float latitude,
+    float longitude,
+    size_t max_count,
+    uint32_t* tag_ids,
+    size_t* count
+) {
+    if(!manager || !tag_ids || !count || max_count == 0) return false;
+    
+    furi_mutex_acquire(manager->mutex, FuriWaitForever);
+    
+    // Nächste sichtbare Wegpunkte per Insertion-Sort sammeln.
+    // Für die kurzen Distanzen im Spielfeld reicht die ebene Näherung.
+    float best_dist[max_count];
+    size_t found = 0;
+    float lon_scale = cosf(latitude * DEG_TO_RAD);
+    
+    for(uint32_t i = 0; i < manager->waypoint_count; i++) {
+        Waypoint* wp = &manager->waypoints[i];
+        if(!wp->visible) continue;
+        
+        float dlat = wp->latitude - latitude;
+        float dlon = (wp->longitude - longitude) * lon_scale;
+        float dist = dlat * dlat + dlon * dlon;
+        
+        size_t pos = found < max_count ? found : max_count;
+        while(pos > 0 && best_dist[pos - 1] > dist) {
+            if(pos < max_count) {
+                best_dist[pos] = best_dist[pos - 1];
+                tag_ids[pos] = tag_ids[pos - 1];
+            }
+            pos--;
+        }
+        
+        if(pos < max_count) {
+            best_dist[pos] = dist;
+            tag_ids[pos] = wp->id;
+            if(found < max_count) found++;
+        }
+    }
+    
+    *count = found;
+    
+    furi_mutex_release(manager->mutex);
+    return found > 0;
+}
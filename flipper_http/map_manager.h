@@ -18,7 +18,7 @@ typedef struct {
     bool visible;
 } Waypoint;
 
-typedef struct {
+typedef struct Route {
     uint32_t id;
     char name[32];
     uint32_t waypoint_count;
@@ -151,6 +151,14 @@ bool map_manager_calculate_distance(
     float lon2,
     float* distance
 );
+bool map_manager_find_nearby_tags(
+    MapManager* manager,
+    float latitude,
+    float longitude,
+    size_t max_count,
+    uint32_t* tag_ids,
+    size_t* count
+);
 bool map_manager_get_bearing(
     MapManager* manager,
     float lat1,
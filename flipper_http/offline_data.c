@@ -1,14 +1,510 @@
 #include "offline_data.h"
 #include <furi_hal.h>
 #include <toolbox/path.h>
-#include <toolbox/compress.h>
-#include <notification/notification_messages.h>
+#include <toolbox/compression.h>
+#include "notifier.h"
+
+// Layout-Version der Abschnittsinhalte
+#define OFFLINE_SECTION_VERSION 1
+#define OFFLINE_COPY_CHUNK 256
+
+// Listen-Abschnitte: Elementgröße, Kapazität und Ring in OfflineData
+typedef struct {
+    size_t item_size;
+    uint32_t max;
+    size_t ring;  // offsetof
+} OfflineListLayout;
+
+static const OfflineListLayout offline_lists[] = {
+    [OfflineSectionGames] = {sizeof(CachedGame), MAX_OFFLINE_GAMES, offsetof(OfflineData, games)},
+    [OfflineSectionTags] = {sizeof(CachedTagScan), MAX_OFFLINE_TAGS, offsetof(OfflineData, tags)},
+    [OfflineSectionLeaderboard] =
+        {sizeof(LeaderboardEntry), MAX_LEADERBOARD_ENTRIES, offsetof(OfflineData, leaderboard)},
+    [OfflineSectionMessages] = {sizeof(OfflineMessage), MAX_CACHED_MESSAGES, offsetof(OfflineData, messages)},
+};
+
+// Inhalt des Abschnitts State
+typedef struct {
+    GpsData last_gps;
+    OfflineTournament current_tournament;
+    bool needs_sync;
+    uint32_t last_sync;
+    uint32_t last_backup;
+} OfflineState;
+
+// Früheres GAME_DATA_FILE: der ganze Stand als ein Block
+typedef struct {
+    uint32_t game_count;
+    CachedGame games[MAX_OFFLINE_GAMES];
+    uint32_t tag_count;
+    CachedTagScan tags[MAX_OFFLINE_TAGS];
+    uint32_t leaderboard_count;
+    LeaderboardEntry leaderboard[MAX_LEADERBOARD_ENTRIES];
+    uint32_t message_count;
+    OfflineMessage messages[MAX_CACHED_MESSAGES];
+    uint32_t map_tile_count;
+    MapTile map_tiles[MAX_MAP_TILES];
+    OfflineState state;
+} OfflineDataV1;
+
+typedef struct {
+    uint32_t magic;
+    uint32_t segment;  // Erstes Protokollsegment, das nicht enthalten ist
+} OfflineSnapshotHeader;
+
+// Welche Abschnitte und Kacheln ein Stück Protokoll ändert
+typedef struct {
+    OfflineData* data;
+    uint32_t mask;                           // Bit pro OfflineSectionType
+    uint8_t tiles[(MAX_MAP_TILES + 7) / 8];  // Bit pro Position in map_tile_ids
+} OfflineTailScan;
+
+typedef struct {
+    OfflineData* data;
+    uint8_t type;
+    uint32_t key;      // tile_id bei OfflineSectionMapTile
+    uint32_t applied;
+} OfflineReplayFilter;
+
+// Ein Protokoll pro App, wie die Dateien, in die es schreibt
+static OfflineLog* offline_log = NULL;
 
 // Interne Hilfsfunktionen
 static bool create_directories(Storage* storage);
-static bool compress_data(const void* data, size_t size, uint8_t* out, size_t* out_size);
 static bool decompress_data(const uint8_t* data, size_t size, void* out, size_t* out_size);
 static void generate_backup_name(char* path, size_t path_size);
+static bool offline_data_apply(OfflineData* data, uint8_t type, const void* payload, size_t size);
+
+static bool offline_data_is_list(uint8_t type) {
+    return type >= OfflineSectionGames && type <= OfflineSectionMessages;
+}
+
+static ItemRing* offline_data_ring(OfflineData* data, uint8_t type) {
+    return (ItemRing*)((uint8_t*)data + offline_lists[type].ring);
+}
+
+static int32_t offline_data_find_tile(const OfflineData* data, uint32_t tile_id) {
+    for(uint32_t i = 0; i < data->map_tile_count; i++) {
+        if(data->map_tile_ids[i] == tile_id) return i;
+    }
+    return -1;
+}
+
+static bool offline_data_add_tile_id(OfflineData* data, uint32_t tile_id) {
+    if(offline_data_find_tile(data, tile_id) >= 0) return true;
+    if(data->map_tile_count >= MAX_MAP_TILES) return false;
+    data->map_tile_ids[data->map_tile_count++] = tile_id;
+    return true;
+}
+
+// Belegter Cache-Platz der Kachel, zählt als Zugriff
+static MapTile* offline_data_cached_tile(OfflineData* data, uint32_t tile_id) {
+    for(size_t i = 0; i < OFFLINE_TILE_CACHE; i++) {
+        if(data->tile_used[i] && data->tile_cache[i]->tile_id == tile_id) {
+            data->tile_used[i] = ++data->tile_clock;
+            return data->tile_cache[i];
+        }
+    }
+    return NULL;
+}
+
+// Freier oder am längsten nicht benutzter Platz; verdrängte Kacheln stehen
+// in Container und Protokoll
+static MapTile* offline_data_tile_slot(OfflineData* data, uint32_t tile_id) {
+    size_t slot = 0;
+    for(size_t i = 1; i < OFFLINE_TILE_CACHE; i++) {
+        if((int32_t)(data->tile_used[i] - data->tile_used[slot]) < 0) slot = i;
+    }
+    if(!data->tile_cache[slot]) data->tile_cache[slot] = malloc(sizeof(MapTile));
+    memset(data->tile_cache[slot], 0, sizeof(MapTile));
+    data->tile_cache[slot]->tile_id = tile_id;
+    data->tile_used[slot] = ++data->tile_clock;
+    return data->tile_cache[slot];
+}
+
+static void offline_data_release_tile(OfflineData* data, const MapTile* tile) {
+    for(size_t i = 0; i < OFFLINE_TILE_CACHE; i++) {
+        if(data->tile_cache[i] == tile) data->tile_used[i] = 0;
+    }
+}
+
+static void offline_data_scan_record(uint8_t type, const uint8_t* payload, size_t size, void* context) {
+    OfflineTailScan* scan = context;
+    if(type < 32) scan->mask |= 1UL << type;
+    // Neue Kacheln gehören gleich in den residenten Index
+    if(type == OfflineSectionMapTile && size == sizeof(MapTile)) {
+        uint32_t tile_id;
+        memcpy(&tile_id, payload + offsetof(MapTile, tile_id), sizeof(tile_id));
+        if(offline_data_add_tile_id(scan->data, tile_id)) {
+            int32_t position = offline_data_find_tile(scan->data, tile_id);
+            scan->tiles[position / 8] |= 1 << (position % 8);
+        }
+    }
+}
+
+// Protokoll von segment bis vor end durchsehen, ohne etwas zu laden.
+// Liefert das erste fehlende Segment
+static uint32_t offline_data_scan_tail(
+    Storage* storage,
+    OfflineData* data,
+    uint32_t end,
+    OfflineTailScan* scan,
+    OfflineLogStats* stats) {
+    memset(scan, 0, sizeof(OfflineTailScan));
+    scan->data = data;
+    return offline_log_replay(
+        storage, OFFLINE_LOG_DIR, data->index->header.segment, end, offline_data_scan_record, scan, stats);
+}
+
+static void offline_data_replay_filtered(uint8_t type, const uint8_t* payload, size_t size, void* context) {
+    OfflineReplayFilter* filter = context;
+    if(type != filter->type) return;
+    if(type == OfflineSectionMapTile) {
+        uint32_t tile_id;
+        if(size != sizeof(MapTile)) return;
+        memcpy(&tile_id, payload + offsetof(MapTile, tile_id), sizeof(tile_id));
+        if(tile_id != filter->key) return;
+    }
+    if(offline_data_apply(filter->data, type, payload, size)) filter->applied++;
+}
+
+// Änderungen seit dem Container an einem Abschnitt nachspielen, bis vor end.
+// UINT32_MAX = einschließlich des aktiven Segments des laufenden Protokolls
+static uint32_t offline_data_replay_section(OfflineData* data, uint8_t type, uint32_t key, uint32_t end) {
+    OfflineReplayFilter filter = {.data = data, .type = type, .key = key};
+    uint32_t first = data->index ? data->index->header.segment : 0;
+    if(end != UINT32_MAX) {
+        Storage* storage = furi_record_open(RECORD_STORAGE);
+        offline_log_replay(storage, OFFLINE_LOG_DIR, first, end, offline_data_replay_filtered, &filter, NULL);
+        furi_record_close(RECORD_STORAGE);
+    } else if(offline_log) {
+        offline_log_read(offline_log, first, offline_data_replay_filtered, &filter);
+    }
+    return filter.applied;
+}
+
+// Ein Kontext pro OfflineData für alle Abschnitte, bis offline_data_close
+static CompressStream* offline_data_stream(OfflineData* data) {
+    if(!data->stream) data->stream = compress_stream_alloc(OFFLINE_SECTIONS_WINDOW);
+    return data->stream;
+}
+
+static bool offline_data_read_section(OfflineData* data, const OfflineSectionEntry* entry, void* out) {
+    Storage* storage = furi_record_open(RECORD_STORAGE);
+    File* file = storage_file_alloc(storage);
+    bool success = storage_file_open(file, OFFLINE_SECTIONS_FILE, FSAM_READ, FSOM_OPEN_EXISTING) &&
+                   offline_sections_read(file, entry, out, offline_data_stream(data));
+    storage_file_free(file);
+    furi_record_close(RECORD_STORAGE);
+    return success;
+}
+
+// Liste aus dem Container plus Protokoll bis vor end in den RAM holen
+static bool offline_data_page_list(OfflineData* data, uint8_t type, uint32_t end) {
+    ItemRing* ring = offline_data_ring(data, type);
+    if(ring->items) return true;
+
+    const OfflineListLayout* layout = &offline_lists[type];
+    size_t capacity = layout->item_size * layout->max;
+    uint8_t* buffer = malloc(capacity);
+    memset(buffer, 0, capacity);
+
+    uint32_t count = 0;
+    const OfflineSectionEntry* entry = data->index ? offline_sections_find(data->index, type, 0) : NULL;
+    if(entry) {
+        if(entry->version != OFFLINE_SECTION_VERSION || entry->count > layout->max ||
+           entry->size != entry->count * layout->item_size || !offline_data_read_section(data, entry, buffer)) {
+            free(buffer);
+            return false;
+        }
+        count = entry->count;
+    }
+
+    item_ring_init(ring, buffer, layout->item_size, layout->max);
+    item_ring_load(ring, count);
+    offline_data_replay_section(data, type, 0, end);
+    return true;
+}
+
+static void offline_data_free_list(OfflineData* data, uint8_t type) {
+    ItemRing* ring = offline_data_ring(data, type);
+    free(ring->items);
+    ring->items = NULL;
+}
+
+// Kachel aus dem Container plus Protokoll bis vor end in den Cache holen
+static MapTile* offline_data_page_tile(OfflineData* data, uint32_t tile_id, uint32_t end) {
+    if(offline_data_find_tile(data, tile_id) < 0) return NULL;
+    MapTile* tile = offline_data_cached_tile(data, tile_id);
+    if(tile) return tile;
+
+    tile = offline_data_tile_slot(data, tile_id);
+    const OfflineSectionEntry* entry =
+        data->index ? offline_sections_find(data->index, OfflineSectionMapTile, tile_id) : NULL;
+    bool found = entry && entry->version == OFFLINE_SECTION_VERSION && entry->size == sizeof(MapTile) &&
+                 offline_data_read_section(data, entry, tile);
+    // Jede neuere Fassung im Protokoll ersetzt die Kachel ganz
+    found |= offline_data_replay_section(data, OfflineSectionMapTile, tile_id, end) > 0;
+    if(!found) {
+        offline_data_release_tile(data, tile);
+        return NULL;
+    }
+    return tile;
+}
+
+// Inhaltsverzeichnis, Zustand, Zähler und Kachel-IDs, keine Liste
+static bool offline_data_read_index(Storage* storage, OfflineData* data) {
+    if(!data->index) data->index = malloc(sizeof(OfflineSectionIndex));
+    memset(&data->index->header, 0, sizeof(OfflineSectionHeader));
+
+    // Abbruch zwischen Löschen und Umbenennen in offline_data_swap_container
+    if(!storage_file_exists(storage, OFFLINE_SECTIONS_FILE) &&
+       storage_file_exists(storage, OFFLINE_SECTIONS_FILE ".tmp")) {
+        storage_common_rename(storage, OFFLINE_SECTIONS_FILE ".tmp", OFFLINE_SECTIONS_FILE);
+    }
+
+    File* file = storage_file_alloc(storage);
+    bool success = true;
+    if(storage_file_open(file, OFFLINE_SECTIONS_FILE, FSAM_READ, FSOM_OPEN_EXISTING)) {
+        success = offline_sections_read_index(file, data->index);
+        for(size_t i = 0; success && i < data->index->header.count; i++) {
+            const OfflineSectionEntry* entry = &data->index->entries[i];
+            if(offline_data_is_list(entry->type)) {
+                offline_data_ring(data, entry->type)->count = entry->count;
+            } else if(entry->type == OfflineSectionMapTile) {
+                offline_data_add_tile_id(data, entry->key);
+            } else if(entry->type == OfflineSectionState && entry->size == sizeof(OfflineState)) {
+                OfflineState state;
+                success = offline_sections_read(file, entry, &state, offline_data_stream(data));
+                data->last_gps = state.last_gps;
+                data->current_tournament = state.current_tournament;
+                data->needs_sync = state.needs_sync;
+                data->last_sync = state.last_sync;
+                data->last_backup = state.last_backup;
+            }
+        }
+    }
+    // Keine gespeicherten Daten - nicht unbedingt ein Fehler
+    storage_file_free(file);
+    return success;
+}
+
+static void offline_data_add_state(OfflineSectionWriter* writer, const OfflineState* state) {
+    offline_sections_add(writer, OfflineSectionState, OFFLINE_SECTION_VERSION, 0, 1, state, sizeof(OfflineState));
+}
+
+static void offline_data_add_items(OfflineSectionWriter* writer, uint8_t type, const void* items, uint32_t count) {
+    offline_sections_add(
+        writer, type, OFFLINE_SECTION_VERSION, 0, count, items, count * offline_lists[type].item_size);
+}
+
+// Neuen Container mit dem Stand bis vor end schreiben: geladene Abschnitte
+// aus dem RAM, vom Protokoll geänderte werden dafür geladen, alle anderen
+// unverändert aus dem alten Container kopiert
+static bool offline_data_write_container(
+    Storage* storage,
+    OfflineData* data,
+    uint32_t end,
+    const OfflineTailScan* scan,
+    OfflineSectionIndex* index) {
+    File* old = storage_file_alloc(storage);
+    File* file = storage_file_alloc(storage);
+    bool has_old = data->index && storage_file_open(old, OFFLINE_SECTIONS_FILE, FSAM_READ, FSOM_OPEN_EXISTING);
+    bool success = storage_file_open(file, OFFLINE_SECTIONS_FILE ".tmp", FSAM_WRITE, FSOM_CREATE_ALWAYS);
+
+    OfflineSectionWriter writer;
+    if(success) {
+        offline_sections_begin(&writer, file, index, end, offline_data_stream(data));
+        OfflineState state = {
+            .last_gps = data->last_gps,
+            .current_tournament = data->current_tournament,
+            .needs_sync = data->needs_sync,
+            .last_sync = data->last_sync,
+            .last_backup = data->last_backup,
+        };
+        offline_data_add_state(&writer, &state);
+
+        for(uint8_t type = OfflineSectionGames; type <= OfflineSectionMessages; type++) {
+            ItemRing* ring = offline_data_ring(data, type);
+            bool paged = false;
+            if(!ring->items && (scan->mask & (1UL << type))) {
+                paged = offline_data_page_list(data, type, end);
+            }
+            const OfflineSectionEntry* entry = has_old ? offline_sections_find(data->index, type, 0) : NULL;
+            if(ring->items) {
+                offline_data_add_items(&writer, type, item_ring_linearize(ring), ring->count);
+            } else if(entry) {
+                offline_sections_copy(&writer, old, entry);
+            }
+            if(paged) offline_data_free_list(data, type);
+        }
+
+        for(uint32_t i = 0; i < data->map_tile_count; i++) {
+            uint32_t tile_id = data->map_tile_ids[i];
+            MapTile* tile = offline_data_cached_tile(data, tile_id);
+            if(!tile && (scan->tiles[i / 8] & (1 << (i % 8)))) {
+                tile = offline_data_page_tile(data, tile_id, end);
+            }
+            const OfflineSectionEntry* entry =
+                has_old ? offline_sections_find(data->index, OfflineSectionMapTile, tile_id) : NULL;
+            if(tile) {
+                offline_sections_add(
+                    &writer, OfflineSectionMapTile, OFFLINE_SECTION_VERSION, tile_id, 1, tile, sizeof(MapTile));
+            } else if(entry) {
+                offline_sections_copy(&writer, old, entry);
+            }
+        }
+        success = offline_sections_finish(&writer);
+    }
+
+    storage_file_free(file);
+    storage_file_free(old);
+    return success;
+}
+
+// Neuen Container an die Stelle des alten setzen
+static bool offline_data_swap_container(Storage* storage) {
+    storage_common_remove(storage, OFFLINE_SECTIONS_FILE);
+    return storage_common_rename(storage, OFFLINE_SECTIONS_FILE ".tmp", OFFLINE_SECTIONS_FILE) == FSE_OK;
+}
+
+// Früheres Format einmal in den Container übernehmen. Braucht wie bisher
+// beim Laden den ganzen Stand auf einmal im RAM
+static bool offline_data_migrate(Storage* storage) {
+    if(storage_file_exists(storage, OFFLINE_SECTIONS_FILE) || !storage_file_exists(storage, GAME_DATA_FILE)) {
+        return true;
+    }
+
+    OfflineDataV1* legacy = malloc(sizeof(OfflineDataV1));
+    File* file = storage_file_alloc(storage);
+    uint32_t segment = 0;
+    bool success = false;
+    if(storage_file_open(file, GAME_DATA_FILE, FSAM_READ, FSOM_OPEN_EXISTING)) {
+        size_t file_size = storage_file_size(file);
+        uint8_t* compressed = malloc(file_size);
+        if(storage_file_read(file, compressed, file_size) == file_size) {
+            // Ältere Snapshots ohne Kopf sind nur der komprimierte Stand
+            size_t offset = 0;
+            OfflineSnapshotHeader header;
+            if(file_size >= sizeof(header)) {
+                memcpy(&header, compressed, sizeof(header));
+                if(header.magic == OFFLINE_SNAPSHOT_MAGIC) {
+                    offset = sizeof(header);
+                    segment = header.segment;
+                }
+            }
+            size_t data_size = sizeof(OfflineDataV1);
+            success = decompress_data(compressed + offset, file_size - offset, legacy, &data_size);
+        }
+        free(compressed);
+    }
+    storage_file_close(file);
+
+    // Bestenliste separat, wenn vorhanden
+    if(success && storage_file_open(file, LEADERBOARD_FILE, FSAM_READ, FSOM_OPEN_EXISTING)) {
+        size_t entries = storage_file_size(file) / sizeof(LeaderboardEntry);
+        if(entries > 0 && entries <= MAX_LEADERBOARD_ENTRIES &&
+           storage_file_read(file, legacy->leaderboard, entries * sizeof(LeaderboardEntry)) ==
+               entries * sizeof(LeaderboardEntry)) {
+            legacy->leaderboard_count = entries;
+        }
+    }
+    storage_file_close(file);
+
+    if(success && storage_file_open(file, OFFLINE_SECTIONS_FILE ".tmp", FSAM_WRITE, FSOM_CREATE_ALWAYS)) {
+        OfflineSectionIndex* index = malloc(sizeof(OfflineSectionIndex));
+        CompressStream* stream = compress_stream_alloc(OFFLINE_SECTIONS_WINDOW);
+        OfflineSectionWriter writer;
+        offline_sections_begin(&writer, file, index, segment, stream);
+        offline_data_add_state(&writer, &legacy->state);
+        offline_data_add_items(&writer, OfflineSectionGames, legacy->games, MIN(legacy->game_count, MAX_OFFLINE_GAMES));
+        offline_data_add_items(&writer, OfflineSectionTags, legacy->tags, MIN(legacy->tag_count, MAX_OFFLINE_TAGS));
+        offline_data_add_items(
+            &writer,
+            OfflineSectionLeaderboard,
+            legacy->leaderboard,
+            MIN(legacy->leaderboard_count, MAX_LEADERBOARD_ENTRIES));
+        offline_data_add_items(
+            &writer, OfflineSectionMessages, legacy->messages, MIN(legacy->message_count, MAX_CACHED_MESSAGES));
+        for(uint32_t i = 0; i < MIN(legacy->map_tile_count, MAX_MAP_TILES); i++) {
+            const MapTile* tile = &legacy->map_tiles[i];
+            offline_sections_add(
+                &writer, OfflineSectionMapTile, OFFLINE_SECTION_VERSION, tile->tile_id, 1, tile, sizeof(MapTile));
+        }
+        success = offline_sections_finish(&writer);
+        storage_file_close(file);
+        compress_stream_free(stream);
+        free(index);
+        if(success) success = offline_data_swap_container(storage);
+    }
+
+    if(success) {
+        storage_common_remove(storage, GAME_DATA_FILE);
+        storage_common_remove(storage, LEADERBOARD_FILE);
+    }
+    storage_file_free(file);
+    free(legacy);
+    return success;
+}
+
+// Läuft im Verdichtungs-Thread: die Daten im RAM ändern sich währenddessen,
+// deshalb Container plus Segmente über eine eigene, leere Instanz
+static bool offline_data_fold(uint32_t segment, void* context) {
+    OfflineData* data = context;
+    Storage* storage = furi_record_open(RECORD_STORAGE);
+    OfflineData* scratch = malloc(sizeof(OfflineData));
+    memset(scratch, 0, sizeof(OfflineData));
+    OfflineSectionIndex* index = malloc(sizeof(OfflineSectionIndex));
+
+    bool success = offline_data_read_index(storage, scratch);
+    if(success) {
+        OfflineTailScan scan;
+        offline_data_scan_tail(storage, scratch, segment, &scan, NULL);
+        success = offline_data_write_container(storage, scratch, segment, &scan, index);
+    }
+    for(uint8_t type = OfflineSectionGames; type <= OfflineSectionMessages; type++) {
+        offline_data_free_list(scratch, type);
+    }
+    for(size_t i = 0; i < OFFLINE_TILE_CACHE; i++) {
+        free(scratch->tile_cache[i]);
+    }
+    compress_stream_free(scratch->stream);
+    free(scratch->index);
+    free(scratch);
+
+    // Lesende Zugriffe halten mutex, sie sehen alten oder neuen Container
+    if(success) {
+        furi_mutex_acquire(offline_log->mutex, FuriWaitForever);
+        success = offline_data_swap_container(storage);
+        if(success) memcpy(data->index, index, sizeof(OfflineSectionIndex));
+        furi_mutex_release(offline_log->mutex);
+    }
+
+    free(index);
+    furi_record_close(RECORD_STORAGE);
+    return success;
+}
+
+static bool offline_data_checkpoint(uint32_t segment, void* context) {
+    OfflineData* data = context;
+    Storage* storage = furi_record_open(RECORD_STORAGE);
+    if(!data->index) {
+        data->index = malloc(sizeof(OfflineSectionIndex));
+        memset(&data->index->header, 0, sizeof(OfflineSectionHeader));
+    }
+
+    // Ausgelagerte Abschnitte können Änderungen nur im Protokoll haben
+    OfflineTailScan scan;
+    offline_data_scan_tail(storage, data, segment, &scan, NULL);
+    OfflineSectionIndex* index = malloc(sizeof(OfflineSectionIndex));
+    bool success = offline_data_write_container(storage, data, segment, &scan, index) &&
+                   offline_data_swap_container(storage);
+    if(success) memcpy(data->index, index, sizeof(OfflineSectionIndex));
+
+    free(index);
+    furi_record_close(RECORD_STORAGE);
+    return success;
+}
 
 bool offline_data_init(OfflineData* data) {
     Storage* storage = furi_record_open(RECORD_STORAGE);
@@ -26,8 +522,22 @@ bool offline_data_init(OfflineData* data) {
     data->last_backup = 0;
     data->needs_sync = false;
     
-    // Gespeicherte Daten laden
-    bool success = offline_data_load(data);
+    // Inhaltsverzeichnis laden; was das Protokoll seitdem geändert hat, wird
+    // nach dem Start des Protokolls geladen und nachgespielt
+    bool success = offline_data_migrate(storage) && offline_data_read_index(storage, data);
+    if(success && !offline_log) {
+        OfflineTailScan scan;
+        OfflineLogStats loaded = {0};
+        uint32_t first = data->index->header.segment;
+        uint32_t next = offline_data_scan_tail(storage, data, UINT32_MAX, &scan, &loaded);
+        OfflineLog* log = offline_log_alloc(OFFLINE_LOG_DIR, first, next, offline_data_fold, data);
+        log->stats.replayed = loaded.replayed;
+        log->stats.torn = loaded.torn;
+        offline_log = log;
+        for(uint8_t type = OfflineSectionGames; type <= OfflineSectionMessages; type++) {
+            if(scan.mask & (1UL << type)) success &= offline_data_page_in(data, type);
+        }
+    }
     
     // Automatisches Backup wenn nötig
     uint32_t now = furi_get_tick();
@@ -39,54 +549,33 @@ bool offline_data_init(OfflineData* data) {
     return success;
 }
 
-bool offline_data_save(OfflineData* data) {
-    Storage* storage = furi_record_open(RECORD_STORAGE);
-    if(!storage) return false;
-    
-    bool success = true;
-    File* file;
-    
-    // Daten komprimieren
-    uint8_t* compressed = malloc(sizeof(OfflineData));
-    size_t compressed_size = 0;
-    
-    if(!compress_data(data, sizeof(OfflineData), compressed, &compressed_size)) {
-        free(compressed);
-        furi_record_close(RECORD_STORAGE);
-        return false;
+void offline_data_close(OfflineData* data) {
+    // Erst freigeben: wartet auf eine laufende Verdichtung, deren
+    // offline_data_fold noch offline_log->mutex braucht
+    offline_log_free(offline_log);
+    offline_log = NULL;
+    
+    for(uint8_t type = OfflineSectionGames; type <= OfflineSectionMessages; type++) {
+        offline_data_free_list(data, type);
     }
-    
-    // Spieldaten speichern
-    file = storage_file_alloc(storage);
-    if(storage_file_open(file, GAME_DATA_FILE, FSAM_WRITE, FSOM_CREATE_ALWAYS)) {
-        success &= storage_file_write(file, compressed, compressed_size) == compressed_size;
+    offline_data_page_out(data, OfflineSectionMapTile);
+    free(data->index);
+    data->index = NULL;
+    compress_stream_free(data->stream);
+    data->stream = NULL;
+}
+
+bool offline_data_save(OfflineData* data) {
+    bool success;
+    if(offline_log) {
+        success = offline_log_checkpoint(offline_log, offline_data_checkpoint, data);
     } else {
-        success = false;
+        // Ohne Protokoll beginnt der Snapshot bei Segment 0
+        success = offline_data_checkpoint(0, data);
     }
-    storage_file_close(file);
-    
-    // Bestenliste separat speichern
-    if(success && data->leaderboard_count > 0) {
-        if(storage_file_open(file, LEADERBOARD_FILE, FSAM_WRITE, FSOM_CREATE_ALWAYS)) {
-            success &= storage_file_write(
-                file,
-                data->leaderboard,
-                sizeof(LeaderboardEntry) * data->leaderboard_count
-            ) == sizeof(LeaderboardEntry) * data->leaderboard_count;
-        } else {
-            success = false;
-        }
-    }
-    storage_file_close(file);
-    
-    storage_file_free(file);
-    free(compressed);
-    furi_record_close(RECORD_STORAGE);
     
     if(success) {
-        NotificationApp* notifications = furi_record_open(RECORD_NOTIFICATION);
-        notification_message(notifications, &sequence_success);
-        furi_record_close(RECORD_NOTIFICATION);
+        notifier_post(NotifySaved);
     }
     
     return success;
@@ -96,76 +585,105 @@ bool offline_data_load(OfflineData* data) {
     Storage* storage = furi_record_open(RECORD_STORAGE);
     if(!storage) return false;
     
-    bool success = true;
-    File* file = storage_file_alloc(storage);
-    
-    // Spieldaten laden
-    if(storage_file_open(file, GAME_DATA_FILE, FSAM_READ, FSOM_OPEN_EXISTING)) {
-        size_t file_size = storage_file_size(file);
-        uint8_t* compressed = malloc(file_size);
-        
-        if(storage_file_read(file, compressed, file_size) == file_size) {
-            size_t data_size = sizeof(OfflineData);
-            success = decompress_data(compressed, file_size, data, &data_size);
-        } else {
-            success = false;
+    bool success = offline_data_migrate(storage) && offline_data_read_index(storage, data);
+    if(success) {
+        OfflineTailScan scan;
+        uint32_t next = offline_data_scan_tail(storage, data, UINT32_MAX, &scan, NULL);
+        for(uint8_t type = OfflineSectionGames; type <= OfflineSectionMessages; type++) {
+            if(scan.mask & (1UL << type)) success &= offline_data_page_list(data, type, next);
         }
-        
-        free(compressed);
-    } else {
-        // Keine gespeicherten Daten - nicht unbedingt ein Fehler
-        memset(data, 0, sizeof(OfflineData));
     }
-    storage_file_close(file);
     
-    // Bestenliste laden wenn vorhanden
-    if(success && storage_file_open(file, LEADERBOARD_FILE, FSAM_READ, FSOM_OPEN_EXISTING)) {
-        size_t entries = storage_file_size(file) / sizeof(LeaderboardEntry);
-        if(entries > 0 && entries <= MAX_LEADERBOARD_ENTRIES) {
-            success = storage_file_read(
-                file,
-                data->leaderboard,
-                entries * sizeof(LeaderboardEntry)
-            ) == entries * sizeof(LeaderboardEntry);
-            data->leaderboard_count = entries;
+    furi_record_close(RECORD_STORAGE);
+    return success;
+}
+
+bool offline_data_page_in(OfflineData* data, OfflineSectionType section) {
+    if(!offline_data_is_list(section)) return false;
+    OfflineLog* log = offline_log;
+    if(log) furi_mutex_acquire(log->mutex, FuriWaitForever);
+    bool success = offline_data_page_list(data, section, UINT32_MAX);
+    if(log) furi_mutex_release(log->mutex);
+    return success;
+}
+
+void offline_data_page_out(OfflineData* data, OfflineSectionType section) {
+    OfflineLog* log = offline_log;
+    if(log) furi_mutex_acquire(log->mutex, FuriWaitForever);
+    if(offline_data_is_list(section)) {
+        offline_data_free_list(data, section);
+    } else if(section == OfflineSectionMapTile) {
+        for(size_t i = 0; i < OFFLINE_TILE_CACHE; i++) {
+            free(data->tile_cache[i]);
+            data->tile_cache[i] = NULL;
+            data->tile_used[i] = 0;
         }
     }
-    storage_file_close(file);
+    if(log) furi_mutex_release(log->mutex);
+}
+
+MapTile* offline_data_get_map_tile(OfflineData* data, uint32_t tile_id) {
+    OfflineLog* log = offline_log;
+    if(log) furi_mutex_acquire(log->mutex, FuriWaitForever);
+    MapTile* tile = offline_data_page_tile(data, tile_id, UINT32_MAX);
+    if(log) furi_mutex_release(log->mutex);
+    return tile;
+}
+
+void offline_data_compact(OfflineData* data) {
+    UNUSED(data);
+    if(offline_log) offline_log_compact(offline_log, true);
+}
+
+bool offline_data_get_log_stats(OfflineLogStats* stats) {
+    if(!offline_log) return false;
+    offline_log_get_stats(offline_log, stats);
+    return true;
+}
+
+// Änderung im Speicher und ihr Datensatz gehören zusammen, siehe
+// OfflineLog.mutex
+static bool offline_data_record(OfflineData* data, OfflineSectionType type, const void* payload, size_t size) {
+    OfflineLog* log = offline_log;
+    if(!log) {
+        return offline_data_apply(data, type, payload, size) && offline_data_save(data);
+    }
+    
+    furi_mutex_acquire(log->mutex, FuriWaitForever);
+    bool success = offline_data_apply(data, type, payload, size) &&
+                   offline_log_append(log, type, payload, size);
+    furi_mutex_release(log->mutex);
+    
+    if(success) {
+        notifier_post(NotifySaved);
+    }
     
-    storage_file_free(file);
-    furi_record_close(RECORD_STORAGE);
     return success;
 }
 
 bool offline_data_backup(OfflineData* data) {
+    // Erst alles in den Container, dann eine Kopie davon
+    if(!offline_data_save(data)) return false;
+    
     Storage* storage = furi_record_open(RECORD_STORAGE);
     if(!storage) return false;
     
     char backup_path[256];
     generate_backup_name(backup_path, sizeof(backup_path));
     
-    bool success = true;
-    File* file = storage_file_alloc(storage);
-    
     // Backup-Verzeichnis erstellen
     storage_mkdir(storage, BACKUP_DIR);
     
-    // Daten komprimieren
-    uint8_t* compressed = malloc(sizeof(OfflineData));
-    size_t compressed_size = 0;
-    
-    if(!compress_data(data, sizeof(OfflineData), compressed, &compressed_size)) {
-        free(compressed);
-        storage_file_free(file);
-        furi_record_close(RECORD_STORAGE);
-        return false;
-    }
+    File* source = storage_file_alloc(storage);
+    File* file = storage_file_alloc(storage);
+    bool success = storage_file_open(source, OFFLINE_SECTIONS_FILE, FSAM_READ, FSOM_OPEN_EXISTING) &&
+                   storage_file_open(file, backup_path, FSAM_WRITE, FSOM_CREATE_ALWAYS);
     
     // Backup schreiben
-    if(storage_file_open(file, backup_path, FSAM_WRITE, FSOM_CREATE_ALWAYS)) {
-        success = storage_file_write(file, compressed, compressed_size) == compressed_size;
-    } else {
-        success = false;
+    uint8_t buffer[OFFLINE_COPY_CHUNK];
+    size_t count;
+    while(success && (count = storage_file_read(source, buffer, sizeof(buffer))) > 0) {
+        success = storage_file_write(file, buffer, count) == count;
     }
     
     if(success) {
@@ -175,9 +693,8 @@ bool offline_data_backup(OfflineData* data) {
         // TODO: Implementiere Backup-Rotation
     }
     
-    storage_file_close(file);
     storage_file_free(file);
-    free(compressed);
+    storage_file_free(source);
     furi_record_close(RECORD_STORAGE);
     
     return success;
@@ -186,107 +703,184 @@ bool offline_data_backup(OfflineData* data) {
 // Implementierung der weiteren Funktionen...
 // Der Code ist zu lang für eine einzelne Nachricht, ich zeige die wichtigsten Teile
 
-bool offline_data_add_game(OfflineData* data, const CachedGame* game) {
-    if(data->game_count >= MAX_OFFLINE_GAMES) {
-        // Ältestes Spiel entfernen wenn Cache voll
-        memmove(
-            &data->games[0],
-            &data->games[1],
-            sizeof(CachedGame) * (MAX_OFFLINE_GAMES - 1)
-        );
-        data->game_count--;
-    }
-    
-    memcpy(&data->games[data->game_count], game, sizeof(CachedGame));
-    data->game_count++;
+// Die Änderungen nur im Speicher, beim Aufruf wie beim Nachspielen. Listen
+// werden dafür geladen; beim Laden selbst sind sie es schon
+static bool offline_data_apply_game(OfflineData* data, const CachedGame* game) {
+    if(!offline_data_page_list(data, OfflineSectionGames, UINT32_MAX)) return false;
+    
+    // Ist der Cache voll, ersetzt es das älteste Spiel
+    item_ring_push(&data->games, game);
     data->needs_sync = true;
     
-    return offline_data_save(data);
+    return true;
 }
 
-bool offline_data_add_tag(OfflineData* data, const CachedTagScan* tag) {
-    if(data->tag_count >= MAX_OFFLINE_TAGS) {
-        // Älteste Tags entfernen wenn Cache voll
-        memmove(
-            &data->tags[0],
-            &data->tags[1],
-            sizeof(CachedTagScan) * (MAX_OFFLINE_TAGS - 1)
-        );
-        data->tag_count--;
-    }
-    
-    memcpy(&data->tags[data->tag_count], tag, sizeof(CachedTagScan));
-    data->tag_count++;
+static bool offline_data_apply_tag(OfflineData* data, const CachedTagScan* tag) {
+    if(!offline_data_page_list(data, OfflineSectionTags, UINT32_MAX)) return false;
+    
+    // Ist der Cache voll, ersetzt er den ältesten Tag
+    item_ring_push(&data->tags, tag);
     data->needs_sync = true;
     
-    return offline_data_save(data);
+    return true;
 }
 
-bool offline_data_update_leaderboard(OfflineData* data, const LeaderboardEntry* entry) {
+void offline_data_write_tag_json(const CachedTagScan* tag, JsonWriter* writer) {
+    json_writer_begin_object(writer);
+    json_writer_add_string(writer, "tag_uid", tag->tag_uid);
+    json_writer_add_string(writer, "game_id", tag->game_id);
+    json_writer_add_uint(writer, "points", tag->points);
+    json_writer_add_uint(writer, "combo", tag->combo);
+    json_writer_add_uint(writer, "timestamp", tag->timestamp);
+    // 0/0 = ohne Position; Festkomma statt Float-printf
+    if(tag->latitude != 0.0f || tag->longitude != 0.0f) {
+        json_writer_key(writer, "latitude");
+        json_writer_fixed(writer, (int32_t)(tag->latitude * 1e7f), 7);
+        json_writer_key(writer, "longitude");
+        json_writer_fixed(writer, (int32_t)(tag->longitude * 1e7f), 7);
+    }
+    json_writer_end_object(writer);
+}
+
+void offline_data_write_game_json(const CachedGame* game, JsonWriter* writer) {
+    json_writer_begin_object(writer);
+    json_writer_add_string(writer, "game_id", game->game_id);
+    json_writer_add_uint(writer, "mode", game->mode);
+    json_writer_add_uint(writer, "duration", game->duration);
+    json_writer_add_uint(writer, "score", game->score);
+    json_writer_add_uint(writer, "tag_count", game->tag_count);
+    json_writer_add_uint(writer, "timestamp", game->timestamp);
+    json_writer_end_object(writer);
+}
+
+static bool pending_flush(const char* data, size_t size, void* context) {
+    return storage_file_write((File*)context, data, size) == size;
+}
+
+bool offline_data_queue_upload(
+    const char* method,
+    const char* url,
+    OfflineBodyWriter body,
+    void* context) {
+    Storage* storage = furi_record_open(RECORD_STORAGE);
+    if(!storage) return false;
+    storage_mkdir(storage, OFFLINE_DATA_DIR);
+
+    bool success = false;
+    File* file = storage_file_alloc(storage);
+    if(storage_file_open(file, PENDING_UPLOAD_FILE, FSAM_WRITE, FSOM_OPEN_APPEND)) {
+        // Der Writer spült unterwegs: nach einem Fehler die halbe Zeile
+        // abschneiden, sonst verdirbt sie auch den nächsten Datensatz
+        uint64_t start = storage_file_size(file);
+        char buffer[128];
+        JsonWriter json;
+        json_writer_init(&json, buffer, sizeof(buffer));
+        json_writer_set_flush(&json, pending_flush, file);
+        json_writer_begin_object(&json);
+        json_writer_add_string(&json, "method", method);
+        json_writer_add_string(&json, "url", url);
+        json_writer_key(&json, "body");
+        body(&json, context);
+        json_writer_end_object(&json);
+        success = json_writer_finish(&json) > 0 && storage_file_write(file, "\n", 1) == 1;
+        if(!success && !(storage_file_seek(file, start, true) && storage_file_truncate(file))) {
+            // Wenigstens die Zeile beenden, der Sync verwirft sie einzeln
+            storage_file_write(file, "\n", 1);
+        }
+    }
+    storage_file_close(file);
+    storage_file_free(file);
+
+    furi_record_close(RECORD_STORAGE);
+    return success;
+}
+
+static bool offline_data_apply_leaderboard(OfflineData* data, const LeaderboardEntry* entry) {
+    if(!offline_data_page_list(data, OfflineSectionLeaderboard, UINT32_MAX)) return false;
+    
     // Existierenden Eintrag suchen und aktualisieren
-    for(uint32_t i = 0; i < data->leaderboard_count; i++) {
-        if(strcmp(data->leaderboard[i].id, entry->id) == 0) {
-            memcpy(&data->leaderboard[i], entry, sizeof(LeaderboardEntry));
-            return offline_data_save(data);
+    for(uint32_t i = 0; i < data->leaderboard.count; i++) {
+        LeaderboardEntry* existing = item_ring_get(&data->leaderboard, i);
+        if(strcmp(existing->id, entry->id) == 0) {
+            memcpy(existing, entry, sizeof(LeaderboardEntry));
+            return true;
         }
     }
     
     // Neuen Eintrag hinzufügen
-    if(data->leaderboard_count < MAX_LEADERBOARD_ENTRIES) {
-        memcpy(
-            &data->leaderboard[data->leaderboard_count],
-            entry,
-            sizeof(LeaderboardEntry)
-        );
-        data->leaderboard_count++;
-        return offline_data_save(data);
+    if(data->leaderboard.count < MAX_LEADERBOARD_ENTRIES) {
+        item_ring_push(&data->leaderboard, entry);
+        return true;
     }
     
     return false;
 }
 
-bool offline_data_add_message(OfflineData* data, const OfflineMessage* message) {
-    if(data->message_count >= MAX_CACHED_MESSAGES) {
-        // Älteste Nachricht entfernen
-        memmove(
-            &data->messages[0],
-            &data->messages[1],
-            sizeof(OfflineMessage) * (MAX_CACHED_MESSAGES - 1)
-        );
-        data->message_count--;
-    }
-    
-    memcpy(&data->messages[data->message_count], message, sizeof(OfflineMessage));
-    data->message_count++;
+static bool offline_data_apply_message(OfflineData* data, const OfflineMessage* message) {
+    if(!offline_data_page_list(data, OfflineSectionMessages, UINT32_MAX)) return false;
+    
+    // Ist der Cache voll, ersetzt sie die älteste Nachricht
+    item_ring_push(&data->messages, message);
     data->needs_sync = true;
     
-    return offline_data_save(data);
+    return true;
 }
 
-bool offline_data_cache_map_tile(OfflineData* data, const MapTile* tile) {
-    // Existierenden Tile aktualisieren
-    for(uint32_t i = 0; i < data->map_tile_count; i++) {
-        if(data->map_tiles[i].tile_id == tile->tile_id) {
-            memcpy(&data->map_tiles[i], tile, sizeof(MapTile));
-            return offline_data_save(data);
-        }
-    }
+// Nur die ID bleibt resident, die Kachel selbst geht in den Cache
+static bool offline_data_apply_map_tile(OfflineData* data, const MapTile* tile) {
+    if(!offline_data_add_tile_id(data, tile->tile_id)) return false;
     
-    // Neuen Tile hinzufügen
-    if(data->map_tile_count < MAX_MAP_TILES) {
-        memcpy(
-            &data->map_tiles[data->map_tile_count],
-            tile,
-            sizeof(MapTile)
-        );
-        data->map_tile_count++;
-        return offline_data_save(data);
+    MapTile* cached = offline_data_cached_tile(data, tile->tile_id);
+    if(!cached) cached = offline_data_tile_slot(data, tile->tile_id);
+    memcpy(cached, tile, sizeof(MapTile));
+    return true;
+}
+
+static bool offline_data_apply(OfflineData* data, uint8_t type, const void* payload, size_t size) {
+    switch(type) {
+    case OfflineSectionGames:
+        return size == sizeof(CachedGame) && offline_data_apply_game(data, payload);
+    case OfflineSectionTags:
+        return size == sizeof(CachedTagScan) && offline_data_apply_tag(data, payload);
+    case OfflineSectionLeaderboard:
+        return size == sizeof(LeaderboardEntry) && offline_data_apply_leaderboard(data, payload);
+    case OfflineSectionMessages:
+        return size == sizeof(OfflineMessage) && offline_data_apply_message(data, payload);
+    case OfflineSectionMapTile:
+        return size == sizeof(MapTile) && offline_data_apply_map_tile(data, payload);
+    default:
+        return false;
     }
-    
-    return false;
+}
+
+bool offline_data_add_game(OfflineData* data, const CachedGame* game) {
+    return offline_data_record(data, OfflineSectionGames, game, sizeof(CachedGame));
+}
+
+bool offline_data_add_tag(OfflineData* data, const CachedTagScan* tag) {
+    return offline_data_record(data, OfflineSectionTags, tag, sizeof(CachedTagScan));
+}
+
+bool offline_data_update_leaderboard(OfflineData* data, const LeaderboardEntry* entry) {
+    return offline_data_record(data, OfflineSectionLeaderboard, entry, sizeof(LeaderboardEntry));
+}
+
+bool offline_data_add_message(OfflineData* data, const OfflineMessage* message) {
+    return offline_data_record(data, OfflineSectionMessages, message, sizeof(OfflineMessage));
+}
+
+bool offline_data_cache_map_tile(OfflineData* data, const MapTile* tile) {
+    return offline_data_record(data, OfflineSectionMapTile, tile, sizeof(MapTile));
 }
 
 // Hilfsfunktionen
+static bool decompress_data(const uint8_t* data, size_t size, void* out, size_t* out_size) {
+    compression_init();
+    bool success = compression_decode(data, size, out, out_size);
+    compression_free();
+    return success;
+}
+
 static bool create_directories(Storage* storage) {
     if(!storage_mkdir(storage, OFFLINE_DATA_DIR)) return false;
     if(!storage_mkdir(storage, BACKUP_DIR)) return false;
@@ -3,6 +3,11 @@
 #include <furi.h>
 #include <storage/storage.h>
 #include "game_state.h"
+#include "offline_storage.h"
+#include "json_writer.h"
+#include "offline_log.h"
+#include "offline_sections.h"
+#include "item_ring.h"
 
 // Datei-Pfade
 #define OFFLINE_DATA_DIR EXT_PATH("apps_data/tagracer")
@@ -12,6 +17,17 @@
 #define MAP_CACHE_FILE OFFLINE_DATA_DIR "/maps.bin"
 #define MESSAGE_FILE OFFLINE_DATA_DIR "/messages.bin"
 #define BACKUP_DIR OFFLINE_DATA_DIR "/backups"
+// Uploads, die bei offenem Circuit Breaker (retry_policy.h) nicht gesendet
+// wurden. Eine JSON-Zeile pro Auftrag: {"method":..,"url":..,"body":{..}}
+// Eine abgebrochene letzte Zeile (Stromausfall) ist beim Einlesen zu überspringen
+#define PENDING_UPLOAD_FILE OFFLINE_DATA_DIR "/pending.jsonl"
+// Snapshot als Container aus Abschnitten (offline_sections.h), dazu die
+// Änderungen seit dem Snapshot (offline_log.h). GAME_DATA_FILE und
+// LEADERBOARD_FILE sind das frühere Format und werden beim ersten Laden
+// übernommen
+#define OFFLINE_SECTIONS_FILE OFFLINE_DATA_DIR "/offline.tgs"
+#define OFFLINE_LOG_DIR OFFLINE_DATA_DIR "/log"
+#define OFFLINE_SNAPSHOT_MAGIC 0x534E4754  // "TGNS", GAME_DATA_FILE mit Segment
 
 // Maximale Anzahl gespeicherter Elemente
 #define MAX_OFFLINE_GAMES 100
@@ -19,6 +35,8 @@
 #define MAX_LEADERBOARD_ENTRIES 100
 #define MAX_CACHED_MESSAGES 500
 #define MAX_MAP_TILES 200
+// Kacheln gleichzeitig im RAM
+#define OFFLINE_TILE_CACHE 4
 
 // Datenstrukturen für Offline-Speicherung
 typedef struct {
@@ -65,27 +83,35 @@ typedef struct {
     bool is_local;
 } OfflineTournament;
 
-// Hauptspeicherstruktur
+// Abschnitte im Container, zugleich Typ der Protokoll-Datensätze, die sie
+// ändern. Neue Typen nur hinten anfügen
+typedef enum {
+    OfflineSectionGames = 1,
+    OfflineSectionTags,
+    OfflineSectionLeaderboard,
+    OfflineSectionMessages,
+    OfflineSectionMapTile,  // Eine pro Kachel, Schlüssel = tile_id
+    OfflineSectionState,    // GPS, Turnier, Status
+} OfflineSectionType;
+
+// Hauptspeicherstruktur. Resident sind nur Zustand, Zähler, Kachel-IDs und
+// das Inhaltsverzeichnis; jede Liste wird erst geladen, wenn ein Aufruf sie
+// braucht (Tags beim Spielen, Nachrichten im Chat), Kacheln einzeln beim
+// Öffnen der Karte
 typedef struct {
-    // Spieldaten
-    uint32_t game_count;
-    CachedGame games[MAX_OFFLINE_GAMES];
+    // Listen, älteste zuerst; volle Ringe verdrängen das älteste Element.
+    // count gilt auch ausgelagert (items == NULL)
+    ItemRing games;        // CachedGame
+    ItemRing tags;         // CachedTagScan
+    ItemRing leaderboard;  // LeaderboardEntry, voll werden neue abgewiesen
+    ItemRing messages;     // OfflineMessage
     
-    // Tag-Daten
-    uint32_t tag_count;
-    CachedTagScan tags[MAX_OFFLINE_TAGS];
-    
-    // Bestenliste
-    uint32_t leaderboard_count;
-    LeaderboardEntry leaderboard[MAX_LEADERBOARD_ENTRIES];
-    
-    // Nachrichten
-    uint32_t message_count;
-    OfflineMessage messages[MAX_CACHED_MESSAGES];
-    
-    // Kartendaten
+    // Kartendaten: IDs aller Kacheln, Inhalt im LRU-Cache
     uint32_t map_tile_count;
-    MapTile map_tiles[MAX_MAP_TILES];
+    uint32_t map_tile_ids[MAX_MAP_TILES];
+    MapTile* tile_cache[OFFLINE_TILE_CACHE];
+    uint32_t tile_used[OFFLINE_TILE_CACHE];
+    uint32_t tile_clock;
     
     // GPS-Cache
     GpsData last_gps;
@@ -97,12 +123,35 @@ typedef struct {
     bool needs_sync;
     uint32_t last_sync;
     uint32_t last_backup;
+    
+    // Inhaltsverzeichnis von OFFLINE_SECTIONS_FILE
+    OfflineSectionIndex* index;
+    // Packt und entpackt die Abschnitte, bleibt bis offline_data_close
+    CompressStream* stream;
 } OfflineData;
 
 // Hauptfunktionen
+// Lädt Inhaltsverzeichnis und Zustand, dazu die Abschnitte, die das
+// Protokoll seit dem Snapshot geändert hat, und startet das Protokoll:
+// danach hängen add_game, add_tag, update_leaderboard, add_message und
+// cache_map_tile nur noch einen Datensatz an, statt alles neu zu schreiben.
+// Ohne init speichern sie wie bisher vollständig
 bool offline_data_init(OfflineData* data);
+// Protokoll beenden und alle geladenen Abschnitte freigeben
+void offline_data_close(OfflineData* data);
+// Vollständiger Snapshot, für Änderungen außerhalb der Funktionen oben
 bool offline_data_save(OfflineData* data);
 bool offline_data_load(OfflineData* data);
+// Abschnitt laden, falls nicht im RAM (nicht OfflineSectionMapTile, siehe
+// offline_data_get_map_tile); false = nicht lesbar
+bool offline_data_page_in(OfflineData* data, OfflineSectionType section);
+// RAM freigeben, Container und Protokoll behalten den Stand. Direkte
+// Änderungen an der Liste vorher mit offline_data_save sichern
+void offline_data_page_out(OfflineData* data, OfflineSectionType section);
+// Geschlossene Segmente sofort in den Snapshot falten
+void offline_data_compact(OfflineData* data);
+// false = kein Protokoll aktiv
+bool offline_data_get_log_stats(OfflineLogStats* stats);
 bool offline_data_backup(OfflineData* data);
 bool offline_data_restore(OfflineData* data, const char* backup_path);
 
@@ -115,6 +164,19 @@ CachedGame* offline_data_get_game(OfflineData* data, const char* game_id);
 bool offline_data_add_tag(OfflineData* data, const CachedTagScan* tag);
 bool offline_data_get_tag_stats(OfflineData* data, const char* game_id, uint32_t* count, uint32_t* points);
 
+// Sync-Bodies für /sync/tag und /sync/game, ohne Heap direkt in den Writer
+void offline_data_write_tag_json(const CachedTagScan* tag, JsonWriter* writer);
+void offline_data_write_game_json(const CachedGame* game, JsonWriter* writer);
+
+// Upload für später ablegen, nur anhängen. body schreibt den Body als
+// JSON-Wert in den Writer, der in kleinen Stücken auf die SD-Karte geht
+typedef void (*OfflineBodyWriter)(JsonWriter* writer, void* context);
+bool offline_data_queue_upload(
+    const char* method,
+    const char* url,
+    OfflineBodyWriter body,
+    void* context);
+
 // Bestenliste
 bool offline_data_update_leaderboard(OfflineData* data, const LeaderboardEntry* entry);
 bool offline_data_get_top_players(OfflineData* data, LeaderboardEntry* entries, uint32_t count);
@@ -126,6 +188,7 @@ bool offline_data_mark_message_read(OfflineData* data, uint32_t message_id);
 
 // Kartendaten
 bool offline_data_cache_map_tile(OfflineData* data, const MapTile* tile);
+// Zeiger in den Kachel-Cache, gültig bis zum nächsten Kachelzugriff
 MapTile* offline_data_get_map_tile(OfflineData* data, uint32_t tile_id);
 bool offline_data_clear_old_tiles(OfflineData* data, uint32_t max_age);
 
@@ -0,0 +1,257 @@
+#include "offline_log.h"
+#include "wire_protocol.h"
+
+#define OFFLINE_LOG_STOP_TOKEN 0xFF
+#define OFFLINE_LOG_MAX_RECORD (OFFLINE_LOG_HEADER_SIZE + OFFLINE_LOG_MAX_PAYLOAD + OFFLINE_LOG_CRC_SIZE)
+
+static void offline_log_path(char* path, size_t path_size, const char* dir, uint32_t segment) {
+    snprintf(path, path_size, "%s/log_%08lX.seg", dir, segment);
+}
+
+// Gelöscht wird aufsteigend. Bricht das ab, bleibt ein lückenloser Rest
+// direkt vor first, den offline_log_alloc findet
+static void offline_log_discard(OfflineLog* log, uint32_t first, uint32_t end) {
+    char path[128];
+    for(uint32_t segment = first; segment < end; segment++) {
+        offline_log_path(path, sizeof(path), log->dir, segment);
+        storage_common_remove(log->storage, path);
+    }
+}
+
+// Aktives Segment schließen; das nächste beginnt nur, wenn es dieses auch
+// als Datei gibt, sonst entstünde eine Lücke, an der das Laden aufhört
+static void offline_log_close_segment(OfflineLog* log) {
+    bool exists = storage_file_is_open(log->file);
+    storage_file_close(log->file);
+    if(exists) {
+        log->segment++;
+        log->segment_size = 0;
+    }
+}
+
+static void offline_log_run_compaction(OfflineLog* log) {
+    furi_mutex_acquire(log->compact_mutex, FuriWaitForever);
+
+    furi_mutex_acquire(log->mutex, FuriWaitForever);
+    uint32_t first = log->first;
+    uint32_t end = log->segment;
+    furi_mutex_release(log->mutex);
+
+    // Nur geschlossene Segmente, das aktive wächst währenddessen weiter
+    if(end > first && log->compact(end, log->context)) {
+        offline_log_discard(log, first, end);
+        furi_mutex_acquire(log->mutex, FuriWaitForever);
+        log->first = end;
+        log->stats.compactions++;
+        furi_mutex_release(log->mutex);
+    }
+
+    furi_mutex_release(log->compact_mutex);
+}
+
+static int32_t offline_log_task(void* context) {
+    OfflineLog* log = context;
+    uint8_t token;
+
+    while(furi_message_queue_get(log->wakeup, &token, FuriWaitForever) == FuriStatusOk) {
+        if(token == OFFLINE_LOG_STOP_TOKEN) break;
+        offline_log_run_compaction(log);
+    }
+
+    return 0;
+}
+
+OfflineLog* offline_log_alloc(
+    const char* dir,
+    uint32_t first,
+    uint32_t segment,
+    OfflineLogCompactCallback compact,
+    void* context) {
+    OfflineLog* log = malloc(sizeof(OfflineLog));
+    memset(log, 0, sizeof(OfflineLog));
+    log->mutex = furi_mutex_alloc(FuriMutexTypeRecursive);
+    log->compact_mutex = furi_mutex_alloc(FuriMutexTypeNormal);
+    log->dir = dir;
+    log->storage = furi_record_open(RECORD_STORAGE);
+    log->file = storage_file_alloc(log->storage);
+    log->first = first;
+    log->segment = segment;
+    log->record = malloc(OFFLINE_LOG_MAX_RECORD);
+    log->compact = compact;
+    log->context = context;
+    storage_mkdir(log->storage, dir);
+
+    // Rest einer abgebrochenen Löschung, schon im Snapshot enthalten
+    char path[128];
+    for(uint32_t orphan = first; orphan > 0; orphan--) {
+        offline_log_path(path, sizeof(path), dir, orphan - 1);
+        if(storage_common_remove(log->storage, path) != FSE_OK) break;
+    }
+
+    // Ein Token genügt, mehrere Anstöße fassen sich zu einem Lauf zusammen
+    log->wakeup = furi_message_queue_alloc(2, sizeof(uint8_t));
+    log->thread = furi_thread_alloc();
+    furi_thread_set_name(log->thread, "OfflineLogCompact");
+    furi_thread_set_stack_size(log->thread, 2048);
+    furi_thread_set_context(log->thread, log);
+    furi_thread_set_callback(log->thread, offline_log_task);
+    furi_thread_start(log->thread);
+
+    if(segment - first >= OFFLINE_LOG_COMPACT_SEGMENTS) offline_log_compact(log, false);
+    return log;
+}
+
+void offline_log_free(OfflineLog* log) {
+    if(!log) return;
+
+    uint8_t token = OFFLINE_LOG_STOP_TOKEN;
+    furi_message_queue_put(log->wakeup, &token, FuriWaitForever);
+    furi_thread_join(log->thread);
+    furi_thread_free(log->thread);
+    furi_message_queue_free(log->wakeup);
+
+    storage_file_free(log->file);
+    furi_record_close(RECORD_STORAGE);
+    furi_mutex_free(log->compact_mutex);
+    furi_mutex_free(log->mutex);
+    free(log->record);
+    free(log);
+}
+
+bool offline_log_append(OfflineLog* log, uint8_t type, const void* payload, size_t size) {
+    if(type == 0 || size > OFFLINE_LOG_MAX_PAYLOAD) return false;
+
+    furi_mutex_acquire(log->mutex, FuriWaitForever);
+
+    // Ein Schreibaufruf pro Datensatz, die CRC erkennt halbe
+    uint8_t* record = log->record;
+    record[0] = type;
+    record[1] = size & 0xFF;
+    record[2] = size >> 8;
+    memcpy(record + OFFLINE_LOG_HEADER_SIZE, payload, size);
+    size_t length = OFFLINE_LOG_HEADER_SIZE + size;
+    uint16_t crc = wire_crc16(0xFFFF, record, length);
+    record[length++] = crc & 0xFF;
+    record[length++] = crc >> 8;
+
+    bool success = false;
+    if(!storage_file_is_open(log->file)) {
+        char path[128];
+        offline_log_path(path, sizeof(path), log->dir, log->segment);
+        if(storage_file_open(log->file, path, FSAM_WRITE, FSOM_OPEN_APPEND)) {
+            log->stats.segments++;
+        }
+    }
+    if(storage_file_is_open(log->file)) {
+        success = storage_file_write(log->file, record, length) == length &&
+                  storage_file_sync(log->file);
+        log->segment_size += length;
+    }
+
+    if(success) {
+        log->stats.appended++;
+        log->stats.bytes += length;
+    } else {
+        // Hinter einem halben Datensatz würde nichts mehr gelesen
+        log->stats.failed++;
+        offline_log_close_segment(log);
+    }
+
+    if(log->segment_size >= OFFLINE_LOG_SEGMENT_SIZE) {
+        offline_log_close_segment(log);
+        if(log->segment - log->first >= OFFLINE_LOG_COMPACT_SEGMENTS) offline_log_compact(log, false);
+    }
+
+    furi_mutex_release(log->mutex);
+    return success;
+}
+
+bool offline_log_checkpoint(OfflineLog* log, OfflineLogCheckpointCallback checkpoint, void* context) {
+    furi_mutex_acquire(log->compact_mutex, FuriWaitForever);
+    furi_mutex_acquire(log->mutex, FuriWaitForever);
+
+    offline_log_close_segment(log);
+    uint32_t first = log->first;
+    uint32_t end = log->segment;
+    bool success = checkpoint(end, context);
+    if(success) {
+        log->first = end;
+        log->stats.checkpoints++;
+    }
+
+    furi_mutex_release(log->mutex);
+    if(success) offline_log_discard(log, first, end);
+    furi_mutex_release(log->compact_mutex);
+    return success;
+}
+
+void offline_log_compact(OfflineLog* log, bool wait) {
+    if(wait) {
+        offline_log_run_compaction(log);
+        return;
+    }
+    uint8_t token = 0;
+    furi_message_queue_put(log->wakeup, &token, 0);
+}
+
+void offline_log_get_stats(OfflineLog* log, OfflineLogStats* stats) {
+    furi_mutex_acquire(log->mutex, FuriWaitForever);
+    *stats = log->stats;
+    furi_mutex_release(log->mutex);
+}
+
+void offline_log_read(OfflineLog* log, uint32_t segment, OfflineLogReplayCallback replay, void* context) {
+    furi_mutex_acquire(log->mutex, FuriWaitForever);
+    storage_file_close(log->file);
+    offline_log_replay(log->storage, log->dir, segment, log->segment + 1, replay, context, NULL);
+    furi_mutex_release(log->mutex);
+}
+
+uint32_t offline_log_replay(
+    Storage* storage,
+    const char* dir,
+    uint32_t segment,
+    uint32_t end,
+    OfflineLogReplayCallback replay,
+    void* context,
+    OfflineLogStats* stats) {
+    // Nutzdaten ohne Kopf am Anfang des Puffers, damit der Callback sie
+    // ausgerichtet als Struktur lesen kann (der Kopf hat nur 3 Bytes)
+    uint8_t* record = malloc(OFFLINE_LOG_MAX_PAYLOAD + OFFLINE_LOG_CRC_SIZE);
+    uint8_t header[OFFLINE_LOG_HEADER_SIZE];
+    File* file = storage_file_alloc(storage);
+    char path[128];
+
+    for(; segment < end; segment++) {
+        offline_log_path(path, sizeof(path), dir, segment);
+        if(!storage_file_open(file, path, FSAM_READ, FSOM_OPEN_EXISTING)) break;
+
+        while(true) {
+            size_t read = storage_file_read(file, header, OFFLINE_LOG_HEADER_SIZE);
+            if(read == 0) break;
+
+            // Alles ab dem ersten unvollständigen oder falschen Datensatz verwerfen
+            size_t size = header[1] | (header[2] << 8);
+            size_t rest = size + OFFLINE_LOG_CRC_SIZE;
+            bool valid = read == OFFLINE_LOG_HEADER_SIZE && header[0] != 0 &&
+                         size <= OFFLINE_LOG_MAX_PAYLOAD &&
+                         storage_file_read(file, record, rest) == rest;
+            if(valid) {
+                uint16_t crc = wire_crc16(wire_crc16(0xFFFF, header, OFFLINE_LOG_HEADER_SIZE), record, size);
+                valid = record[size] == (crc & 0xFF) && record[size + 1] == (crc >> 8);
+            }
+            if(!valid) {
+                if(stats) stats->torn++;
+                break;
+            }
+
+            replay(header[0], record, size, context);
+            if(stats) stats->replayed++;
+        }
+        storage_file_close(file);
+    }
+
+    storage_file_free(file);
+    free(record);
+    return segment;
+}
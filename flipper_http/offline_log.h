@@ -0,0 +1,104 @@
+#pragma once
+
+#include <furi.h>
+#include <storage/storage.h>
+
+// Append-only-Protokoll für Änderungen an den Offline-Daten. Statt bei jedem
+// Ereignis den ganzen Stand neu zu schreiben, wird ein kleiner Datensatz an
+// das aktive Segment "<dir>/log_<n>.seg" gehängt:
+//
+//   Typ (1) | Länge (2) | Nutzdaten | CRC-16 (2)
+//
+// Länge Little Endian, CRC-16 wie im Leitungsprotokoll (wire_crc16) über Typ,
+// Länge und Nutzdaten. Typ 0 ist ungültig, damit gelöschte oder
+// vorbelegte Bereiche nicht als Datensatz durchgehen.
+//
+// Segmente sind fortlaufend nummeriert. Ist das aktive voll, beginnt das
+// nächste; sind genug Segmente geschlossen, faltet ein Hintergrund-Thread sie
+// über den compact-Callback in den Snapshot und löscht sie. Der Snapshot
+// merkt sich das erste nicht enthaltene Segment, beim Laden werden ab dort
+// alle Segmente bis zum ersten fehlenden nachgespielt. Ein abgerissener
+// Datensatz (Stromausfall) beendet sein Segment, das nächste gilt wieder.
+
+#define OFFLINE_LOG_HEADER_SIZE 3
+#define OFFLINE_LOG_CRC_SIZE 2
+#define OFFLINE_LOG_MAX_PAYLOAD 4608  // MapTile mit Kopf
+#define OFFLINE_LOG_SEGMENT_SIZE (32 * 1024)
+#define OFFLINE_LOG_COMPACT_SEGMENTS 8  // Geschlossene Segmente bis zur Verdichtung
+
+// Alle Segmente vor segment in den Snapshot übernehmen.
+// true = geschrieben, die Segmente dürfen weg
+typedef bool (*OfflineLogCompactCallback)(uint32_t segment, void* context);
+// Den Stand bis einschließlich des zuletzt angehängten Datensatzes als
+// Snapshot schreiben, der ab segment fortgesetzt wird
+typedef bool (*OfflineLogCheckpointCallback)(uint32_t segment, void* context);
+// payload ist wie malloc ausgerichtet und darf als Struktur gelesen werden
+typedef void (*OfflineLogReplayCallback)(uint8_t type, const uint8_t* payload, size_t size, void* context);
+
+typedef struct {
+    uint32_t appended;     // Datensätze
+    uint64_t bytes;        // Davon geschrieben, mit Kopf und CRC
+    uint32_t failed;       // Schreibfehler
+    uint32_t segments;     // Begonnene Segmente
+    uint32_t compactions;  // Im Hintergrund
+    uint32_t checkpoints;  // offline_log_checkpoint
+    uint32_t replayed;     // Beim Laden nachgespielt
+    uint32_t torn;         // Beim Laden verworfene Segment-Enden
+} OfflineLogStats;
+
+typedef struct {
+    // Schreibende Threads halten ihn um Änderung im Speicher und Anhängen,
+    // damit ein Checkpoint nie eine Änderung ohne ihren Datensatz sieht
+    FuriMutex* mutex;
+    // Verdichtung und Checkpoint nacheinander; vor mutex nehmen
+    FuriMutex* compact_mutex;
+    const char* dir;
+    Storage* storage;
+    File* file;             // Aktives Segment, erst beim ersten Datensatz offen
+    uint32_t first;         // Ältestes noch nicht verdichtetes Segment
+    uint32_t segment;       // Aktives Segment
+    uint32_t segment_size;  // Bytes im aktiven Segment
+    uint8_t* record;        // Kopf, Nutzdaten und CRC für einen Schreibaufruf
+
+    OfflineLogCompactCallback compact;
+    void* context;
+    FuriThread* thread;
+    FuriMessageQueue* wakeup;
+    OfflineLogStats stats;
+} OfflineLog;
+
+// first = erstes Segment nach dem Snapshot, segment = erstes freies
+// (Rückgabe von offline_log_replay). Neue Datensätze gehen nie in ein
+// altes Segment, dessen Ende abgerissen sein könnte
+OfflineLog* offline_log_alloc(
+    const char* dir,
+    uint32_t first,
+    uint32_t segment,
+    OfflineLogCompactCallback compact,
+    void* context);
+// Wartet eine laufende Verdichtung ab, verdichtet aber nicht mehr
+void offline_log_free(OfflineLog* log);
+
+bool offline_log_append(OfflineLog* log, uint8_t type, const void* payload, size_t size);
+// Vollständiger Snapshot aus dem Speicher: aktives Segment schließen,
+// checkpoint unter mutex aufrufen, danach alle älteren Segmente löschen
+bool offline_log_checkpoint(OfflineLog* log, OfflineLogCheckpointCallback checkpoint, void* context);
+// Verdichtung anstoßen (wait = false) oder sofort im Aufrufer ausführen
+void offline_log_compact(OfflineLog* log, bool wait);
+void offline_log_get_stats(OfflineLog* log, OfflineLogStats* stats);
+
+// Wie offline_log_replay über die eigenen Segmente ab segment bis zum
+// aktiven, unter mutex. Das aktive Segment wird dafür geschlossen und beim
+// nächsten Datensatz wieder zum Anhängen geöffnet
+void offline_log_read(OfflineLog* log, uint32_t segment, OfflineLogReplayCallback replay, void* context);
+
+// Segmente ab segment bis vor end (oder bis zum ersten fehlenden) abspielen.
+// Liefert das erste nicht vorhandene Segment; stats darf NULL sein
+uint32_t offline_log_replay(
+    Storage* storage,
+    const char* dir,
+    uint32_t segment,
+    uint32_t end,
+    OfflineLogReplayCallback replay,
+    void* context,
+    OfflineLogStats* stats);
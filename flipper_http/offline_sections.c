@@ -0,0 +1,151 @@
+#include "offline_sections.h"
+#include <toolbox/compression.h>
+#include "wire_protocol.h"
+
+#define OFFLINE_SECTIONS_COPY_CHUNK 256
+
+bool offline_sections_read_index(File* file, OfflineSectionIndex* index) {
+    memset(&index->header, 0, sizeof(OfflineSectionHeader));
+    OfflineSectionHeader header;
+    if(!storage_file_seek(file, 0, true) ||
+       storage_file_read(file, &header, sizeof(header)) != sizeof(header)) {
+        return false;
+    }
+    if(header.magic != OFFLINE_SECTIONS_MAGIC || header.version != OFFLINE_SECTIONS_VERSION ||
+       header.count > OFFLINE_SECTIONS_MAX) {
+        return false;
+    }
+
+    size_t size = header.count * sizeof(OfflineSectionEntry);
+    if(!storage_file_seek(file, header.index_offset, true) ||
+       storage_file_read(file, index->entries, size) != size) {
+        return false;
+    }
+    index->header = header;
+    return true;
+}
+
+const OfflineSectionEntry* offline_sections_find(const OfflineSectionIndex* index, uint8_t type, uint32_t key) {
+    for(size_t i = 0; i < index->header.count; i++) {
+        const OfflineSectionEntry* entry = &index->entries[i];
+        if(entry->type == type && entry->key == key) return entry;
+    }
+    return NULL;
+}
+
+bool offline_sections_read(File* file, const OfflineSectionEntry* entry, void* out, CompressStream* stream) {
+    if(!storage_file_seek(file, entry->offset, true)) return false;
+
+    if(entry->flags & OFFLINE_SECTION_BLOCKS) {
+        compress_stream_open_file(stream, file, entry->stored);
+        return compress_stream_read(stream, out, entry->size) == entry->size && stream->ok &&
+               stream->left == 0 && stream->crc == entry->crc;
+    }
+
+    // Ältere Container: am Stück gepackt über einen Puffer, sonst roh
+    if(!(entry->flags & OFFLINE_SECTION_COMPRESSED) && entry->stored != entry->size) return false;
+    uint8_t* stored = (entry->flags & OFFLINE_SECTION_COMPRESSED) ? malloc(entry->stored) : out;
+    bool success = storage_file_read(file, stored, entry->stored) == entry->stored &&
+                   wire_crc16(0xFFFF, stored, entry->stored) == entry->crc;
+    if(success && stored != out) {
+        size_t size = entry->size;
+        compression_init();
+        success = compression_decode(stored, entry->stored, out, &size) && size == entry->size;
+        compression_free();
+    }
+    if(stored != out) free(stored);
+    return success;
+}
+
+void offline_sections_begin(
+    OfflineSectionWriter* writer,
+    File* file,
+    OfflineSectionIndex* index,
+    uint32_t segment,
+    CompressStream* stream) {
+    memset(index, 0, sizeof(OfflineSectionHeader));
+    index->header.magic = OFFLINE_SECTIONS_MAGIC;
+    index->header.version = OFFLINE_SECTIONS_VERSION;
+    index->header.segment = segment;
+    writer->file = file;
+    writer->index = index;
+    writer->stream = stream;
+    writer->offset = sizeof(OfflineSectionHeader);
+    // Platzhalter, finish schreibt den Kopf mit dem Inhaltsverzeichnis neu
+    writer->ok = storage_file_write(file, &index->header, sizeof(OfflineSectionHeader)) ==
+                 sizeof(OfflineSectionHeader);
+}
+
+static OfflineSectionEntry* offline_sections_entry(OfflineSectionWriter* writer, uint8_t type, uint32_t key) {
+    OfflineSectionEntry* entry = (OfflineSectionEntry*)offline_sections_find(writer->index, type, key);
+    if(entry) return entry;
+    if(writer->index->header.count == OFFLINE_SECTIONS_MAX) {
+        writer->ok = false;
+        return NULL;
+    }
+    entry = &writer->index->entries[writer->index->header.count++];
+    memset(entry, 0, sizeof(OfflineSectionEntry));
+    entry->type = type;
+    entry->key = key;
+    return entry;
+}
+
+void offline_sections_add(
+    OfflineSectionWriter* writer,
+    uint8_t type,
+    uint8_t version,
+    uint32_t key,
+    uint32_t count,
+    const void* data,
+    size_t size) {
+    if(!writer->ok) return;
+    // Ersetzt: die alten Bytes bleiben bis zum nächsten Schreiben als Lücke
+    OfflineSectionEntry* entry = offline_sections_entry(writer, type, key);
+    if(!entry) return;
+
+    // Direkt in die Datei, blockweise über das Fenster des Stroms
+    CompressStream* stream = writer->stream;
+    compress_stream_begin_file(stream, writer->file);
+    writer->ok = compress_stream_write(stream, data, size) && compress_stream_finish(stream);
+
+    entry->version = version;
+    entry->flags = OFFLINE_SECTION_BLOCKS;
+    entry->count = count;
+    entry->offset = writer->offset;
+    entry->stored = stream->out;
+    entry->size = size;
+    entry->crc = stream->crc;
+    writer->offset += stream->out;
+}
+
+void offline_sections_copy(OfflineSectionWriter* writer, File* from, const OfflineSectionEntry* entry) {
+    if(!writer->ok) return;
+    OfflineSectionEntry copy = *entry;
+    OfflineSectionEntry* target = offline_sections_entry(writer, entry->type, entry->key);
+    if(!target) return;
+
+    uint8_t buffer[OFFLINE_SECTIONS_COPY_CHUNK];
+    bool success = storage_file_seek(from, entry->offset, true);
+    for(uint32_t left = entry->stored; success && left > 0;) {
+        size_t chunk = MIN(left, sizeof(buffer));
+        success = storage_file_read(from, buffer, chunk) == chunk &&
+                  storage_file_write(writer->file, buffer, chunk) == chunk;
+        left -= chunk;
+    }
+
+    *target = copy;
+    target->offset = writer->offset;
+    writer->offset += entry->stored;
+    writer->ok = success;
+}
+
+bool offline_sections_finish(OfflineSectionWriter* writer) {
+    if(!writer->ok) return false;
+    OfflineSectionHeader* header = &writer->index->header;
+    size_t size = header->count * sizeof(OfflineSectionEntry);
+    header->index_offset = writer->offset;
+    return storage_file_write(writer->file, writer->index->entries, size) == size &&
+           storage_file_seek(writer->file, 0, true) &&
+           storage_file_write(writer->file, header, sizeof(OfflineSectionHeader)) ==
+               sizeof(OfflineSectionHeader);
+}
@@ -0,0 +1,88 @@
+#pragma once
+
+#include <furi.h>
+#include <storage/storage.h>
+#include "compress_stream.h"
+
+// Container aus unabhängig ladbaren Abschnitten für die Offline-Daten:
+//
+//   Kopf | Abschnitt | Abschnitt | ... | Inhaltsverzeichnis
+//
+// Der Kopf nennt Anzahl und Lage des Inhaltsverzeichnisses, jeder Eintrag
+// Typ, Layout-Version, Schlüssel (Kachel-ID, sonst 0), Elementzahl, Lage,
+// Größe und CRC-16 (wire_crc16) eines Abschnitts. Abschnitte werden über
+// einen CompressStream in Blöcken gepackt geschrieben und gelesen, ohne
+// Puffer in Abschnittsgröße. Geschrieben wird einmal
+// von vorn nach hinten in eine neue Datei; unveränderte Abschnitte werden
+// dabei unverändert aus dem alten Container kopiert.
+
+#define OFFLINE_SECTIONS_MAGIC 0x43534754  // "TGSC"
+#define OFFLINE_SECTIONS_VERSION 1
+#define OFFLINE_SECTIONS_MAX 224  // Feste Abschnitte plus eine pro Kachel
+
+// Fenster des CompressStream, den Lesen und Schreiben brauchen
+#define OFFLINE_SECTIONS_WINDOW 1024
+
+#define OFFLINE_SECTION_COMPRESSED (1 << 0)  // Am Stück gepackt, nur noch gelesen
+#define OFFLINE_SECTION_BLOCKS (1 << 1)      // Blöcke aus compress_stream
+
+typedef struct {
+    uint32_t magic;
+    uint16_t version;
+    uint16_t count;      // Einträge im Inhaltsverzeichnis
+    uint32_t segment;    // Erstes Protokollsegment, das nicht enthalten ist
+    uint32_t index_offset;
+} OfflineSectionHeader;
+
+typedef struct {
+    uint8_t type;
+    uint8_t version;     // Layout des Inhalts, vom Besitzer vergeben
+    uint16_t flags;
+    uint32_t key;
+    uint32_t count;      // Elemente, ohne den Abschnitt zu laden
+    uint32_t offset;     // Ab Dateianfang
+    uint32_t stored;     // Bytes in der Datei
+    uint32_t size;       // Entpackt
+    uint16_t crc;        // Über die gespeicherten Bytes
+} OfflineSectionEntry;
+
+// Bleibt im RAM, damit jeder Abschnitt mit einem Seek erreichbar ist
+typedef struct {
+    OfflineSectionHeader header;
+    OfflineSectionEntry entries[OFFLINE_SECTIONS_MAX];
+} OfflineSectionIndex;
+
+typedef struct {
+    File* file;
+    OfflineSectionIndex* index;
+    CompressStream* stream;
+    uint32_t offset;
+    bool ok;  // false nach dem ersten Fehler, finish schlägt dann fehl
+} OfflineSectionWriter;
+
+// false = keine oder beschädigte Datei, index ist dann leer
+bool offline_sections_read_index(File* file, OfflineSectionIndex* index);
+// NULL = kein solcher Abschnitt
+const OfflineSectionEntry* offline_sections_find(const OfflineSectionIndex* index, uint8_t type, uint32_t key);
+// Prüfen und entpacken; out fasst entry->size Bytes
+bool offline_sections_read(File* file, const OfflineSectionEntry* entry, void* out, CompressStream* stream);
+
+void offline_sections_begin(
+    OfflineSectionWriter* writer,
+    File* file,
+    OfflineSectionIndex* index,
+    uint32_t segment,
+    CompressStream* stream);
+// Ein vorhandener Eintrag mit Typ und Schlüssel wird ersetzt
+void offline_sections_add(
+    OfflineSectionWriter* writer,
+    uint8_t type,
+    uint8_t version,
+    uint32_t key,
+    uint32_t count,
+    const void* data,
+    size_t size);
+// Abschnitt unverändert aus einem anderen Container übernehmen
+void offline_sections_copy(OfflineSectionWriter* writer, File* from, const OfflineSectionEntry* entry);
+// Inhaltsverzeichnis und Kopf schreiben
+bool offline_sections_finish(OfflineSectionWriter* writer);
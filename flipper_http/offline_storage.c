@@ -1,139 +1,245 @@
 #include "offline_storage.h"
 #include <furi_hal_rtc.h>
 #include <storage/storage.h>
-#include <toolbox/compression.h>
 
 #define STORAGE_FOLDER "/ext/tagracer"
-#define CACHE_SIZE 8192
-#define COMPRESSION_LEVEL 9
+#define STORAGE_NO_FILE OFFLINE_STORAGE_FILES
+
+typedef struct {
+    char path[128];
+    File* file;          // NULL = Platz frei
+    uint32_t size;       // Mit noch nicht zurückgeschriebenen Seiten
+    uint32_t disk_size;  // Davon schon auf der Karte
+    uint32_t next_page;  // Erwartete Seite beim fortlaufenden Lesen
+    uint32_t used;
+} StorageFile;
 
-// Optimierter Speicher-Cache
 typedef struct {
     uint8_t* data;
-    size_t size;
-    size_t capacity;
+    uint32_t index;  // Seitennummer in der Datei
+    uint16_t valid;  // Bytes ab Seitenanfang, die zur Datei gehören
+    uint8_t file;    // Platz in files, STORAGE_NO_FILE = Seite frei
     bool dirty;
-    uint32_t last_access;
-} StorageCache;
+    uint32_t used;
+} StoragePage;
 
 typedef struct {
     Storage* storage;
-    StorageCache cache;
     FuriMutex* mutex;
-    char current_file[256];
+    uint8_t* arena;
+    StorageFile files[OFFLINE_STORAGE_FILES];
+    StoragePage pages[OFFLINE_STORAGE_PAGES];
+    uint32_t clock;
+    OfflineStorageStats stats;
 } StorageManager;
 
 static StorageManager* storage = NULL;
 
-// Optimierte Kompression
-static bool compress_data(const void* data, size_t size, void* compressed, size_t* compressed_size) {
-    // DEFLATE mit optimiertem Dictionary
-    compression_init();
-    
-    bool success = compression_encode(
-        data,
-        size,
-        compressed,
-        compressed_size,
-        COMPRESSION_LEVEL
-    );
-    
-    compression_free();
+// Seiten-Cache
+
+// Lücke vom Ende auf der Karte bis offset mit Nullen füllen. Ein Seek
+// hinter das Ende ließe sonst undefinierten Inhalt stehen
+static bool file_fill_gap(StorageFile* slot, uint32_t offset) {
+    static const uint8_t zeros[64] = {0};
+    if(slot->disk_size >= offset) return true;
+    if(!storage_file_seek(slot->file, slot->disk_size, true)) return false;
+    while(slot->disk_size < offset) {
+        size_t chunk = MIN(sizeof(zeros), offset - slot->disk_size);
+        if(storage_file_write(slot->file, zeros, chunk) != chunk) return false;
+        slot->disk_size += chunk;
+    }
+    return true;
+}
+
+// Bis zum Dateiende gehört die ganze Seite zur Datei, auch hinter valid
+// (dort Nullen), sobald dahinter schon geschrieben wurde
+static bool page_write_back(StorageManager* manager, StoragePage* page) {
+    if(!page->dirty) return true;
+    StorageFile* slot = &manager->files[page->file];
+    uint32_t start = page->index * OFFLINE_STORAGE_PAGE_SIZE;
+    size_t length = MIN((uint32_t)OFFLINE_STORAGE_PAGE_SIZE, slot->size - start);
+    bool success = file_fill_gap(slot, start) && storage_file_seek(slot->file, start, true) &&
+                   storage_file_write(slot->file, page->data, length) == length;
+    if(success) {
+        slot->disk_size = MAX(slot->disk_size, start + length);
+        page->dirty = false;
+        manager->stats.writebacks++;
+    }
     return success;
 }
 
-static bool decompress_data(const void* compressed, size_t compressed_size, void* data, size_t* size) {
-    compression_init();
-    
-    bool success = compression_decode(
-        compressed,
-        compressed_size,
-        data,
-        size
-    );
-    
-    compression_free();
+// Geänderte Seiten einer Datei von from bis einschließlich to
+// aufsteigend zurückschreiben, damit die Karte fortlaufend beschrieben wird
+// und keine Seite vor einer davorliegenden hinter dem Dateiende landet
+static bool file_write_back(StorageManager* manager, uint8_t file, uint32_t from, uint32_t to) {
+    bool success = true;
+    while(true) {
+        StoragePage* first = NULL;
+        for(size_t i = 0; i < OFFLINE_STORAGE_PAGES; i++) {
+            StoragePage* page = &manager->pages[i];
+            if(page->file == file && page->dirty && page->index >= from && page->index <= to &&
+               (!first || page->index < first->index)) {
+                first = page;
+            }
+        }
+        if(!first) break;
+        if(!page_write_back(manager, first)) {
+            // Bleibt geändert im Cache, nächster Versuch beim nächsten Flush
+            success = false;
+            first->used = ++manager->clock;
+            break;
+        }
+    }
     return success;
 }
 
-// Cache-Management
-static bool cache_init(StorageCache* cache) {
-    cache->data = malloc(CACHE_SIZE);
-    if(!cache->data) return false;
-    
-    cache->capacity = CACHE_SIZE;
-    cache->size = 0;
-    cache->dirty = false;
-    cache->last_access = 0;
-    
-    return true;
+// Alles Geänderte einer Datei auf die Karte und synchronisieren
+static bool file_flush(StorageManager* manager, uint8_t file) {
+    return file_write_back(manager, file, 0, UINT32_MAX) && storage_file_sync(manager->files[file].file);
 }
 
-static void cache_free(StorageCache* cache) {
-    if(cache->data) {
-        free(cache->data);
-        cache->data = NULL;
+static StoragePage* page_find(StorageManager* manager, uint8_t file, uint32_t index) {
+    for(size_t i = 0; i < OFFLINE_STORAGE_PAGES; i++) {
+        StoragePage* page = &manager->pages[i];
+        if(page->file == file && page->index == index) return page;
     }
+    return NULL;
 }
 
-static bool cache_flush(StorageManager* manager) {
-    if(!manager->cache.dirty) return true;
-    
-    File* file = storage_file_alloc(manager->storage);
-    if(!storage_file_open(file, manager->current_file,
-                         FSAM_WRITE, FSOM_OPEN_EXISTING)) {
-        storage_file_free(file);
-        return false;
+// Freie oder am längsten nicht benutzte Seite; eine geänderte wird vorher
+// zurückgeschrieben. Liegt sie hinter dem Ende auf der Karte, zuerst die
+// geänderten Seiten dazwischen. NULL = Schreibfehler, die Seite bleibt
+// dann im Cache
+static StoragePage* page_victim(StorageManager* manager) {
+    StoragePage* victim = &manager->pages[0];
+    for(size_t i = 0; i < OFFLINE_STORAGE_PAGES; i++) {
+        StoragePage* page = &manager->pages[i];
+        if(page->file == STORAGE_NO_FILE) return page;
+        if((int32_t)(page->used - victim->used) < 0) victim = page;
     }
-    
-    // Daten komprimieren
-    size_t compressed_size = manager->cache.size * 2; // Worst case
-    void* compressed = malloc(compressed_size);
-    if(!compressed) {
-        storage_file_free(file);
-        return false;
+    uint32_t disk_page = manager->files[victim->file].disk_size / OFFLINE_STORAGE_PAGE_SIZE;
+    if(victim->dirty && !file_write_back(manager, victim->file, MIN(disk_page, victim->index), victim->index)) {
+        return NULL;
     }
-    
-    bool success = compress_data(
-        manager->cache.data,
-        manager->cache.size,
-        compressed,
-        &compressed_size
-    );
-    
-    if(success) {
-        success = storage_file_write(
-            file,
-            compressed,
-            compressed_size
-        ) == compressed_size;
+    victim->file = STORAGE_NO_FILE;
+    manager->stats.evictions++;
+    return victim;
+}
+
+// Seite belegen; fill = vorhandenen Inhalt von der Karte lesen
+static StoragePage* page_load(StorageManager* manager, uint8_t file, uint32_t index, bool fill) {
+    StoragePage* page = page_victim(manager);
+    if(!page) return NULL;
+
+    size_t valid = 0;
+    File* handle = manager->files[file].file;
+    if(fill && storage_file_seek(handle, index * OFFLINE_STORAGE_PAGE_SIZE, true)) {
+        valid = storage_file_read(handle, page->data, OFFLINE_STORAGE_PAGE_SIZE);
     }
-    
-    free(compressed);
-    storage_file_close(file);
-    storage_file_free(file);
-    
-    if(success) {
-        manager->cache.dirty = false;
+    memset(page->data + valid, 0, OFFLINE_STORAGE_PAGE_SIZE - valid);
+
+    page->file = file;
+    page->index = index;
+    page->valid = valid;
+    page->dirty = false;
+    page->used = ++manager->clock;
+    return page;
+}
+
+static StoragePage* page_get(StorageManager* manager, uint8_t file, uint32_t index, bool fill) {
+    StoragePage* page = page_find(manager, file, index);
+    if(page) {
+        page->used = ++manager->clock;
+        manager->stats.hits++;
+        return page;
     }
-    
-    return success;
+    manager->stats.misses++;
+    return page_load(manager, file, index, fill);
+}
+
+// Folgeseiten einer fortlaufend gelesenen Datei, solange es sie gibt
+static void page_read_ahead(StorageManager* manager, uint8_t file, uint32_t index) {
+    StorageFile* slot = &manager->files[file];
+    for(uint32_t i = 1; i <= OFFLINE_STORAGE_READ_AHEAD; i++) {
+        uint32_t next = index + i;
+        if(next * OFFLINE_STORAGE_PAGE_SIZE >= slot->size) break;
+        if(page_find(manager, file, next)) continue;
+        if(!page_load(manager, file, next, true)) break;
+        manager->stats.read_ahead++;
+    }
+}
+
+static void page_drop(StorageManager* manager, uint8_t file) {
+    for(size_t i = 0; i < OFFLINE_STORAGE_PAGES; i++) {
+        if(manager->pages[i].file == file) manager->pages[i].file = STORAGE_NO_FILE;
+    }
+}
+
+static void file_close(StorageManager* manager, uint8_t file) {
+    StorageFile* slot = &manager->files[file];
+    if(!slot->file) return;
+    storage_file_free(slot->file);
+    slot->file = NULL;
+    slot->path[0] = '\0';
+}
+
+// Platz der Datei in files, bei Bedarf geöffnet. Verdrängt die am längsten
+// nicht benutzte Datei samt ihrer Seiten. STORAGE_NO_FILE = nicht vorhanden
+// (create = false) oder nicht zu öffnen
+static uint8_t file_get(StorageManager* manager, const char* filename, bool create) {
+    char path[128];
+    snprintf(path, sizeof(path), "%s/%s", STORAGE_FOLDER, filename);
+
+    uint8_t victim = 0;
+    for(uint8_t i = 0; i < OFFLINE_STORAGE_FILES; i++) {
+        StorageFile* slot = &manager->files[i];
+        if(slot->file && strcmp(slot->path, path) == 0) {
+            slot->used = ++manager->clock;
+            return i;
+        }
+        if(!slot->file) {
+            victim = i;
+        } else if(manager->files[victim].file && (int32_t)(slot->used - manager->files[victim].used) < 0) {
+            victim = i;
+        }
+    }
+    if(!create && !storage_file_exists(manager->storage, path)) return STORAGE_NO_FILE;
+
+    StorageFile* slot = &manager->files[victim];
+    if(slot->file) {
+        if(!file_flush(manager, victim)) return STORAGE_NO_FILE;
+        page_drop(manager, victim);
+        file_close(manager, victim);
+    }
+
+    slot->file = storage_file_alloc(manager->storage);
+    if(!storage_file_open(slot->file, path, FSAM_READ_WRITE, FSOM_OPEN_ALWAYS)) {
+        storage_file_free(slot->file);
+        slot->file = NULL;
+        return STORAGE_NO_FILE;
+    }
+    snprintf(slot->path, sizeof(slot->path), "%s", path);
+    slot->size = storage_file_size(slot->file);
+    slot->disk_size = slot->size;
+    slot->next_page = 0;
+    slot->used = ++manager->clock;
+    return victim;
 }
 
-// Optimierte Dateiverwaltung
+// Dateiverwaltung
 bool offline_storage_init(void) {
     if(storage) return true;
     
     storage = malloc(sizeof(StorageManager));
     if(!storage) return false;
+    memset(storage, 0, sizeof(StorageManager));
     
     storage->storage = furi_record_open(RECORD_STORAGE);
     storage->mutex = furi_mutex_alloc(FuriMutexTypeNormal);
-    
-    if(!cache_init(&storage->cache)) {
-        free(storage);
-        storage = NULL;
-        return false;
+    storage->arena = malloc(OFFLINE_STORAGE_PAGES * OFFLINE_STORAGE_PAGE_SIZE);
+    for(size_t i = 0; i < OFFLINE_STORAGE_PAGES; i++) {
+        storage->pages[i].data = storage->arena + i * OFFLINE_STORAGE_PAGE_SIZE;
+        storage->pages[i].file = STORAGE_NO_FILE;
     }
     
     // Verzeichnis erstellen
@@ -147,12 +253,12 @@ void offline_storage_deinit(void) {
     
     furi_mutex_acquire(storage->mutex, FuriWaitForever);
     
-    if(storage->cache.dirty) {
-        cache_flush(storage);
+    for(uint8_t i = 0; i < OFFLINE_STORAGE_FILES; i++) {
+        if(storage->files[i].file) file_flush(storage, i);
+        file_close(storage, i);
     }
     
-    cache_free(&storage->cache);
-    
+    free(storage->arena);
     furi_mutex_free(storage->mutex);
     furi_record_close(RECORD_STORAGE);
     
@@ -160,170 +266,177 @@ void offline_storage_deinit(void) {
     storage = NULL;
 }
 
-// Optimierte Lese-/Schreiboperationen
-bool offline_storage_save(const char* filename, const void* data, size_t size) {
-    if(!storage || !filename || !data) return false;
+size_t offline_storage_read(const char* filename, uint32_t offset, void* data, size_t size) {
+    if(!storage || !filename || !data) return 0;
     
     furi_mutex_acquire(storage->mutex, FuriWaitForever);
     
-    char full_path[512];
-    snprintf(full_path, sizeof(full_path),
-             "%s/%s", STORAGE_FOLDER, filename);
-             
-    // Cache leeren wenn anderes File
-    if(strcmp(full_path, storage->current_file) != 0) {
-        if(storage->cache.dirty) {
-            cache_flush(storage);
+    size_t done = 0;
+    uint8_t file = file_get(storage, filename, false);
+    if(file != STORAGE_NO_FILE) {
+        StorageFile* slot = &storage->files[file];
+        if(offset < slot->size) size = MIN(size, slot->size - offset);
+        else size = 0;
+        
+        while(done < size) {
+            uint32_t position = offset + done;
+            uint32_t index = position / OFFLINE_STORAGE_PAGE_SIZE;
+            size_t start = position % OFFLINE_STORAGE_PAGE_SIZE;
+            size_t chunk = MIN(size - done, OFFLINE_STORAGE_PAGE_SIZE - start);
+            
+            bool cached = page_find(storage, file, index) != NULL;
+            StoragePage* page = page_get(storage, file, index, true);
+            if(!page) break;
+            memcpy((uint8_t*)data + done, page->data + start, chunk);
+            
+            // Fortlaufend gelesen: die nächsten Seiten gleich mitnehmen
+            if(!cached && index > 0 && index == slot->next_page) {
+                page_read_ahead(storage, file, index);
+            }
+            slot->next_page = index + 1;
+            done += chunk;
         }
-        strncpy(storage->current_file, full_path,
-                sizeof(storage->current_file)-1);
     }
     
-    // In Cache schreiben
-    if(size > storage->cache.capacity) {
-        // Direkt auf Disk schreiben bei großen Daten
-        File* file = storage_file_alloc(storage->storage);
-        if(!storage_file_open(file, full_path,
-                             FSAM_WRITE, FSOM_CREATE_ALWAYS)) {
-            storage_file_free(file);
-            furi_mutex_release(storage->mutex);
-            return false;
-        }
-        
-        // Komprimieren und schreiben
-        size_t compressed_size = size * 2;
-        void* compressed = malloc(compressed_size);
-        if(!compressed) {
-            storage_file_free(file);
-            furi_mutex_release(storage->mutex);
-            return false;
-        }
-        
-        bool success = compress_data(
-            data,
-            size,
-            compressed,
-            &compressed_size
-        );
-        
-        if(success) {
-            success = storage_file_write(
-                file,
-                compressed,
-                compressed_size
-            ) == compressed_size;
-        }
-        
-        free(compressed);
-        storage_file_close(file);
-        storage_file_free(file);
+    furi_mutex_release(storage->mutex);
+    return done;
+}
+
+// In den Cache schreiben, mutex muss gehalten werden
+static bool file_write(StorageManager* manager, uint8_t file, uint32_t offset, const void* data, size_t size) {
+    StorageFile* slot = &manager->files[file];
+    size_t done = 0;
+    
+    while(done < size) {
+        uint32_t position = offset + done;
+        uint32_t index = position / OFFLINE_STORAGE_PAGE_SIZE;
+        size_t start = position % OFFLINE_STORAGE_PAGE_SIZE;
+        size_t chunk = MIN(size - done, OFFLINE_STORAGE_PAGE_SIZE - start);
         
-        furi_mutex_release(storage->mutex);
-        return success;
+        // Ganze Seiten und Seiten hinter dem Dateiende nicht erst lesen
+        bool fill = chunk < OFFLINE_STORAGE_PAGE_SIZE &&
+                    index * OFFLINE_STORAGE_PAGE_SIZE < slot->size;
+        StoragePage* page = page_get(manager, file, index, fill);
+        if(!page) return false;
+        memcpy(page->data + start, (const uint8_t*)data + done, chunk);
+        page->valid = MAX(page->valid, start + chunk);
+        page->dirty = true;
+        done += chunk;
+        // Schon vor dem nächsten Verdrängen, das die Seite zurückschreibt
+        slot->size = MAX(slot->size, offset + done);
     }
+    return true;
+}
+
+bool offline_storage_write(const char* filename, uint32_t offset, const void* data, size_t size) {
+    if(!storage || !filename || !data) return false;
     
-    // In Cache kopieren
-    memcpy(storage->cache.data, data, size);
-    storage->cache.size = size;
-    storage->cache.dirty = true;
-    storage->cache.last_access = furi_get_tick();
+    furi_mutex_acquire(storage->mutex, FuriWaitForever);
+    
+    bool success = false;
+    uint8_t file = file_get(storage, filename, true);
+    if(file != STORAGE_NO_FILE) {
+        success = file_write(storage, file, offset, data, size);
+    }
     
     furi_mutex_release(storage->mutex);
-    return true;
+    return success;
 }
 
-bool offline_storage_load(const char* filename, void* data, size_t* size) {
-    if(!storage || !filename || !data || !size) return false;
+uint32_t offline_storage_size(const char* filename) {
+    if(!storage || !filename) return 0;
     
     furi_mutex_acquire(storage->mutex, FuriWaitForever);
+    uint8_t file = file_get(storage, filename, false);
+    uint32_t size = (file != STORAGE_NO_FILE) ? storage->files[file].size : 0;
+    furi_mutex_release(storage->mutex);
     
-    char full_path[512];
-    snprintf(full_path, sizeof(full_path),
-             "%s/%s", STORAGE_FOLDER, filename);
-             
-    bool success = false;
+    return size;
+}
+
+bool offline_storage_save(const char* filename, const void* data, size_t size) {
+    if(!storage || !filename || !data) return false;
     
-    // Aus Cache lesen wenn möglich
-    if(strcmp(full_path, storage->current_file) == 0 &&
-       !storage->cache.dirty) {
-        memcpy(data, storage->cache.data, storage->cache.size);
-        *size = storage->cache.size;
-        storage->cache.last_access = furi_get_tick();
-        success = true;
-    } else {
-        // Von Disk lesen
-        File* file = storage_file_alloc(storage->storage);
-        if(!storage_file_open(file, full_path,
-                             FSAM_READ, FSOM_OPEN_EXISTING)) {
-            storage_file_free(file);
-            furi_mutex_release(storage->mutex);
-            return false;
-        }
-        
-        // Größe ermitteln
-        uint64_t file_size = storage_file_size(file);
-        if(file_size == 0) {
-            storage_file_free(file);
-            furi_mutex_release(storage->mutex);
-            return false;
-        }
-        
-        // Komprimierte Daten lesen
-        void* compressed = malloc(file_size);
-        if(!compressed) {
-            storage_file_free(file);
-            furi_mutex_release(storage->mutex);
-            return false;
-        }
-        
-        if(storage_file_read(file, compressed, file_size) == file_size) {
-            // Dekomprimieren
-            success = decompress_data(
-                compressed,
-                file_size,
-                data,
-                size
-            );
-            
-            // In Cache speichern
-            if(success && *size <= storage->cache.capacity) {
-                memcpy(storage->cache.data, data, *size);
-                storage->cache.size = *size;
-                storage->cache.dirty = false;
-                storage->cache.last_access = furi_get_tick();
-                strncpy(storage->current_file, full_path,
-                        sizeof(storage->current_file)-1);
+    furi_mutex_acquire(storage->mutex, FuriWaitForever);
+    
+    bool success = false;
+    uint8_t file = file_get(storage, filename, true);
+    if(file != STORAGE_NO_FILE) {
+        // Alten Inhalt hinter dem neuen Ende verwerfen, ohne ihn zu schreiben.
+        // Auf der Seite über dem Ende auch die Bytes hinter valid löschen,
+        // ein Write-back schreibt sie bis slot->size mit
+        StorageFile* slot = &storage->files[file];
+        for(size_t i = 0; i < OFFLINE_STORAGE_PAGES; i++) {
+            StoragePage* page = &storage->pages[i];
+            if(page->file != file) continue;
+            uint32_t start = page->index * OFFLINE_STORAGE_PAGE_SIZE;
+            if(start >= size) {
+                page->file = STORAGE_NO_FILE;
+            } else if(start + OFFLINE_STORAGE_PAGE_SIZE > size) {
+                page->valid = MIN(page->valid, size - start);
+                memset(page->data + page->valid, 0, OFFLINE_STORAGE_PAGE_SIZE - page->valid);
             }
         }
-        
-        free(compressed);
-        storage_file_close(file);
-        storage_file_free(file);
+        success = slot->disk_size <= size ||
+                  (storage_file_seek(slot->file, size, true) && storage_file_truncate(slot->file));
+        slot->size = MIN(slot->size, size);
+        slot->disk_size = MIN(slot->disk_size, size);
+        // Im selben Halten, sonst sähe ein Leser die gekürzte Datei
+        success = success && file_write(storage, file, 0, data, size);
     }
     
     furi_mutex_release(storage->mutex);
     return success;
 }
 
-// Optimierte Hilfsfunktionen
+bool offline_storage_load(const char* filename, void* data, size_t* size) {
+    if(!storage || !filename || !data || !size) return false;
+    
+    uint32_t file_size = offline_storage_size(filename);
+    if(file_size == 0 || file_size > *size) return false;
+    
+    *size = offline_storage_read(filename, 0, data, file_size);
+    return *size == file_size;
+}
+
+bool offline_storage_flush(void) {
+    if(!storage) return false;
+    
+    furi_mutex_acquire(storage->mutex, FuriWaitForever);
+    
+    bool success = true;
+    for(uint8_t i = 0; i < OFFLINE_STORAGE_FILES; i++) {
+        if(!storage->files[i].file) continue;
+        success &= file_flush(storage, i);
+    }
+    storage->stats.flushes++;
+    
+    furi_mutex_release(storage->mutex);
+    return success;
+}
+
+// Hilfsfunktionen
 bool offline_storage_delete(const char* filename) {
     if(!storage || !filename) return false;
     
+    furi_mutex_acquire(storage->mutex, FuriWaitForever);
+    
     char full_path[512];
     snprintf(full_path, sizeof(full_path),
              "%s/%s", STORAGE_FOLDER, filename);
              
-    // Cache leeren wenn betroffen
-    if(strcmp(full_path, storage->current_file) == 0) {
-        storage->cache.size = 0;
-        storage->cache.dirty = false;
-        storage->current_file[0] = '\0';
+    // Seiten verwerfen, ohne sie zurückzuschreiben
+    for(uint8_t i = 0; i < OFFLINE_STORAGE_FILES; i++) {
+        if(storage->files[i].file && strcmp(storage->files[i].path, full_path) == 0) {
+            page_drop(storage, i);
+            file_close(storage, i);
+        }
     }
     
-    return storage_file_delete(
-        storage->storage,
-        full_path
-    );
+    bool success = storage_common_remove(storage->storage, full_path) == FSE_OK;
+    
+    furi_mutex_release(storage->mutex);
+    return success;
 }
 
 bool offline_storage_exists(const char* filename) {
@@ -338,3 +451,14 @@ bool offline_storage_exists(const char* filename) {
         full_path
     );
 }
+
+void offline_storage_get_stats(OfflineStorageStats* stats) {
+    if(!storage) {
+        memset(stats, 0, sizeof(OfflineStorageStats));
+        return;
+    }
+    
+    furi_mutex_acquire(storage->mutex, FuriWaitForever);
+    *stats = storage->stats;
+    furi_mutex_release(storage->mutex);
+}
@@ -35,10 +35,44 @@ typedef struct {
     bool needs_sync;
 } OfflineStorage;
 
-// Initialisierung und Speichermanagement
-bool offline_storage_init(OfflineStorage* storage);
-bool offline_storage_save(OfflineStorage* storage);
-bool offline_storage_load(OfflineStorage* storage);
+// Dateien unter /ext/tagracer über einen gemeinsamen Seiten-Cache:
+// OFFLINE_STORAGE_PAGES Seiten zu OFFLINE_STORAGE_PAGE_SIZE Bytes, Schlüssel
+// (Datei, Seitennummer), LRU-Verdrängung. Geschrieben wird in den Cache;
+// auf die Karte kommen geänderte Seiten erst beim Verdrängen oder mit
+// offline_storage_flush. Liest jemand fortlaufend, werden die folgenden
+// Seiten gleich mitgelesen.
+#define OFFLINE_STORAGE_PAGE_SIZE 512
+#define OFFLINE_STORAGE_PAGES 16      // 8 KB wie der frühere Einzel-Cache
+#define OFFLINE_STORAGE_FILES 4       // Gleichzeitig offene Dateien
+#define OFFLINE_STORAGE_READ_AHEAD 4  // Seiten
+
+typedef struct {
+    uint32_t hits;
+    uint32_t misses;
+    uint32_t read_ahead;  // Vorab gelesene Seiten
+    uint32_t writebacks;  // Geänderte Seiten auf die Karte geschrieben
+    uint32_t evictions;
+    uint32_t flushes;
+} OfflineStorageStats;
+
+bool offline_storage_init(void);
+// Schreibt alle geänderten Seiten zurück und synchronisiert die Dateien
+void offline_storage_deinit(void);
+
+// size Bytes ab offset lesen; liefert weniger am Dateiende, 0 ohne Datei
+size_t offline_storage_read(const char* filename, uint32_t offset, void* data, size_t size);
+// size Bytes ab offset schreiben, die Datei wächst bei Bedarf
+bool offline_storage_write(const char* filename, uint32_t offset, const void* data, size_t size);
+// Größe inklusive noch nicht zurückgeschriebener Seiten
+uint32_t offline_storage_size(const char* filename);
+// Ganze Datei ersetzen bzw. lesen; *size ist beim Laden die Kapazität
+bool offline_storage_save(const char* filename, const void* data, size_t size);
+bool offline_storage_load(const char* filename, void* data, size_t* size);
+// Alle geänderten Seiten zurückschreiben, dateiweise aufsteigend
+bool offline_storage_flush(void);
+bool offline_storage_delete(const char* filename);
+bool offline_storage_exists(const char* filename);
+void offline_storage_get_stats(OfflineStorageStats* stats);
 
 // Tag-Operationen
 bool offline_storage_add_tag_scan(
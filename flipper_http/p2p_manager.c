@@ -1,4 +1,5 @@
 #include "p2p_manager.h"
+#include "game_log.h"
 #include <furi_hal_random.h>
 #include <notification/notification_messages.h>
 
@@ -39,6 +40,8 @@ P2pManager* p2p_manager_alloc(void) {
     manager->is_host = false;
     manager->game_id = 0;
     manager->player_count = 0;
+    manager->territory = NULL;
+    manager->log = NULL;
     manager->message_callback = NULL;
     manager->callback_context = NULL;
     
@@ -160,14 +163,26 @@ bool p2p_manager_send_game_state(P2pManager* manager, GameContext* game) {
         .timestamp = furi_get_tick()
     };
     
-    // Game State in Nachricht packen
-    memcpy(msg.data, game, sizeof(GameContext));
+    // Nur die Felder packen, die andere Spieler brauchen
+    P2pGameState* state = (P2pGameState*)msg.data;
+    state->score = game->score;
+    state->time_remaining = game->time_remaining;
+    state->tag_count = game->tag_count;
+    state->combo_multiplier = game->combo_multiplier;
+    state->team_id = game->team_id;
+    state->last_tag_key = game->last_tag_key;
+    state->state = game->state;
+    state->mode = game->mode;
     
     return p2p_send_message(manager, &msg);
 }
 
-bool p2p_manager_send_tag_scan(P2pManager* manager, const CachedTagScan* tag) {
-    if(!manager || !tag) return false;
+bool p2p_manager_send_tag_scan(
+    P2pManager* manager,
+    TagKey tag_key,
+    uint32_t points,
+    uint32_t combo) {
+    if(!manager || tag_key == TAG_KEY_NONE) return false;
     
     P2pMessage msg = {
         .type = P2pMessageTypeTagScan,
@@ -176,8 +191,11 @@ bool p2p_manager_send_tag_scan(P2pManager* manager, const CachedTagScan* tag) {
         .timestamp = furi_get_tick()
     };
     
-    // Tag-Daten in Nachricht packen
-    memcpy(msg.data, tag, sizeof(CachedTagScan));
+    // Tag-Scan in Nachricht packen
+    P2pTagScan* scan = (P2pTagScan*)msg.data;
+    scan->tag_key = tag_key;
+    scan->points = points;
+    scan->combo = combo;
     
     return p2p_send_message(manager, &msg);
 }
@@ -198,6 +216,54 @@ bool p2p_manager_send_chat(P2pManager* manager, const char* message) {
     return p2p_send_message(manager, &msg);
 }
 
+bool p2p_manager_set_team(P2pManager* manager, uint8_t player_id, uint32_t team_id) {
+    if(!manager || team_id >= TERRITORY_MAX_TEAMS) return false;
+    
+    bool found = false;
+    furi_mutex_acquire(manager->mutex, FuriWaitForever);
+    for(uint8_t i = 0; i < manager->player_count; i++) {
+        if(manager->players[i].player_id == player_id) {
+            manager->players[i].team_id = team_id;
+            found = true;
+            break;
+        }
+    }
+    furi_mutex_release(manager->mutex);
+    
+    return found;
+}
+
+uint32_t p2p_manager_get_team_score(P2pManager* manager, uint32_t team_id) {
+    if(!manager || team_id >= TERRITORY_MAX_TEAMS) return 0;
+    
+    // Capture-Spiel: Haltezeit aus der Team-Zusammenfassung, O(1)
+    if(manager->territory) {
+        return territory_team_score(manager->territory, team_id, furi_get_tick());
+    }
+    
+    // Sonst: Summe der Spielerpunkte des Teams
+    uint32_t score = 0;
+    furi_mutex_acquire(manager->mutex, FuriWaitForever);
+    for(uint8_t i = 0; i < manager->player_count; i++) {
+        if(manager->players[i].team_id == team_id) {
+            score += manager->players[i].score;
+        }
+    }
+    furi_mutex_release(manager->mutex);
+    
+    return score;
+}
+
+void p2p_manager_set_territory(P2pManager* manager, const Territory* territory) {
+    if(!manager) return;
+    manager->territory = territory;
+}
+
+void p2p_manager_set_log(P2pManager* manager, GameLog* log) {
+    if(!manager) return;
+    manager->log = log;
+}
+
 static int32_t p2p_rx_thread(void* context) {
     P2pManager* manager = (P2pManager*)context;
     P2pMessage msg;
@@ -261,6 +327,10 @@ static void p2p_process_message(P2pManager* manager, P2pMessage* message) {
     
     furi_mutex_acquire(manager->mutex, FuriWaitForever);
     
+    if(manager->log) {
+        game_log_p2p(manager->log, message, sizeof(P2pMessage));
+    }
+    
     switch(message->type) {
         case P2pMessageTypeBeacon:
             // Beacon verarbeiten
@@ -37,6 +37,25 @@ typedef struct {
     uint8_t data[P2P_PACKET_SIZE - 8];
 } P2pMessage;
 
+// Nutzdaten für Spielstand und Tag-Scans, passen in P2pMessage.data.
+// Tags werden nur über ihren Schlüssel referenziert.
+typedef struct {
+    uint32_t score;
+    uint32_t time_remaining;
+    uint32_t tag_count;
+    uint32_t combo_multiplier;
+    uint32_t team_id;
+    TagKey last_tag_key;
+    uint8_t state;
+    uint8_t mode;
+} P2pGameState;
+
+typedef struct {
+    TagKey tag_key;
+    uint32_t points;
+    uint32_t combo;
+} P2pTagScan;
+
 typedef struct {
     bool enabled;
     uint8_t player_id;
@@ -47,6 +66,8 @@ typedef struct {
     FuriThread* rx_thread;
     FuriThread* tx_thread;
     FuriMutex* mutex;
+    const Territory* territory;  // Capture-Gebiete des laufenden Spiels
+    GameLog* log;                // Empfangene Nachrichten mitschreiben, NULL = aus
     void (*message_callback)(P2pMessage* message, void* context);
     void* callback_context;
 } P2pManager;
@@ -62,7 +83,11 @@ void p2p_manager_stop(P2pManager* manager);
 
 // Nachrichtenversand
 bool p2p_manager_send_game_state(P2pManager* manager, GameContext* game);
-bool p2p_manager_send_tag_scan(P2pManager* manager, const CachedTagScan* tag);
+bool p2p_manager_send_tag_scan(
+    P2pManager* manager,
+    TagKey tag_key,
+    uint32_t points,
+    uint32_t combo);
 bool p2p_manager_send_chat(P2pManager* manager, const char* message);
 bool p2p_manager_send_challenge(P2pManager* manager, uint8_t target_id, uint32_t challenge_type);
 
@@ -74,6 +99,10 @@ bool p2p_manager_is_host(P2pManager* manager);
 // Team-Funktionen
 bool p2p_manager_set_team(P2pManager* manager, uint8_t player_id, uint32_t team_id);
 uint32_t p2p_manager_get_team_score(P2pManager* manager, uint32_t team_id);
+void p2p_manager_set_territory(P2pManager* manager, const Territory* territory);
+
+// Eingabeprotokoll (game_log), NULL = aus
+void p2p_manager_set_log(P2pManager* manager, GameLog* log);
 
 // Callback-Management
 void p2p_manager_set_message_callback(
@@ -0,0 +1,102 @@
+#include "retry_policy.h"
+#include <furi_hal_random.h>
+
+void retry_policy_init(RetryPolicy* policy, const RetryConfig* config) {
+    furi_assert(config->max_attempts > 0 && config->failure_threshold > 0);
+    memset(policy, 0, sizeof(RetryPolicy));
+    policy->config = *config;
+    policy->seed = furi_hal_random_get() | 1;
+}
+
+static void retry_policy_open(RetryPolicy* policy, uint32_t now) {
+    if(policy->state != RetryBreakerOpen) policy->stats.opened++;
+    policy->state = RetryBreakerOpen;
+    policy->opened_at = now;
+}
+
+// Darf das Ergebnis von job den Zustand ändern?
+static bool retry_policy_counts(const RetryPolicy* policy, uint32_t job) {
+    return policy->state == RetryBreakerClosed ||
+           (policy->state == RetryBreakerHalfOpen && job == policy->probe);
+}
+
+RetryDecision retry_policy_check(RetryPolicy* policy, uint32_t now) {
+    return retry_policy_check_job(policy, 0, now);
+}
+
+void retry_policy_success(RetryPolicy* policy) {
+    retry_policy_success_job(policy, 0);
+}
+
+void retry_policy_failure(RetryPolicy* policy, uint32_t now) {
+    retry_policy_failure_job(policy, 0, now);
+}
+
+RetryDecision retry_policy_check_job(RetryPolicy* policy, uint32_t job, uint32_t now) {
+    switch(policy->state) {
+        case RetryBreakerClosed:
+            return RetryAllow;
+        case RetryBreakerOpen:
+            if(now - policy->opened_at >= policy->config.open_ms) {
+                policy->state = RetryBreakerHalfOpen;
+                policy->probe = job;
+                policy->stats.probes++;
+                return RetryAllow;
+            }
+            policy->stats.rejected++;
+            return RetryReject;
+        case RetryBreakerHalfOpen:
+        default:
+            return RetryWait;
+    }
+}
+
+void retry_policy_success_job(RetryPolicy* policy, uint32_t job) {
+    if(!retry_policy_counts(policy, job)) return;
+    policy->state = RetryBreakerClosed;
+    policy->consecutive = 0;
+}
+
+void retry_policy_failure_job(RetryPolicy* policy, uint32_t job, uint32_t now) {
+    policy->stats.failures++;
+    if(!retry_policy_counts(policy, job)) return;
+    if(policy->consecutive < UINT8_MAX) policy->consecutive++;
+
+    // Gescheiterte Probe öffnet sofort wieder
+    if(policy->state == RetryBreakerHalfOpen ||
+       policy->consecutive >= policy->config.failure_threshold) {
+        retry_policy_open(policy, now);
+    }
+}
+
+void retry_policy_abandon(RetryPolicy* policy, uint32_t job, uint32_t now) {
+    if(policy->state == RetryBreakerHalfOpen && job == policy->probe) {
+        retry_policy_open(policy, now);
+    }
+}
+
+uint32_t retry_policy_backoff(RetryPolicy* policy, uint8_t attempt) {
+    uint32_t delay = policy->config.max_ms;
+    if(attempt > 0 && attempt <= 31 && policy->config.base_ms <= (policy->config.max_ms >> (attempt - 1))) {
+        delay = policy->config.base_ms << (attempt - 1);
+    }
+
+    uint32_t x = policy->seed;
+    x ^= x << 13;
+    x ^= x >> 17;
+    x ^= x << 5;
+    policy->seed = x;
+
+    uint32_t half = delay / 2;
+    return delay - half + x % (half + 1);
+}
+
+bool retry_policy_can_retry(const RetryPolicy* policy, uint8_t attempt) {
+    return attempt < policy->config.max_attempts && policy->state == RetryBreakerClosed;
+}
+
+uint32_t retry_policy_open_remaining(const RetryPolicy* policy, uint32_t now) {
+    if(policy->state != RetryBreakerOpen) return 0;
+    uint32_t elapsed = now - policy->opened_at;
+    return elapsed >= policy->config.open_ms ? 0 : policy->config.open_ms - elapsed;
+}
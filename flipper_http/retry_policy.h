@@ -0,0 +1,74 @@
+#pragma once
+
+#include <furi.h>
+
+// Gemeinsame Wiederholungsstrategie für Netzwerkaufrufe (flipper_http,
+// data_pipeline, sync_manager). Exponentieller Backoff mit Jitter verteilt
+// Wiederholungen, der Circuit Breaker stoppt sie bei einem Ausfall ganz:
+//
+//   Closed    Normalbetrieb, failure_threshold Fehler in Folge öffnen
+//   Open      Alles wird sofort abgewiesen und gehört in den Offline-Speicher
+//   HalfOpen  Nach open_ms genau eine Probe; Erfolg schließt, Fehler öffnet
+//
+// Mit mehreren Aufträgen unterwegs (flipper_http) kennzeichnet job den
+// Auftrag: außerhalb von Closed zählt nur das Ergebnis der Probe, späte
+// Antworten älterer Aufträge ändern den Zustand nicht.
+//
+// Nicht threadsicher, der Aufrufer schützt die Struktur mit seinem Mutex.
+
+typedef struct {
+    uint32_t base_ms;           // Wartezeit vor der ersten Wiederholung
+    uint32_t max_ms;            // Obergrenze des Backoffs
+    uint8_t max_attempts;       // Versuche pro Auftrag, erster eingeschlossen
+    uint8_t failure_threshold;  // Fehler in Folge bis der Breaker öffnet
+    uint32_t open_ms;           // Offen bis zur Probe
+} RetryConfig;
+
+typedef enum {
+    RetryBreakerClosed,
+    RetryBreakerOpen,
+    RetryBreakerHalfOpen,
+} RetryBreakerState;
+
+typedef enum {
+    RetryAllow,   // Senden; im Zustand HalfOpen ist das die Probe
+    RetryWait,    // Probe unterwegs, Auftrag behalten
+    RetryReject,  // Breaker offen, Auftrag offline ablegen
+} RetryDecision;
+
+typedef struct {
+    uint32_t failures;  // Gemeldete Fehler
+    uint32_t opened;    // Wie oft der Breaker geöffnet hat
+    uint32_t probes;
+    uint32_t rejected;  // Mit RetryReject abgewiesen
+} RetryStats;
+
+typedef struct {
+    RetryConfig config;
+    RetryBreakerState state;
+    uint8_t consecutive;  // Fehler in Folge
+    uint32_t opened_at;
+    uint32_t probe;       // job der Probe, gilt im Zustand HalfOpen
+    uint32_t seed;        // Jitter, xorshift32
+    RetryStats stats;
+} RetryPolicy;
+
+void retry_policy_init(RetryPolicy* policy, const RetryConfig* config);
+// Vor jedem Versuch fragen
+RetryDecision retry_policy_check(RetryPolicy* policy, uint32_t now);
+void retry_policy_success(RetryPolicy* policy);
+void retry_policy_failure(RetryPolicy* policy, uint32_t now);
+// Wie oben für Aufrufer mit mehreren Aufträgen unterwegs, job != 0
+RetryDecision retry_policy_check_job(RetryPolicy* policy, uint32_t job, uint32_t now);
+void retry_policy_success_job(RetryPolicy* policy, uint32_t job);
+void retry_policy_failure_job(RetryPolicy* policy, uint32_t job, uint32_t now);
+// Auftrag ohne Ergebnis verworfen. War er die Probe, öffnet der Breaker
+// wieder, sonst bliebe er halb offen und hielte alles mit RetryWait fest
+void retry_policy_abandon(RetryPolicy* policy, uint32_t job, uint32_t now);
+// Wartezeit vor Versuch attempt + 1: min(max_ms, base_ms * 2^(attempt - 1)),
+// davon die obere Hälfte zufällig, damit Geräte nicht im Gleichtakt senden
+uint32_t retry_policy_backoff(RetryPolicy* policy, uint8_t attempt);
+// Noch ein Versuch nach attempt fehlgeschlagenen?
+bool retry_policy_can_retry(const RetryPolicy* policy, uint8_t attempt);
+// Millisekunden bis zur nächsten Probe, 0 wenn nicht offen
+uint32_t retry_policy_open_remaining(const RetryPolicy* policy, uint32_t now);
@@ -1,6 +1,6 @@
 #include "game_modes.h"
 #include <furi_hal.h>
-#include <notification/notification_messages.h>
+#include "notifier.h"
 
 // Story-Kapitel Definitionen
 static const StoryChapter default_chapters[] = {
@@ -51,14 +51,15 @@ bool story_mode_init(GameContext* game, StoryProgress* progress) {
     
     // Spiel-Kontext für Story-Modus konfigurieren
     game->mode = GameModeStory;
+    game->mode_desc = game_state_get_mode(GameModeStory);
     game->state = GameStateIdle;
     game->score = 0;
     game->combo_multiplier = 1;
     
     // Story-spezifische Einstellungen
     game->time_remaining = 0; // Kein Zeitlimit im Story-Modus
-    snprintf(game->status_text, sizeof(game->status_text),
-        "Story-Modus: Kapitel %lu", progress->current_chapter);
+    game_state_mark_dirty(game, GameDirtyAll);
+    game_state_set_status(game, "Story-Modus: Kapitel %lu", progress->current_chapter);
     
     return true;
 }
@@ -97,23 +98,19 @@ bool story_mode_update(GameContext* game, StoryProgress* progress) {
         
         // Belohnung vergeben
         game->score += 500; // Bonus für Kapitel-Abschluss
+        game_state_mark_dirty(game, GameDirtyScore);
         progress->total_score += game->score;
         
         // Benachrichtigung
-        NotificationApp* notifications = furi_record_open(RECORD_NOTIFICATION);
-        notification_message(notifications, &sequence_success);
-        notification_message(notifications, &sequence_success);
-        furi_record_close(RECORD_NOTIFICATION);
+        notifier_post(NotifyChapter);
         
-        snprintf(game->status_text, sizeof(game->status_text),
-            "Kapitel %lu abgeschlossen!", current->id);
+        game_state_set_status(game, "Kapitel %lu abgeschlossen!", current->id);
         
         return true;
     }
     
     // Status aktualisieren
-    snprintf(game->status_text, sizeof(game->status_text),
-        "Tags: %lu/%lu Score: %lu/%lu",
+    game_state_set_status(game, "Tags: %lu/%lu Score: %lu/%lu",
         game->tag_count, current->required_tags,
         game->score, current->required_score);
     
@@ -135,6 +132,14 @@ bool story_mode_process_tag(GameContext* game, StoryProgress* progress, TagConfi
     
     if(!current) return false;
     
+    // Jeder Tag zählt nur einmal pro Spiel
+    if(tag->key != TAG_KEY_NONE &&
+       !tag_id_table_mark(&game->scanned_tags, tag->key, NULL, 0)) {
+        game_state_set_status(game, "Tag bereits gescannt!");
+        return false;
+    }
+    game->last_tag_key = tag->key;
+    
     // Tag-spezifische Aktionen
     uint32_t base_points = tag->points;
     
@@ -172,6 +177,7 @@ bool story_mode_process_tag(GameContext* game, StoryProgress* progress, TagConfi
     uint32_t points = game_state_calculate_points(game, base_points);
     game->score += points;
     game->tag_count++;
+    game_state_mark_dirty(game, GameDirtyScore | GameDirtyTags);
     
     // Combo aktualisieren
     game_state_update_combo(game, furi_get_tick());
@@ -204,8 +210,7 @@ bool story_mode_complete_chapter(GameContext* game, StoryProgress* progress) {
                 }
             } else {
                 // Story-Modus komplett abgeschlossen
-                snprintf(game->status_text, sizeof(game->status_text),
-                    "Story-Modus abgeschlossen!");
+                game_state_set_status(game, "Story-Modus abgeschlossen!");
             }
             
             break;
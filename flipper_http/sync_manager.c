@@ -4,9 +4,16 @@
 #include <storage/storage.h>
 
 #define SYNC_CHUNK_SIZE 4096
-#define SYNC_RETRY_COUNT 3
 #define SYNC_TIMEOUT 30000
 
+static const RetryConfig sync_retry_config = {
+    .base_ms = 1000,
+    .max_ms = 30000,
+    .max_attempts = 3,
+    .failure_threshold = 3,
+    .open_ms = 120000,
+};
+
 static int32_t sync_worker_thread(void* context);
 static bool sync_upload_item(SyncManager* manager, SyncItem* item);
 static bool sync_download_item(SyncManager* manager, SyncItem* item);
@@ -26,6 +33,9 @@ SyncManager* sync_manager_alloc(HttpClient* client, OfflineData* data) {
     manager->auto_sync = false;
     manager->sync_interval = 3600; // 1 Stunde
     manager->last_sync = 0;
+    manager->attempts = 0;
+    manager->retry_at = 0;
+    retry_policy_init(&manager->retry, &sync_retry_config);
     
     manager->mutex = furi_mutex_alloc(FuriMutexTypeNormal);
     
@@ -83,11 +93,40 @@ void sync_manager_stop_sync(SyncManager* manager) {
     furi_thread_join(manager->worker);
 }
 
+// Fehlversuch melden. true = Item nach dem Backoff erneut versuchen,
+// false = aufgeben, needs_sync bleibt für den nächsten Sync stehen
+static bool sync_retry_later(SyncManager* manager, uint32_t now) {
+    manager->attempts++;
+    retry_policy_failure(&manager->retry, now);
+    if(!retry_policy_can_retry(&manager->retry, manager->attempts)) {
+        manager->attempts = 0;
+        manager->data->needs_sync = true;
+        return false;
+    }
+    manager->retry_at = now + retry_policy_backoff(&manager->retry, manager->attempts);
+    return true;
+}
+
+// Darf das nächste Item jetzt übertragen werden? Bei offenem Breaker
+// wird der Sync abgebrochen, die Daten bleiben offline markiert
+static bool sync_may_transfer(SyncManager* manager, uint32_t now) {
+    if((int32_t)(now - manager->retry_at) < 0) return false;
+    
+    RetryDecision decision = retry_policy_check(&manager->retry, now);
+    if(decision == RetryReject) {
+        manager->data->needs_sync = true;
+        manager->state = SyncStateError;
+        sync_update_status(manager, "Server nicht erreichbar, Sync später");
+    }
+    return decision == RetryAllow;
+}
+
 static int32_t sync_worker_thread(void* context) {
     SyncManager* manager = (SyncManager*)context;
     
     while(manager->state != SyncStateIdle) {
         furi_mutex_acquire(manager->mutex, FuriWaitForever);
+        uint32_t now = furi_get_tick();
         
         switch(manager->state) {
             case SyncStateUploading:
@@ -97,12 +136,21 @@ static int32_t sync_worker_thread(void* context) {
                     // TODO: Nächstes Upload-Item holen
                     
                     if(item) {
-                        if(!sync_upload_item(manager, item)) {
+                        if(!sync_may_transfer(manager, now)) break;
+                        if(sync_upload_item(manager, item)) {
+                            retry_policy_success(&manager->retry);
+                            manager->attempts = 0;
+                            item->needs_upload = false;
+                            manager->processed_items++;
+                        } else if(sync_retry_later(manager, now)) {
+                            sync_update_status(manager,
+                                "Upload von %s, Versuch %u", item->path, manager->attempts + 1);
+                        } else {
                             manager->state = SyncStateError;
                             sync_update_status(manager,
                                 "Fehler beim Upload von %s", item->path);
+                            manager->processed_items++;
                         }
-                        manager->processed_items++;
                     } else {
                         manager->state = SyncStateDownloading;
                         sync_update_status(manager,
@@ -118,12 +166,21 @@ static int32_t sync_worker_thread(void* context) {
                     // TODO: Nächstes Download-Item holen
                     
                     if(item) {
-                        if(!sync_download_item(manager, item)) {
+                        if(!sync_may_transfer(manager, now)) break;
+                        if(sync_download_item(manager, item)) {
+                            retry_policy_success(&manager->retry);
+                            manager->attempts = 0;
+                            item->needs_download = false;
+                            manager->processed_items++;
+                        } else if(sync_retry_later(manager, now)) {
+                            sync_update_status(manager,
+                                "Download von %s, Versuch %u", item->path, manager->attempts + 1);
+                        } else {
                             manager->state = SyncStateError;
                             sync_update_status(manager,
                                 "Fehler beim Download von %s", item->path);
+                            manager->processed_items++;
                         }
-                        manager->processed_items++;
                     } else {
                         // Sync abgeschlossen
                         manager->state = SyncStateIdle;
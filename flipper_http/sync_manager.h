@@ -3,6 +3,7 @@
 #include <furi.h>
 #include "offline_data.h"
 #include "http_client.h"
+#include "retry_policy.h"
 
 typedef enum {
     SyncStateIdle,
@@ -46,6 +47,12 @@ typedef struct {
     uint32_t sync_interval;
     uint32_t last_sync;
     
+    // Wiederholung pro Item; bei offenem Breaker bleibt needs_sync in
+    // OfflineData gesetzt und der nächste Sync holt es nach
+    RetryPolicy retry;
+    uint8_t attempts;
+    uint32_t retry_at;
+    
     void (*progress_callback)(float progress, const char* status, void* context);
     void* callback_context;
 } SyncManager;
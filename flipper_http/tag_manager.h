@@ -19,6 +19,7 @@ typedef enum {
 typedef struct {
     TagType type;
     uint32_t id;
+    TagKey key;         // Aus der UID beim Scan berechnet
     uint32_t points;
     uint32_t power_up_id;
     uint32_t checkpoint_id;
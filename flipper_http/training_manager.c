@@ -21,7 +21,9 @@ TrainingManager* training_manager_alloc(
     manager->game = game;
     manager->location = location;
     manager->map = map;
-    manager->session_count = 0;
+    item_ring_init(
+        &manager->sessions, manager->session_items, sizeof(TrainingSession), MAX_TRAINING_SESSIONS);
+    manager->session_serial = 0;
     manager->route_count = 0;
     manager->current_session = NULL;
     manager->current_route = NULL;
@@ -46,16 +48,16 @@ void training_manager_free(TrainingManager* manager) {
 }
 
 bool training_manager_start_session(TrainingManager* manager) {
-    if(!manager || manager->current_session ||
-       manager->session_count >= MAX_TRAINING_SESSIONS) {
+    if(!manager || manager->current_session) {
         return false;
     }
     
     furi_mutex_acquire(manager->mutex, FuriWaitForever);
     
-    // Neue Session erstellen
-    TrainingSession* session = &manager->sessions[manager->session_count];
-    session->id = manager->session_count + 1;
+    // Neue Session erstellen; der Platz bleibt ihr bis zum Ende, weil bis
+    // dahin keine weitere beginnt
+    TrainingSession* session = item_ring_push(&manager->sessions, NULL);
+    session->id = ++manager->session_serial;
     session->start_time = furi_get_tick();
     session->duration = 0;
     session->distance = 0;
@@ -107,8 +109,7 @@ bool training_manager_end_session(TrainingManager* manager) {
         map_manager_stop_tracking(manager->map);
     }
     
-    // Session speichern
-    manager->session_count++;
+    // Session steht schon seit dem Start im Verlauf
     manager->current_session = NULL;
     
     // Gesamtstatistik aktualisieren
@@ -231,9 +232,10 @@ bool training_manager_analyze_session(
     TrainingSession* session = NULL;
     
     // Session finden
-    for(uint32_t i = 0; i < manager->session_count; i++) {
-        if(manager->sessions[i].id == session_id) {
-            session = &manager->sessions[i];
+    for(uint32_t i = 0; i < manager->sessions.count; i++) {
+        TrainingSession* candidate = item_ring_get(&manager->sessions, i);
+        if(candidate->id == session_id) {
+            session = candidate;
             break;
         }
     }
@@ -4,6 +4,7 @@
 #include "game_state.h"
 #include "location_manager.h"
 #include "map_manager.h"
+#include "item_ring.h"
 
 #define MAX_TRAINING_SESSIONS 100
 #define MAX_TRAINING_ROUTES 20
@@ -51,8 +52,11 @@ typedef struct {
 } TrainingStats;
 
 typedef struct {
-    TrainingSession sessions[MAX_TRAINING_SESSIONS];
-    uint32_t session_count;
+    // Verlauf, älteste zuerst; ist er voll, verdrängt eine neue Session
+    // die älteste
+    TrainingSession session_items[MAX_TRAINING_SESSIONS];
+    ItemRing sessions;
+    uint32_t session_serial;  // Vergebene IDs, auch verdrängte
     
     TrainingRoute routes[MAX_TRAINING_ROUTES];
     uint32_t route_count;
@@ -1,6 +1,6 @@
 #include "ui_manager.h"
 #include <gui/gui.h>
-#include <notification/notification_messages.h>
+#include "notifier.h"
 
 #define SCREEN_WIDTH 128
 #define SCREEN_HEIGHT 64
@@ -200,9 +200,7 @@ void ui_manager_update_combo(UiManager* manager) {
     
     // Combo-Animation
     if(manager->game->combo_multiplier > 1) {
-        NotificationApp* notifications = furi_record_open(RECORD_NOTIFICATION);
-        notification_message(notifications, &sequence_blink_yellow_100);
-        furi_record_close(RECORD_NOTIFICATION);
+        notifier_post(NotifyCombo);
         
         char combo_text[32];
         snprintf(combo_text, sizeof(combo_text),
@@ -217,10 +215,7 @@ void ui_manager_update_combo(UiManager* manager) {
 void ui_manager_animate_tag_scan(UiManager* manager) {
     if(!manager) return;
     
-    NotificationApp* notifications = furi_record_open(RECORD_NOTIFICATION);
-    notification_message(notifications, &sequence_success);
-    notification_message(notifications, &sequence_blink_green_100);
-    furi_record_close(RECORD_NOTIFICATION);
+    notifier_post(NotifyScanOk);
     
     // TODO: Scan-Animation implementieren
 }
@@ -228,9 +223,7 @@ void ui_manager_animate_tag_scan(UiManager* manager) {
 void ui_manager_animate_powerup(UiManager* manager) {
     if(!manager) return;
     
-    NotificationApp* notifications = furi_record_open(RECORD_NOTIFICATION);
-    notification_message(notifications, &sequence_blink_magenta_100);
-    furi_record_close(RECORD_NOTIFICATION);
+    notifier_post(NotifyPowerUp);
     
     // TODO: Power-up-Animation implementieren
 }
@@ -0,0 +1,157 @@
+#include "wire_protocol.h"
+
+// Halbbyte-Tabelle: 32 Byte statt 512 für die volle Tabelle
+static const uint16_t wire_crc_table[16] = {
+    0x0000, 0x1021, 0x2042, 0x3063, 0x4084, 0x50A5, 0x60C6, 0x70E7,
+    0x8108, 0x9129, 0xA14A, 0xB16B, 0xC18C, 0xD1AD, 0xE1CE, 0xF1EF,
+};
+
+uint16_t wire_crc16(uint16_t crc, const uint8_t* data, size_t size) {
+    for(size_t i = 0; i < size; i++) {
+        crc = (crc << 4) ^ wire_crc_table[(crc >> 12) ^ (data[i] >> 4)];
+        crc = (crc << 4) ^ wire_crc_table[(crc >> 12) ^ (data[i] & 0x0F)];
+    }
+    return crc;
+}
+
+size_t wire_payload_size(uint8_t type) {
+    switch(type) {
+#define WIRE_BEGIN(name, type, json) \
+    case WireType##name:             \
+        return sizeof(Wire##name);
+#define WIRE_U8(field)
+#define WIRE_U16(field)
+#define WIRE_U32(field)
+#define WIRE_STR(field, size)
+#define WIRE_BYTES(field, size)
+#define WIRE_END(name)
+#include "wire_schema.def"
+#undef WIRE_BEGIN
+#undef WIRE_U8
+#undef WIRE_U16
+#undef WIRE_U32
+#undef WIRE_STR
+#undef WIRE_BYTES
+#undef WIRE_END
+        default:
+            return 0;
+    }
+}
+
+size_t wire_encode(
+    uint8_t* buffer,
+    size_t capacity,
+    uint8_t type,
+    uint16_t id,
+    const void* payload,
+    size_t size) {
+    size_t length = WIRE_HEADER_SIZE + size + WIRE_CRC_SIZE;
+    if(size == 0 || wire_payload_size(type) != size || length > capacity) return 0;
+
+    buffer[0] = WIRE_SYNC;
+    buffer[1] = type;
+    buffer[2] = id & 0xFF;
+    buffer[3] = id >> 8;
+    buffer[4] = size & 0xFF;
+    buffer[5] = size >> 8;
+    memcpy(buffer + WIRE_HEADER_SIZE, payload, size);
+
+    uint16_t crc = wire_crc16(0xFFFF, buffer + 1, WIRE_HEADER_SIZE - 1 + size);
+    buffer[length - 2] = crc & 0xFF;
+    buffer[length - 1] = crc >> 8;
+    return length;
+}
+
+void wire_decoder_init(
+    WireDecoder* decoder,
+    void (*on_frame)(WireDecoder* decoder, const WireFrame* frame, void* context),
+    void* context) {
+    memset(decoder, 0, sizeof(WireDecoder));
+    decoder->on_frame = on_frame;
+    decoder->context = context;
+    decoder->frame.payload = &decoder->payload;
+}
+
+void wire_decoder_reset(WireDecoder* decoder) {
+    decoder->state = WireDecodeSync;
+    decoder->position = 0;
+}
+
+// Kopf vollständig: Typ und Länge gegen das Schema prüfen
+static bool wire_decoder_header(WireDecoder* decoder) {
+    const uint8_t* header = decoder->header;
+    decoder->frame.type = header[1];
+    decoder->frame.id = header[2] | (header[3] << 8);
+    decoder->frame.size = header[4] | (header[5] << 8);
+
+    size_t expected = wire_payload_size(decoder->frame.type);
+    return expected != 0 && decoder->frame.size == expected;
+}
+
+static void wire_decoder_finish(WireDecoder* decoder) {
+    const uint8_t* crc_data = decoder->header + WIRE_HEADER_SIZE;
+    uint16_t received = crc_data[0] | (crc_data[1] << 8);
+    uint16_t crc = wire_crc16(0xFFFF, decoder->header + 1, WIRE_HEADER_SIZE - 1);
+    crc = wire_crc16(crc, (const uint8_t*)&decoder->payload, decoder->frame.size);
+
+    if(crc == received) {
+        decoder->frames++;
+        if(decoder->on_frame) decoder->on_frame(decoder, &decoder->frame, decoder->context);
+    } else {
+        decoder->errors++;
+    }
+    wire_decoder_reset(decoder);
+}
+
+size_t wire_decoder_feed(WireDecoder* decoder, const uint8_t* data, size_t size) {
+    size_t offset = 0;
+
+    while(offset < size) {
+        switch(decoder->state) {
+            case WireDecodeSync:
+                if(data[offset++] != WIRE_SYNC) {
+                    decoder->skipped++;
+                    break;
+                }
+                decoder->header[0] = WIRE_SYNC;
+                decoder->position = 1;
+                decoder->state = WireDecodeHeader;
+                break;
+
+            case WireDecodeHeader:
+                decoder->header[decoder->position++] = data[offset++];
+                if(decoder->position < WIRE_HEADER_SIZE) break;
+                if(!wire_decoder_header(decoder)) {
+                    // Ab dem nächsten Byte neu synchronisieren
+                    decoder->errors++;
+                    wire_decoder_reset(decoder);
+                    return offset;
+                }
+                decoder->position = 0;
+                decoder->state = WireDecodePayload;
+                break;
+
+            case WireDecodePayload: {
+                size_t count = MIN(size - offset, (size_t)(decoder->frame.size - decoder->position));
+                memcpy((uint8_t*)&decoder->payload + decoder->position, data + offset, count);
+                decoder->position += count;
+                offset += count;
+                if(decoder->position == decoder->frame.size) {
+                    decoder->position = WIRE_HEADER_SIZE;
+                    decoder->state = WireDecodeCrc;
+                }
+                break;
+            }
+
+            case WireDecodeCrc:
+                decoder->header[decoder->position++] = data[offset++];
+                if(decoder->position == WIRE_HEADER_SIZE + WIRE_CRC_SIZE) {
+                    wire_decoder_finish(decoder);
+                    return offset;
+                }
+                break;
+        }
+    }
+
+    return offset;
+}
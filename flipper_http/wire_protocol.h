@@ -0,0 +1,128 @@
+#pragma once
+
+#include <furi.h>
+
+// Binäres Leitungsprotokoll zur Bridge, Alternative zu HTTP-Text. Rahmen:
+//
+//   0xA5 | Typ (1) | ID (2) | Länge (2) | Nutzdaten | CRC-16 (2)
+//
+// Zahlen Little Endian, CRC-16/CCITT (0x1021, Start 0xFFFF) über alles
+// nach dem Sync-Byte. Die Nutzdaten haben feste Layouts aus wire_schema.def;
+// Flipper und Host sind Little Endian, die Strukturen werden direkt kopiert.
+// ID ordnet Antworten zu, 0 = unaufgefordert (Hello, Server-Push).
+
+#define WIRE_SYNC 0xA5
+#define WIRE_VERSION 3
+#define WIRE_HEADER_SIZE 6  // Mit Sync-Byte
+#define WIRE_CRC_SIZE 2
+
+typedef enum {
+#define WIRE_BEGIN(name, type, json) WireType##name = type,
+#define WIRE_U8(field)
+#define WIRE_U16(field)
+#define WIRE_U32(field)
+#define WIRE_STR(field, size)
+#define WIRE_BYTES(field, size)
+#define WIRE_END(name)
+#include "wire_schema.def"
+#undef WIRE_BEGIN
+#undef WIRE_U8
+#undef WIRE_U16
+#undef WIRE_U32
+#undef WIRE_STR
+#undef WIRE_BYTES
+#undef WIRE_END
+} WireType;
+
+// Wire<Name> für jede Nachricht
+#define WIRE_BEGIN(name, type, json) typedef struct __attribute__((packed)) {
+#define WIRE_U8(field) uint8_t field;
+#define WIRE_U16(field) uint16_t field;
+#define WIRE_U32(field) uint32_t field;
+#define WIRE_STR(field, size) char field[size];
+#define WIRE_BYTES(field, size) uint8_t field[size];
+#define WIRE_END(name) } Wire##name;
+#include "wire_schema.def"
+#undef WIRE_BEGIN
+#undef WIRE_U8
+#undef WIRE_U16
+#undef WIRE_U32
+#undef WIRE_STR
+#undef WIRE_BYTES
+#undef WIRE_END
+
+// Platz für die größte Nachricht
+typedef union {
+#define WIRE_BEGIN(name, type, json)
+#define WIRE_U8(field)
+#define WIRE_U16(field)
+#define WIRE_U32(field)
+#define WIRE_STR(field, size)
+#define WIRE_BYTES(field, size)
+#define WIRE_END(name) Wire##name name;
+#include "wire_schema.def"
+#undef WIRE_BEGIN
+#undef WIRE_U8
+#undef WIRE_U16
+#undef WIRE_U32
+#undef WIRE_STR
+#undef WIRE_BYTES
+#undef WIRE_END
+} WirePayload;
+
+#define WIRE_MAX_PAYLOAD sizeof(WirePayload)
+#define WIRE_FRAME_MAX (WIRE_HEADER_SIZE + WIRE_MAX_PAYLOAD + WIRE_CRC_SIZE)
+
+// Nutzdatengröße eines Typs, 0 = unbekannter Typ
+size_t wire_payload_size(uint8_t type);
+uint16_t wire_crc16(uint16_t crc, const uint8_t* data, size_t size);
+// Schreibt einen Rahmen nach buffer. Liefert die Rahmenlänge, 0 wenn
+// Typ und Größe nicht zum Schema passen oder der Platz nicht reicht
+size_t wire_encode(
+    uint8_t* buffer,
+    size_t capacity,
+    uint8_t type,
+    uint16_t id,
+    const void* payload,
+    size_t size);
+
+typedef struct {
+    uint8_t type;
+    uint16_t id;
+    uint16_t size;
+    const WirePayload* payload;  // Nur während on_frame gültig
+} WireFrame;
+
+typedef enum {
+    WireDecodeSync,     // Bytes bis zum Sync-Byte überspringen
+    WireDecodeHeader,
+    WireDecodePayload,
+    WireDecodeCrc,
+} WireDecodeState;
+
+typedef struct WireDecoder WireDecoder;
+
+struct WireDecoder {
+    WireDecodeState state;
+    void (*on_frame)(WireDecoder* decoder, const WireFrame* frame, void* context);
+    void* context;
+
+    uint8_t header[WIRE_HEADER_SIZE + WIRE_CRC_SIZE];  // Kopf, danach die CRC
+    size_t position;
+    WireFrame frame;
+    WirePayload payload;
+
+    uint32_t frames;
+    uint32_t errors;   // Unbekannter Typ, falsche Länge oder CRC
+    uint32_t skipped;  // Bytes außerhalb von Rahmen
+};
+
+void wire_decoder_init(
+    WireDecoder* decoder,
+    void (*on_frame)(WireDecoder* decoder, const WireFrame* frame, void* context),
+    void* context);
+void wire_decoder_reset(WireDecoder* decoder);
+// Verarbeitet höchstens einen Rahmen und kehrt nach dessen Ende oder einem
+// Fehler zurück, damit der Aufrufer zwischen Rahmen und HTTP umschalten
+// kann. Liefert die verbrauchten Bytes.
+size_t wire_decoder_feed(WireDecoder* decoder, const uint8_t* data, size_t size);
@@ -0,0 +1,422 @@
+#include "game_log.h"
+
+#define GAME_LOG_FLAG_UNIQUE (1 << 0)
+#define GAME_LOG_FLAG_POWER_UPS (1 << 1)
+
+GameLog* game_log_alloc(void) {
+    GameLog* log = malloc(sizeof(GameLog));
+    memset(log, 0, sizeof(GameLog));
+    log->mutex = furi_mutex_alloc(FuriMutexTypeNormal);
+    return log;
+}
+
+void game_log_free(GameLog* log) {
+    if(!log) return;
+    game_log_close(log);
+    furi_mutex_free(log->mutex);
+    free(log);
+}
+
+// Puffer in die Datei bzw. den Speicherbereich schreiben
+static void game_log_flush(GameLog* log) {
+    if(log->used == 0) return;
+
+    if(log->file) {
+        if(storage_file_write(log->file, log->buffer, log->used) != log->used) {
+            log->overflow = true;
+        }
+    } else if(log->memory) {
+        if(log->size + log->used > log->capacity) {
+            log->overflow = true;
+        } else {
+            memcpy(log->memory + log->size, log->buffer, log->used);
+        }
+    }
+
+    if(!log->overflow) {
+        log->size += log->used;
+    }
+    log->used = 0;
+}
+
+static void game_log_put(GameLog* log, const void* data, size_t size) {
+    const uint8_t* bytes = data;
+    while(size > 0) {
+        if(log->used == GAME_LOG_BUFFER_SIZE) {
+            game_log_flush(log);
+        }
+        size_t chunk = MIN(size, GAME_LOG_BUFFER_SIZE - log->used);
+        memcpy(log->buffer + log->used, bytes, chunk);
+        log->used += chunk;
+        bytes += chunk;
+        size -= chunk;
+    }
+}
+
+static void game_log_put_u8(GameLog* log, uint8_t value) {
+    game_log_put(log, &value, 1);
+}
+
+// LEB128: kleine Werte (Zeitabstände, Zähler) brauchen nur ein Byte
+static void game_log_put_varint(GameLog* log, uint32_t value) {
+    uint8_t bytes[5];
+    size_t count = 0;
+    do {
+        bytes[count] = value & 0x7F;
+        value >>= 7;
+        if(value) bytes[count] |= 0x80;
+        count++;
+    } while(value);
+    game_log_put(log, bytes, count);
+}
+
+static void game_log_put_zigzag(GameLog* log, int32_t value) {
+    game_log_put_varint(log, ((uint32_t)value << 1) ^ (uint32_t)(value >> 31));
+}
+
+static void game_log_put_blob(GameLog* log, const void* data, size_t size) {
+    game_log_put_varint(log, size);
+    game_log_put(log, data, size);
+}
+
+static void game_log_put_header(GameLog* log) {
+    uint32_t magic = GAME_LOG_MAGIC;
+    uint16_t version = GAME_LOG_VERSION;
+    uint16_t reserved = 0;
+    game_log_put(log, &magic, sizeof(magic));
+    game_log_put(log, &version, sizeof(version));
+    game_log_put(log, &reserved, sizeof(reserved));
+    // Absoluter Starttick: das Timer-Rad ordnet nach Slot-Grenzen
+    game_log_put(log, &log->last_tick, sizeof(log->last_tick));
+}
+
+bool game_log_open_file(GameLog* log, const char* path) {
+    if(!log || !path) return false;
+    game_log_close(log);
+
+    log->storage = furi_record_open(RECORD_STORAGE);
+    storage_mkdir(log->storage, EXT_PATH("apps_data/tagracer"));
+    storage_mkdir(log->storage, GAME_LOG_DIR);
+
+    log->file = storage_file_alloc(log->storage);
+    if(!storage_file_open(log->file, path, FSAM_WRITE, FSOM_CREATE_ALWAYS)) {
+        storage_file_free(log->file);
+        log->file = NULL;
+        furi_record_close(RECORD_STORAGE);
+        log->storage = NULL;
+        return false;
+    }
+
+    log->size = 0;
+    log->used = 0;
+    log->overflow = false;
+    log->last_tick = furi_get_tick();
+    log->open = true;
+    game_log_put_header(log);
+    return true;
+}
+
+bool game_log_open_memory(GameLog* log, uint8_t* data, size_t capacity) {
+    if(!log || !data) return false;
+    game_log_close(log);
+
+    log->memory = data;
+    log->capacity = capacity;
+    log->size = 0;
+    log->used = 0;
+    log->overflow = false;
+    log->last_tick = furi_get_tick();
+    log->open = true;
+    game_log_put_header(log);
+    return true;
+}
+
+size_t game_log_close(GameLog* log) {
+    if(!log || !log->open) return 0;
+
+    furi_mutex_acquire(log->mutex, FuriWaitForever);
+    game_log_flush(log);
+    if(log->file) {
+        storage_file_close(log->file);
+        storage_file_free(log->file);
+        furi_record_close(RECORD_STORAGE);
+        log->file = NULL;
+        log->storage = NULL;
+    }
+    log->memory = NULL;
+    log->open = false;
+    furi_mutex_release(log->mutex);
+
+    return log->size;
+}
+
+// Eintrag beginnen: Typ und Zeitabstand. Hält den Mutex bis game_log_end.
+static bool game_log_begin(GameLog* log, GameLogType type) {
+    if(!log || !log->open) return false;
+
+    furi_mutex_acquire(log->mutex, FuriWaitForever);
+    uint32_t now = furi_get_tick();
+    game_log_put_u8(log, type);
+    game_log_put_varint(log, now - log->last_tick);
+    log->last_tick = now;
+    return true;
+}
+
+static void game_log_end(GameLog* log) {
+    furi_mutex_release(log->mutex);
+}
+
+void game_log_start(GameLog* log, const GameContext* context) {
+    if(!game_log_begin(log, GameLogStart)) return;
+
+    game_log_put_u8(log, context->mode);
+    game_log_put_varint(log, context->team_id);
+    if(context->mode == GameModeCustom) {
+        // Eigene Regeln haben keine Hooks, die Zahlenwerte genügen
+        const GameModeDescriptor* mode = context->mode_desc;
+        game_log_put_varint(log, mode->duration_sec);
+        game_log_put_varint(log, mode->base_points);
+        game_log_put_varint(log, mode->cooldown_ms);
+        game_log_put_varint(log, mode->combo_window_ms);
+        game_log_put_varint(log, mode->max_combo);
+        game_log_put_varint(log, mode->tick_bonus);
+        game_log_put_varint(log, mode->tick_bonus_min_remaining);
+        game_log_put_varint(log, mode->win_score);
+        game_log_put_u8(
+            log,
+            (mode->unique_tags ? GAME_LOG_FLAG_UNIQUE : 0) |
+                (mode->power_ups_enabled ? GAME_LOG_FLAG_POWER_UPS : 0));
+    }
+    game_log_end(log);
+
+    // Staffel: geladene Route mitschreiben, damit das Replay nicht von der
+    // SD-Karte abhängt (leer = keine Route)
+    if(context->mode == GameModeRelay && game_log_begin(log, GameLogRelay)) {
+        game_log_put_blob(log, &context->relay, context->relay.loaded ? sizeof(RelayRoute) : 0);
+        game_log_end(log);
+    }
+}
+
+void game_log_reset(GameLog* log) {
+    if(!game_log_begin(log, GameLogReset)) return;
+    game_log_end(log);
+}
+
+void game_log_tick(GameLog* log) {
+    if(!game_log_begin(log, GameLogTick)) return;
+    game_log_end(log);
+}
+
+void game_log_scan(GameLog* log, const TagData* tag) {
+    if(!game_log_begin(log, GameLogScan)) return;
+    uint8_t uid_len = MIN(tag->uid_len, TAG_UID_MAX_LEN);
+    game_log_put_u8(log, uid_len);
+    game_log_put(log, tag->uid, uid_len);
+    game_log_end(log);
+}
+
+void game_log_power_up(GameLog* log, uint8_t power_up_id) {
+    if(!game_log_begin(log, GameLogPowerUp)) return;
+    game_log_put_u8(log, power_up_id);
+    game_log_end(log);
+}
+
+void game_log_points(GameLog* log, uint32_t points) {
+    if(!game_log_begin(log, GameLogPoints)) return;
+    game_log_put_varint(log, points);
+    game_log_end(log);
+}
+
+void game_log_checkpoint(const GameContext* context, GameLogCheckpoint* checkpoint) {
+    checkpoint->score = context->score;
+    checkpoint->tag_count = context->tag_count;
+    checkpoint->time_remaining = context->time_remaining;
+    checkpoint->combo_multiplier = context->combo_multiplier;
+    checkpoint->last_tag_key = context->last_tag_key;
+    checkpoint->state = context->state;
+}
+
+void game_log_check(GameLog* log, const GameContext* context) {
+    if(!game_log_begin(log, GameLogCheck)) return;
+    GameLogCheckpoint checkpoint;
+    game_log_checkpoint(context, &checkpoint);
+    game_log_put_varint(log, checkpoint.score);
+    game_log_put_varint(log, checkpoint.tag_count);
+    game_log_put_varint(log, checkpoint.time_remaining);
+    game_log_put_varint(log, checkpoint.combo_multiplier);
+    game_log_put_varint(log, checkpoint.last_tag_key);
+    game_log_put_u8(log, checkpoint.state);
+    game_log_end(log);
+}
+
+void game_log_input(GameLog* log, uint8_t key, uint8_t type) {
+    if(!game_log_begin(log, GameLogInput)) return;
+    game_log_put_u8(log, key);
+    game_log_put_u8(log, type);
+    game_log_end(log);
+}
+
+void game_log_location(GameLog* log, float latitude, float longitude) {
+    if(!game_log_begin(log, GameLogLocation)) return;
+    game_log_put_zigzag(log, (int32_t)(latitude * 1e7f));
+    game_log_put_zigzag(log, (int32_t)(longitude * 1e7f));
+    game_log_end(log);
+}
+
+void game_log_p2p(GameLog* log, const void* data, size_t size) {
+    if(size > GAME_LOG_MAX_BLOB || !game_log_begin(log, GameLogP2p)) return;
+    game_log_put_blob(log, data, size);
+    game_log_end(log);
+}
+
+// Lesen
+
+static bool game_log_get(GameLogReader* reader, void* out, size_t size) {
+    if(reader->size - reader->offset < size) return false;
+    memcpy(out, reader->data + reader->offset, size);
+    reader->offset += size;
+    return true;
+}
+
+static bool game_log_get_u8(GameLogReader* reader, uint8_t* value) {
+    return game_log_get(reader, value, 1);
+}
+
+static bool game_log_get_varint(GameLogReader* reader, uint32_t* value) {
+    *value = 0;
+    for(uint32_t shift = 0; shift < 35; shift += 7) {
+        uint8_t byte;
+        if(!game_log_get_u8(reader, &byte)) return false;
+        *value |= (uint32_t)(byte & 0x7F) << shift;
+        if(!(byte & 0x80)) return true;
+    }
+    return false;
+}
+
+static bool game_log_get_zigzag(GameLogReader* reader, int32_t* value) {
+    uint32_t raw;
+    if(!game_log_get_varint(reader, &raw)) return false;
+    *value = (int32_t)(raw >> 1) ^ -(int32_t)(raw & 1);
+    return true;
+}
+
+static bool game_log_get_blob(GameLogReader* reader, GameLogRecord* record) {
+    uint32_t size;
+    if(!game_log_get_varint(reader, &size)) return false;
+    if(size > GAME_LOG_MAX_BLOB || reader->size - reader->offset < size) return false;
+    record->blob.data = reader->data + reader->offset;
+    record->blob.size = size;
+    reader->offset += size;
+    return true;
+}
+
+bool game_log_reader_init(GameLogReader* reader, const uint8_t* data, size_t size) {
+    memset(reader, 0, sizeof(GameLogReader));
+    reader->data = data;
+    reader->size = size;
+
+    uint32_t magic;
+    uint16_t version;
+    uint16_t reserved;
+    return game_log_get(reader, &magic, sizeof(magic)) &&
+           game_log_get(reader, &version, sizeof(version)) &&
+           game_log_get(reader, &reserved, sizeof(reserved)) &&
+           game_log_get(reader, &reader->tick, sizeof(reader->tick)) && magic == GAME_LOG_MAGIC &&
+           version == GAME_LOG_VERSION;
+}
+
+static bool game_log_read_start(GameLogReader* reader, GameLogRecord* record) {
+    uint8_t mode;
+    if(!game_log_get_u8(reader, &mode) || mode >= GameModeCount) return false;
+    record->start.mode = mode;
+    if(!game_log_get_varint(reader, &record->start.team_id)) return false;
+    if(mode != GameModeCustom) return true;
+
+    GameModeDescriptor* custom = &record->start.custom;
+    *custom = *game_state_get_mode(GameModeCustom);
+    uint8_t flags;
+    if(!game_log_get_varint(reader, &custom->duration_sec) ||
+       !game_log_get_varint(reader, &custom->base_points) ||
+       !game_log_get_varint(reader, &custom->cooldown_ms) ||
+       !game_log_get_varint(reader, &custom->combo_window_ms) ||
+       !game_log_get_varint(reader, &custom->max_combo) ||
+       !game_log_get_varint(reader, &custom->tick_bonus) ||
+       !game_log_get_varint(reader, &custom->tick_bonus_min_remaining) ||
+       !game_log_get_varint(reader, &custom->win_score) || !game_log_get_u8(reader, &flags)) {
+        return false;
+    }
+    custom->unique_tags = flags & GAME_LOG_FLAG_UNIQUE;
+    custom->power_ups_enabled = flags & GAME_LOG_FLAG_POWER_UPS;
+    return true;
+}
+
+static bool game_log_read_check(GameLogReader* reader, GameLogCheckpoint* check) {
+    uint8_t state;
+    if(!game_log_get_varint(reader, &check->score) ||
+       !game_log_get_varint(reader, &check->tag_count) ||
+       !game_log_get_varint(reader, &check->time_remaining) ||
+       !game_log_get_varint(reader, &check->combo_multiplier) ||
+       !game_log_get_varint(reader, &check->last_tag_key) || !game_log_get_u8(reader, &state)) {
+        return false;
+    }
+    check->state = state;
+    return true;
+}
+
+bool game_log_read(GameLogReader* reader, GameLogRecord* record) {
+    if(reader->offset >= reader->size) return false;
+
+    size_t start = reader->offset;
+    uint8_t type;
+    uint32_t delta;
+    if(!game_log_get_u8(reader, &type) || type >= GameLogTypeCount ||
+       !game_log_get_varint(reader, &delta)) {
+        reader->offset = start;
+        return false;
+    }
+
+    reader->tick += delta;
+    record->type = type;
+    record->tick = reader->tick;
+
+    bool success = true;
+    switch(record->type) {
+        case GameLogStart:
+            success = game_log_read_start(reader, record);
+            break;
+        case GameLogRelay:
+        case GameLogP2p:
+            success = game_log_get_blob(reader, record);
+            break;
+        case GameLogScan:
+            memset(&record->scan, 0, sizeof(TagData));
+            success = game_log_get_u8(reader, &record->scan.uid_len) &&
+                      record->scan.uid_len <= TAG_UID_MAX_LEN &&
+                      game_log_get(reader, record->scan.uid, record->scan.uid_len);
+            break;
+        case GameLogPowerUp:
+            success = game_log_get_u8(reader, &record->power_up_id);
+            break;
+        case GameLogPoints:
+            success = game_log_get_varint(reader, &record->points);
+            break;
+        case GameLogInput:
+            success = game_log_get_u8(reader, &record->input.key) &&
+                      game_log_get_u8(reader, &record->input.type);
+            break;
+        case GameLogLocation:
+            success = game_log_get_zigzag(reader, &record->location.latitude_e7) &&
+                      game_log_get_zigzag(reader, &record->location.longitude_e7);
+            break;
+        case GameLogCheck:
+            success = game_log_read_check(reader, &record->check);
+            break;
+        default:
+            break;
+    }
+
+    if(!success) {
+        reader->offset = start;
+    }
+    return success;
+}
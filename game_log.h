@@ -0,0 +1,123 @@
+#pragma once
+
+#include <furi.h>
+#include <storage/storage.h>
+#include "game_state.h"
+
+// Kompaktes Binärprotokoll aller Eingaben eines Spiels. Nach dem Kopf
+// (Magic, Version, Starttick) folgen die Einträge: jeder ist
+// Typ (1 Byte), Zeitabstand zum vorherigen Eintrag (Varint, ms) und Nutzdaten.
+// Ein Replay speist die Einträge mit virtueller Uhr wieder in game_state_*
+// ein; Check-Einträge halten den erwarteten Spielstand fest.
+
+#define GAME_LOG_DIR EXT_PATH("apps_data/tagracer/logs")
+#define GAME_LOG_MAGIC 0x474C4754  // "TGLG"
+#define GAME_LOG_VERSION 1
+#define GAME_LOG_BUFFER_SIZE 256
+#define GAME_LOG_MAX_BLOB 1024  // RelayRoute und P2P-Nachrichten
+
+typedef enum {
+    GameLogStart,     // Modus, Team, bei GameModeCustom die Regeln
+    GameLogRelay,     // Geladene Staffel-Route (RelayRoute)
+    GameLogReset,
+    GameLogTick,      // game_state_update
+    GameLogScan,      // UID
+    GameLogPowerUp,   // Power-up ID
+    GameLogPoints,    // Punkte vom Server (game_state_add_points)
+    GameLogInput,     // Taste und Ereignistyp (nur protokolliert)
+    GameLogLocation,  // GPS-Fix in 1e-7 Grad (nur protokolliert)
+    GameLogP2p,       // Empfangene P2P-Nachricht (nur protokolliert)
+    GameLogCheck,     // Erwarteter Spielstand
+    GameLogTypeCount
+} GameLogType;
+
+// Spielstand, der beim Replay bitgenau übereinstimmen muss
+typedef struct {
+    uint32_t score;
+    uint32_t tag_count;
+    uint32_t time_remaining;
+    uint32_t combo_multiplier;
+    TagKey last_tag_key;
+    GameState state;
+} GameLogCheckpoint;
+
+struct GameLog {
+    FuriMutex* mutex;  // Scanner-, P2P- und Hauptthread schreiben
+    Storage* storage;
+    File* file;
+
+    // Alternativ direkt in einen Speicherbereich (Host, Tests)
+    uint8_t* memory;
+    size_t capacity;
+
+    uint8_t buffer[GAME_LOG_BUFFER_SIZE];
+    size_t used;
+    size_t size;       // Insgesamt geschriebene Bytes
+    uint32_t last_tick;
+    bool open;
+    bool overflow;     // Speicher voll oder Schreibfehler
+};
+
+GameLog* game_log_alloc(void);
+void game_log_free(GameLog* log);
+
+bool game_log_open_file(GameLog* log, const char* path);
+bool game_log_open_memory(GameLog* log, uint8_t* data, size_t capacity);
+// Schreibt den Puffer aus; liefert die Gesamtgröße in Bytes
+size_t game_log_close(GameLog* log);
+
+// Aufgerufen aus game_state_*, wenn context->log gesetzt ist
+void game_log_start(GameLog* log, const GameContext* context);
+void game_log_reset(GameLog* log);
+void game_log_tick(GameLog* log);
+void game_log_scan(GameLog* log, const TagData* tag);
+void game_log_power_up(GameLog* log, uint8_t power_up_id);
+void game_log_points(GameLog* log, uint32_t points);
+void game_log_check(GameLog* log, const GameContext* context);
+
+// Weitere Eingaben, nur zur Nachverfolgung
+void game_log_input(GameLog* log, uint8_t key, uint8_t type);
+void game_log_location(GameLog* log, float latitude, float longitude);
+void game_log_p2p(GameLog* log, const void* data, size_t size);
+
+void game_log_checkpoint(const GameContext* context, GameLogCheckpoint* checkpoint);
+
+// Lesen für das Replay
+typedef struct {
+    GameLogType type;
+    uint32_t tick;
+    union {
+        struct {
+            GameMode mode;
+            uint32_t team_id;
+            GameModeDescriptor custom;  // Nur Zahlenwerte, bei GameModeCustom
+        } start;
+        TagData scan;
+        uint8_t power_up_id;
+        uint32_t points;
+        struct {
+            uint8_t key;
+            uint8_t type;
+        } input;
+        struct {
+            int32_t latitude_e7;
+            int32_t longitude_e7;
+        } location;
+        struct {
+            const uint8_t* data;
+            size_t size;
+        } blob;  // GameLogRelay, GameLogP2p
+        GameLogCheckpoint check;
+    };
+} GameLogRecord;
+
+typedef struct {
+    const uint8_t* data;
+    size_t size;
+    size_t offset;
+    uint32_t tick;
+} GameLogReader;
+
+bool game_log_reader_init(GameLogReader* reader, const uint8_t* data, size_t size);
+// false am Ende oder bei beschädigten Daten (offset zeigt auf die Stelle)
+bool game_log_read(GameLogReader* reader, GameLogRecord* record);
@@ -1,6 +1,7 @@
 #include "game_state.h"
 #include <furi_hal.h>
-#include <notification/notification_messages.h>
+#include "notifier.h"
+#include "game_log.h"
 #include <math.h>
 
 #define GAME_DURATION_SEC 300
@@ -8,9 +9,227 @@
 #define COMBO_TIMEOUT_MS 5000
 #define MAX_COMBO_MULTIPLIER 8
 #define POWER_UP_DURATION_MS 30000
+#define CAPTURE_HOLD_POINTS 1
+#define TIME_WARNING_SEC 30
 
-static uint32_t last_tag_time = 0;
-static uint32_t power_up_end_times[4] = {0};
+static void game_mode_relay_start(GameContext* context) {
+    relay_route_load(&context->relay, RELAY_ROUTE_FILE);
+}
+
+static bool game_mode_relay_scan(GameContext* context, TagKey tag_key, uint32_t* points) {
+    // Ohne Routendefinition zählt jeder Tag
+    if(!context->relay.loaded) return true;
+    
+    switch(relay_route_check(&context->relay, tag_key)) {
+        case RelayStepWrong:
+            game_state_set_status(context, "Falscher Tag!");
+            return false;
+        case RelayStepLap:
+            // Bonus für eine vollständige Runde
+            *points *= 2;
+            return true;
+        default:
+            return true;
+    }
+}
+
+static void game_mode_capture_start(GameContext* context) {
+    territory_reset(&context->territory);
+}
+
+static bool game_mode_capture_scan(GameContext* context, TagKey tag_key, uint32_t* points) {
+    uint8_t team = (uint8_t)MIN(context->team_id, (uint32_t)TERRITORY_NO_TEAM);
+    
+    switch(territory_capture(&context->territory, tag_key, team, furi_get_tick())) {
+        case TerritoryCaptureHeld:
+            game_state_set_status(context, "Gebiet gehört schon dir!");
+            return false;
+        case TerritoryCaptureStolen:
+            // Gegnerische Gebiete zählen doppelt
+            *points *= 2;
+            return true;
+        default:
+            return true;
+    }
+}
+
+static void game_mode_capture_periodic(GameContext* context) {
+    game_state_update_territory(context, TAG_KEY_NONE);
+}
+
+static bool game_mode_sprint_scan(GameContext* context, TagKey tag_key, uint32_t* points) {
+    UNUSED(tag_key);
+    *points += context->time_remaining / 2;
+    return true;
+}
+
+static bool game_mode_hunter_scan(GameContext* context, TagKey tag_key, uint32_t* points) {
+    UNUSED(tag_key);
+    // Verstecker bekommt Punkte für nicht gefundene Tags
+    if(context->team_id == 0) {
+        *points = 5;
+    }
+    return true;
+}
+
+// Eingebaute Modi, Index = GameMode
+static const GameModeDescriptor game_modes[GameModeCount] = {
+    [GameModeClassic] = {
+        .name = "Classic",
+        .start_text = "Spiel gestartet!",
+        .duration_sec = GAME_DURATION_SEC,
+        .base_points = 10,
+        .cooldown_ms = TAG_COOLDOWN_MS,
+        .combo_window_ms = COMBO_TIMEOUT_MS,
+        .max_combo = MAX_COMBO_MULTIPLIER,
+        .unique_tags = true,
+        .power_ups_enabled = true,
+    },
+    [GameModeRelay] = {
+        .name = "Staffel",
+        .start_text = "Staffel gestartet!",
+        .duration_sec = GAME_DURATION_SEC,
+        .base_points = 20,
+        .cooldown_ms = TAG_COOLDOWN_MS,
+        .combo_window_ms = COMBO_TIMEOUT_MS,
+        .max_combo = MAX_COMBO_MULTIPLIER,
+        .power_ups_enabled = true,
+        .start = game_mode_relay_start,
+        .scan = game_mode_relay_scan,
+    },
+    [GameModeCapture] = {
+        .name = "Capture",
+        .start_text = "Capture gestartet!",
+        .duration_sec = GAME_DURATION_SEC,
+        .base_points = 15,
+        .cooldown_ms = TAG_COOLDOWN_MS,
+        .combo_window_ms = COMBO_TIMEOUT_MS,
+        .max_combo = MAX_COMBO_MULTIPLIER,
+        .periodic_interval_sec = 10,  // Punkte für gehaltene Gebiete
+        .power_ups_enabled = true,
+        .start = game_mode_capture_start,
+        .scan = game_mode_capture_scan,
+        .periodic = game_mode_capture_periodic,
+    },
+    [GameModeSprint] = {
+        .name = "Sprint",
+        .start_text = "Sprint gestartet!",
+        .duration_sec = 120,  // 2 Minuten für Sprint
+        .base_points = 10,
+        .cooldown_ms = TAG_COOLDOWN_MS,
+        .combo_window_ms = COMBO_TIMEOUT_MS,
+        .max_combo = MAX_COMBO_MULTIPLIER,
+        .tick_bonus = 1,  // Bonus für schnelles Scannen
+        .tick_bonus_min_remaining = 60,
+        .power_ups_enabled = true,
+        .scan = game_mode_sprint_scan,
+    },
+    [GameModeHunter] = {
+        .name = "Jäger",
+        .start_text = "Jagd beginnt!",
+        .duration_sec = 600,  // 10 Minuten für Hunter
+        .base_points = 25,
+        .cooldown_ms = TAG_COOLDOWN_MS,
+        .combo_window_ms = COMBO_TIMEOUT_MS,
+        .max_combo = MAX_COMBO_MULTIPLIER,
+        .power_ups_enabled = true,
+        .scan = game_mode_hunter_scan,
+    },
+    [GameModeStory] = {
+        .name = "Story",
+        .start_text = "Story gestartet!",
+        .duration_sec = 0,
+        .base_points = 10,
+        .cooldown_ms = TAG_COOLDOWN_MS,
+        .combo_window_ms = COMBO_TIMEOUT_MS,
+        .max_combo = MAX_COMBO_MULTIPLIER,
+        .unique_tags = true,
+        .power_ups_enabled = true,
+    },
+    // Vorlage für custom_game_create
+    [GameModeCustom] = {
+        .name = "Custom",
+        .start_text = "Eigenes Spiel gestartet!",
+        .duration_sec = GAME_DURATION_SEC,
+        .base_points = 10,
+        .cooldown_ms = TAG_COOLDOWN_MS,
+        .combo_window_ms = COMBO_TIMEOUT_MS,
+        .max_combo = MAX_COMBO_MULTIPLIER,
+        .unique_tags = true,
+        .power_ups_enabled = true,
+    },
+};
+
+const GameModeDescriptor* game_state_get_mode(GameMode mode) {
+    if(mode >= GameModeCount) return NULL;
+    return &game_modes[mode];
+}
+
+static void game_state_finish(GameContext* context) {
+    context->state = GameStateFinished;
+    timer_wheel_clear(&context->timers);
+    game_state_set_status(context, "Spiel beendet!");
+    if(context->log) game_log_check(context->log, context);
+    
+    notifier_post(NotifyGameEnd);
+}
+
+// Timer-Callbacks, arg ist der geplante Zeitpunkt bzw. die Power-up ID.
+// Wiederkehrende Timer planen vom Sollzeitpunkt aus neu, damit nichts driftet.
+
+static void game_timer_second(void* ctx, uint32_t due) {
+    GameContext* context = ctx;
+    const GameModeDescriptor* mode = context->mode_desc;
+    
+    if(mode->duration_sec > 0) {
+        if(context->time_remaining > 0) {
+            context->time_remaining--;
+            game_state_mark_dirty(context, GameDirtyTime);
+        }
+        if(context->time_remaining == 0) {
+            game_state_finish(context);
+            return;
+        }
+    }
+    
+    if(mode->tick_bonus && context->time_remaining > mode->tick_bonus_min_remaining) {
+        context->score += mode->tick_bonus * context->combo_multiplier;
+        game_state_mark_dirty(context, GameDirtyScore);
+    }
+    
+    timer_wheel_schedule(&context->timers, GameTimerSecond, due + 1000, game_timer_second, due + 1000);
+}
+
+static void game_timer_periodic(void* ctx, uint32_t due) {
+    GameContext* context = ctx;
+    const GameModeDescriptor* mode = context->mode_desc;
+    
+    mode->periodic(context);
+    
+    uint32_t next = due + mode->periodic_interval_sec * 1000;
+    timer_wheel_schedule(&context->timers, GameTimerPeriodic, next, game_timer_periodic, next);
+}
+
+static void game_timer_warning(void* ctx, uint32_t due) {
+    UNUSED(due);
+    GameContext* context = ctx;
+    
+    notifier_post(NotifyTimeWarning);
+    game_state_set_status(context, "Noch 30 Sekunden!");
+}
+
+static void game_timer_combo(void* ctx, uint32_t due) {
+    UNUSED(due);
+    GameContext* context = ctx;
+    context->combo_multiplier = 1;
+}
+
+static void game_timer_power_up(void* ctx, uint32_t power_up_id) {
+    GameContext* context = ctx;
+    context->power_ups_active[power_up_id] = false;
+    
+    notifier_post(NotifyPowerUpEnd);
+}
 
 void game_state_init(GameContext* context) {
     context->score = 0;
@@ -20,56 +239,77 @@ void game_state_init(GameContext* context) {
     context->team_id = 0;
     context->state = GameStateIdle;
     context->mode = GameModeClassic;
+    context->mode_desc = &game_modes[GameModeClassic];
+    context->custom_mode = game_modes[GameModeCustom];
     memset(context->player_id, 0, sizeof(context->player_id));
-    memset(context->last_tag_id, 0, sizeof(context->last_tag_id));
+    context->last_tag_key = TAG_KEY_NONE;
+    context->last_tag_tick = 0;
     memset(context->power_ups_active, 0, sizeof(context->power_ups_active));
-    snprintf(context->status_text, sizeof(context->status_text), "Bereit zum Start");
+    timer_wheel_init(&context->timers, furi_get_tick(), context);
+    context->dirty = GameDirtyAll;
+    tag_id_table_init(&context->scanned_tags);
+    relay_route_reset(&context->relay);
+    territory_reset(&context->territory);
+    context->log = NULL;
+    context->load_tag_callback = NULL;
+    context->callback_context = NULL;
+    game_state_set_status(context, "Bereit zum Start");
 }
 
 void game_state_reset(GameContext* context) {
     context->score = 0;
-    context->time_remaining = GAME_DURATION_SEC;
+    context->time_remaining = context->mode_desc->duration_sec;
     context->tag_count = 0;
     context->combo_multiplier = 1;
     context->state = GameStateIdle;
-    memset(context->last_tag_id, 0, sizeof(context->last_tag_id));
+    context->last_tag_key = TAG_KEY_NONE;
     memset(context->power_ups_active, 0, sizeof(context->power_ups_active));
-    snprintf(context->status_text, sizeof(context->status_text), "Spiel zurückgesetzt");
+    timer_wheel_init(&context->timers, furi_get_tick(), context);
+    game_state_mark_dirty(context, GameDirtyAll);
+    tag_id_table_clear(&context->scanned_tags);
+    game_state_set_status(context, "Spiel zurückgesetzt");
+    if(context->log) game_log_reset(context->log);
 }
 
 bool game_state_start(GameContext* context, GameMode mode) {
-    if(context->state != GameStateIdle) {
+    if(context->state != GameStateIdle || mode >= GameModeCount) {
         return false;
     }
     
+    // Eigene Regeln wurden vorher in custom_mode kompiliert
+    const GameModeDescriptor* desc =
+        (mode == GameModeCustom) ? &context->custom_mode : &game_modes[mode];
+    
     context->state = GameStateRunning;
     context->mode = mode;
-    context->time_remaining = GAME_DURATION_SEC;
+    context->mode_desc = desc;
+    context->time_remaining = desc->duration_sec;
+    game_state_mark_dirty(context, GameDirtyTime);
+    tag_id_table_clear(&context->scanned_tags);
+    game_state_set_status(context, "%s", desc->start_text);
+    if(desc->start) {
+        desc->start(context);
+    }
     
-    // Modus-spezifische Initialisierung
-    switch(mode) {
-        case GameModeRelay:
-            snprintf(context->status_text, sizeof(context->status_text), "Staffel gestartet!");
-            break;
-        case GameModeCapture:
-            snprintf(context->status_text, sizeof(context->status_text), "Capture gestartet!");
-            break;
-        case GameModeSprint:
-            context->time_remaining = 120; // 2 Minuten für Sprint
-            snprintf(context->status_text, sizeof(context->status_text), "Sprint gestartet!");
-            break;
-        case GameModeHunter:
-            context->time_remaining = 600; // 10 Minuten für Hunter
-            snprintf(context->status_text, sizeof(context->status_text), "Jagd beginnt!");
-            break;
-        default:
-            snprintf(context->status_text, sizeof(context->status_text), "Spiel gestartet!");
-            break;
+    // Alle Spielereignisse ab jetzt im Timer-Rad
+    uint32_t now = furi_get_tick();
+    TimerWheel* timers = &context->timers;
+    timer_wheel_init(timers, now, context);
+    // Erster Scan ist weder zu schnell noch Teil einer Combo
+    context->last_tag_tick = now - MAX(desc->cooldown_ms, desc->combo_window_ms);
+    
+    timer_wheel_schedule(timers, GameTimerSecond, now + 1000, game_timer_second, now + 1000);
+    if(desc->periodic && desc->periodic_interval_sec > 0) {
+        uint32_t due = now + desc->periodic_interval_sec * 1000;
+        timer_wheel_schedule(timers, GameTimerPeriodic, due, game_timer_periodic, due);
+    }
+    if(desc->duration_sec > TIME_WARNING_SEC) {
+        uint32_t due = now + (desc->duration_sec - TIME_WARNING_SEC) * 1000;
+        timer_wheel_schedule(timers, GameTimerWarning, due, game_timer_warning, due);
     }
     
-    NotificationApp* notifications = furi_record_open(RECORD_NOTIFICATION);
-    notification_message(notifications, &sequence_success);
-    furi_record_close(RECORD_NOTIFICATION);
+    if(context->log) game_log_start(context->log, context);
+    notifier_post(NotifyGameStart);
     
     return true;
 }
@@ -79,54 +319,20 @@ void game_state_update(GameContext* context) {
         return;
     }
     
-    // Zeit aktualisieren
-    if(context->time_remaining > 0) {
-        context->time_remaining--;
-        
-        // Power-ups aktualisieren
-        uint32_t current_time = furi_get_tick();
-        for(int i = 0; i < 4; i++) {
-            if(context->power_ups_active[i] && current_time >= power_up_end_times[i]) {
-                context->power_ups_active[i] = false;
-                NotificationApp* notifications = furi_record_open(RECORD_NOTIFICATION);
-                notification_message(notifications, &sequence_error);
-                furi_record_close(RECORD_NOTIFICATION);
-            }
-        }
-        
-        // Modus-spezifische Updates
-        switch(context->mode) {
-            case GameModeCapture:
-                // Territorium alle 10 Sekunden neu berechnen
-                if(context->time_remaining % 10 == 0) {
-                    game_state_update_territory(context, NULL);
-                }
-                break;
-            case GameModeSprint:
-                // Bonus für schnelles Scannen
-                if(context->time_remaining > 60) {
-                    context->score += context->combo_multiplier;
-                }
-                break;
-            default:
-                break;
-        }
-        
-        // Zeitwarnungen
-        if(context->time_remaining == 30) {
-            NotificationApp* notifications = furi_record_open(RECORD_NOTIFICATION);
-            notification_message(notifications, &sequence_warning);
-            furi_record_close(RECORD_NOTIFICATION);
-            snprintf(context->status_text, sizeof(context->status_text), "Noch 30 Sekunden!");
-        }
-    } else {
-        context->state = GameStateFinished;
-        snprintf(context->status_text, sizeof(context->status_text), "Spiel beendet!");
-        
-        NotificationApp* notifications = furi_record_open(RECORD_NOTIFICATION);
-        notification_message(notifications, &sequence_success);
-        furi_record_close(RECORD_NOTIFICATION);
+    if(context->log) game_log_tick(context->log);
+    
+    // Nur fällige Ereignisse kosten Zeit
+    timer_wheel_advance(&context->timers, furi_get_tick());
+}
+
+uint32_t game_state_next_update(GameContext* context, uint32_t max_delay) {
+    if(context->state != GameStateRunning) {
+        return max_delay;
     }
+    
+    uint32_t now = furi_get_tick();
+    uint32_t wakeup = timer_wheel_next_wakeup(&context->timers, now + max_delay);
+    return ((int32_t)(wakeup - now) > 0) ? wakeup - now : 0;
 }
 
 void game_state_process_tag(GameContext* context, TagData* tag_data) {
@@ -134,112 +340,120 @@ void game_state_process_tag(GameContext* context, TagData* tag_data) {
         return;
     }
     
-    // Prüfe Cooldown
+    if(context->log) game_log_scan(context->log, tag_data);
+    
+    const GameModeDescriptor* mode = context->mode_desc;
+    
+    // Fällige Ereignisse (Combo-Ende, Power-ups) vor dem Scan auslösen
     uint32_t current_time = furi_get_tick();
-    if(current_time - last_tag_time < TAG_COOLDOWN_MS) {
-        snprintf(context->status_text, sizeof(context->status_text), "Zu schnell! Warte...");
+    timer_wheel_advance(&context->timers, current_time);
+    if(context->state != GameStateRunning) {
         return;
     }
     
-    // Tag-ID konvertieren
-    char tag_id[32];
-    for(uint8_t i = 0; i < tag_data->uid_len; i++) {
-        snprintf(tag_id + (i * 2), 3, "%02X", tag_data->uid[i]);
+    // Prüfe Cooldown
+    if(current_time - context->last_tag_tick < mode->cooldown_ms) {
+        game_state_set_status(context, "Zu schnell! Warte...");
+        return;
     }
     
-    // Modus-spezifische Verarbeitung
-    uint32_t points = 10;
-    bool valid_scan = true;
+    // Schlüssel kommt vom Scanner, nur für fremde Quellen nachberechnen
+    if(tag_data->key == TAG_KEY_NONE) {
+        tag_data->key = tag_id_hash(tag_data->uid, tag_data->uid_len);
+    }
+    TagKey tag_key = tag_data->key;
+    bool first_scan =
+        tag_id_table_mark(&context->scanned_tags, tag_key, tag_data->uid, tag_data->uid_len);
     
-    switch(context->mode) {
-        case GameModeRelay:
-            valid_scan = game_state_check_relay_sequence(context, tag_id);
-            points = valid_scan ? 20 : 0;
-            break;
-            
-        case GameModeCapture:
-            game_state_update_territory(context, tag_id);
-            points = 15;
-            break;
-            
-        case GameModeSprint:
-            points = 10 + (context->time_remaining / 2);
-            break;
-            
-        case GameModeHunter:
-            // Verstecker bekommt Punkte für nicht gefundene Tags
-            if(context->team_id == 0) {
-                points = 5;
-            } else {
-                points = 25;
-            }
-            break;
-            
-        default:
-            // Klassischer Modus
-            if(strcmp(context->last_tag_id, tag_id) == 0) {
-                snprintf(context->status_text, sizeof(context->status_text), "Tag bereits gescannt!");
-                NotificationApp* notifications = furi_record_open(RECORD_NOTIFICATION);
-                notification_message(notifications, &sequence_error);
-                furi_record_close(RECORD_NOTIFICATION);
-                return;
-            }
-            break;
+    if(mode->unique_tags && !first_scan) {
+        game_state_set_status(context, "Tag bereits gescannt!");
+        notifier_post(NotifyScanRejected);
+        return;
     }
     
-    if(valid_scan) {
-        // Combo aktualisieren
-        game_state_update_combo(context, current_time - last_tag_time);
-        
-        // Punkte berechnen und vergeben
-        uint32_t final_points = game_state_calculate_points(context, points);
-        context->score += final_points;
-        context->tag_count++;
-        strcpy(context->last_tag_id, tag_id);
-        last_tag_time = current_time;
-        
-        // Erfolgsbenachrichtigung
-        NotificationApp* notifications = furi_record_open(RECORD_NOTIFICATION);
-        notification_message(notifications, &sequence_success);
-        furi_record_close(RECORD_NOTIFICATION);
-        
-        snprintf(context->status_text, sizeof(context->status_text), 
-                "+%ld (x%ld)", final_points, context->combo_multiplier);
+    // Modus-spezifische Verarbeitung
+    uint32_t points = mode->base_points;
+    if(mode->scan && !mode->scan(context, tag_key, &points)) {
+        return;
+    }
+    
+    // Combo aktualisieren
+    game_state_update_combo(context, current_time - context->last_tag_tick);
+    
+    // Punkte berechnen und vergeben
+    uint32_t final_points = game_state_calculate_points(context, points);
+    context->score += final_points;
+    context->tag_count++;
+    game_state_mark_dirty(context, GameDirtyScore | GameDirtyTags);
+    context->last_tag_key = tag_key;
+    context->last_tag_tick = current_time;
+    
+    // Erfolgsbenachrichtigung
+    notifier_post(NotifyScanOk);
+    
+    game_state_set_status(context, "+%ld (x%ld)", final_points, context->combo_multiplier);
+    
+    if(mode->win_score > 0 && context->score >= mode->win_score) {
+        game_state_finish(context);
     }
 }
 
+void game_state_add_points(GameContext* context, uint32_t points) {
+    if(context->state != GameStateRunning) {
+        return;
+    }
+    
+    if(context->log) game_log_points(context->log, points);
+    
+    context->score += points;
+    game_state_mark_dirty(context, GameDirtyScore);
+}
+
 void game_state_activate_power_up(GameContext* context, uint8_t power_up_id) {
-    if(power_up_id >= 4) return;
+    if(power_up_id >= 4 || !context->mode_desc->power_ups_enabled) return;
+    if(context->log) game_log_power_up(context->log, power_up_id);
     
     context->power_ups_active[power_up_id] = true;
-    power_up_end_times[power_up_id] = furi_get_tick() + POWER_UP_DURATION_MS;
+    timer_wheel_schedule(
+        &context->timers,
+        GameTimerPowerUp + power_up_id,
+        furi_get_tick() + POWER_UP_DURATION_MS,
+        game_timer_power_up,
+        power_up_id);
     
-    NotificationApp* notifications = furi_record_open(RECORD_NOTIFICATION);
-    notification_message(notifications, &sequence_success);
-    furi_record_close(RECORD_NOTIFICATION);
+    notifier_post(NotifyPowerUp);
     
     switch(power_up_id) {
         case POWERUP_DOUBLE_POINTS:
-            snprintf(context->status_text, sizeof(context->status_text), "2x Punkte aktiv!");
+            game_state_set_status(context, "2x Punkte aktiv!");
             break;
         case POWERUP_SPEED_BOOST:
-            snprintf(context->status_text, sizeof(context->status_text), "Speed Boost!");
+            game_state_set_status(context, "Speed Boost!");
             break;
         case POWERUP_SHIELD:
-            snprintf(context->status_text, sizeof(context->status_text), "Schild aktiv!");
+            game_state_set_status(context, "Schild aktiv!");
             break;
         case POWERUP_RADAR:
-            snprintf(context->status_text, sizeof(context->status_text), "Radar aktiviert!");
+            game_state_set_status(context, "Radar aktiviert!");
             break;
     }
 }
 
 void game_state_update_combo(GameContext* context, uint32_t time_since_last_tag) {
-    if(time_since_last_tag < COMBO_TIMEOUT_MS) {
-        context->combo_multiplier = MIN(context->combo_multiplier + 1, MAX_COMBO_MULTIPLIER);
+    const GameModeDescriptor* mode = context->mode_desc;
+    if(time_since_last_tag < mode->combo_window_ms) {
+        context->combo_multiplier = MIN(context->combo_multiplier + 1, mode->max_combo);
     } else {
         context->combo_multiplier = 1;
     }
+    
+    // Combo verfällt genau am Ende des Fensters, nicht erst beim nächsten Scan
+    timer_wheel_schedule(
+        &context->timers,
+        GameTimerCombo,
+        furi_get_tick() + mode->combo_window_ms,
+        game_timer_combo,
+        0);
 }
 
 uint32_t game_state_calculate_points(GameContext* context, uint32_t base_points) {
@@ -256,13 +470,25 @@ uint32_t game_state_calculate_points(GameContext* context, uint32_t base_points)
     return points;
 }
 
-bool game_state_check_relay_sequence(GameContext* context, const char* tag_id) {
-    // TODO: Implementiere Sequenz-Prüfung für Relay-Modus
-    return true;
+bool game_state_check_relay_sequence(GameContext* context, TagKey tag_key) {
+    if(!context->relay.loaded) return true;
+    return relay_route_check(&context->relay, tag_key) != RelayStepWrong;
 }
 
-void game_state_update_territory(GameContext* context, const char* tag_id) {
-    // TODO: Implementiere Territorium-Update für Capture-Modus
+void game_state_update_territory(GameContext* context, TagKey tag_key) {
+    uint8_t team = (uint8_t)MIN(context->team_id, (uint32_t)TERRITORY_NO_TEAM);
+    
+    if(tag_key != TAG_KEY_NONE) {
+        territory_capture(&context->territory, tag_key, team, furi_get_tick());
+        return;
+    }
+    
+    // Periodisch: Punkte pro gehaltenem Gebiet, O(1) über die Team-Zusammenfassung
+    uint32_t owned = territory_team_owned(&context->territory, team);
+    if(owned > 0) {
+        context->score += owned * CAPTURE_HOLD_POINTS;
+        game_state_mark_dirty(context, GameDirtyScore);
+    }
 }
 
 bool game_state_radar_ping(GameContext* context, float* distance, float* angle) {
@@ -279,3 +505,20 @@ bool game_state_radar_ping(GameContext* context, float* distance, float* angle)
 bool game_state_is_finished(GameContext* context) {
     return context->state == GameStateFinished;
 }
+
+void game_state_mark_dirty(GameContext* context, uint32_t flags) {
+    // HTTP- und Scanner-Callbacks können aus anderen Threads kommen
+    __atomic_fetch_or(&context->dirty, flags, __ATOMIC_RELEASE);
+}
+
+uint32_t game_state_take_dirty(GameContext* context) {
+    return __atomic_exchange_n(&context->dirty, 0, __ATOMIC_ACQUIRE);
+}
+
+void game_state_set_status(GameContext* context, const char* format, ...) {
+    va_list args;
+    va_start(args, format);
+    vsnprintf(context->status_text, sizeof(context->status_text), format, args);
+    va_end(args);
+    game_state_mark_dirty(context, GameDirtyStatus);
+}
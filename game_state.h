@@ -2,6 +2,9 @@
 
 #include <furi.h>
 #include "tagracer_nfc.h"
+#include "relay_route.h"
+#include "territory.h"
+#include "timer_wheel.h"
 
 typedef enum {
     GameStateIdle,
@@ -15,22 +18,87 @@ typedef enum {
     GameModeRelay,      // Staffel: Tags müssen in bestimmter Reihenfolge gescannt werden
     GameModeCapture,    // Capture the Flag: Teams kämpfen um Tag-Kontrolle
     GameModeSprint,     // Sprint: Wer scannt am schnellsten alle Tags?
-    GameModeHunter      // Jäger: Ein Spieler versteckt Tags, andere suchen
+    GameModeHunter,     // Jäger: Ein Spieler versteckt Tags, andere suchen
+    GameModeStory,      // Story: Kapitel ohne Zeitlimit
+    GameModeCustom,     // Eigene Regeln (custom_game_create)
+    GameModeCount
 } GameMode;
 
-typedef struct {
+// Feste Timer-IDs im TimerWheel des GameContext
+typedef enum {
+    GameTimerPowerUp,                      // + Power-up ID
+    GameTimerCombo = GameTimerPowerUp + 4, // Combo verfällt
+    GameTimerSecond,                       // Countdown und Sekundenbonus
+    GameTimerPeriodic,                     // GameModeDescriptor.periodic
+    GameTimerWarning,                      // 30-Sekunden-Warnung
+    GameTimerCount
+} GameTimer;
+
+// Geänderte Anzeigefelder; game_state setzt sie, der Renderer holt sie ab
+typedef enum {
+    GameDirtyScore = 1 << 0,
+    GameDirtyTime = 1 << 1,
+    GameDirtyTags = 1 << 2,
+    GameDirtyStatus = 1 << 3,
+    GameDirtyAll = 0x0F,
+} GameDirty;
+
+typedef struct GameContext GameContext;
+typedef struct GameModeDescriptor GameModeDescriptor;
+typedef struct GameLog GameLog;
+
+// Verhalten eines Spielmodus als Daten. Tick- und Scan-Pfad lesen nur diese
+// Parameter und rufen höchstens einen Hook auf, neue Modi brauchen keine
+// zusätzlichen Verzweigungen.
+struct GameModeDescriptor {
+    const char* name;
+    const char* start_text;
+    uint32_t duration_sec;            // 0 = kein Zeitlimit
+    uint32_t base_points;
+    uint32_t cooldown_ms;             // Mindestabstand zwischen zwei Scans
+    uint32_t combo_window_ms;         // Scan innerhalb des Fensters erhöht die Combo
+    uint32_t max_combo;
+    uint32_t tick_bonus;              // Punkte pro Sekunde (mal Combo)
+    uint32_t tick_bonus_min_remaining; // Bonus nur solange mehr Zeit übrig ist
+    uint32_t periodic_interval_sec;   // Abstand für periodic, 0 = nie
+    uint32_t win_score;               // Spielende bei Erreichen, 0 = keins
+    bool unique_tags;                 // Jeder Tag zählt nur einmal pro Spiel
+    bool power_ups_enabled;
+
+    // Optional: beim Spielstart, z.B. Routen laden
+    void (*start)(GameContext* context);
+    // Optional: Punkte für einen Scan bestimmen, false = ungültiger Scan
+    bool (*scan)(GameContext* context, TagKey tag_key, uint32_t* points);
+    // Optional: alle periodic_interval_sec Sekunden
+    void (*periodic)(GameContext* context);
+};
+
+struct GameContext {
     uint32_t score;
     uint32_t time_remaining;
     uint32_t tag_count;
     uint32_t combo_multiplier;  // Multiplikator für Combos
     uint32_t team_id;          // Team-ID für Team-Modi
     char player_id[32];
-    char last_tag_id[32];
+    TagKey last_tag_key;
     char status_text[64];
     GameState state;
     GameMode mode;
+    const GameModeDescriptor* mode_desc;  // Aktive Regeln, gesetzt beim Start
+    GameModeDescriptor custom_mode;       // Aus GameRules kompiliert
+    uint32_t last_tag_tick;
     bool power_ups_active[4];  // Aktive Power-ups
-} GameContext;
+    TimerWheel timers;         // Alle zeitgesteuerten Ereignisse (GameTimer)
+    uint32_t dirty;            // GameDirty-Bits seit dem letzten Frame
+    TagIdTable scanned_tags;   // Alle in diesem Spiel gescannten Tags
+    RelayRoute relay;          // Staffel-Reihenfolge, beim Start übersetzt
+    Territory territory;       // Capture-Punkte und Team-Haltezeiten
+    GameLog* log;              // Eingabeprotokoll für das Replay, NULL = aus
+    
+    // Tag-Daten nachladen (z.B. für den Prefetch im Game Optimizer)
+    bool (*load_tag_callback)(uint32_t tag_id, uint8_t* data, size_t* size, void* context);
+    void* callback_context;
+};
 
 // Power-up IDs
 #define POWERUP_DOUBLE_POINTS 0
@@ -38,17 +106,30 @@ typedef struct {
 #define POWERUP_SHIELD       2
 #define POWERUP_RADAR        3
 
+// Beschreibung eines eingebauten Modus (GameModeCustom: Klassik-Vorlage)
+const GameModeDescriptor* game_state_get_mode(GameMode mode);
+
 void game_state_init(GameContext* context);
 void game_state_reset(GameContext* context);
 bool game_state_start(GameContext* context, GameMode mode);
 void game_state_update(GameContext* context);
+// Millisekunden bis game_state_update wieder fällig ist, höchstens max_delay
+uint32_t game_state_next_update(GameContext* context, uint32_t max_delay);
 void game_state_process_tag(GameContext* context, TagData* tag_data);
+// Zusätzliche Punkte von außen, z.B. Bonus vom Server. Nur im laufenden
+// Spiel und aus dem Thread, der auch Scans und Ticks verarbeitet
+void game_state_add_points(GameContext* context, uint32_t points);
 bool game_state_is_finished(GameContext* context);
 
+// Anzeige: Änderungen markieren und für einen Frame abholen (threadsicher)
+void game_state_mark_dirty(GameContext* context, uint32_t flags);
+uint32_t game_state_take_dirty(GameContext* context);
+void game_state_set_status(GameContext* context, const char* format, ...);
+
 // Neue Funktionen
 void game_state_activate_power_up(GameContext* context, uint8_t power_up_id);
 void game_state_update_combo(GameContext* context, uint32_t time_since_last_tag);
 uint32_t game_state_calculate_points(GameContext* context, uint32_t base_points);
-bool game_state_check_relay_sequence(GameContext* context, const char* tag_id);
-void game_state_update_territory(GameContext* context, const char* tag_id);
+bool game_state_check_relay_sequence(GameContext* context, TagKey tag_key);
+void game_state_update_territory(GameContext* context, TagKey tag_key);
 bool game_state_radar_ping(GameContext* context, float* distance, float* angle);
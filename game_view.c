@@ -0,0 +1,168 @@
+#include "game_view.h"
+#include <furi_hal.h>
+
+// Nur das Overlay hat sich geändert (Statistik im Sekundentakt)
+#define GAME_VIEW_DIRTY_OVERLAY (1U << 16)
+
+void game_view_init(GameView* view) {
+    memset(view, 0, sizeof(GameView));
+    uint32_t now = furi_get_tick();
+    view->last_request = now - GAME_VIEW_FRAME_MS;
+    view->window_start = now;
+    view->fps_window_start = now;
+    // Erster Frame formatiert alle Zeilen
+    view->pending = GameDirtyAll;
+}
+
+void game_view_toggle_debug(GameView* view) {
+    view->debug = (view->debug + 1) % GameViewDebugCount;
+    // Ohne Quelle gibt es keine Link-Seite
+    if(view->debug == GameViewDebugLink && !view->debug_source) view->debug = GameViewDebugOff;
+    view->queued |= GAME_VIEW_DIRTY_OVERLAY;
+}
+
+void game_view_set_debug_source(GameView* view, GameViewDebugSource source, void* context) {
+    view->debug_source = source;
+    view->debug_context = context;
+}
+
+bool game_view_poll(GameView* view, GameContext* game) {
+    uint32_t now = furi_get_tick();
+
+    view->stats.wakeups++;
+    view->window_wakeups++;
+    uint32_t window = now - view->window_start;
+    if(window >= GAME_VIEW_STATS_MS) {
+        view->stats.wakeups_per_sec = view->window_wakeups * 1000 / window;
+        view->window_start = now;
+        view->window_wakeups = 0;
+        if(view->debug != GameViewDebugOff) {
+            view->queued |= GAME_VIEW_DIRTY_OVERLAY;
+        }
+    }
+
+    view->queued |= game_state_take_dirty(game);
+    if(!view->queued) return false;
+
+    // Frame-Begrenzung: Änderungen sammeln sich bis zum nächsten Frame
+    if(now - view->last_request < GAME_VIEW_FRAME_MS) return false;
+
+    __atomic_fetch_or(&view->pending, view->queued, __ATOMIC_RELEASE);
+    view->queued = 0;
+    view->last_request = now;
+    view->stats.requests++;
+    return true;
+}
+
+uint32_t game_view_next_frame(GameView* view, uint32_t max_delay) {
+    uint32_t now = furi_get_tick();
+    uint32_t delay = max_delay;
+
+    if(view->queued) {
+        uint32_t elapsed = now - view->last_request;
+        delay = MIN(delay, elapsed >= GAME_VIEW_FRAME_MS ? 0 : GAME_VIEW_FRAME_MS - elapsed);
+    }
+    if(view->debug != GameViewDebugOff) {
+        uint32_t elapsed = now - view->window_start;
+        delay = MIN(delay, elapsed >= GAME_VIEW_STATS_MS ? 0 : GAME_VIEW_STATS_MS - elapsed);
+    }
+
+    return delay;
+}
+
+// Nur die als geändert markierten Zeilen neu formatieren
+static void game_view_format(GameView* view, GameContext* game, uint32_t dirty) {
+    if(dirty & GameDirtyStatus) {
+        snprintf(view->status, sizeof(view->status), "%s", game->status_text);
+        view->stats.formats++;
+    }
+    if(dirty & GameDirtyScore) {
+        snprintf(view->score, sizeof(view->score), "Score: %ld", game->score);
+        view->stats.formats++;
+    }
+    if(dirty & GameDirtyTime) {
+        snprintf(view->time, sizeof(view->time), "Zeit: %ld:%02ld",
+                 game->time_remaining / 60, game->time_remaining % 60);
+        view->stats.formats++;
+    }
+    if(dirty & GameDirtyTags) {
+        if(game->mode == GameModeCapture) {
+            // Team-Zusammenfassung ist O(1), unabhängig von der Zahl der Gebiete
+            snprintf(view->tags, sizeof(view->tags), "Tags: %ld Gebiet: %u/%u",
+                     game->tag_count,
+                     territory_team_owned(&game->territory, game->team_id),
+                     game->territory.count);
+        } else {
+            snprintf(view->tags, sizeof(view->tags), "Tags: %ld", game->tag_count);
+        }
+        view->stats.formats++;
+    }
+}
+
+static void game_view_draw_main(GameView* view, Canvas* canvas) {
+    // Titel
+    canvas_set_font(canvas, FontPrimary);
+    canvas_draw_str(canvas, 2, 10, "TagRacer");
+
+    // Spielstatus
+    canvas_set_font(canvas, FontSecondary);
+    canvas_draw_str(canvas, 2, 22, view->status);
+
+    // Score, Zeit, Tag-Zähler
+    canvas_set_font(canvas, FontPrimary);
+    canvas_draw_str(canvas, 2, 36, view->score);
+    canvas_draw_str(canvas, 2, 50, view->time);
+    canvas_draw_str(canvas, 2, 64, view->tags);
+
+    // Debug-Overlay: fps, Zeichendauer, Aufwachvorgänge pro Sekunde
+    if(view->debug == GameViewDebugFrames) {
+        char overlay[32];
+        snprintf(overlay, sizeof(overlay), "%luf %luu %luw",
+                 view->stats.fps, view->stats.frame_us, view->stats.wakeups_per_sec);
+        canvas_set_font(canvas, FontSecondary);
+        canvas_draw_str(canvas, 62, 8, overlay);
+    }
+}
+
+// Link-Seite: Zeilen werden bei jedem Frame frisch geholt, neu gezeichnet
+// wird im Sekundentakt wie beim Overlay
+static void game_view_draw_link(GameView* view, Canvas* canvas) {
+    char lines[GAME_VIEW_DEBUG_LINES][GAME_VIEW_DEBUG_LINE_SIZE];
+    size_t count = view->debug_source(lines, GAME_VIEW_DEBUG_LINES, view->debug_context);
+
+    canvas_set_font(canvas, FontPrimary);
+    canvas_draw_str(canvas, 2, 10, "Link");
+    canvas_set_font(canvas, FontSecondary);
+    for(size_t i = 0; i < count; i++) {
+        canvas_draw_str(canvas, 2, 21 + i * 10, lines[i]);
+    }
+}
+
+void game_view_draw(GameView* view, GameContext* game, Canvas* canvas) {
+    FuriHalCortexTimer start = furi_hal_cortex_timer_get(0);
+
+    uint32_t dirty = __atomic_exchange_n(&view->pending, 0, __ATOMIC_ACQUIRE);
+    game_view_format(view, game, dirty);
+
+    canvas_clear(canvas);
+
+    if(view->debug == GameViewDebugLink) {
+        game_view_draw_link(view, canvas);
+    } else {
+        game_view_draw_main(view, canvas);
+    }
+
+    // Statistik für das Overlay fortschreiben
+    uint32_t now = furi_get_tick();
+    view->stats.frames++;
+    view->fps_window_frames++;
+    if(now - view->fps_window_start >= GAME_VIEW_STATS_MS) {
+        view->stats.fps = view->fps_window_frames * 1000 / (now - view->fps_window_start);
+        view->fps_window_start = now;
+        view->fps_window_frames = 0;
+    }
+
+    uint32_t cycles = furi_hal_cortex_timer_get(0).start - start.start;
+    view->stats.frame_us = cycles / furi_hal_cortex_instructions_per_microsecond();
+    view->stats.frame_us_max = MAX(view->stats.frame_us_max, view->stats.frame_us);
+}
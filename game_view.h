@@ -0,0 +1,78 @@
+#pragma once
+
+#include <furi.h>
+#include <gui/gui.h>
+#include "game_state.h"
+
+// Render-Modell der Hauptansicht. game_state markiert geänderte Felder
+// (GameDirty), nur diese Zeilen werden neu formatiert, und ein Frame wird
+// nur bei Änderungen angefordert, höchstens alle GAME_VIEW_FRAME_MS.
+
+#define GAME_VIEW_FRAME_MS 50  // Höchstens 20 fps
+#define GAME_VIEW_STATS_MS 1000
+#define GAME_VIEW_DEBUG_LINES 5
+#define GAME_VIEW_DEBUG_LINE_SIZE 32
+
+// Debug-Anzeige, Taste Hoch schaltet weiter
+typedef enum {
+    GameViewDebugOff,
+    GameViewDebugFrames,  // Overlay mit Frame-Statistik
+    GameViewDebugLink,    // Eigene Seite mit Zeilen aus debug_source
+    GameViewDebugCount,
+} GameViewDebug;
+
+// Füllt höchstens GAME_VIEW_DEBUG_LINES Zeilen, liefert deren Anzahl.
+// Läuft im GUI-Thread
+typedef size_t (*GameViewDebugSource)(
+    char lines[][GAME_VIEW_DEBUG_LINE_SIZE],
+    size_t count,
+    void* context);
+
+typedef struct {
+    uint32_t wakeups;       // Durchläufe der Hauptschleife
+    uint32_t requests;      // Angeforderte Frames
+    uint32_t frames;        // Gezeichnete Frames
+    uint32_t formats;       // Neu formatierte Zeilen
+    uint32_t frame_us;      // Zeichendauer des letzten Frames
+    uint32_t frame_us_max;
+    uint32_t fps;           // Frames in der letzten vollen Sekunde
+    uint32_t wakeups_per_sec;
+} GameViewStats;
+
+typedef struct {
+    // Hauptthread
+    uint32_t queued;         // Änderungen, die auf den nächsten Frame warten
+    uint32_t last_request;   // Tick der letzten Frame-Anforderung
+    uint32_t window_start;
+    uint32_t window_wakeups;
+    GameViewDebug debug;
+    GameViewDebugSource debug_source;
+    void* debug_context;
+
+    // Übergabe an den GUI-Thread
+    uint32_t pending;
+
+    // Nur im GUI-Thread
+    char status[64];
+    char score[32];
+    char time[32];
+    char tags[40];
+    uint32_t fps_window_start;
+    uint32_t fps_window_frames;
+
+    GameViewStats stats;
+} GameView;
+
+void game_view_init(GameView* view);
+void game_view_toggle_debug(GameView* view);
+void game_view_set_debug_source(GameView* view, GameViewDebugSource source, void* context);
+
+// Hauptthread, nach jedem Schleifendurchlauf: Änderungen abholen.
+// true = jetzt view_port_update aufrufen
+bool game_view_poll(GameView* view, GameContext* game);
+
+// Millisekunden bis ein wartender Frame gezeichnet werden darf, höchstens max_delay
+uint32_t game_view_next_frame(GameView* view, uint32_t max_delay);
+
+// GUI-Thread (render_callback)
+void game_view_draw(GameView* view, GameContext* game, Canvas* canvas);
@@ -0,0 +1,3123 @@
+#include <furi.h>
+#include <inttypes.h>
+#include <input/input.h>
+#include <pthread.h>
+#include "host_shim.h"
+#include "bench_stats.h"
+
+#include "game_state.h"
+#include "game_view.h"
+#include "notifier.h"
+#include "game_modes.h"
+#include "map_manager.h"
+#include "tagracer_nfc.h"
+#include "game_optimizer.h"
+#include "data_pipeline.h"
+#include "achievement_cache.h"
+#include "flipper_http.h"
+#include "http_parser.h"
+#include "wire_protocol.h"
+#include "json_writer.h"
+#include "game_log.h"
+#include "game_replay.h"
+#include "retry_policy.h"
+#include "offline_data.h"
+#include "compress_stream.h"
+#include <toolbox/compression.h>
+
+#define BENCH_TAG_POOL 64
+#define BENCH_DEFAULT_SCANS 1000000
+
+typedef struct {
+    uint32_t scans;
+    uint32_t seed;
+} BenchConfig;
+
+typedef struct {
+    const char* name;
+    void (*run)(const BenchConfig* config);
+} BenchSuite;
+
+static uint32_t bench_rng_state;
+
+static uint32_t bench_rand(void) {
+    uint32_t x = bench_rng_state;
+    x ^= x << 13;
+    x ^= x >> 17;
+    x ^= x << 5;
+    bench_rng_state = x;
+    return x;
+}
+
+static uint32_t bench_rand_range(uint32_t min, uint32_t max) {
+    return min + bench_rand() % (max - min + 1);
+}
+
+static void bench_make_tags(TagData* tags, size_t count) {
+    for(size_t i = 0; i < count; i++) {
+        tags[i].uid_len = 7;
+        for(uint8_t b = 0; b < tags[i].uid_len; b++) {
+            tags[i].uid[b] = (uint8_t)bench_rand();
+        }
+        // Wie der Scanner: Schlüssel einmal vorab berechnen
+        tags[i].key = tag_id_hash(tags[i].uid, tags[i].uid_len);
+    }
+}
+
+// Spielt zufällige Scans durch game_state_process_tag. Die virtuelle Uhr
+// läuft zwischen den Scans 100..3000 ms weiter, damit Cooldown, Combos und
+// Spielende (über die Timer im GameContext) realistisch greifen.
+static void bench_scan_mode(
+    const BenchConfig* config,
+    TagData* tags,
+    GameMode mode,
+    const GameRules* rules,
+    const char* name) {
+    GameContext* game = malloc(sizeof(GameContext));
+    game_state_init(game);
+    if(rules) custom_game_create(game, rules);
+    host_clock_set(0);
+    game_state_start(game, mode);
+
+    BenchHistogram* hist = malloc(sizeof(BenchHistogram));
+    bench_hist_reset(hist);
+
+    uint32_t relay_laps = 0;
+    uint64_t wall_start = host_time_ns();
+
+    for(uint32_t i = 0; i < config->scans; i++) {
+        host_clock_advance(bench_rand_range(100, 3000));
+
+        game_state_update(game);
+
+        if(game_state_is_finished(game)) {
+            relay_laps += game->relay.laps;
+            game_state_reset(game);
+            game_state_start(game, mode);
+        }
+
+        // Staffel: nur die Tags der Route, damit Abschnitte auch gelingen
+        uint32_t pool = (mode == GameModeRelay) ? 8 : BENCH_TAG_POOL;
+        TagData* tag = &tags[bench_rand() % pool];
+
+        uint64_t start = host_time_ns();
+        game_state_process_tag(game, tag);
+        bench_hist_record(hist, host_time_ns() - start);
+    }
+
+    bench_print_result(name, hist, host_time_ns() - wall_start);
+    if(mode == GameModeRelay) {
+        relay_laps += game->relay.laps;
+        printf("  relay laps %" PRIu32 ", linear %d\n", relay_laps, game->relay.linear);
+    }
+
+    free(hist);
+    free(game);
+}
+
+// Staffel über die ersten Tags des Pools: eine Route oder zwei, die sich
+// nach dem zweiten Wegpunkt verzweigen und am Ende wieder treffen
+static void bench_write_relay(const TagData* tags, bool branching) {
+    RelayBinding bindings[8];
+    for(uint32_t i = 0; i < COUNT_OF(bindings); i++) {
+        bindings[i].waypoint_id = 100 + i;
+        bindings[i].uid_len = tags[i].uid_len;
+        memcpy(bindings[i].uid, tags[i].uid, tags[i].uid_len);
+    }
+
+    Route* routes = malloc(sizeof(Route) * 2);
+    memset(routes, 0, sizeof(Route) * 2);
+    const uint32_t main_path[] = {100, 101, 102, 103, 104, 105};
+    const uint32_t side_path[] = {100, 101, 106, 107, 105};
+    routes[0].waypoint_count = COUNT_OF(main_path);
+    memcpy(routes[0].waypoints, main_path, sizeof(main_path));
+    routes[1].waypoint_count = COUNT_OF(side_path);
+    memcpy(routes[1].waypoints, side_path, sizeof(side_path));
+
+    relay_route_save(RELAY_ROUTE_FILE, bindings, COUNT_OF(bindings), routes, branching ? 2 : 1);
+    free(routes);
+}
+
+static void bench_suite_scan(const BenchConfig* config) {
+    TagData tags[BENCH_TAG_POOL];
+    bench_make_tags(tags, BENCH_TAG_POOL);
+
+    // Eigene Regeln: 3 Minuten, dreifache Tag-Punkte, Combo bis x4
+    const GameRules rules = {
+        .power_ups_enabled = true,
+        .time_limit_enabled = true,
+        .min_players = 1,
+        .max_players = 4,
+        .win_score = 5000,
+        .time_limit = 180,
+        .tag_multiplier = 3,
+        .combo_multiplier = 4,
+    };
+
+    // Wie in der App: Benachrichtigungen gehen an den Dienst-Thread
+    notifier_start();
+
+    bench_scan_mode(config, tags, GameModeClassic, NULL, "scan/classic");
+    bench_write_relay(tags, false);
+    bench_scan_mode(config, tags, GameModeRelay, NULL, "scan/relay");
+    bench_write_relay(tags, true);
+    bench_scan_mode(config, tags, GameModeRelay, NULL, "scan/relay_branch");
+    bench_scan_mode(config, tags, GameModeCapture, NULL, "scan/capture");
+    bench_scan_mode(config, tags, GameModeSprint, NULL, "scan/sprint");
+    bench_scan_mode(config, tags, GameModeHunter, NULL, "scan/hunter");
+    bench_scan_mode(config, tags, GameModeStory, NULL, "scan/story");
+    bench_scan_mode(config, tags, GameModeCustom, &rules, "scan/custom");
+
+    NotifierStats stats;
+    notifier_get_stats(&stats);
+    notifier_stop();
+    printf(
+        "  notify posted %" PRIu32 ", coalesced %" PRIu32 ", played %" PRIu32 "\n",
+        stats.posted,
+        stats.coalesced,
+        stats.played);
+}
+
+// Simuliertes NFC-Feld: jeder Tag liegt 1..4 Erkennungen lang auf,
+// jede Erkennung kostet 30 ms virtuelle Zeit und etwas reale Funkzeit.
+typedef struct {
+    TagData* tags;
+    uint32_t remaining;
+    uint32_t hold;
+    TagData* current;
+} BenchNfcField;
+
+static bool bench_nfc_source(FuriHalNfcDevData* dev_data, void* context) {
+    BenchNfcField* field = context;
+
+    host_clock_advance(30);
+    furi_delay_ms(1);
+    if(field->remaining == 0) {
+        return false;
+    }
+
+    if(field->hold == 0) {
+        field->current = &field->tags[bench_rand() % BENCH_TAG_POOL];
+        field->hold = bench_rand_range(1, 4);
+        field->remaining--;
+    }
+    field->hold--;
+
+    memcpy(dev_data->uid, field->current->uid, field->current->uid_len);
+    dev_data->uid_len = field->current->uid_len;
+    return true;
+}
+
+// Scanner-Thread schreibt in den Ring, der Hauptthread leert ihn wie
+// tagracer_app_main. Gemessen wird die Verarbeitung pro Scan sowie
+// Überläufe und Latenz Scan bis Punktevergabe (virtuelle ms).
+static void bench_suite_nfc(const BenchConfig* config) {
+    TagData tags[BENCH_TAG_POOL];
+    bench_make_tags(tags, BENCH_TAG_POOL);
+
+    BenchNfcField field = {
+        .tags = tags,
+        .remaining = config->scans / 50,
+        .hold = 0,
+        .current = NULL,
+    };
+
+    GameContext* game = malloc(sizeof(GameContext));
+    game_state_init(game);
+    host_clock_set(0);
+    game_state_start(game, GameModeClassic);
+
+    BenchHistogram* hist = malloc(sizeof(BenchHistogram));
+    bench_hist_reset(hist);
+
+    host_nfc_set_source(bench_nfc_source, &field);
+    NFCScanner* scanner = nfc_scanner_alloc();
+    uint64_t wall_start = host_time_ns();
+    nfc_scanner_start(scanner, NULL, NULL);
+
+    NfcScanRecord record;
+    while(true) {
+        if(!nfc_scanner_pop(scanner, &record)) {
+            if(__atomic_load_n(&field.remaining, __ATOMIC_ACQUIRE) == 0 &&
+               !nfc_scanner_pop(scanner, &record)) {
+                break;
+            }
+            furi_delay_ms(1);
+            continue;
+        }
+
+        uint64_t start = host_time_ns();
+        game_state_process_tag(game, &record.tag);
+        nfc_scanner_record_processed(scanner, &record);
+        bench_hist_record(hist, host_time_ns() - start);
+    }
+
+    nfc_scanner_stop(scanner);
+    uint64_t wall_ns = host_time_ns() - wall_start;
+    host_nfc_set_source(NULL, NULL);
+
+    bench_print_result("nfc/scan_to_score", hist, wall_ns);
+
+    NfcScannerStats stats;
+    nfc_scanner_get_stats(scanner, &stats);
+    printf(
+        "  detected %" PRIu32 ", debounced %" PRIu32 ", overflows %" PRIu32 ", processed %" PRIu32 ", latency avg %" PRIu32 " ms max %" PRIu32 " ms\n",
+        stats.detected,
+        stats.debounced,
+        stats.overflows,
+        stats.processed,
+        stats.processed ? stats.latency_sum / stats.processed : 0,
+        stats.latency_max);
+
+    nfc_scanner_free(scanner);
+    free(hist);
+    free(game);
+}
+
+// Capture mit wenigen und sehr vielen Gebieten: Tick- und Eroberungskosten
+// dürfen nicht von der Anzahl der Punkte abhängen
+static void bench_territory_points(const BenchConfig* config, uint32_t points) {
+    GameContext* game = malloc(sizeof(GameContext));
+    game_state_init(game);
+    host_clock_set(0);
+    game_state_start(game, GameModeCapture);
+
+    TagKey* keys = malloc(sizeof(TagKey) * points);
+    for(uint32_t i = 0; i < points; i++) {
+        keys[i] = bench_rand() | 1;
+        territory_capture(&game->territory, keys[i], bench_rand() % 4, furi_get_tick());
+    }
+
+    BenchHistogram* tick_hist = malloc(sizeof(BenchHistogram));
+    BenchHistogram* capture_hist = malloc(sizeof(BenchHistogram));
+    bench_hist_reset(tick_hist);
+    bench_hist_reset(capture_hist);
+
+    uint32_t ops = config->scans / 10;
+    uint64_t tick_ns = 0;
+    uint64_t capture_ns = 0;
+    uint32_t score = 0;
+
+    for(uint32_t i = 0; i < ops; i++) {
+        host_clock_advance(1000);
+        game->time_remaining = 300;  // Spiel nicht enden lassen
+
+        uint64_t start = host_time_ns();
+        game_state_update(game);
+        uint64_t elapsed = host_time_ns() - start;
+        bench_hist_record(tick_hist, elapsed);
+        tick_ns += elapsed;
+
+        start = host_time_ns();
+        territory_capture(
+            &game->territory, keys[bench_rand() % points], bench_rand() % 4, furi_get_tick());
+        score += territory_team_score(&game->territory, bench_rand() % 4, furi_get_tick());
+        elapsed = host_time_ns() - start;
+        bench_hist_record(capture_hist, elapsed);
+        capture_ns += elapsed;
+    }
+
+    char name[32];
+    snprintf(name, sizeof(name), "territory/tick_%" PRIu32, points);
+    bench_print_result(name, tick_hist, tick_ns);
+    snprintf(name, sizeof(name), "territory/capture_%" PRIu32, points);
+    bench_print_result(name, capture_hist, capture_ns);
+    UNUSED(score);
+
+    free(tick_hist);
+    free(capture_hist);
+    free(keys);
+    free(game);
+}
+
+static void bench_suite_territory(const BenchConfig* config) {
+    bench_territory_points(config, 5);
+    bench_territory_points(config, 250);
+}
+
+typedef struct {
+    uint32_t fired;
+    uint32_t late;    // Ausgelöst, aber nicht exakt zum Ablaufzeitpunkt
+    uint32_t max_late_ms;
+} BenchTimerStats;
+
+static BenchTimerStats bench_timer_stats;
+static TimerWheel* bench_wheel;
+
+static void bench_timer_fired(void* context, uint32_t due) {
+    UNUSED(context);
+    uint32_t late = bench_wheel->now - 1 - due;
+    bench_timer_stats.fired++;
+    if(late > 0) {
+        bench_timer_stats.late++;
+        bench_timer_stats.max_late_ms = MAX(bench_timer_stats.max_late_ms, late);
+    }
+}
+
+// Timer 0 bricht im selben Tick fällige Timer ab oder stellt sie neu
+static void bench_timer_cancel_fired(void* context, uint32_t id) {
+    UNUSED(context);
+    bench_timer_stats.fired |= 1U << id;
+    if(id == 0) {
+        for(uint8_t other = 1; other < 4; other++) {
+            timer_wheel_cancel(bench_wheel, other);
+        }
+        timer_wheel_schedule(bench_wheel, 2, bench_wheel->now + 10, bench_timer_cancel_fired, 2);
+    }
+}
+
+// Abbrechen im Callback: Timer 1..3 feuern in derselben Millisekunde wie
+// Timer 0, der sie verwirft und nur 2 zehn ms später neu stellt
+static bool bench_timers_cancel_in_callback(TimerWheel* wheel) {
+    bench_wheel = wheel;
+    memset(&bench_timer_stats, 0, sizeof(bench_timer_stats));
+    timer_wheel_init(wheel, 0, NULL);
+    // Verkehrte Reihenfolge: Timer 0 steht vorn in der Slot-Liste. Unter
+    // 64 ms bleiben alle in Ebene 0, Kaskadieren würde sie umdrehen
+    for(uint8_t id = 4; id-- > 0;) {
+        timer_wheel_schedule(wheel, id, 50, bench_timer_cancel_fired, id);
+    }
+
+    timer_wheel_advance(wheel, 50);
+    bool ok = bench_timer_stats.fired == 1 && timer_wheel_is_active(wheel, 2) &&
+              !timer_wheel_is_active(wheel, 1) && !timer_wheel_is_active(wheel, 3);
+    timer_wheel_advance(wheel, 200);
+    return ok && bench_timer_stats.fired == ((1U << 0) | (1U << 2));
+}
+
+// Timer-Rad: 16 Timer mit 1 ms..10 min Laufzeit, die Uhr springt zufällig
+// 1..2000 ms. Jeder Timer muss genau in seiner Millisekunde feuern.
+static void bench_suite_timers(const BenchConfig* config) {
+    TimerWheel* wheel = malloc(sizeof(TimerWheel));
+    bool cancel_ok = bench_timers_cancel_in_callback(wheel);
+    bench_wheel = wheel;
+    memset(&bench_timer_stats, 0, sizeof(bench_timer_stats));
+    timer_wheel_init(wheel, 0, NULL);
+
+    BenchHistogram* hist = malloc(sizeof(BenchHistogram));
+    bench_hist_reset(hist);
+
+    uint32_t now = 0;
+    uint32_t ops = config->scans;
+    uint64_t wall_start = host_time_ns();
+
+    for(uint32_t i = 0; i < ops; i++) {
+        uint8_t id = bench_rand() % TIMER_WHEEL_MAX_TIMERS;
+        if(!timer_wheel_is_active(wheel, id)) {
+            // Kurze Timer häufiger, wie Combo und Power-ups im Spiel
+            uint32_t delay = (bench_rand() & 1) ? bench_rand_range(1, 5000) :
+                                                  bench_rand_range(1, 600000);
+            timer_wheel_schedule(wheel, id, now + delay, bench_timer_fired, now + delay);
+        }
+
+        now += bench_rand_range(1, 2000);
+        uint64_t start = host_time_ns();
+        timer_wheel_advance(wheel, now);
+        bench_hist_record(hist, host_time_ns() - start);
+    }
+
+    bench_print_result("timers/advance", hist, host_time_ns() - wall_start);
+    printf(
+        "  fired %" PRIu32 ", late %" PRIu32 " (max %" PRIu32 " ms)\n",
+        bench_timer_stats.fired,
+        bench_timer_stats.late,
+        bench_timer_stats.max_late_ms);
+    printf("timers/verify: cancel in callback %s\n", cancel_ok ? "ok" : "FAILED");
+
+    free(hist);
+    free(wheel);
+}
+
+#define BENCH_RENDER_GAME_MS (600 * 1000)  // Ein Hunter-Spiel, 10 Minuten
+
+// Alte Hauptansicht: alle Zeilen bei jedem Aufwachen neu formatieren und zeichnen
+static void bench_render_legacy(GameContext* game, Canvas* canvas) {
+    canvas_clear(canvas);
+    canvas_set_font(canvas, FontPrimary);
+    canvas_draw_str(canvas, 2, 10, "TagRacer");
+    canvas_set_font(canvas, FontSecondary);
+    canvas_draw_str(canvas, 2, 22, game->status_text);
+    canvas_set_font(canvas, FontPrimary);
+
+    char score_str[32];
+    snprintf(score_str, sizeof(score_str), "Score: %" PRIu32, game->score);
+    canvas_draw_str(canvas, 2, 36, score_str);
+
+    char time_str[32];
+    snprintf(time_str, sizeof(time_str), "Zeit: %" PRIu32 ":%02" PRIu32,
+             game->time_remaining / 60, game->time_remaining % 60);
+    canvas_draw_str(canvas, 2, 50, time_str);
+
+    char tags_str[32];
+    snprintf(tags_str, sizeof(tags_str), "Tags: %" PRIu32, game->tag_count);
+    canvas_draw_str(canvas, 2, 64, tags_str);
+}
+
+typedef struct {
+    uint32_t wakeups;
+    uint32_t frames;
+    uint32_t formats;
+    uint32_t draw_calls;
+} BenchRenderCounts;
+
+// Hunter-Spiel mit seltenen Scans (alle 5..60 s). legacy = Hauptschleife
+// wacht alle 100 ms auf und zeichnet jedes Mal alles neu.
+static void bench_render_game(const BenchConfig* config, TagData* tags, bool legacy) {
+    UNUSED(config);
+    GameContext* game = malloc(sizeof(GameContext));
+    GameView* view = malloc(sizeof(GameView));
+    BenchHistogram* hist = malloc(sizeof(BenchHistogram));
+    bench_hist_reset(hist);
+
+    host_clock_set(0);
+    game_state_init(game);
+    game_view_init(view);
+    game_state_start(game, GameModeHunter);
+
+    BenchRenderCounts counts = {0};
+    uint32_t draw_calls_start = host_canvas_get_draw_calls();
+    uint32_t next_scan = bench_rand_range(5000, 60000);
+    uint64_t wall_start = host_time_ns();
+
+    while(furi_get_tick() < BENCH_RENDER_GAME_MS && !game_state_is_finished(game)) {
+        uint32_t timeout = legacy ? 100 :
+                                    game_view_next_frame(view, game_state_next_update(game, 1000));
+        uint32_t now = furi_get_tick();
+
+        // Wie furi_message_queue_get: ein Scan weckt früher als das Timeout
+        if(next_scan - now <= timeout) {
+            host_clock_set(next_scan);
+            game_state_process_tag(game, &tags[bench_rand() % BENCH_TAG_POOL]);
+            next_scan += bench_rand_range(5000, 60000);
+        } else {
+            host_clock_advance(timeout);
+        }
+        counts.wakeups++;
+        game_state_update(game);
+
+        uint64_t start = host_time_ns();
+        if(legacy) {
+            bench_render_legacy(game, NULL);
+            counts.formats += 3;
+            counts.frames++;
+        } else if(game_view_poll(view, game)) {
+            game_view_draw(view, game, NULL);
+            counts.frames++;
+        } else {
+            continue;
+        }
+        bench_hist_record(hist, host_time_ns() - start);
+    }
+
+    if(!legacy) counts.formats = view->stats.formats;
+    counts.draw_calls = host_canvas_get_draw_calls() - draw_calls_start;
+
+    bench_print_result(legacy ? "render/legacy" : "render/dirty", hist, host_time_ns() - wall_start);
+    printf(
+        "  wakeups %" PRIu32 ", frames %" PRIu32 ", formats %" PRIu32 ", draw calls %" PRIu32 "\n",
+        counts.wakeups,
+        counts.frames,
+        counts.formats,
+        counts.draw_calls);
+
+    free(hist);
+    free(view);
+    free(game);
+}
+
+static void bench_suite_render(const BenchConfig* config) {
+    TagData tags[BENCH_TAG_POOL];
+    bench_make_tags(tags, BENCH_TAG_POOL);
+
+    bench_render_game(config, tags, true);
+    bench_render_game(config, tags, false);
+}
+
+static bool bench_upload_ok(DataBatch* batch, void* context) {
+    UNUSED(batch);
+    UNUSED(context);
+    return true;
+}
+
+static void bench_suite_pipeline(const BenchConfig* config) {
+    DataPipeline* pipeline = data_pipeline_alloc();
+    data_pipeline_set_upload_callback(pipeline, bench_upload_ok, NULL);
+
+    uint8_t payload[1024];
+    for(size_t i = 0; i < sizeof(payload); i++) {
+        payload[i] = (uint8_t)(i / 16);
+    }
+
+    BenchHistogram* hist = malloc(sizeof(BenchHistogram));
+    bench_hist_reset(hist);
+
+    uint32_t items = config->scans / 10;
+    uint64_t wall_start = host_time_ns();
+
+    for(uint32_t i = 0; i < items; i++) {
+        uint32_t size = bench_rand_range(32, sizeof(payload));
+        host_clock_advance(bench_rand_range(10, 500));
+
+        uint64_t start = host_time_ns();
+        if(!data_pipeline_add_item(
+               pipeline, DataTypeTag, i, payload, size, bench_rand_range(0, 3))) {
+            // Batch voll: wie der Worker synchron verarbeiten und hochladen
+            data_pipeline_process_batch(pipeline);
+            data_pipeline_upload_batch(pipeline);
+            data_pipeline_add_item(pipeline, DataTypeTag, i, payload, size, 0);
+        }
+        bench_hist_record(hist, host_time_ns() - start);
+    }
+
+    bench_print_result("pipeline/add_item", hist, host_time_ns() - wall_start);
+
+    free(hist);
+    data_pipeline_free(pipeline);
+}
+
+static void bench_suite_achievements(const BenchConfig* config) {
+    AchievementCache* cache = achievement_cache_alloc();
+
+    BenchHistogram* hist = malloc(sizeof(BenchHistogram));
+    bench_hist_reset(hist);
+
+    uint32_t updates = config->scans / 10;
+    uint64_t wall_start = host_time_ns();
+
+    for(uint32_t i = 0; i < updates; i++) {
+        host_clock_advance(bench_rand_range(10, 200));
+
+        uint64_t start = host_time_ns();
+        achievement_cache_update(cache, bench_rand() % 48, i);
+        bench_hist_record(hist, host_time_ns() - start);
+
+        if(i % 64 == 0) {
+            achievement_cache_cleanup(cache);
+        }
+    }
+
+    bench_print_result("achievements/update", hist, host_time_ns() - wall_start);
+
+    free(hist);
+    achievement_cache_free(cache);
+}
+
+static void bench_suite_optimizer(const BenchConfig* config) {
+    GameContext* game = malloc(sizeof(GameContext));
+    game_state_init(game);
+    GameOptimizer* optimizer = game_optimizer_alloc(game, NULL, NULL);
+
+    BenchHistogram* move_hist = malloc(sizeof(BenchHistogram));
+    BenchHistogram* cache_hist = malloc(sizeof(BenchHistogram));
+    bench_hist_reset(move_hist);
+    bench_hist_reset(cache_hist);
+
+    uint32_t ops = config->scans / 10;
+    uint8_t data[CACHE_LINE_SIZE] = {0};
+    float x = 0;
+    float y = 0;
+
+    uint64_t wall_start = host_time_ns();
+    for(uint32_t i = 0; i < ops; i++) {
+        host_clock_advance(bench_rand_range(50, 1000));
+        x += (float)(bench_rand() % 200) / 100.0f - 1.0f;
+        y += (float)(bench_rand() % 200) / 100.0f - 1.0f;
+
+        uint64_t start = host_time_ns();
+        game_optimizer_update_movement(optimizer, x, y, 1.4f);
+        bench_hist_record(move_hist, host_time_ns() - start);
+    }
+    bench_print_result("optimizer/update_movement", move_hist, host_time_ns() - wall_start);
+
+    wall_start = host_time_ns();
+    for(uint32_t i = 0; i < ops; i++) {
+        uint32_t tag_id = bench_rand() % 512;
+        size_t size = 0;
+
+        uint64_t start = host_time_ns();
+        if(!game_optimizer_get_cached_tag(optimizer, tag_id, data, &size)) {
+            game_optimizer_cache_tag(optimizer, tag_id, data, sizeof(data));
+        }
+        bench_hist_record(cache_hist, host_time_ns() - start);
+    }
+    bench_print_result("optimizer/tag_cache", cache_hist, host_time_ns() - wall_start);
+
+    free(move_hist);
+    free(cache_hist);
+    game_optimizer_free(optimizer);
+    free(game);
+}
+
+// Simulierte Bridge am UART: 115200 Baud in beide Richtungen, 150 ms vom
+// Request bis zur Server-Antwort. Antwortet im Format des Requests, HTTP
+// oder Binärrahmen. Die Leitungszeit wird mit furi_delay_ms
+// nachgebildet, Zeiten unten sind reale Host-Zeit (furi_delay_ms läuft 10x).
+#define BENCH_HTTP_REQUESTS 100
+#define BENCH_HTTP_BYTES_PER_SEC (115200 / 10)
+#define BENCH_HTTP_RTT_MS 150
+
+typedef struct {
+    FlipperHTTPRequestId id;
+    uint64_t due_ns;
+    bool wire;
+    bool get;           // Suite cache: Bestenliste
+    bool not_modified;  // If-None-Match passt, 304 ohne Body
+} BenchHttpPending;
+
+typedef struct {
+    FuriMessageQueue* pending;  // Requests in Ankunftsreihenfolge
+    FuriThread* thread;
+    uint32_t records;           // Serverseitig angelegte Scans
+    uint64_t tx_bytes;          // Nur Requests, ohne Hello
+    uint64_t rx_bytes;
+    uint32_t link_reports;      // LinkStats-Rahmen des Flipper
+    volatile bool clock_running;
+    volatile uint32_t clock_offset;  // Auf die virtuelle Zeit aufgeschlagen
+    // Suite retry: jeden drop_every-ten Request verlieren, down = alle
+    uint32_t drop_every;
+    volatile bool down;
+    uint32_t arrivals;
+    uint32_t dropped;
+    volatile uint16_t server_error;  // Status statt der Antwort, Wire als Ack
+    // Suite cache: GET liefert die Bestenliste mit ETag "v<board_version>"
+    volatile uint32_t board_version;
+    uint32_t max_age;  // s, 0 = kein Cache-Control
+    uint32_t gets;
+    uint32_t not_modified;
+} BenchBridge;
+
+typedef struct {
+    FuriMessageQueue* done;
+    uint64_t sent_ns[BENCH_HTTP_REQUESTS + 1];
+    BenchHistogram* hist;
+    char body[32];
+    size_t body_len;
+    uint32_t ok;
+    bool wire;
+} BenchHttpClient;
+
+static void bench_link_delay(size_t size) {
+    furi_delay_ms(size * 1000 / BENCH_HTTP_BYTES_PER_SEC);
+}
+
+#define BENCH_CACHE_PLAYERS 12
+
+// Bestenliste wie /api/leaderboard, rund 600 Bytes
+static int bench_cache_board(char* out, size_t size, uint32_t version) {
+    int length = snprintf(out, size, "{\"version\":%" PRIu32 ",\"leaderboard\":[", version);
+    for(uint32_t i = 0; i < BENCH_CACHE_PLAYERS; i++) {
+        length += snprintf(
+            out + length,
+            size - length,
+            "%s{\"username\":\"player%02" PRIu32 "\",\"total_score\":%" PRIu32 "}",
+            i ? "," : "",
+            i,
+            (version * 37 + i * 101) % 1000);
+    }
+    length += snprintf(out + length, size - length, "]}");
+    return length;
+}
+
+// Läuft in furi_hal_uart_tx: ein Aufruf trägt genau einen Request
+static void bench_bridge_sink(const uint8_t* data, size_t size, void* context) {
+    BenchBridge* bridge = context;
+    bench_link_delay(size);
+
+    BenchHttpPending pending = {
+        .due_ns = host_time_ns() + BENCH_HTTP_RTT_MS * 100000ULL,
+    };
+    if(data[0] == WIRE_SYNC) {
+        // Hello-Antwort bestätigt nur den Modus
+        if(size >= WIRE_HEADER_SIZE && data[1] == WireTypeLinkStats) bridge->link_reports++;
+        if(size < WIRE_HEADER_SIZE || data[1] != WireTypeTagScan) return;
+        pending.id = data[2] | (data[3] << 8);
+        pending.wire = true;
+    } else {
+        const char* header = strstr((const char*)data, "X-Request-Id: ");
+        if(!header) return;
+        pending.id = strtoul(header + 14, NULL, 10);
+        pending.get = strncmp((const char*)data, "GET ", 4) == 0;
+        const char* match = strstr((const char*)data, "If-None-Match: ");
+        if(pending.get && match) {
+            char etag[16];
+            snprintf(etag, sizeof(etag), "\"v%" PRIu32 "\"\r\n", bridge->board_version);
+            pending.not_modified = strncmp(match + 15, etag, strlen(etag)) == 0;
+        }
+    }
+    bridge->tx_bytes += size;
+    bridge->arrivals++;
+    if(bridge->down || (bridge->drop_every && bridge->arrivals % bridge->drop_every == 0)) {
+        bridge->dropped++;
+        return;
+    }
+    bridge->records++;
+    furi_message_queue_put(bridge->pending, &pending, FuriWaitForever);
+}
+
+static int32_t bench_bridge_task(void* context) {
+    BenchBridge* bridge = context;
+    BenchHttpPending pending;
+
+    while(true) {
+        furi_message_queue_get(bridge->pending, &pending, FuriWaitForever);
+        if(pending.id == FLIPPER_HTTP_REQUEST_NONE) break;
+
+        uint64_t now = host_time_ns();
+        // furi_delay_ms: 1 ms entspricht 100 µs Host-Zeit
+        if(pending.due_ns > now) furi_delay_ms((pending.due_ns - now) / 100000);
+
+        char response[1024];
+        int length;
+        if(bridge->server_error && pending.wire) {
+            WireAck ack = {.status = bridge->server_error};
+            length = wire_encode((uint8_t*)response, sizeof(response), WireTypeAck, pending.id, &ack, sizeof(ack));
+        } else if(bridge->server_error) {
+            length = snprintf(
+                response,
+                sizeof(response),
+                "HTTP/1.1 %u Bad Gateway\r\nX-Request-Id: %" PRIu32 "\r\nContent-Length: 0\r\n\r\n",
+                bridge->server_error,
+                pending.id);
+        } else if(pending.wire) {
+            WireScanResult result = {.points = 10};
+            length = wire_encode(
+                (uint8_t*)response, sizeof(response), WireTypeScanResult, pending.id, &result, sizeof(result));
+        } else if(pending.get) {
+            char cache_control[48] = "";
+            if(bridge->max_age) snprintf(cache_control, sizeof(cache_control), "Cache-Control: max-age=%" PRIu32 "\r\n", bridge->max_age);
+            uint32_t version = bridge->board_version;
+            char board[768];
+            int board_length = pending.not_modified ? 0 : bench_cache_board(board, sizeof(board), version);
+            length = snprintf(
+                response,
+                sizeof(response),
+                "HTTP/1.1 %s\r\nX-Request-Id: %" PRIu32 "\r\nETag: \"v%" PRIu32 "\"\r\n%sContent-Length: %d\r\n\r\n%s",
+                pending.not_modified ? "304 Not Modified" : "200 OK",
+                pending.id,
+                version,
+                cache_control,
+                board_length,
+                pending.not_modified ? "" : board);
+            bridge->gets++;
+            if(pending.not_modified) bridge->not_modified++;
+        } else {
+            length = snprintf(
+                response,
+                sizeof(response),
+                "HTTP/1.1 200 OK\r\nX-Request-Id: %" PRIu32 "\r\nContent-Length: 13\r\n\r\n{\"points\":10}",
+                pending.id);
+        }
+        bench_link_delay(length);
+        bridge->rx_bytes += length;
+        host_uart_receive(FLIPPER_HTTP_UART, (const uint8_t*)response, length);
+    }
+    return 0;
+}
+
+// Virtuelle Ticks folgen der nachgebildeten Leitungszeit, damit die
+// Zeitstempel in flipper_http_get_link_stats Leitungs-ms zeigen. Läuft ab
+// dem aktuellen Tick weiter, ein Rücksprung hielte Backoffs fest
+static int32_t bench_http_clock(void* context) {
+    BenchBridge* bridge = context;
+    uint64_t start = host_time_ns();
+    uint32_t base = furi_get_tick();
+    while(bridge->clock_running) {
+        host_clock_set(base + (host_time_ns() - start) / 100000 + bridge->clock_offset);
+        furi_delay_ms(1);
+    }
+    return 0;
+}
+
+static void bench_http_body(const uint8_t* data, size_t size, size_t offset, void* context) {
+    BenchHttpClient* client = context;
+    if(offset == 0) client->body_len = 0;
+    size_t count = MIN(size, sizeof(client->body) - 1 - client->body_len);
+    memcpy(client->body + client->body_len, data, count);
+    client->body_len += count;
+}
+
+static void bench_http_callback(FlipperHTTPResponse* response, void* context) {
+    BenchHttpClient* client = context;
+    client->body[client->body_len] = '\0';
+    bool expected;
+    if(client->wire) {
+        WireScanResult result;
+        memcpy(&result, client->body, sizeof(result));
+        expected = client->body_len == sizeof(result) && result.points == 10;
+    } else {
+        expected = strcmp(client->body, "{\"points\":10}") == 0;
+    }
+    if(response->status_code == 200 && expected) {
+        client->ok++;
+    }
+    if(response->id <= BENCH_HTTP_REQUESTS) {
+        bench_hist_record(client->hist, host_time_ns() - client->sent_ns[response->id]);
+    }
+    uint8_t token = 1;
+    furi_message_queue_put(client->done, &token, FuriWaitForever);
+}
+
+// serial = wie bisher ein Request nach dem anderen, sonst als Burst mit
+// Wiederholung, solange die Warteschlange voll ist. wire = die Bridge
+// handelt zuerst Binärrahmen aus, Scans gehen als WireTagScan
+static void bench_http_run(const char* name, bool serial, bool wire) {
+    BenchBridge bridge = {0};
+    bridge.pending = furi_message_queue_alloc(BENCH_HTTP_REQUESTS + 1, sizeof(BenchHttpPending));
+    bridge.thread = furi_thread_alloc_ex("BenchBridge", 2048, bench_bridge_task, &bridge);
+    furi_thread_start(bridge.thread);
+    host_uart_set_sink(FLIPPER_HTTP_UART, bench_bridge_sink, &bridge);
+    bridge.clock_running = true;
+    FuriThread* clock = furi_thread_alloc_ex("BenchClock", 1024, bench_http_clock, &bridge);
+    furi_thread_start(clock);
+
+    BenchHttpClient* client = malloc(sizeof(BenchHttpClient));
+    memset(client, 0, sizeof(BenchHttpClient));
+    client->done = furi_message_queue_alloc(BENCH_HTTP_REQUESTS, sizeof(uint8_t));
+    client->hist = malloc(sizeof(BenchHistogram));
+    client->wire = wire;
+    bench_hist_reset(client->hist);
+
+    FlipperHTTP* http = flipper_http_alloc();
+    flipper_http_init(http);
+
+    if(wire) {
+        uint8_t frame[WIRE_FRAME_MAX];
+        WireHello hello = {.version = WIRE_VERSION, .max_payload = WIRE_MAX_PAYLOAD};
+        size_t length = wire_encode(frame, sizeof(frame), WireTypeHello, 0, &hello, sizeof(hello));
+        host_uart_receive(FLIPPER_HTTP_UART, frame, length);
+        while(flipper_http_get_mode(http) != FlipperHTTPModeWire) {
+            furi_delay_ms(1);
+        }
+    }
+
+    char body[64];
+    FlipperHTTPRequest request = {
+        .method = "POST",
+        .url = "http://localhost:5000/api/tag",
+        .body = body,
+        .callback = bench_http_callback,
+        .body_callback = bench_http_body,
+        .context = client,
+    };
+    WireTagScan scan = {.uid_len = 7, .player_id = "bench"};
+    FlipperHTTPMessage message = {
+        .type = WireTypeTagScan,
+        .payload = &scan,
+        .size = sizeof(scan),
+        .callback = bench_http_callback,
+        .body_callback = bench_http_body,
+        .context = client,
+    };
+
+    uint8_t token;
+    uint64_t wall_start = host_time_ns();
+    for(uint32_t i = 0; i < BENCH_HTTP_REQUESTS; i++) {
+        snprintf(body, sizeof(body), "{\"tag_id\":\"%08" PRIx32 "\",\"player_id\":\"bench\"}", i);
+        memcpy(scan.uid, &i, sizeof(i));
+        scan.timestamp = i;
+        uint64_t sent = host_time_ns();
+        FlipperHTTPRequestId id;
+        while((id = wire ? flipper_http_send_message(http, &message) :
+                           flipper_http_send_request(http, &request)) == FLIPPER_HTTP_REQUEST_NONE) {
+            furi_delay_ms(1);
+        }
+        client->sent_ns[id] = sent;
+        if(serial) furi_message_queue_get(client->done, &token, FuriWaitForever);
+    }
+    if(!serial) {
+        for(uint32_t i = 0; i < BENCH_HTTP_REQUESTS; i++) {
+            furi_message_queue_get(client->done, &token, FuriWaitForever);
+        }
+    }
+    uint64_t wall_ns = host_time_ns() - wall_start;
+
+    FlipperHTTPStats stats;
+    FlipperHTTPLinkStats link;
+    flipper_http_get_stats(http, &stats);
+    flipper_http_get_link_stats(http, &link);
+    flipper_http_deinit(http);
+    flipper_http_free(http);
+
+    BenchHttpPending stop = {0};
+    furi_message_queue_put(bridge.pending, &stop, FuriWaitForever);
+    furi_thread_join(bridge.thread);
+    furi_thread_free(bridge.thread);
+    host_uart_set_sink(FLIPPER_HTTP_UART, NULL, NULL);
+    bridge.clock_running = false;
+    furi_thread_join(clock);
+    furi_thread_free(clock);
+
+    bench_print_result(name, client->hist, wall_ns);
+    // Auslastung der Senderichtung, Leitungszeit in Host-Zeit umgerechnet
+    uint64_t link_ns = bridge.tx_bytes * 100000000ULL / BENCH_HTTP_BYTES_PER_SEC;
+    printf(
+        "  server records %" PRIu32 "/%u, ok %" PRIu32 ", rejected %" PRIu32 ", timeouts %" PRIu32 ", max in flight %" PRIu32 ", link %" PRIu32 "%%, %" PRIu32 "/%" PRIu32 " B per scan\n",
+        bridge.records,
+        BENCH_HTTP_REQUESTS,
+        client->ok,
+        stats.rejected,
+        stats.timeouts,
+        stats.max_in_flight,
+        (uint32_t)(link_ns * 100 / wall_ns),
+        (uint32_t)(bridge.tx_bytes / MAX(bridge.records, 1U)),
+        (uint32_t)(bridge.rx_bytes / MAX(bridge.records, 1U)));
+    // Sicht des Flipper in Leitungs-ms
+    printf(
+        "  link rtt p50/p90/p99 %" PRIu32 "/%" PRIu32 "/%" PRIu32 " ms, queue p50/p99 %" PRIu32 "/%" PRIu32 " ms, %" PRIu32 "/%" PRIu32 " B total, %" PRIu32 " samples, %" PRIu32 " reports\n",
+        link.rtt_p50,
+        link.rtt_p90,
+        link.rtt_p99,
+        link.queue_p50,
+        link.queue_p99,
+        link.tx_bytes,
+        link.rx_bytes,
+        link.samples,
+        bridge.link_reports);
+
+    furi_message_queue_free(bridge.pending);
+    furi_message_queue_free(client->done);
+    free(client->hist);
+    free(client);
+}
+
+static void bench_suite_http(const BenchConfig* config) {
+    UNUSED(config);
+    bench_http_run("http/serial", true, false);
+    bench_http_run("http/pipelined", false, false);
+}
+
+// HTTP-Parser: zufällige Antworten (Content-Length und chunked, Bodies bis
+// 8 KB, überlange Kopfzeilen, Trailer) laufen in zufälligen Stücken durch
+// einen 256-Byte-Ring. Jede Antwort muss mit Status, ID, Länge und
+// Prüfsumme ankommen. Danach dieselben Daten mit gekippten Bytes: es darf
+// nur Fehler geben, keinen Absturz.
+#define BENCH_PARSER_RESPONSES 2000
+#define BENCH_PARSER_RING 256
+#define BENCH_PARSER_STACK (64 * 1024)
+#define BENCH_FNV_OFFSET 2166136261U
+
+typedef struct {
+    uint8_t* data;
+    size_t size;
+    size_t capacity;
+} BenchBuffer;
+
+typedef struct {
+    uint32_t id;
+    int status;
+    uint32_t size;
+    uint32_t hash;
+} BenchParserExpect;
+
+typedef struct {
+    const uint8_t* stream;
+    size_t stream_size;
+    const BenchParserExpect* expect;
+    uint32_t index;
+    uint32_t hash;
+    uint32_t mismatches;
+    uint32_t slices;
+    BenchHistogram* hist;
+    uint64_t stream_ns;
+    uint64_t fuzz_bytes;
+    uint32_t fuzz_errors;
+    uint32_t fuzz_responses;
+} BenchParserRun;
+
+static void bench_buffer_append(BenchBuffer* buffer, const void* data, size_t size) {
+    if(buffer->size + size > buffer->capacity) {
+        buffer->capacity = MAX(buffer->capacity * 2, buffer->size + size);
+        buffer->data = realloc(buffer->data, buffer->capacity);
+    }
+    memcpy(buffer->data + buffer->size, data, size);
+    buffer->size += size;
+}
+
+static void bench_buffer_printf(BenchBuffer* buffer, const char* format, ...) {
+    char line[160];
+    va_list args;
+    va_start(args, format);
+    int length = vsnprintf(line, sizeof(line), format, args);
+    va_end(args);
+    bench_buffer_append(buffer, line, MIN((size_t)length, sizeof(line) - 1));
+}
+
+static uint32_t bench_fnv(uint32_t hash, const uint8_t* data, size_t size) {
+    for(size_t i = 0; i < size; i++) {
+        hash = (hash ^ data[i]) * 16777619U;
+    }
+    return hash;
+}
+
+static void bench_parser_make(BenchBuffer* stream, BenchParserExpect* expect) {
+    uint8_t body[8192];
+
+    for(uint32_t i = 0; i < BENCH_PARSER_RESPONSES; i++) {
+        BenchParserExpect* e = &expect[i];
+        e->id = i + 1;
+        e->status = (bench_rand() % 8) ? 200 : 404;
+        e->size = (bench_rand() % 4) ? bench_rand_range(0, 256) : bench_rand_range(0, sizeof(body));
+        for(uint32_t b = 0; b < e->size; b++) body[b] = (uint8_t)bench_rand();
+        e->hash = bench_fnv(BENCH_FNV_OFFSET, body, e->size);
+        bool chunked = bench_rand() & 1;
+
+        bench_buffer_printf(stream, "HTTP/1.1 %d %s\r\n", e->status, e->status == 200 ? "OK" : "Not Found");
+        if(bench_rand() % 4 == 0) {
+            // Länger als HTTP_PARSER_LINE_SIZE
+            bench_buffer_printf(stream, "X-Padding: %0120d\r\n", 0);
+        }
+        bench_buffer_printf(stream, "Content-Type: application/json\r\nX-Request-Id: %lu\r\n", e->id);
+        if(chunked) {
+            bench_buffer_printf(stream, (bench_rand() & 1) ? "Transfer-Encoding: chunked\r\n" : "transfer-encoding: Chunked\r\n");
+        } else {
+            bench_buffer_printf(stream, "Content-Length: %lu\r\n", e->size);
+        }
+        bench_buffer_printf(stream, "\r\n");
+
+        if(!chunked) {
+            bench_buffer_append(stream, body, e->size);
+        } else {
+            uint32_t offset = 0;
+            while(offset < e->size) {
+                // MIN wertet seine Argumente mehrfach aus
+                uint32_t chunk = (bench_rand() % 4) ? bench_rand_range(1, 16) : bench_rand_range(1, 2000);
+                chunk = MIN(chunk, e->size - offset);
+                bench_buffer_printf(stream, (bench_rand() & 1) ? "%lx\r\n" : "%lX;ext=1\r\n", chunk);
+                bench_buffer_append(stream, body + offset, chunk);
+                bench_buffer_printf(stream, "\r\n");
+                offset += chunk;
+            }
+            bench_buffer_printf(stream, (bench_rand() % 4) ? "0\r\n\r\n" : "0\r\nX-Trailer: 1\r\n\r\n");
+        }
+    }
+}
+
+static void bench_parser_body(HttpParser* parser, const uint8_t* data, size_t size, void* context) {
+    UNUSED(parser);
+    BenchParserRun* run = context;
+    run->hash = bench_fnv(run->hash, data, size);
+    run->slices++;
+}
+
+static void bench_parser_complete(HttpParser* parser, void* context) {
+    BenchParserRun* run = context;
+    const BenchParserExpect* e = &run->expect[run->index++];
+    if(parser->request_id != e->id || parser->status_code != e->status ||
+       parser->body_size != e->size || run->hash != e->hash) {
+        run->mismatches++;
+    }
+    run->hash = BENCH_FNV_OFFSET;
+}
+
+static const HttpParserCallbacks bench_parser_callbacks = {
+    .on_body = bench_parser_body,
+    .on_complete = bench_parser_complete,
+};
+
+static const HttpParserCallbacks bench_fuzz_callbacks = {0};
+
+// Läuft auf einem eigenen, vorab gefüllten Stack (Messung der Stacktiefe)
+static void* bench_parser_task(void* context) {
+    BenchParserRun* run = context;
+    static uint8_t ring_buffer[BENCH_PARSER_RING];
+    HttpRxRing ring;
+    HttpParser parser;
+
+    http_rx_ring_init(&ring, ring_buffer, sizeof(ring_buffer));
+    http_parser_init(&parser, &bench_parser_callbacks, run);
+    run->hash = BENCH_FNV_OFFSET;
+
+    // Zufällige Lesegrößen wie beim UART, der Ring läuft ständig über sein Ende
+    uint64_t start_ns = host_time_ns();
+    size_t offset = 0;
+    while(offset < run->stream_size) {
+        size_t chunk = bench_rand_range(1, 300);
+        chunk = MIN(chunk, run->stream_size - offset);
+        offset += http_rx_ring_write(&ring, run->stream + offset, chunk);
+
+        const uint8_t* data;
+        size_t size;
+        while((size = http_rx_ring_peek(&ring, &data)) > 0) {
+            uint64_t feed_start = host_time_ns();
+            size_t consumed = http_parser_feed(&parser, data, size);
+            bench_hist_record(run->hist, host_time_ns() - feed_start);
+            http_rx_ring_release(&ring, consumed);
+            if(parser.state == HttpParseError) break;
+        }
+    }
+    run->stream_ns = host_time_ns() - start_ns;
+    if(parser.errors || run->index != BENCH_PARSER_RESPONSES) run->mismatches++;
+
+    // Gekippte Bytes: Fehler zählen, danach wie flipper_http neu aufsetzen
+    uint8_t* copy = malloc(run->stream_size);
+    memcpy(copy, run->stream, run->stream_size);
+    for(size_t i = 0; i < run->stream_size / 512; i++) {
+        copy[bench_rand() % run->stream_size] = (uint8_t)bench_rand();
+    }
+    http_parser_init(&parser, &bench_fuzz_callbacks, NULL);
+    offset = 0;
+    while(offset < run->stream_size) {
+        size_t chunk = bench_rand_range(1, 300);
+        chunk = MIN(chunk, run->stream_size - offset);
+        size_t consumed = http_parser_feed(&parser, copy + offset, chunk);
+        if(parser.state == HttpParseError) {
+            http_parser_reset(&parser);
+            consumed = chunk;
+        }
+        offset += consumed;
+    }
+    run->fuzz_bytes = run->stream_size;
+    run->fuzz_errors = parser.errors;
+    run->fuzz_responses = parser.responses;
+    free(copy);
+
+    return NULL;
+}
+
+static void* bench_idle_task(void* context) {
+    return context;
+}
+
+// Höchster belegter Stack eines Threads, abzüglich eines leeren Threads
+static size_t bench_stack_run(void* (*task)(void*), void* context) {
+    void* stack;
+    if(posix_memalign(&stack, 4096, BENCH_PARSER_STACK) != 0) return 0;
+    memset(stack, 0xA5, BENCH_PARSER_STACK);
+
+    pthread_attr_t attr;
+    pthread_attr_init(&attr);
+    pthread_attr_setstack(&attr, stack, BENCH_PARSER_STACK);
+    pthread_t thread;
+    pthread_create(&thread, &attr, task, context);
+    pthread_join(thread, NULL);
+    pthread_attr_destroy(&attr);
+
+    size_t untouched = 0;
+    while(untouched < BENCH_PARSER_STACK && ((uint8_t*)stack)[untouched] == 0xA5) {
+        untouched++;
+    }
+    (free)(stack);
+    return BENCH_PARSER_STACK - untouched;
+}
+
+static void bench_suite_parser(const BenchConfig* config) {
+    UNUSED(config);
+    BenchBuffer stream = {0};
+    BenchParserExpect* expect = malloc(sizeof(BenchParserExpect) * BENCH_PARSER_RESPONSES);
+    bench_parser_make(&stream, expect);
+
+    BenchParserRun run = {
+        .stream = stream.data,
+        .stream_size = stream.size,
+        .expect = expect,
+        .hist = malloc(sizeof(BenchHistogram)),
+    };
+    bench_hist_reset(run.hist);
+
+    size_t idle = bench_stack_run(bench_idle_task, NULL);
+    size_t used = bench_stack_run(bench_parser_task, &run);
+
+    bench_print_result("parser/feed", run.hist, run.stream_ns);
+    printf(
+        "  %u responses, %zu KB, %" PRIu32 " KB/s, slices %" PRIu32 ", mismatches %" PRIu32 ", stack %zu B\n",
+        BENCH_PARSER_RESPONSES,
+        stream.size / 1024,
+        (uint32_t)(stream.size * 1000000ULL / MAX(run.stream_ns, 1ULL)),
+        run.slices,
+        run.mismatches,
+        used > idle ? used - idle : 0);
+    printf(
+        "  fuzz %" PRIu32 " KB mutated, errors %" PRIu32 ", responses %" PRIu32 "\n",
+        (uint32_t)(run.fuzz_bytes / 1024),
+        run.fuzz_errors,
+        run.fuzz_responses);
+
+    free(run.hist);
+    free(expect);
+    free(stream.data);
+}
+
+// Binärrahmen: zufällige Nachrichten aller Nutzdatentypen mit Fremdbytes
+// dazwischen, in zufälligen Stücken dekodiert; jeder Rahmen muss mit Typ,
+// ID und Prüfsumme ankommen. Danach mit gekippten Bytes: kaputte Rahmen
+// fallen durch die CRC, die übrigen kommen trotzdem an. Zum Schluss
+// dieselben Scans wie in der http-Suite, nach Aushandlung als Binärrahmen.
+#define BENCH_WIRE_FRAMES 20000
+
+typedef struct {
+    uint8_t type;
+    uint32_t hash;
+} BenchWireExpect;
+
+typedef struct {
+    const BenchWireExpect* expect;
+    uint32_t received;
+    uint32_t mismatches;  // Falscher Inhalt trotz gültiger CRC
+} BenchWireRun;
+
+static const uint8_t bench_wire_types[] = {
+    WireTypeTagScan,
+    WireTypeGameState,
+    WireTypeAchievement,
+    WireTypeSyncChunk,
+};
+
+// ID = Index + 1, eindeutig solange BENCH_WIRE_FRAMES < 65536
+static void bench_wire_frame(WireDecoder* decoder, const WireFrame* frame, void* context) {
+    UNUSED(decoder);
+    BenchWireRun* run = context;
+    run->received++;
+    if(frame->id == 0 || frame->id > BENCH_WIRE_FRAMES) {
+        run->mismatches++;
+        return;
+    }
+    const BenchWireExpect* e = &run->expect[frame->id - 1];
+    if(frame->type != e->type ||
+       bench_fnv(BENCH_FNV_OFFSET, (const uint8_t*)frame->payload, frame->size) != e->hash) {
+        run->mismatches++;
+    }
+}
+
+static uint64_t bench_wire_decode(BenchWireRun* run, const uint8_t* stream, size_t size, WireDecoder* decoder, BenchHistogram* hist) {
+    wire_decoder_init(decoder, bench_wire_frame, run);
+    uint64_t start_ns = host_time_ns();
+    size_t offset = 0;
+    while(offset < size) {
+        size_t chunk = bench_rand_range(1, 300);
+        chunk = MIN(chunk, size - offset);
+        size_t end = offset + chunk;
+        while(offset < end) {
+            uint64_t feed_start = host_time_ns();
+            offset += wire_decoder_feed(decoder, stream + offset, end - offset);
+            if(hist) bench_hist_record(hist, host_time_ns() - feed_start);
+        }
+    }
+    return host_time_ns() - start_ns;
+}
+
+static void bench_suite_wire(const BenchConfig* config) {
+    UNUSED(config);
+    BenchBuffer stream = {0};
+    BenchWireExpect* expect = malloc(sizeof(BenchWireExpect) * BENCH_WIRE_FRAMES);
+    WirePayload payload;
+    uint8_t frame[WIRE_FRAME_MAX];
+    uint64_t encode_ns = 0;
+    size_t frame_bytes = 0;
+
+    for(uint32_t i = 0; i < BENCH_WIRE_FRAMES; i++) {
+        BenchWireExpect* e = &expect[i];
+        e->type = bench_wire_types[bench_rand() % COUNT_OF(bench_wire_types)];
+        size_t size = wire_payload_size(e->type);
+        for(size_t b = 0; b < size; b++) ((uint8_t*)&payload)[b] = (uint8_t)bench_rand();
+        e->hash = bench_fnv(BENCH_FNV_OFFSET, (const uint8_t*)&payload, size);
+
+        // Fremdbytes ohne Sync-Byte, wie Reste einer Textausgabe
+        uint32_t junk = (bench_rand() % 8) ? 0 : bench_rand_range(1, 16);
+        for(uint32_t b = 0; b < junk; b++) {
+            uint8_t byte = (uint8_t)bench_rand();
+            if(byte == WIRE_SYNC) byte = 0;
+            bench_buffer_append(&stream, &byte, 1);
+        }
+
+        uint64_t start = host_time_ns();
+        size_t length = wire_encode(frame, sizeof(frame), e->type, i + 1, &payload, size);
+        encode_ns += host_time_ns() - start;
+        frame_bytes += length;
+        bench_buffer_append(&stream, frame, length);
+    }
+
+    BenchHistogram* hist = malloc(sizeof(BenchHistogram));
+    bench_hist_reset(hist);
+    WireDecoder* decoder = malloc(sizeof(WireDecoder));
+    BenchWireRun run = {.expect = expect};
+    uint64_t decode_ns = bench_wire_decode(&run, stream.data, stream.size, decoder, hist);
+    if(run.received != BENCH_WIRE_FRAMES || decoder->errors) run.mismatches++;
+
+    bench_print_result("wire/decode", hist, decode_ns);
+    printf(
+        "  %u frames, %zu KB, encode %" PRIu32 " KB/s, decode %" PRIu32 " KB/s, skipped %" PRIu32 " B, mismatches %" PRIu32 "\n",
+        BENCH_WIRE_FRAMES,
+        stream.size / 1024,
+        (uint32_t)(frame_bytes * 1000000ULL / MAX(encode_ns, 1ULL)),
+        (uint32_t)(stream.size * 1000000ULL / MAX(decode_ns, 1ULL)),
+        decoder->skipped,
+        run.mismatches);
+
+    // Ein gekipptes Byte pro 512
+    for(size_t i = 0; i < stream.size / 512; i++) {
+        stream.data[bench_rand() % stream.size] = (uint8_t)bench_rand();
+    }
+    BenchWireRun fuzz = {.expect = expect};
+    bench_wire_decode(&fuzz, stream.data, stream.size, decoder, NULL);
+    printf(
+        "  fuzz %zu bytes mutated, frames %" PRIu32 "/%u, errors %" PRIu32 ", false accepts %" PRIu32 "\n",
+        stream.size / 512,
+        fuzz.received,
+        BENCH_WIRE_FRAMES,
+        decoder->errors,
+        fuzz.mismatches);
+
+    free(decoder);
+    free(hist);
+    free(expect);
+    free(stream.data);
+
+    bench_http_run("wire/serial", true, true);
+    bench_http_run("wire/pipelined", false, true);
+}
+
+// JSON-Bodies: die früheren strcat-Helfer aus flipper_http gegen den
+// JsonWriter, einmal für den Tag-Scan-Body und einmal für ein Objekt mit
+// 32 Feldern. Beide müssen dasselbe JSON liefern. Danach ein voller
+// Pipeline-Batch über einen 256-Byte-Puffer mit flush.
+#define BENCH_JSON_LEGACY_SIZE 512
+#define BENCH_JSON_WIDE_FIELDS 32
+
+static char* bench_json_legacy_create_object() {
+    char* json = malloc(BENCH_JSON_LEGACY_SIZE);
+    strcpy(json, "{");
+    return json;
+}
+
+static void bench_json_legacy_add_string(char* json, const char* key, const char* value) {
+    char buffer[BENCH_JSON_LEGACY_SIZE];
+    snprintf(buffer, sizeof(buffer), "\"%s\":\"%s\",", key, value);
+    strcat(json, buffer);
+}
+
+static void bench_json_legacy_add_int(char* json, const char* key, int value) {
+    char buffer[32];
+    snprintf(buffer, sizeof(buffer), "\"%s\":%d,", key, value);
+    strcat(json, buffer);
+}
+
+static void bench_json_legacy_add_bool(char* json, const char* key, bool value) {
+    char buffer[32];
+    snprintf(buffer, sizeof(buffer), "\"%s\":%s,", key, value ? "true" : "false");
+    strcat(json, buffer);
+}
+
+static void bench_json_legacy_close_object(char* json) {
+    size_t len = strlen(json);
+    if(json[len-1] == ',') {
+        json[len-1] = '}';
+    } else {
+        strcat(json, "}");
+    }
+}
+
+static const char* const bench_json_keys[] = {
+    "score", "tag_count", "combo", "team", "mode", "state", "player_id", "ready",
+};
+
+// Feld i: abwechselnd Zahl, String und Bool
+static void bench_json_wide_legacy(char* out, size_t size) {
+    char* json = bench_json_legacy_create_object();
+    for(uint32_t i = 0; i < BENCH_JSON_WIDE_FIELDS; i++) {
+        const char* key = bench_json_keys[i % COUNT_OF(bench_json_keys)];
+        if(i % 3 == 0) bench_json_legacy_add_int(json, key, i * 1000);
+        if(i % 3 == 1) bench_json_legacy_add_string(json, key, "runner");
+        if(i % 3 == 2) bench_json_legacy_add_bool(json, key, i & 1);
+    }
+    bench_json_legacy_close_object(json);
+    snprintf(out, size, "%s", json);
+    free(json);
+}
+
+static void bench_json_wide_writer(char* out, size_t size) {
+    JsonWriter json;
+    json_writer_init(&json, out, size);
+    json_writer_begin_object(&json);
+    for(uint32_t i = 0; i < BENCH_JSON_WIDE_FIELDS; i++) {
+        const char* key = bench_json_keys[i % COUNT_OF(bench_json_keys)];
+        if(i % 3 == 0) json_writer_add_int(&json, key, i * 1000);
+        if(i % 3 == 1) json_writer_add_string(&json, key, "runner");
+        if(i % 3 == 2) json_writer_add_bool(&json, key, i & 1);
+    }
+    json_writer_end_object(&json);
+    json_writer_finish(&json);
+}
+
+static void bench_json_tag_legacy(char* out, size_t size, const TagData* tag) {
+    char tag_id[TAG_ID_HEX_SIZE];
+    tag_id_format_hex(tag->uid, tag->uid_len, tag_id, sizeof(tag_id));
+    char* json = bench_json_legacy_create_object();
+    bench_json_legacy_add_string(json, "tag_id", tag_id);
+    bench_json_legacy_add_string(json, "player_id", "bench");
+    bench_json_legacy_close_object(json);
+    snprintf(out, size, "%s", json);
+    free(json);
+}
+
+static void bench_json_tag_writer(char* out, size_t size, const TagData* tag) {
+    JsonWriter json;
+    json_writer_init(&json, out, size);
+    json_writer_begin_object(&json);
+    json_writer_key(&json, "tag_id");
+    json_writer_hex(&json, tag->uid, tag->uid_len);
+    json_writer_add_string(&json, "player_id", "bench");
+    json_writer_end_object(&json);
+    json_writer_finish(&json);
+}
+
+typedef struct {
+    void (*tag)(char* out, size_t size, const TagData* tag);
+    void (*wide)(char* out, size_t size);
+} BenchJsonImpl;
+
+static uint32_t bench_json_run(const char* name, bool wide, const BenchJsonImpl* impl, const TagData* tags, uint32_t ops, char* out) {
+    BenchHistogram* hist = malloc(sizeof(BenchHistogram));
+    bench_hist_reset(hist);
+    uint32_t hash = BENCH_FNV_OFFSET;
+
+    uint64_t wall_start = host_time_ns();
+    for(uint32_t i = 0; i < ops; i++) {
+        uint64_t start = host_time_ns();
+        if(wide) {
+            impl->wide(out, BENCH_JSON_LEGACY_SIZE);
+        } else {
+            impl->tag(out, BENCH_JSON_LEGACY_SIZE, &tags[i % BENCH_TAG_POOL]);
+        }
+        bench_hist_record(hist, host_time_ns() - start);
+        if(i < BENCH_TAG_POOL) hash = bench_fnv(hash, (const uint8_t*)out, strlen(out));
+    }
+    bench_print_result(name, hist, host_time_ns() - wall_start);
+
+    free(hist);
+    return hash;
+}
+
+typedef struct {
+    uint64_t bytes;
+    uint32_t flushes;
+} BenchJsonSink;
+
+static bool bench_json_flush(const char* data, size_t size, void* context) {
+    UNUSED(data);
+    BenchJsonSink* sink = context;
+    sink->bytes += size;
+    sink->flushes++;
+    return true;
+}
+
+static void bench_suite_json(const BenchConfig* config) {
+    static const BenchJsonImpl legacy = {bench_json_tag_legacy, bench_json_wide_legacy};
+    static const BenchJsonImpl writer = {bench_json_tag_writer, bench_json_wide_writer};
+    TagData tags[BENCH_TAG_POOL];
+    bench_make_tags(tags, BENCH_TAG_POOL);
+    char out[BENCH_JSON_LEGACY_SIZE];
+    uint32_t ops = config->scans / 10;
+
+    uint32_t tag_legacy = bench_json_run("json/tag_legacy", false, &legacy, tags, ops, out);
+    uint32_t tag_writer = bench_json_run("json/tag_writer", false, &writer, tags, ops, out);
+    uint32_t wide_legacy = bench_json_run("json/wide_legacy", true, &legacy, tags, ops, out);
+    uint32_t wide_writer = bench_json_run("json/wide_writer", true, &writer, tags, ops, out);
+    size_t wide_size = strlen(out);
+
+    // Maskierung und Überlauf
+    JsonWriter json;
+    json_writer_init(&json, out, sizeof(out));
+    json_writer_begin_array(&json);
+    json_writer_string(&json, "a\"b\\c\n\x01");
+    json_writer_fixed(&json, -525200000, 7);
+    json_writer_int(&json, INT32_MIN);
+    json_writer_end_array(&json);
+    bool escaped = json_writer_finish(&json) &&
+                   strcmp(out, "[\"a\\\"b\\\\c\\n\\u0001\",-52.5200000,-2147483648]") == 0;
+    char small[16];
+    json_writer_init(&json, small, sizeof(small));
+    json_writer_begin_object(&json);
+    json_writer_add_string(&json, "player_id", "too long for this buffer");
+    json_writer_end_object(&json);
+    bool truncated = json_writer_finish(&json) == 0 && json.truncated;
+
+    printf(
+        "  output tag %s, wide %s (%zu B), escaping %s, truncation %s\n",
+        tag_legacy == tag_writer ? "identical" : "DIFFERENT",
+        wide_legacy == wide_writer ? "identical" : "DIFFERENT",
+        wide_size,
+        escaped ? "ok" : "FAILED",
+        truncated ? "reported" : "MISSED");
+
+    // Voller Batch, gestreamt durch einen kleinen Puffer
+    DataBatch* batch = malloc(sizeof(DataBatch));
+    uint8_t payload[128];
+    for(size_t i = 0; i < sizeof(payload); i++) payload[i] = (uint8_t)bench_rand();
+    batch->count = MAX_BATCH_SIZE;
+    for(uint32_t i = 0; i < MAX_BATCH_SIZE; i++) {
+        batch->items[i] = (DataItem){
+            .type = DataTypeTag,
+            .id = i,
+            .timestamp = 1700000000 + i,
+            .size = sizeof(payload),
+            .data = payload,
+        };
+    }
+
+    BenchHistogram* hist = malloc(sizeof(BenchHistogram));
+    bench_hist_reset(hist);
+    BenchJsonSink sink = {0};
+    char segment[256];
+    uint32_t batches = MAX(ops / 100, 1U);
+    uint64_t wall_start = host_time_ns();
+    for(uint32_t i = 0; i < batches; i++) {
+        uint64_t start = host_time_ns();
+        json_writer_init(&json, segment, sizeof(segment));
+        json_writer_set_flush(&json, bench_json_flush, &sink);
+        data_pipeline_write_batch_json(batch, &json);
+        json_writer_finish(&json);
+        bench_hist_record(hist, host_time_ns() - start);
+    }
+    uint64_t wall_ns = host_time_ns() - wall_start;
+    bench_print_result("json/pipeline_batch", hist, wall_ns);
+    printf(
+        "  %" PRIu32 " B per batch, %" PRIu32 " KB/s through a %zu B buffer\n",
+        (uint32_t)(sink.bytes / batches),
+        (uint32_t)(sink.bytes * 1000000ULL / MAX(wall_ns, 1ULL)),
+        sizeof(segment));
+
+    free(hist);
+    free(batch);
+}
+
+// Wiederholung und Circuit Breaker: zuerst retry_policy allein mit festen
+// Zeitpunkten, dann die DataPipeline mit virtueller Zeit durch einen
+// Serverausfall und zuletzt flipper_http an der Bench-Bridge mit verlorenen
+// Requests, vollem Ausfall und Erholung nach BREAKER_OPEN_MS.
+#define BENCH_RETRY_STEP_MS 2000
+#define BENCH_RETRY_STEPS 300           // 10 Minuten
+#define BENCH_RETRY_OUTAGE_START 30
+#define BENCH_RETRY_OUTAGE_END 180      // 5 Minuten Ausfall
+#define BENCH_RETRY_DROP_EVERY 10
+#define BENCH_RETRY_OUTAGE_REQUESTS 40
+#define BENCH_RETRY_RECOVER_REQUESTS 20
+#define BENCH_RETRY_SCAN_REQUESTS 40     // Verliert 4, unter der Breaker-Schwelle
+#define BENCH_RETRY_SERVER_ERRORS 2      // Je Modus, zusammen unter der Breaker-Schwelle
+
+typedef struct {
+    volatile bool down;
+    uint32_t attempts;
+    uint32_t failures;
+    uint32_t uploaded;
+    uint32_t spilled;
+    uint32_t spills;
+} BenchRetryPipeline;
+
+static bool bench_retry_upload(DataBatch* batch, void* context) {
+    BenchRetryPipeline* run = context;
+    run->attempts++;
+    if(run->down) {
+        run->failures++;
+        return false;
+    }
+    run->uploaded += batch->count;
+    return true;
+}
+
+static bool bench_retry_spill(DataBatch* batch, void* context) {
+    BenchRetryPipeline* run = context;
+    run->spilled += batch->count;
+    run->spills++;
+    return data_pipeline_spill_offline(batch, NULL);
+}
+
+static uint32_t bench_retry_pending_lines(void) {
+    Storage* storage = furi_record_open(RECORD_STORAGE);
+    File* file = storage_file_alloc(storage);
+    uint32_t lines = 0;
+    if(storage_file_open(file, PENDING_UPLOAD_FILE, FSAM_READ, FSOM_OPEN_EXISTING)) {
+        char buffer[256];
+        size_t count;
+        while((count = storage_file_read(file, buffer, sizeof(buffer))) > 0) {
+            for(size_t i = 0; i < count; i++) {
+                if(buffer[i] == '\n') lines++;
+            }
+        }
+    }
+    storage_file_close(file);
+    storage_file_free(file);
+    furi_record_close(RECORD_STORAGE);
+    return lines;
+}
+
+// Body, der nach dem ersten Spülen des Writers abbricht (Objekt bleibt offen)
+static void bench_retry_torn_body(JsonWriter* json, void* context) {
+    UNUSED(context);
+    json_writer_begin_object(json);
+    for(uint32_t i = 0; i < 16; i++) {
+        json_writer_add_string(json, "pad", "0123456789abcdef");
+    }
+}
+
+static void bench_retry_scan_body(JsonWriter* json, void* context) {
+    UNUSED(context);
+    json_writer_raw(json, "{\"tag_id\":\"04a1b2c3\",\"player_id\":\"bench\"}");
+}
+
+// Gescheiterter Eintrag darf keine halbe Zeile hinterlassen: danach steht
+// genau der folgende Eintrag in pending.jsonl, als ganze Zeile
+static bool bench_retry_pending_torn(void) {
+    Storage* storage = furi_record_open(RECORD_STORAGE);
+    storage_common_remove(storage, PENDING_UPLOAD_FILE);
+    bool failed = !offline_data_queue_upload("POST", "http://localhost:5000/api/tag", bench_retry_torn_body, NULL);
+    bool queued = offline_data_queue_upload("POST", "http://localhost:5000/api/tag", bench_retry_scan_body, NULL);
+
+    char line[256] = "";
+    size_t size = 0;
+    File* file = storage_file_alloc(storage);
+    if(storage_file_open(file, PENDING_UPLOAD_FILE, FSAM_READ, FSOM_OPEN_EXISTING)) {
+        size = storage_file_read(file, line, sizeof(line) - 1);
+        line[size] = '\0';
+    }
+    storage_file_close(file);
+    storage_file_free(file);
+    storage_common_remove(storage, PENDING_UPLOAD_FILE);
+    furi_record_close(RECORD_STORAGE);
+
+    return failed && queued && size > 2 && line[0] == '{' && strchr(line, '\n') == line + size - 1 &&
+           line[size - 2] == '}';
+}
+
+static void bench_retry_policy(void) {
+    const RetryConfig config = {
+        .base_ms = 500, .max_ms = 8000, .max_attempts = 3, .failure_threshold = 5, .open_ms = 15000};
+    RetryPolicy policy;
+    retry_policy_init(&policy, &config);
+
+    // Backoff je Versuch in [delay / 2, delay], delay = min(max, base * 2^(n - 1))
+    uint32_t in_range = 0;
+    uint32_t draws = 0;
+    uint32_t spread[6] = {0};
+    for(uint8_t attempt = 1; attempt <= 6; attempt++) {
+        uint32_t delay = MIN(config.base_ms << (attempt - 1), config.max_ms);
+        uint32_t low = UINT32_MAX;
+        uint32_t high = 0;
+        for(uint32_t i = 0; i < 1000; i++) {
+            uint32_t wait = retry_policy_backoff(&policy, attempt);
+            if(wait >= delay / 2 && wait <= delay) in_range++;
+            low = MIN(low, wait);
+            high = MAX(high, wait);
+            draws++;
+        }
+        spread[attempt - 1] = high - low;
+    }
+
+    // Closed -> Open -> Reject -> Probe -> Open -> Probe -> Closed, danach
+    // dasselbe mit Auftragskennungen
+    bool ok = true;
+    uint32_t now = 1000;
+    for(uint8_t i = 0; i < config.failure_threshold; i++) {
+        ok &= retry_policy_check(&policy, now) == RetryAllow;
+        retry_policy_failure(&policy, now);
+    }
+    ok &= policy.state == RetryBreakerOpen && !retry_policy_can_retry(&policy, 1);
+    ok &= retry_policy_check(&policy, now + config.open_ms - 1) == RetryReject;
+    ok &= retry_policy_open_remaining(&policy, now + 1000) == config.open_ms - 1000;
+    now += config.open_ms;
+    ok &= retry_policy_check(&policy, now) == RetryAllow && policy.state == RetryBreakerHalfOpen;
+    ok &= retry_policy_check(&policy, now) == RetryWait;
+    retry_policy_failure(&policy, now);
+    ok &= policy.state == RetryBreakerOpen;
+    now += config.open_ms;
+    ok &= retry_policy_check(&policy, now) == RetryAllow;
+    retry_policy_success(&policy);
+    ok &= policy.state == RetryBreakerClosed && retry_policy_can_retry(&policy, 1) &&
+          !retry_policy_can_retry(&policy, config.max_attempts);
+
+    // Mehrere Aufträge unterwegs: nur die Probe (job 7) schließt, späte
+    // Antworten älterer Aufträge nicht; eine verworfene Probe öffnet wieder
+    for(uint8_t i = 0; i < config.failure_threshold; i++) {
+        retry_policy_failure_job(&policy, i + 1, now);
+    }
+    retry_policy_success_job(&policy, 6);
+    ok &= policy.state == RetryBreakerOpen;
+    now += config.open_ms;
+    ok &= retry_policy_check_job(&policy, 7, now) == RetryAllow;
+    retry_policy_success_job(&policy, 3);
+    retry_policy_failure_job(&policy, 4, now);
+    retry_policy_abandon(&policy, 5, now);
+    ok &= policy.state == RetryBreakerHalfOpen && retry_policy_check_job(&policy, 8, now) == RetryWait;
+    retry_policy_abandon(&policy, 7, now + 100);
+    ok &= policy.state == RetryBreakerOpen &&
+          retry_policy_open_remaining(&policy, now + 100) == config.open_ms;
+    now += 100 + config.open_ms;
+    ok &= retry_policy_check_job(&policy, 9, now) == RetryAllow;
+    retry_policy_success_job(&policy, 9);
+    ok &= policy.state == RetryBreakerClosed;
+
+    printf(
+        "retry/policy: backoff in range %" PRIu32 "/%" PRIu32 ", jitter spread %" PRIu32 "..%" PRIu32 " ms, breaker %s (opened %" PRIu32 ", probes %" PRIu32 ", rejected %" PRIu32 ")\n",
+        in_range,
+        draws,
+        spread[0],
+        spread[5],
+        ok ? "ok" : "FAILED",
+        policy.stats.opened,
+        policy.stats.probes,
+        policy.stats.rejected);
+}
+
+static void bench_retry_pipeline(void) {
+    Storage* storage = furi_record_open(RECORD_STORAGE);
+    storage_common_remove(storage, PENDING_UPLOAD_FILE);
+    furi_record_close(RECORD_STORAGE);
+
+    BenchRetryPipeline run = {0};
+    host_clock_set(0);
+    DataPipeline* pipeline = data_pipeline_alloc();
+    data_pipeline_set_upload_callback(pipeline, bench_retry_upload, &run);
+    data_pipeline_set_spill_callback(pipeline, bench_retry_spill, &run);
+
+    uint8_t payload[256];
+    for(size_t i = 0; i < sizeof(payload); i++) {
+        payload[i] = (uint8_t)(i / 16);
+    }
+
+    // Ein Item je Schritt, der Worker läuft alle 100 virtuellen ms und
+    // sieht so etwa einen Takt pro Schritt
+    uint32_t items = 0;
+    uint64_t wall_start = host_time_ns();
+    for(uint32_t step = 0; step < BENCH_RETRY_STEPS + 10; step++) {
+        run.down = step >= BENCH_RETRY_OUTAGE_START && step < BENCH_RETRY_OUTAGE_END;
+        if(step < BENCH_RETRY_STEPS &&
+           data_pipeline_add_item(
+               pipeline, DataTypeTag, step, payload, bench_rand_range(32, sizeof(payload)), 0)) {
+            items++;
+        }
+        host_clock_advance(BENCH_RETRY_STEP_MS);
+        furi_delay_ms(100);
+    }
+    uint64_t wall_ns = host_time_ns() - wall_start;
+
+    furi_mutex_acquire(pipeline->mutex, FuriWaitForever);
+    uint32_t left = pipeline->batch.count;
+    uint32_t dropped = pipeline->dropped_items;
+    RetryStats stats = pipeline->retry.stats;
+    furi_mutex_release(pipeline->mutex);
+    data_pipeline_free(pipeline);
+
+    uint32_t outage_ms = (BENCH_RETRY_OUTAGE_END - BENCH_RETRY_OUTAGE_START) * BENCH_RETRY_STEP_MS;
+    printf(
+        "retry/pipeline: %" PRIu32 " items, uploaded %" PRIu32 ", spilled %" PRIu32 " in %" PRIu32 " lines (%" PRIu32 " in file), dropped %" PRIu32 ", left %" PRIu32 ", %" PRIu32 " ms wall\n",
+        items,
+        run.uploaded,
+        run.spilled,
+        run.spills,
+        bench_retry_pending_lines(),
+        dropped,
+        left,
+        (uint32_t)(wall_ns / 1000000));
+    // Ohne Backoff hätte jeder Worker-Takt im Ausfall erneut gesendet
+    printf(
+        "  %" PRIu32 " s outage: %" PRIu32 " upload attempts, %" PRIu32 " failed (every tick: up to %" PRIu32 "), breaker opened %" PRIu32 ", probes %" PRIu32 ", rejected %" PRIu32 "\n",
+        outage_ms / 1000,
+        run.attempts,
+        run.failures,
+        outage_ms / 100,
+        stats.opened,
+        stats.probes,
+        stats.rejected);
+
+    storage = furi_record_open(RECORD_STORAGE);
+    storage_common_remove(storage, PENDING_UPLOAD_FILE);
+    furi_record_close(RECORD_STORAGE);
+}
+
+typedef struct {
+    uint32_t count;
+    uint32_t circuit_open;
+} BenchRetryUndelivered;
+
+static void bench_retry_write_body(JsonWriter* json, void* context) {
+    const FlipperHTTPUndelivered* request = context;
+    if(request->wire_type == WireTypeTagScan) {
+        const WireTagScan* scan = request->payload;
+        json_writer_begin_object(json);
+        json_writer_add_uint(json, "timestamp", scan->timestamp);
+        json_writer_end_object(json);
+    } else {
+        json_writer_raw(json, request->body);
+    }
+}
+
+// Wie http_undelivered_callback in tagracer.c: offline für den Sync ablegen
+static void bench_retry_undelivered(const FlipperHTTPUndelivered* request, void* context) {
+    BenchRetryUndelivered* undelivered = context;
+    undelivered->count++;
+    if(request->circuit_open) undelivered->circuit_open++;
+    offline_data_queue_upload(
+        request->wire_type ? "POST" : request->method,
+        request->wire_type ? "http://localhost:5000/api/tag" : request->url,
+        bench_retry_write_body,
+        (void*)request);
+}
+
+// Burst wie http/pipelined, wartet auf alle Callbacks. PUT des Spielstands
+// wird wiederholt, POST /api/tag nicht
+static void bench_retry_burst(FlipperHTTP* http, BenchHttpClient* client, const char* method, uint32_t count) {
+    char body[64];
+    FlipperHTTPRequest request = {
+        .method = method,
+        .url = strcmp(method, "POST") == 0 ? "http://localhost:5000/api/tag" :
+                                             "http://localhost:5000/api/game/bench",
+        .body = body,
+        .callback = bench_http_callback,
+        .body_callback = bench_http_body,
+        .context = client,
+    };
+
+    for(uint32_t i = 0; i < count; i++) {
+        snprintf(body, sizeof(body), "{\"tag_id\":\"%08" PRIx32 "\",\"player_id\":\"bench\"}", i);
+        uint64_t sent = host_time_ns();
+        FlipperHTTPRequestId id;
+        while((id = flipper_http_send_request(http, &request)) == FLIPPER_HTTP_REQUEST_NONE) {
+            furi_delay_ms(1);
+        }
+        if(id <= BENCH_HTTP_REQUESTS) client->sent_ns[id] = sent;
+    }
+    uint8_t token;
+    for(uint32_t i = 0; i < count; i++) {
+        furi_message_queue_get(client->done, &token, FuriWaitForever);
+    }
+}
+
+static const char* bench_retry_breaker(FlipperHTTP* http) {
+    FlipperHTTPLinkStats link;
+    flipper_http_get_link_stats(http, &link);
+    switch(link.breaker) {
+        case RetryBreakerOpen:
+            return "open";
+        case RetryBreakerHalfOpen:
+            return "half-open";
+        default:
+            return "closed";
+    }
+}
+
+static void bench_retry_http(void) {
+    BenchBridge bridge = {.drop_every = BENCH_RETRY_DROP_EVERY};
+    bridge.pending = furi_message_queue_alloc(BENCH_HTTP_REQUESTS + 1, sizeof(BenchHttpPending));
+    bridge.thread = furi_thread_alloc_ex("BenchBridge", 2048, bench_bridge_task, &bridge);
+    furi_thread_start(bridge.thread);
+    host_uart_set_sink(FLIPPER_HTTP_UART, bench_bridge_sink, &bridge);
+    bridge.clock_running = true;
+    FuriThread* clock = furi_thread_alloc_ex("BenchClock", 1024, bench_http_clock, &bridge);
+    furi_thread_start(clock);
+
+    BenchHttpClient* client = malloc(sizeof(BenchHttpClient));
+    memset(client, 0, sizeof(BenchHttpClient));
+    client->done = furi_message_queue_alloc(BENCH_HTTP_REQUESTS, sizeof(uint8_t));
+    client->hist = malloc(sizeof(BenchHistogram));
+    bench_hist_reset(client->hist);
+
+    BenchRetryUndelivered undelivered = {0};
+    FlipperHTTP* http = flipper_http_alloc();
+    flipper_http_init(http);
+    flipper_http_set_undelivered_callback(http, bench_retry_undelivered, &undelivered);
+    FlipperHTTPStats stats;
+
+    // Jeder zehnte Request geht verloren, Timeout und Wiederholung holen ihn
+    uint64_t wall_start = host_time_ns();
+    bench_retry_burst(http, client, "PUT", BENCH_HTTP_REQUESTS);
+    uint64_t wall_ns = host_time_ns() - wall_start;
+    flipper_http_get_stats(http, &stats);
+    bench_print_result("retry/lossy_link", client->hist, wall_ns);
+    printf(
+        "  ok %" PRIu32 "/%u, dropped by bridge %" PRIu32 ", retries %" PRIu32 ", timeouts %" PRIu32 ", undelivered %" PRIu32 ", breaker %s\n",
+        client->ok,
+        BENCH_HTTP_REQUESTS,
+        bridge.dropped,
+        stats.retries,
+        stats.timeouts,
+        stats.undelivered,
+        bench_retry_breaker(http));
+
+    // Scans werden nicht wiederholt: jeder verlorene geht offline ab, keiner
+    // erreicht die Bridge zweimal
+    uint32_t ok = client->ok;
+    uint32_t dropped = bridge.dropped;
+    uint32_t arrivals = bridge.arrivals;
+    FlipperHTTPStats scans;
+    bench_retry_burst(http, client, "POST", BENCH_RETRY_SCAN_REQUESTS);
+    flipper_http_get_stats(http, &scans);
+    printf(
+        "retry/scans: ok %" PRIu32 "/%u, dropped by bridge %" PRIu32 ", reached the bridge %" PRIu32 ", retries %" PRIu32 ", undelivered %" PRIu32 "\n",
+        client->ok - ok,
+        BENCH_RETRY_SCAN_REQUESTS,
+        bridge.dropped - dropped,
+        bridge.arrivals - arrivals,
+        scans.retries - stats.retries,
+        scans.undelivered - stats.undelivered);
+    stats = scans;
+
+    // Bridge antwortet gar nicht mehr: nach BREAKER_THRESHOLD Timeouts
+    // wird der Rest ohne Senden abgewiesen und offline abgelegt
+    bridge.drop_every = 0;
+    bridge.down = true;
+    arrivals = bridge.arrivals;
+    wall_start = host_time_ns();
+    bench_retry_burst(http, client, "PUT", BENCH_RETRY_OUTAGE_REQUESTS);
+    wall_ns = host_time_ns() - wall_start;
+    FlipperHTTPStats outage;
+    flipper_http_get_stats(http, &outage);
+    printf(
+        "retry/outage: %u requests, %" PRIu32 " reached the bridge, undelivered %" PRIu32 " (callback %" PRIu32 ", circuit open %" PRIu32 "), short-circuited %" PRIu32 ", breaker %s, %" PRIu32 " ms wall\n",
+        BENCH_RETRY_OUTAGE_REQUESTS,
+        bridge.arrivals - arrivals,
+        outage.undelivered - stats.undelivered,
+        undelivered.count,
+        undelivered.circuit_open,
+        outage.short_circuited,
+        bench_retry_breaker(http),
+        (uint32_t)(wall_ns / 1000000));
+
+    // Probe ohne Antwort abbrechen: der Breaker muss wieder öffnen, statt
+    // halb offen alles festzuhalten. Wartet wie unten auf den Uhr-Thread
+    bridge.clock_offset += FLIPPER_HTTP_BREAKER_OPEN_MS;
+    furi_delay_ms(10);
+    FlipperHTTPRequest probe = {
+        .method = "PUT",
+        .url = "http://localhost:5000/api/game/bench",
+        .body = "{}",
+        .callback = bench_http_callback,
+        .context = client,
+    };
+    FlipperHTTPRequestId probe_id = flipper_http_send_request(http, &probe);
+    for(uint32_t i = 0; i < 1000 && strcmp(bench_retry_breaker(http), "half-open") != 0; i++) {
+        furi_delay_ms(1);
+    }
+    bool probing = strcmp(bench_retry_breaker(http), "half-open") == 0;
+    flipper_http_cancel_request(http, probe_id);
+    const char* cancelled = probing ? bench_retry_breaker(http) : "not probing";
+    printf("retry/probe_cancel: breaker %s\n", cancelled);
+
+    // Bridge wieder da, nach BREAKER_OPEN_MS schließt die erste Probe
+    bridge.down = false;
+    bridge.clock_offset += FLIPPER_HTTP_BREAKER_OPEN_MS;
+    // Bis der Uhr-Thread den Sprung übernommen hat, sonst weist der Worker
+    // die ersten Requests noch mit der alten Zeit ab
+    furi_delay_ms(10);
+    ok = client->ok;
+    wall_start = host_time_ns();
+    bench_retry_burst(http, client, "PUT", BENCH_RETRY_RECOVER_REQUESTS);
+    wall_ns = host_time_ns() - wall_start;
+    FlipperHTTPStats recovered;
+    flipper_http_get_stats(http, &recovered);
+    printf(
+        "retry/recover: ok %" PRIu32 "/%u, breaker %s, opened %" PRIu32 ", undelivered %" PRIu32 ", %" PRIu32 " ms wall\n",
+        client->ok - ok,
+        BENCH_RETRY_RECOVER_REQUESTS,
+        bench_retry_breaker(http),
+        recovered.breaker_opened,
+        recovered.undelivered - outage.undelivered,
+        (uint32_t)(wall_ns / 1000000));
+
+    // Serverfehler beim letzten Versuch: Bridge antwortet 502, im
+    // Binärmodus als Ack 502. Scans per POST und als Rahmen werden nicht
+    // wiederholt und müssen in pending.jsonl landen, unter der Breaker-Schwelle
+    bridge.server_error = 502;
+    uint32_t lines = bench_retry_pending_lines();
+    uint32_t callbacks = undelivered.count;
+    ok = client->ok;
+    bench_retry_burst(http, client, "POST", BENCH_RETRY_SERVER_ERRORS);
+    uint8_t frame[WIRE_FRAME_MAX];
+    WireHello hello = {.version = WIRE_VERSION, .max_payload = WIRE_MAX_PAYLOAD};
+    size_t length = wire_encode(frame, sizeof(frame), WireTypeHello, 0, &hello, sizeof(hello));
+    host_uart_receive(FLIPPER_HTTP_UART, frame, length);
+    while(flipper_http_get_mode(http) != FlipperHTTPModeWire) {
+        furi_delay_ms(1);
+    }
+    WireTagScan scan = {.uid_len = 7, .player_id = "bench"};
+    FlipperHTTPMessage message = {
+        .type = WireTypeTagScan,
+        .payload = &scan,
+        .size = sizeof(scan),
+        .callback = bench_http_callback,
+        .body_callback = bench_http_body,
+        .context = client,
+    };
+    for(uint32_t i = 0; i < BENCH_RETRY_SERVER_ERRORS; i++) {
+        scan.timestamp = i;
+        while(flipper_http_send_message(http, &message) == FLIPPER_HTTP_REQUEST_NONE) {
+            furi_delay_ms(1);
+        }
+    }
+    uint8_t token;
+    for(uint32_t i = 0; i < BENCH_RETRY_SERVER_ERRORS; i++) {
+        furi_message_queue_get(client->done, &token, FuriWaitForever);
+    }
+    FlipperHTTPStats errors;
+    flipper_http_get_stats(http, &errors);
+    uint32_t queued = bench_retry_pending_lines() - lines;
+    printf(
+        "retry/server_error: %u POST + %u frames, ok %" PRIu32 ", retries %" PRIu32 ", undelivered %" PRIu32 ", %" PRIu32 " lines in pending.jsonl, breaker %s\n",
+        BENCH_RETRY_SERVER_ERRORS,
+        BENCH_RETRY_SERVER_ERRORS,
+        client->ok - ok,
+        errors.retries - recovered.retries,
+        errors.undelivered - recovered.undelivered,
+        queued,
+        bench_retry_breaker(http));
+    printf(
+        "retry/verify: server errors offline %s, cancelled probe reopens %s\n",
+        queued == 2 * BENCH_RETRY_SERVER_ERRORS && undelivered.count - callbacks == queued ? "ok" : "FAILED",
+        strcmp(cancelled, "open") == 0 ? "ok" : "FAILED");
+
+    flipper_http_deinit(http);
+    flipper_http_free(http);
+
+    BenchHttpPending stop = {0};
+    furi_message_queue_put(bridge.pending, &stop, FuriWaitForever);
+    furi_thread_join(bridge.thread);
+    furi_thread_free(bridge.thread);
+    host_uart_set_sink(FLIPPER_HTTP_UART, NULL, NULL);
+    bridge.clock_running = false;
+    furi_thread_join(clock);
+    furi_thread_free(clock);
+
+    furi_message_queue_free(bridge.pending);
+    furi_message_queue_free(client->done);
+    free(client->hist);
+    free(client);
+
+    Storage* storage = furi_record_open(RECORD_STORAGE);
+    storage_common_remove(storage, PENDING_UPLOAD_FILE);
+    furi_record_close(RECORD_STORAGE);
+}
+
+static void bench_suite_retry(const BenchConfig* config) {
+    UNUSED(config);
+    bench_retry_policy();
+    bench_retry_pipeline();
+    bench_retry_http();
+    printf("retry/verify: pending.jsonl after failed write %s\n", bench_retry_pending_torn() ? "ok" : "FAILED");
+}
+
+// Antwort-Cache: ein Bildschirm mit der Bestenliste wird alle 100 ms
+// geöffnet, die Bridge erlaubt max-age 1 s und die Liste ändert sich
+// alle 25 Aufrufe. Ohne Cache (jedes Mal invalidiert) geht jeder Aufruf
+// voll über den UART. Danach verdrängen kalte URLs in der Arena, die heiße
+// Bestenliste muss per LRU drinbleiben
+#define BENCH_CACHE_SCREENS 50
+#define BENCH_CACHE_SCREEN_MS 100
+#define BENCH_CACHE_CHANGE_EVERY 25
+#define BENCH_CACHE_COLD_URLS 16
+#define BENCH_CACHE_URL "http://localhost:5000/api/leaderboard"
+
+typedef struct {
+    FuriMessageQueue* done;
+    BenchHistogram* hist;
+    uint64_t sent_ns;
+    char body[1024];
+    size_t body_len;
+    uint32_t ok;
+    uint32_t from_cache;
+    uint32_t stale;  // Ältere Version als die der Bridge, innerhalb max-age erlaubt
+    uint32_t version;
+    const BenchBridge* bridge;
+} BenchCacheClient;
+
+static void bench_cache_body(const uint8_t* data, size_t size, size_t offset, void* context) {
+    BenchCacheClient* client = context;
+    if(offset == 0) client->body_len = 0;
+    size_t count = MIN(size, sizeof(client->body) - 1 - client->body_len);
+    memcpy(client->body + client->body_len, data, count);
+    client->body_len += count;
+}
+
+static void bench_cache_callback(FlipperHTTPResponse* response, void* context) {
+    BenchCacheClient* client = context;
+    bench_hist_record(client->hist, host_time_ns() - client->sent_ns);
+    client->body[client->body_len] = '\0';
+
+    char expected[768];
+    unsigned long version = 0;
+    bool parsed = sscanf(client->body, "{\"version\":%lu,", &version) == 1;
+    bench_cache_board(expected, sizeof(expected), version);
+    if(response->status_code == 200 && parsed && strcmp(client->body, expected) == 0) client->ok++;
+    if(response->from_cache) client->from_cache++;
+    if(version != client->bridge->board_version) client->stale++;
+    client->version = version;
+    uint8_t token = 1;
+    furi_message_queue_put(client->done, &token, FuriWaitForever);
+}
+
+// Eine Antwort abwarten; Treffer kommen schon während send_request
+static void bench_cache_get(FlipperHTTP* http, BenchCacheClient* client, const char* url) {
+    FlipperHTTPRequest request = {
+        .method = "GET",
+        .url = url,
+        .callback = bench_cache_callback,
+        .body_callback = bench_cache_body,
+        .context = client,
+    };
+    client->sent_ns = host_time_ns();
+    while(flipper_http_send_request(http, &request) == FLIPPER_HTTP_REQUEST_NONE) {
+        furi_delay_ms(1);
+    }
+    uint8_t token;
+    furi_message_queue_get(client->done, &token, FuriWaitForever);
+}
+
+static void bench_cache_screens(const char* name, FlipperHTTP* http, BenchBridge* bridge, BenchCacheClient* client, bool cached) {
+    FlipperHTTPStats before;
+    flipper_http_get_stats(http, &before);
+    uint32_t gets = bridge->gets;
+    uint32_t not_modified = bridge->not_modified;
+    uint64_t rx_bytes = bridge->rx_bytes;
+    client->ok = 0;
+    client->from_cache = 0;
+    client->stale = 0;
+    bench_hist_reset(client->hist);
+
+    uint64_t wall_start = host_time_ns();
+    for(uint32_t i = 0; i < BENCH_CACHE_SCREENS; i++) {
+        if(i % BENCH_CACHE_CHANGE_EVERY == 0) bridge->board_version++;
+        if(!cached) flipper_http_cache_invalidate(http, NULL);
+        bench_cache_get(http, client, BENCH_CACHE_URL);
+        furi_delay_ms(BENCH_CACHE_SCREEN_MS);
+    }
+    uint64_t wall_ns = host_time_ns() - wall_start;
+
+    FlipperHTTPStats stats;
+    flipper_http_get_stats(http, &stats);
+    bench_print_result(name, client->hist, wall_ns);
+    printf(
+        "  ok %" PRIu32 "/%u, hits %" PRIu32 ", revalidated %" PRIu32 ", full %" PRIu32 ", from cache %" PRIu32 ", stale %" PRIu32 ", link rx %" PRIu32 " B (%" PRIu32 " B per screen)\n",
+        client->ok,
+        BENCH_CACHE_SCREENS,
+        stats.cache_hits - before.cache_hits,
+        stats.cache_revalidated - before.cache_revalidated,
+        (bridge->gets - gets) - (bridge->not_modified - not_modified),
+        client->from_cache,
+        client->stale,
+        (uint32_t)(bridge->rx_bytes - rx_bytes),
+        (uint32_t)((bridge->rx_bytes - rx_bytes) / BENCH_CACHE_SCREENS));
+}
+
+static void bench_suite_cache(const BenchConfig* config) {
+    UNUSED(config);
+    BenchBridge bridge = {.max_age = 1};
+    bridge.pending = furi_message_queue_alloc(BENCH_HTTP_REQUESTS + 1, sizeof(BenchHttpPending));
+    bridge.thread = furi_thread_alloc_ex("BenchBridge", 2048, bench_bridge_task, &bridge);
+    furi_thread_start(bridge.thread);
+    host_uart_set_sink(FLIPPER_HTTP_UART, bench_bridge_sink, &bridge);
+    bridge.clock_running = true;
+    FuriThread* clock = furi_thread_alloc_ex("BenchClock", 1024, bench_http_clock, &bridge);
+    furi_thread_start(clock);
+
+    BenchCacheClient* client = malloc(sizeof(BenchCacheClient));
+    memset(client, 0, sizeof(BenchCacheClient));
+    client->done = furi_message_queue_alloc(4, sizeof(uint8_t));
+    client->hist = malloc(sizeof(BenchHistogram));
+    client->bridge = &bridge;
+
+    FlipperHTTP* http = flipper_http_alloc();
+    flipper_http_init(http);
+
+    bench_cache_screens("cache/off", http, &bridge, client, false);
+    flipper_http_cache_invalidate(http, NULL);
+    bench_cache_screens("cache/on", http, &bridge, client, true);
+
+    // Kalte URLs verdrängen sich gegenseitig, die heiße bleibt frisch im Cache
+    bridge.max_age = 60;
+    flipper_http_cache_invalidate(http, NULL);
+    bench_cache_get(http, client, BENCH_CACHE_URL);
+    FlipperHTTPStats before;
+    flipper_http_get_stats(http, &before);
+    uint32_t hot_cached = 0;
+    for(uint32_t i = 0; i < BENCH_CACHE_COLD_URLS; i++) {
+        char url[64];
+        snprintf(url, sizeof(url), "http://localhost:5000/api/tags?page=%" PRIu32, i);
+        bench_cache_get(http, client, url);
+        client->from_cache = 0;
+        bench_cache_get(http, client, BENCH_CACHE_URL);
+        hot_cached += client->from_cache;
+    }
+    FlipperHTTPStats stats;
+    flipper_http_get_stats(http, &stats);
+    printf(
+        "cache/lru: %u cold URLs of ~%u B in a %u B arena, hot answered from cache %" PRIu32 "/%u, stored %" PRIu32 ", evicted %" PRIu32 "\n",
+        BENCH_CACHE_COLD_URLS,
+        (unsigned)client->body_len,
+        HTTP_CACHE_ARENA_SIZE,
+        hot_cached,
+        BENCH_CACHE_COLD_URLS,
+        stats.cache_stored - before.cache_stored,
+        stats.cache_evicted - before.cache_evicted);
+
+    flipper_http_deinit(http);
+    flipper_http_free(http);
+
+    BenchHttpPending stop = {0};
+    furi_message_queue_put(bridge.pending, &stop, FuriWaitForever);
+    furi_thread_join(bridge.thread);
+    furi_thread_free(bridge.thread);
+    host_uart_set_sink(FLIPPER_HTTP_UART, NULL, NULL);
+    bridge.clock_running = false;
+    furi_thread_join(clock);
+    furi_thread_free(clock);
+
+    furi_message_queue_free(bridge.pending);
+    furi_message_queue_free(client->done);
+    free(client->hist);
+    free(client);
+}
+
+#define BENCH_OFFLINE_TAGS 1000
+#define BENCH_OFFLINE_LEGACY_SCANS 10
+#define BENCH_OFFLINE_SCANS 3000
+#define BENCH_OFFLINE_MAX_SEGMENTS 256
+
+static void bench_offline_clear(void) {
+    Storage* storage = furi_record_open(RECORD_STORAGE);
+    storage_common_remove(storage, GAME_DATA_FILE);
+    storage_common_remove(storage, GAME_DATA_FILE ".tmp");
+    storage_common_remove(storage, OFFLINE_SECTIONS_FILE);
+    storage_common_remove(storage, OFFLINE_SECTIONS_FILE ".tmp");
+    storage_common_remove(storage, LEADERBOARD_FILE);
+    char path[128];
+    for(uint32_t segment = 0; segment < BENCH_OFFLINE_MAX_SEGMENTS; segment++) {
+        snprintf(path, sizeof(path), "%s/log_%08" PRIX32 ".seg", OFFLINE_LOG_DIR, segment);
+        storage_common_remove(storage, path);
+    }
+    furi_record_close(RECORD_STORAGE);
+}
+
+// Letztes vorhandenes Segment, dort hängt der nächste Stromausfall
+static bool bench_offline_last_segment(char* path, size_t path_size) {
+    Storage* storage = furi_record_open(RECORD_STORAGE);
+    bool found = false;
+    char candidate[128];
+    for(uint32_t segment = 0; segment < BENCH_OFFLINE_MAX_SEGMENTS; segment++) {
+        snprintf(candidate, sizeof(candidate), "%s/log_%08" PRIX32 ".seg", OFFLINE_LOG_DIR, segment);
+        if(storage_file_exists(storage, candidate)) {
+            snprintf(path, path_size, "%s", candidate);
+            found = true;
+        }
+    }
+    furi_record_close(RECORD_STORAGE);
+    return found;
+}
+
+static void bench_offline_tag(CachedTagScan* tag, uint32_t i) {
+    memset(tag, 0, sizeof(CachedTagScan));
+    tag->timestamp = i;
+    snprintf(tag->tag_uid, sizeof(tag->tag_uid), "04%012" PRIX32, (uint32_t)bench_rand());
+    snprintf(tag->game_id, sizeof(tag->game_id), "bench");
+    tag->points = 10;
+    tag->combo = i % 5;
+    tag->latitude = 52.52f + (float)(i % 100) * 1e-5f;
+    tag->longitude = 13.40f;
+}
+
+static void bench_offline_entry(LeaderboardEntry* entry, uint32_t i) {
+    memset(entry, 0, sizeof(LeaderboardEntry));
+    snprintf(entry->id, sizeof(entry->id), "player%" PRIu32, i % 50);
+    snprintf(entry->name, sizeof(entry->name), "Player %" PRIu32, i % 50);
+    entry->score = i * 10;
+    entry->last_updated = i;
+}
+
+// Karten-Kacheln sind Bitmaps und lassen sich kaum komprimieren
+static void bench_offline_tile(MapTile* tile, uint32_t id) {
+    memset(tile, 0, sizeof(MapTile));
+    tile->tile_id = id;
+    tile->zoom = 16;
+    tile->x = 35000 + id;
+    tile->y = 21000;
+    for(size_t i = 0; i < sizeof(tile->data); i++) {
+        tile->data[i] = (uint8_t)bench_rand();
+    }
+}
+
+// Vom Bench gehaltener Stand, zum Vergleich über einen Neustart hinweg
+typedef struct {
+    uint32_t tag_count;
+    CachedTagScan tags[MAX_OFFLINE_TAGS];
+    uint32_t game_count;
+    CachedGame games[MAX_OFFLINE_GAMES];
+    uint32_t leaderboard_count;
+    LeaderboardEntry leaderboard[MAX_LEADERBOARD_ENTRIES];
+    uint32_t map_tile_count;
+    MapTile map_tiles[MAX_MAP_TILES];
+} BenchOfflineState;
+
+// Lädt alles einmal durch, danach wieder ausgelagert
+static void bench_offline_capture(OfflineData* data, BenchOfflineState* state) {
+    memset(state, 0, sizeof(BenchOfflineState));
+    offline_data_page_in(data, OfflineSectionTags);
+    offline_data_page_in(data, OfflineSectionGames);
+    offline_data_page_in(data, OfflineSectionLeaderboard);
+    state->tag_count = data->tags.count;
+    for(uint32_t i = 0; i < data->tags.count; i++) {
+        state->tags[i] = *(CachedTagScan*)item_ring_get(&data->tags, i);
+    }
+    state->game_count = data->games.count;
+    for(uint32_t i = 0; i < data->games.count; i++) {
+        state->games[i] = *(CachedGame*)item_ring_get(&data->games, i);
+    }
+    state->leaderboard_count = data->leaderboard.count;
+    for(uint32_t i = 0; i < data->leaderboard.count; i++) {
+        state->leaderboard[i] = *(LeaderboardEntry*)item_ring_get(&data->leaderboard, i);
+    }
+    state->map_tile_count = data->map_tile_count;
+    for(uint32_t i = 0; i < data->map_tile_count; i++) {
+        MapTile* tile = offline_data_get_map_tile(data, data->map_tile_ids[i]);
+        if(tile) state->map_tiles[i] = *tile;
+    }
+    offline_data_page_out(data, OfflineSectionTags);
+    offline_data_page_out(data, OfflineSectionGames);
+    offline_data_page_out(data, OfflineSectionLeaderboard);
+    offline_data_page_out(data, OfflineSectionMapTile);
+}
+
+// Gleicher Inhalt wie vor dem Neustart, ohne Status und Backup-Zeit
+static bool bench_offline_equal(const BenchOfflineState* a, const BenchOfflineState* b) {
+    return memcmp(a, b, sizeof(BenchOfflineState)) == 0;
+}
+
+// Heap der Offline-Module seit dem letzten host_heap_reset_peaks
+static size_t bench_offline_peak(void) {
+    HostHeapStats stats[HOST_HEAP_MAX_MODULES];
+    size_t count = host_heap_get_stats(stats, HOST_HEAP_MAX_MODULES);
+    size_t peak = 0;
+    for(size_t i = 0; i < count; i++) {
+        if(strncmp(stats[i].module, "offline_", 8) == 0) peak += stats[i].peak;
+    }
+    return peak;
+}
+
+static void bench_offline_report(const char* name, uint64_t ns, const OfflineData* data) {
+    printf(
+        "offline/cold_start %-12s %6" PRIu64 " us, peak RAM %7" PRIu32 " B (OfflineData %" PRIu32 " B + %" PRIu32 " B heap)\n",
+        name,
+        ns / 1000,
+        (uint32_t)(sizeof(OfflineData) + bench_offline_peak()),
+        (uint32_t)sizeof(*data),
+        (uint32_t)bench_offline_peak());
+}
+
+static void bench_suite_offline(const BenchConfig* config) {
+    UNUSED(config);
+    bench_offline_clear();
+    OfflineData* data = malloc(sizeof(OfflineData));
+    MapTile* tile = malloc(sizeof(MapTile));
+
+    // Ausgangsstand über das Protokoll, am Ende ein Checkpoint in den Container
+    offline_data_init(data);
+    offline_data_page_in(data, OfflineSectionTags);
+    for(uint32_t i = 0; i < BENCH_OFFLINE_TAGS; i++) {
+        bench_offline_tag(item_ring_push(&data->tags, NULL), i);
+    }
+    offline_data_page_in(data, OfflineSectionLeaderboard);
+    for(uint32_t i = 0; i < 50; i++) {
+        bench_offline_entry(item_ring_push(&data->leaderboard, NULL), i);
+    }
+    for(uint32_t i = 0; i < MAX_MAP_TILES; i++) {
+        bench_offline_tile(tile, i);
+        offline_data_cache_map_tile(data, tile);
+    }
+    offline_data_compact(data);
+
+    HostStorageStats storage;
+    host_storage_reset_stats();
+    offline_data_save(data);
+    host_storage_get_stats(&storage);
+    uint64_t snapshot_bytes = storage.bytes_written;
+    offline_data_close(data);
+
+    // Kaltstart: nur Inhaltsverzeichnis und Zustand, Abschnitte bei Bedarf
+    host_heap_reset_peaks();
+    memset(data, 0, sizeof(OfflineData));
+    uint64_t start = host_time_ns();
+    offline_data_init(data);
+    bench_offline_report("lazy", host_time_ns() - start, data);
+
+    host_heap_reset_peaks();
+    start = host_time_ns();
+    offline_data_page_in(data, OfflineSectionTags);
+    bench_offline_report("+tags", host_time_ns() - start, data);
+
+    host_heap_reset_peaks();
+    start = host_time_ns();
+    for(uint32_t i = 0; i < 10; i++) {
+        offline_data_get_map_tile(data, data->map_tile_ids[i]);
+    }
+    bench_offline_report("+map 10", host_time_ns() - start, data);
+
+    host_heap_reset_peaks();
+    start = host_time_ns();
+    offline_data_page_in(data, OfflineSectionGames);
+    offline_data_page_in(data, OfflineSectionLeaderboard);
+    offline_data_page_in(data, OfflineSectionMessages);
+    bench_offline_report("+all lists", host_time_ns() - start, data);
+    offline_data_close(data);
+
+    BenchHistogram* hist = malloc(sizeof(BenchHistogram));
+    CachedTagScan tag;
+    uint32_t scan = BENCH_OFFLINE_TAGS;
+
+    // Einfügen in den vollen Tag-Cache, nur im Speicher: bisher rückte jeder
+    // Scan das ganze Array um einen Platz, jetzt ersetzt er den ältesten
+    CachedTagScan* tags = malloc(sizeof(CachedTagScan) * MAX_OFFLINE_TAGS);
+    memset(tags, 0, sizeof(CachedTagScan) * MAX_OFFLINE_TAGS);
+    bench_offline_tag(&tag, 0);
+    bench_hist_reset(hist);
+    uint64_t wall_start = host_time_ns();
+    for(uint32_t i = 0; i < BENCH_OFFLINE_SCANS; i++) {
+        start = host_time_ns();
+        memmove(&tags[0], &tags[1], sizeof(CachedTagScan) * (MAX_OFFLINE_TAGS - 1));
+        memcpy(&tags[MAX_OFFLINE_TAGS - 1], &tag, sizeof(CachedTagScan));
+        bench_hist_record(hist, host_time_ns() - start);
+    }
+    bench_print_result("offline/full_cache_shift", hist, host_time_ns() - wall_start);
+    ItemRing ring;
+    item_ring_init(&ring, tags, sizeof(CachedTagScan), MAX_OFFLINE_TAGS);
+    item_ring_load(&ring, MAX_OFFLINE_TAGS);
+    bench_hist_reset(hist);
+    wall_start = host_time_ns();
+    for(uint32_t i = 0; i < BENCH_OFFLINE_SCANS; i++) {
+        start = host_time_ns();
+        item_ring_push(&ring, &tag);
+        bench_hist_record(hist, host_time_ns() - start);
+    }
+    bench_print_result("offline/full_cache_ring", hist, host_time_ns() - wall_start);
+    free(tags);
+
+    // Bisher: ohne Protokoll schreibt jeder Scan den ganzen Stand neu
+    memset(data, 0, sizeof(OfflineData));
+    offline_data_load(data);
+    bench_hist_reset(hist);
+    host_storage_reset_stats();
+    wall_start = host_time_ns();
+    for(uint32_t i = 0; i < BENCH_OFFLINE_LEGACY_SCANS; i++) {
+        bench_offline_tag(&tag, scan++);
+        start = host_time_ns();
+        offline_data_add_tag(data, &tag);
+        bench_hist_record(hist, host_time_ns() - start);
+    }
+    bench_print_result("offline/legacy_add_tag", hist, host_time_ns() - wall_start);
+    host_storage_get_stats(&storage);
+    printf(
+        "offline/legacy: %" PRIu32 " B OfflineData, %" PRIu64 " B container, %" PRIu64 " B written per scan\n",
+        (uint32_t)sizeof(OfflineData),
+        snapshot_bytes,
+        storage.bytes_written / BENCH_OFFLINE_LEGACY_SCANS);
+    offline_data_close(data);
+
+    // Protokoll: Scans, dazu Bestenliste und ab und zu eine Kachel
+    start = host_time_ns();
+    offline_data_init(data);
+    uint64_t load_ns = host_time_ns() - start;
+    bench_hist_reset(hist);
+    host_storage_reset_stats();
+    wall_start = host_time_ns();
+    uint32_t events = 0;
+    for(uint32_t i = 0; i < BENCH_OFFLINE_SCANS; i++) {
+        bench_offline_tag(&tag, scan++);
+        start = host_time_ns();
+        offline_data_add_tag(data, &tag);
+        bench_hist_record(hist, host_time_ns() - start);
+        if(i % 10 == 0) {
+            LeaderboardEntry entry;
+            bench_offline_entry(&entry, scan);
+            offline_data_update_leaderboard(data, &entry);
+            events++;
+        }
+        if(i % 500 == 0) {
+            bench_offline_tile(tile, i % MAX_MAP_TILES);
+            offline_data_cache_map_tile(data, tile);
+            events++;
+        }
+    }
+    uint64_t wall_ns = host_time_ns() - wall_start;
+    // Laufende Verdichtung abwarten, sie zählt zum Schreibvolumen
+    offline_data_compact(data);
+    bench_print_result("offline/log_add_tag", hist, wall_ns);
+    host_storage_get_stats(&storage);
+    OfflineLogStats log;
+    offline_data_get_log_stats(&log);
+    printf(
+        "offline/log: %u scans + %" PRIu32 " other events, %u B per scan record, %" PRIu64 " B appended, %" PRIu64 " B written per scan incl. %" PRIu32 " compactions, load %" PRIu64 " us\n",
+        BENCH_OFFLINE_SCANS,
+        events,
+        (unsigned)(OFFLINE_LOG_HEADER_SIZE + sizeof(CachedTagScan) + OFFLINE_LOG_CRC_SIZE),
+        log.bytes,
+        storage.bytes_written / BENCH_OFFLINE_SCANS,
+        log.compactions,
+        load_ns / 1000);
+
+    // Stromausfall mitten im Schreiben: halber Datensatz am Ende
+    BenchOfflineState* expected = malloc(sizeof(BenchOfflineState));
+    BenchOfflineState* actual = malloc(sizeof(BenchOfflineState));
+    bench_offline_capture(data, expected);
+    offline_data_close(data);
+    char path[128];
+    if(bench_offline_last_segment(path, sizeof(path))) {
+        Storage* sd = furi_record_open(RECORD_STORAGE);
+        File* file = storage_file_alloc(sd);
+        uint8_t torn[40] = {OfflineSectionTags, sizeof(CachedTagScan), 0};
+        if(storage_file_open(file, path, FSAM_WRITE, FSOM_OPEN_APPEND)) {
+            storage_file_write(file, torn, sizeof(torn));
+        }
+        storage_file_free(file);
+        furi_record_close(RECORD_STORAGE);
+    }
+
+    start = host_time_ns();
+    bool loaded = offline_data_init(data);
+    load_ns = host_time_ns() - start;
+    offline_data_get_log_stats(&log);
+    bench_offline_capture(data, actual);
+    bool recovered = loaded && bench_offline_equal(actual, expected);
+
+    // Nach dem abgerissenen Segment geht es in einem neuen weiter; die Liste ist voll
+    bench_offline_tag(&tag, scan++);
+    offline_data_add_tag(data, &tag);
+    memmove(&expected->tags[0], &expected->tags[1], sizeof(CachedTagScan) * (MAX_OFFLINE_TAGS - 1));
+    expected->tags[MAX_OFFLINE_TAGS - 1] = tag;
+    offline_data_close(data);
+    offline_data_init(data);
+    bench_offline_capture(data, actual);
+    bool continued = bench_offline_equal(actual, expected);
+    offline_data_close(data);
+
+    printf(
+        "offline/recovery: replayed %" PRIu32 " records, %" PRIu32 " torn, load %" PRIu64 " us, state %s, append after torn segment %s\n",
+        log.replayed,
+        log.torn,
+        load_ns / 1000,
+        recovered ? "ok" : "FAILED",
+        continued ? "ok" : "FAILED");
+
+    bench_offline_clear();
+    free(actual);
+    free(expected);
+    free(hist);
+    free(tile);
+    free(data);
+}
+
+#define BENCH_PAGECACHE_FILE_SIZE (8 * 1024)
+#define BENCH_PAGECACHE_RECORD 32
+#define BENCH_PAGECACHE_OPS 2000
+#define BENCH_PAGECACHE_LOAD_SIZE (64 * 1024)
+#define BENCH_PAGECACHE_CHUNK 256
+
+// Gleicher Inhalt auf der Karte wie im Spiegel des Benchmarks
+static bool bench_pagecache_verify(const char* filename, const uint8_t* mirror, size_t size) {
+    uint8_t* buffer = malloc(size);
+    size_t loaded = size;
+    bool equal = offline_storage_load(filename, buffer, &loaded) && loaded == size &&
+                 memcmp(buffer, mirror, size) == 0;
+    free(buffer);
+    return equal;
+}
+
+// Neue Datei, die über den Cache hinaus wächst: je Seite nur der Anfang,
+// Seite 1 vor Seite 0. Verdrängt wird so zuerst eine Seite hinter dem
+// Ende auf der Karte, davor stehen nur Nullen
+static bool bench_pagecache_grow(void) {
+    const char* name = "bench_grow.bin";
+    size_t pages = OFFLINE_STORAGE_PAGES + 8;
+    size_t size = (pages - 1) * OFFLINE_STORAGE_PAGE_SIZE + BENCH_PAGECACHE_RECORD;
+    uint8_t* mirror = malloc(size);
+    memset(mirror, 0, size);
+    uint8_t record[BENCH_PAGECACHE_RECORD];
+
+    offline_storage_init();
+    offline_storage_delete(name);
+    for(size_t i = 0; i < pages; i++) {
+        size_t index = i < 2 ? 1 - i : i;
+        memset(record, index + 1, sizeof(record));
+        memcpy(mirror + index * OFFLINE_STORAGE_PAGE_SIZE, record, sizeof(record));
+        offline_storage_write(name, index * OFFLINE_STORAGE_PAGE_SIZE, record, sizeof(record));
+    }
+    offline_storage_deinit();
+
+    offline_storage_init();
+    bool grown = bench_pagecache_verify(name, mirror, size);
+    offline_storage_delete(name);
+    offline_storage_deinit();
+    free(mirror);
+    return grown;
+}
+
+// Kürzer speichern, dann hinter dem neuen Ende weiterschreiben: die Lücke
+// auf der Seite über dem neuen Ende muss Nullen enthalten, nicht den alten Inhalt
+static bool bench_pagecache_shrink(void) {
+    const char* name = "bench_shrink.bin";
+    size_t size = 2 * OFFLINE_STORAGE_PAGE_SIZE;
+    size_t shrunk = OFFLINE_STORAGE_PAGE_SIZE + OFFLINE_STORAGE_PAGE_SIZE / 4;
+    size_t offset = OFFLINE_STORAGE_PAGE_SIZE + OFFLINE_STORAGE_PAGE_SIZE * 3 / 4;
+    uint8_t* mirror = malloc(size);
+    memset(mirror, 0xAA, size);
+    uint8_t record[BENCH_PAGECACHE_RECORD];
+    memset(record, 0x55, sizeof(record));
+
+    offline_storage_init();
+    offline_storage_delete(name);
+    bool success = offline_storage_save(name, mirror, size);
+    memset(mirror, 0x11, shrunk);
+    memset(mirror + shrunk, 0, size - shrunk);
+    memcpy(mirror + offset, record, sizeof(record));
+    success &= offline_storage_save(name, mirror, shrunk) &&
+               offline_storage_write(name, offset, record, sizeof(record));
+    offline_storage_deinit();
+
+    offline_storage_init();
+    success &= bench_pagecache_verify(name, mirror, offset + sizeof(record));
+    offline_storage_delete(name);
+    offline_storage_deinit();
+    free(mirror);
+    return success;
+}
+
+static void bench_suite_pagecache(const BenchConfig* config) {
+    UNUSED(config);
+    const char* names[2] = {"bench_a.bin", "bench_b.bin"};
+    char paths[2][64];
+    uint8_t* mirror[2];
+    for(size_t f = 0; f < 2; f++) {
+        snprintf(paths[f], sizeof(paths[f]), "/ext/tagracer/%s", names[f]);
+        mirror[f] = malloc(BENCH_PAGECACHE_FILE_SIZE);
+        for(size_t i = 0; i < BENCH_PAGECACHE_FILE_SIZE; i++) {
+            mirror[f][i] = (uint8_t)bench_rand();
+        }
+    }
+    BenchHistogram* hist = malloc(sizeof(BenchHistogram));
+    uint8_t record[BENCH_PAGECACHE_RECORD];
+    HostStorageStats sd;
+
+    // Bisher: wechseln sich zwei Dateien ab, schreibt jeder Aufruf die
+    // ganze Datei neu
+    Storage* fs = furi_record_open(RECORD_STORAGE);
+    storage_mkdir(fs, "/ext/tagracer");
+    File* file = storage_file_alloc(fs);
+    bench_hist_reset(hist);
+    host_storage_reset_stats();
+    uint64_t wall_start = host_time_ns();
+    for(uint32_t i = 0; i < BENCH_PAGECACHE_OPS; i++) {
+        size_t f = i % 2;
+        uint32_t offset = (bench_rand() % (BENCH_PAGECACHE_FILE_SIZE / BENCH_PAGECACHE_RECORD)) *
+                          BENCH_PAGECACHE_RECORD;
+        memset(record, i, sizeof(record));
+        memcpy(mirror[f] + offset, record, sizeof(record));
+        uint64_t start = host_time_ns();
+        if(storage_file_open(file, paths[f], FSAM_WRITE, FSOM_CREATE_ALWAYS)) {
+            storage_file_write(file, mirror[f], BENCH_PAGECACHE_FILE_SIZE);
+        }
+        storage_file_close(file);
+        bench_hist_record(hist, host_time_ns() - start);
+    }
+    bench_print_result("pagecache/whole_file", hist, host_time_ns() - wall_start);
+    host_storage_get_stats(&sd);
+    printf(
+        "pagecache/whole_file: %" PRIu64 " B written per update, %" PRIu32 " write calls\n",
+        sd.bytes_written / BENCH_PAGECACHE_OPS,
+        sd.write_calls);
+    storage_file_free(file);
+    furi_record_close(RECORD_STORAGE);
+
+    // Seiten-Cache: nur der Datensatz, zurückgeschrieben beim Verdrängen
+    // und beim abschließenden Flush
+    offline_storage_init();
+    bench_hist_reset(hist);
+    host_storage_reset_stats();
+    wall_start = host_time_ns();
+    for(uint32_t i = 0; i < BENCH_PAGECACHE_OPS; i++) {
+        size_t f = i % 2;
+        uint32_t offset = (bench_rand() % (BENCH_PAGECACHE_FILE_SIZE / BENCH_PAGECACHE_RECORD)) *
+                          BENCH_PAGECACHE_RECORD;
+        memset(record, i, sizeof(record));
+        memcpy(mirror[f] + offset, record, sizeof(record));
+        uint64_t start = host_time_ns();
+        offline_storage_write(names[f], offset, record, sizeof(record));
+        bench_hist_record(hist, host_time_ns() - start);
+    }
+    offline_storage_flush();
+    bench_print_result("pagecache/write", hist, host_time_ns() - wall_start);
+    host_storage_get_stats(&sd);
+    OfflineStorageStats stats;
+    offline_storage_get_stats(&stats);
+    printf(
+        "pagecache/write: %" PRIu64 " B written per update, %" PRIu32 " write calls, hits %" PRIu32 ", misses %" PRIu32 ", writebacks %" PRIu32 ", evictions %" PRIu32 "\n",
+        sd.bytes_written / BENCH_PAGECACHE_OPS,
+        sd.write_calls,
+        stats.hits,
+        stats.misses,
+        stats.writebacks,
+        stats.evictions);
+    offline_storage_deinit();
+
+    // Neu geöffnet: steht auf der Karte, was der Spiegel sagt?
+    offline_storage_init();
+    bool written = bench_pagecache_verify(names[0], mirror[0], BENCH_PAGECACHE_FILE_SIZE) &&
+                   bench_pagecache_verify(names[1], mirror[1], BENCH_PAGECACHE_FILE_SIZE);
+    offline_storage_deinit();
+
+    // Fortlaufendes Laden einer Datei größer als der ganze Cache
+    uint8_t* blob = malloc(BENCH_PAGECACHE_LOAD_SIZE);
+    for(size_t i = 0; i < BENCH_PAGECACHE_LOAD_SIZE; i++) {
+        blob[i] = (uint8_t)bench_rand();
+    }
+    offline_storage_init();
+    offline_storage_save("bench_blob.bin", blob, BENCH_PAGECACHE_LOAD_SIZE);
+    offline_storage_deinit();
+    offline_storage_init();
+    uint8_t chunk[BENCH_PAGECACHE_CHUNK];
+    bool loaded = true;
+    bench_hist_reset(hist);
+    host_storage_reset_stats();
+    wall_start = host_time_ns();
+    for(uint32_t offset = 0; offset < BENCH_PAGECACHE_LOAD_SIZE; offset += sizeof(chunk)) {
+        uint64_t start = host_time_ns();
+        size_t count = offline_storage_read("bench_blob.bin", offset, chunk, sizeof(chunk));
+        bench_hist_record(hist, host_time_ns() - start);
+        loaded &= count == sizeof(chunk) && memcmp(chunk, blob + offset, sizeof(chunk)) == 0;
+    }
+    bench_print_result("pagecache/sequential_read", hist, host_time_ns() - wall_start);
+    host_storage_get_stats(&sd);
+    offline_storage_get_stats(&stats);
+    printf(
+        "pagecache/sequential_read: %u KB in %u B reads, %" PRIu32 " SD reads, hits %" PRIu32 ", misses %" PRIu32 ", read-ahead %" PRIu32 " pages\n",
+        BENCH_PAGECACHE_LOAD_SIZE / 1024,
+        BENCH_PAGECACHE_CHUNK,
+        sd.read_calls,
+        stats.hits,
+        stats.misses,
+        stats.read_ahead);
+    offline_storage_deinit();
+    bool grown = bench_pagecache_grow();
+    bool shrunk = bench_pagecache_shrink();
+    offline_storage_init();
+    printf(
+        "pagecache/verify: updates after reopen %s, sequential read %s, growing file %s, shrunk file %s\n",
+        written ? "ok" : "FAILED",
+        loaded ? "ok" : "FAILED",
+        grown ? "ok" : "FAILED",
+        shrunk ? "ok" : "FAILED");
+
+    offline_storage_delete("bench_blob.bin");
+    offline_storage_delete(names[0]);
+    offline_storage_delete(names[1]);
+    offline_storage_deinit();
+    free(blob);
+    free(hist);
+    free(mirror[0]);
+    free(mirror[1]);
+}
+
+#define BENCH_COMPRESS_SIZE (1024 * 1024)
+#define BENCH_COMPRESS_PATH "/ext/tagracer/bench_stream.bin"
+#define BENCH_COMPRESS_READ 700
+
+// Heap-Spitze eines Moduls seit dem letzten host_heap_reset_peaks, über
+// dem, was davor schon belegt war
+static size_t bench_compress_peak(const char* module) {
+    HostHeapStats stats[HOST_HEAP_MAX_MODULES];
+    size_t count = host_heap_get_stats(stats, HOST_HEAP_MAX_MODULES);
+    for(size_t i = 0; i < count; i++) {
+        if(strcmp(stats[i].module, module) == 0) return stats[i].peak - stats[i].current;
+    }
+    return 0;
+}
+
+// 1 MB Tag-Scans wie in den Offline-Daten: wie bisher am Stück über einen
+// Puffer doppelter Größe gepackt, dann blockweise über einen CompressStream
+// direkt in die Datei und in kleinen Stücken wieder zurück
+static void bench_suite_compress(const BenchConfig* config) {
+    UNUSED(config);
+    uint8_t* dataset = malloc(BENCH_COMPRESS_SIZE);
+    for(size_t offset = 0; offset < BENCH_COMPRESS_SIZE; offset += sizeof(CachedTagScan)) {
+        CachedTagScan tag;
+        bench_offline_tag(&tag, offset / sizeof(CachedTagScan));
+        memcpy(dataset + offset, &tag, MIN(sizeof(tag), BENCH_COMPRESS_SIZE - offset));
+    }
+    Storage* fs = furi_record_open(RECORD_STORAGE);
+    storage_mkdir(fs, "/ext/tagracer");
+    File* file = storage_file_alloc(fs);
+    uint8_t* chunk = malloc(BENCH_COMPRESS_READ);
+    HostStorageStats sd;
+
+    // Bisher: Puffer für den schlechtesten Fall, ein Aufruf, ein Schreibvorgang
+    host_heap_reset_peaks();
+    host_storage_reset_stats();
+    uint64_t start = host_time_ns();
+    size_t packed = BENCH_COMPRESS_SIZE * 2;
+    uint8_t* scratch = malloc(packed);
+    compression_init();
+    bool encoded = compression_encode(dataset, BENCH_COMPRESS_SIZE, scratch, &packed, 9);
+    compression_free();
+    if(encoded && storage_file_open(file, BENCH_COMPRESS_PATH, FSAM_WRITE, FSOM_CREATE_ALWAYS)) {
+        storage_file_write(file, scratch, packed);
+    }
+    storage_file_close(file);
+    free(scratch);
+    uint64_t ns = host_time_ns() - start;
+    printf(
+        "compress/whole_buffer: 1024 KB -> %" PRIu32 " KB in %" PRIu64 " us, heap %" PRIu32 " B\n",
+        (uint32_t)(packed / 1024),
+        ns / 1000,
+        (uint32_t)bench_compress_peak("bench"));
+
+    bool roundtrip = true;
+    for(size_t window = COMPRESS_STREAM_WINDOW_MIN; window <= COMPRESS_STREAM_WINDOW_MAX; window *= 2) {
+        host_heap_reset_peaks();
+        host_storage_reset_stats();
+        start = host_time_ns();
+        CompressStream* stream = compress_stream_alloc(window);
+        if(storage_file_open(file, BENCH_COMPRESS_PATH, FSAM_WRITE, FSOM_CREATE_ALWAYS)) {
+            compress_stream_begin_file(stream, file);
+            roundtrip &= compress_stream_write(stream, dataset, BENCH_COMPRESS_SIZE) &&
+                         compress_stream_finish(stream);
+        }
+        storage_file_close(file);
+        ns = host_time_ns() - start;
+        host_storage_get_stats(&sd);
+        uint32_t stored = stream->out;
+        uint16_t crc = stream->crc;
+
+        // Zurück, ohne die Datei oder den Datensatz am Stück zu halten
+        start = host_time_ns();
+        if(storage_file_open(file, BENCH_COMPRESS_PATH, FSAM_READ, FSOM_OPEN_EXISTING)) {
+            compress_stream_open_file(stream, file, stored);
+            for(size_t offset = 0; offset < BENCH_COMPRESS_SIZE; offset += BENCH_COMPRESS_READ) {
+                size_t size = MIN((size_t)BENCH_COMPRESS_READ, BENCH_COMPRESS_SIZE - offset);
+                roundtrip &= compress_stream_read(stream, chunk, size) == size &&
+                             memcmp(chunk, dataset + offset, size) == 0;
+            }
+            roundtrip &= stream->ok && stream->left == 0 && stream->crc == crc;
+        } else {
+            roundtrip = false;
+        }
+        storage_file_close(file);
+        uint64_t read_ns = host_time_ns() - start;
+        compress_stream_free(stream);
+
+        printf(
+            "compress/stream_%" PRIu32 ": 1024 KB -> %" PRIu32 " KB in %" PRIu64 " us, read %" PRIu64 " us, %" PRIu32 " SD writes, heap %" PRIu32 " B\n",
+            (uint32_t)window,
+            stored / 1024,
+            ns / 1000,
+            read_ns / 1000,
+            sd.write_calls,
+            (uint32_t)bench_compress_peak("compress_stream"));
+    }
+    printf("compress/verify: roundtrip %s\n", roundtrip ? "ok" : "FAILED");
+
+    storage_common_remove(fs, BENCH_COMPRESS_PATH);
+    storage_file_free(file);
+    furi_record_close(RECORD_STORAGE);
+    free(chunk);
+    free(dataset);
+}
+
+#define BENCH_REPLAY_LOG_SIZE (32 * 1024)
+#define BENCH_REPLAY_STEPS 300
+
+// Ein Spiel mit Protokoll im Speicher: Scans, Ticks, Tasten, Power-ups und
+// Serverpunkte, alle 50 Schritte ein Check. Liefert die Protokollgröße.
+static size_t bench_replay_record(
+    GameContext* game,
+    GameLog* log,
+    uint8_t* buffer,
+    const TagData* tags,
+    GameMode mode,
+    const GameRules* rules) {
+    host_clock_set(bench_rand());
+    game_state_init(game);
+    if(rules) custom_game_create(game, rules);
+    game->team_id = bench_rand() % 4;
+
+    game_log_open_memory(log, buffer, BENCH_REPLAY_LOG_SIZE);
+    game->log = log;
+    game_state_start(game, mode);
+
+    for(uint32_t i = 0; i < BENCH_REPLAY_STEPS && !game_state_is_finished(game); i++) {
+        host_clock_advance(bench_rand_range(100, 3000));
+        game_state_update(game);
+
+        uint32_t event = bench_rand() % 50;
+        if(event == 0) {
+            game_state_activate_power_up(game, bench_rand() % 4);
+        } else if(event == 1) {
+            game_state_add_points(game, bench_rand_range(1, 100));
+        } else if(event < 6) {
+            game_log_input(log, InputKeyOk, InputTypeShort);
+        }
+
+        uint32_t pool = (mode == GameModeRelay) ? 8 : BENCH_TAG_POOL;
+        TagData tag = tags[bench_rand() % pool];
+        // Wie eine fremde Quelle: Schlüssel erst im Spiel berechnen
+        tag.key = TAG_KEY_NONE;
+        game_state_process_tag(game, &tag);
+
+        if(i % 50 == 49) game_log_check(log, game);
+    }
+
+    game_log_check(log, game);
+    game->log = NULL;
+    return log->overflow ? 0 : game_log_close(log);
+}
+
+// Aufnahme über alle Modi, danach jedes Protokoll nachspielen. Jeder Check
+// muss bitgenau stimmen; gemessen werden Spiele pro Sekunde.
+static void bench_suite_replay(const BenchConfig* config) {
+    TagData tags[BENCH_TAG_POOL];
+    bench_make_tags(tags, BENCH_TAG_POOL);
+    bench_write_relay(tags, true);
+
+    const GameRules rules = {
+        .power_ups_enabled = true,
+        .time_limit_enabled = true,
+        .min_players = 1,
+        .max_players = 4,
+        .win_score = 5000,
+        .time_limit = 180,
+        .tag_multiplier = 3,
+        .combo_multiplier = 4,
+    };
+
+    uint32_t games = MAX(config->scans / 100, GameModeCount);
+    size_t* offsets = malloc(sizeof(size_t) * (games + 1));
+    size_t arena_size = BENCH_REPLAY_LOG_SIZE * 4;
+    uint8_t* arena = malloc(arena_size);
+    uint8_t* buffer = malloc(BENCH_REPLAY_LOG_SIZE);
+    GameContext* game = malloc(sizeof(GameContext));
+    GameLog* log = game_log_alloc();
+
+    BenchHistogram* hist = malloc(sizeof(BenchHistogram));
+    bench_hist_reset(hist);
+
+    uint32_t overflows = 0;
+    uint64_t wall_start = host_time_ns();
+    offsets[0] = 0;
+    for(uint32_t i = 0; i < games; i++) {
+        GameMode mode = i % GameModeCount;
+        uint64_t start = host_time_ns();
+        size_t size = bench_replay_record(
+            game, log, buffer, tags, mode, mode == GameModeCustom ? &rules : NULL);
+        bench_hist_record(hist, host_time_ns() - start);
+        if(size == 0) overflows++;
+
+        if(offsets[i] + size > arena_size) {
+            arena_size *= 2;
+            arena = realloc(arena, arena_size);
+        }
+        memcpy(arena + offsets[i], buffer, size);
+        offsets[i + 1] = offsets[i] + size;
+    }
+    bench_print_result("replay/record", hist, host_time_ns() - wall_start);
+
+    bench_hist_reset(hist);
+    GameReplayResult result;
+    uint32_t checks = 0;
+    uint32_t mismatches = 0;
+    uint32_t corrupt = 0;
+    wall_start = host_time_ns();
+    for(uint32_t i = 0; i < games; i++) {
+        size_t size = offsets[i + 1] - offsets[i];
+        if(size == 0) continue;
+
+        uint64_t start = host_time_ns();
+        game_replay_run(game, arena + offsets[i], size, &result);
+        bench_hist_record(hist, host_time_ns() - start);
+
+        checks += result.checks;
+        mismatches += result.mismatches;
+        if(!result.complete) corrupt++;
+    }
+    bench_print_result("replay/games", hist, host_time_ns() - wall_start);
+    printf(
+        "  games %" PRIu32 ", %zu bytes/game, checks %" PRIu32 ", mismatches %" PRIu32 ", corrupt %" PRIu32 ", overflow %" PRIu32 "\n",
+        games,
+        offsets[games] / games,
+        checks,
+        mismatches,
+        corrupt,
+        overflows);
+
+    free(hist);
+    game_log_free(log);
+    free(game);
+    free(buffer);
+    free(arena);
+    free(offsets);
+}
+
+static const BenchSuite bench_suites[] = {
+    {"scan", bench_suite_scan},
+    {"nfc", bench_suite_nfc},
+    {"territory", bench_suite_territory},
+    {"timers", bench_suite_timers},
+    {"render", bench_suite_render},
+    {"pipeline", bench_suite_pipeline},
+    {"achievements", bench_suite_achievements},
+    {"optimizer", bench_suite_optimizer},
+    {"http", bench_suite_http},
+    {"parser", bench_suite_parser},
+    {"wire", bench_suite_wire},
+    {"json", bench_suite_json},
+    {"retry", bench_suite_retry},
+    {"cache", bench_suite_cache},
+    {"offline", bench_suite_offline},
+    {"pagecache", bench_suite_pagecache},
+    {"compress", bench_suite_compress},
+    {"replay", bench_suite_replay},
+};
+
+static void bench_usage(const char* argv0) {
+    printf("Usage: %s [--scans N] [--seed S] [--suite NAME]...\n", argv0);
+    printf("Suites:");
+    for(size_t i = 0; i < COUNT_OF(bench_suites); i++) {
+        printf(" %s", bench_suites[i].name);
+    }
+    printf("\n");
+}
+
+int main(int argc, char** argv) {
+    BenchConfig config = {
+        .scans = BENCH_DEFAULT_SCANS,
+        .seed = 0x5EED1234U,
+    };
+    const char* selected[COUNT_OF(bench_suites)];
+    size_t selected_count = 0;
+
+    for(int i = 1; i < argc; i++) {
+        if(strcmp(argv[i], "--scans") == 0 && i + 1 < argc) {
+            config.scans = (uint32_t)strtoul(argv[++i], NULL, 0);
+        } else if(strcmp(argv[i], "--seed") == 0 && i + 1 < argc) {
+            config.seed = (uint32_t)strtoul(argv[++i], NULL, 0);
+        } else if(strcmp(argv[i], "--suite") == 0 && i + 1 < argc) {
+            if(selected_count < COUNT_OF(selected)) selected[selected_count++] = argv[++i];
+        } else {
+            bench_usage(argv[0]);
+            return strcmp(argv[i], "--help") == 0 ? 0 : 1;
+        }
+    }
+
+    // SD-Karte neben dem Build-Verzeichnis (host/_host_sd), unabhängig vom Arbeitsverzeichnis
+    char sd_root[256];
+    const char* slash = strrchr(argv[0], '/');
+    int dir_len = slash ? (int)(slash - argv[0]) : 1;
+    snprintf(sd_root, sizeof(sd_root), "%.*s/../_host_sd", dir_len, slash ? argv[0] : ".");
+    host_storage_set_root(sd_root);
+    bench_print_header();
+
+    for(size_t s = 0; s < COUNT_OF(bench_suites); s++) {
+        bool run = selected_count == 0;
+        for(size_t i = 0; i < selected_count; i++) {
+            if(strcmp(selected[i], bench_suites[s].name) == 0) run = true;
+        }
+        if(!run) continue;
+
+        bench_rng_state = config.seed;
+        host_heap_reset_peaks();
+        bench_suites[s].run(&config);
+        bench_print_heap();
+    }
+
+    return 0;
+}
@@ -0,0 +1,81 @@
+#include "bench_stats.h"
+#include "host_shim.h"
+
+static uint32_t bench_hist_index(uint64_t ns) {
+    if(ns < 64) return (uint32_t)ns;
+    uint32_t msb = 63 - (uint32_t)__builtin_clzll(ns);
+    uint32_t shift = msb - 5;
+    uint32_t index = shift * 32 + (uint32_t)(ns >> shift);
+    return MIN(index, BENCH_HIST_BUCKETS - 1);
+}
+
+static uint64_t bench_hist_value(uint32_t index) {
+    if(index < 64) return index;
+    uint32_t shift = index / 32 - 1;
+    return (uint64_t)(index - shift * 32) << shift;
+}
+
+void bench_hist_reset(BenchHistogram* hist) {
+    memset(hist, 0, sizeof(BenchHistogram));
+}
+
+void bench_hist_record(BenchHistogram* hist, uint64_t ns) {
+    hist->buckets[bench_hist_index(ns)]++;
+    hist->count++;
+    hist->total_ns += ns;
+    if(ns > hist->max_ns) hist->max_ns = ns;
+}
+
+uint64_t bench_hist_percentile(const BenchHistogram* hist, double percentile) {
+    if(hist->count == 0) return 0;
+
+    uint64_t target = (uint64_t)(percentile / 100.0 * (double)hist->count);
+    if(target >= hist->count) target = hist->count - 1;
+
+    uint64_t seen = 0;
+    for(uint32_t i = 0; i < BENCH_HIST_BUCKETS; i++) {
+        seen += hist->buckets[i];
+        if(seen > target) return bench_hist_value(i);
+    }
+    return hist->max_ns;
+}
+
+void bench_print_header(void) {
+    printf(
+        "%-28s %12s %14s %10s %10s %10s\n",
+        "benchmark",
+        "ops",
+        "ops/sec",
+        "p50 ns",
+        "p99 ns",
+        "max ns");
+}
+
+void bench_print_result(const char* name, const BenchHistogram* hist, uint64_t wall_ns) {
+    double seconds = (double)wall_ns / 1e9;
+    double rate = seconds > 0 ? (double)hist->count / seconds : 0;
+    printf(
+        "%-28s %12llu %14.0f %10llu %10llu %10llu\n",
+        name,
+        (unsigned long long)hist->count,
+        rate,
+        (unsigned long long)bench_hist_percentile(hist, 50.0),
+        (unsigned long long)bench_hist_percentile(hist, 99.0),
+        (unsigned long long)hist->max_ns);
+}
+
+void bench_print_heap(void) {
+    HostHeapStats stats[HOST_HEAP_MAX_MODULES];
+    size_t count = host_heap_get_stats(stats, HOST_HEAP_MAX_MODULES);
+
+    printf("  %-24s %12s %12s %10s\n", "heap module", "peak B", "current B", "allocs");
+    for(size_t i = 0; i < count; i++) {
+        if(stats[i].peak == 0 && stats[i].allocations == 0) continue;
+        printf(
+            "  %-24s %12zu %12zu %10u\n",
+            stats[i].module,
+            stats[i].peak,
+            stats[i].current,
+            stats[i].allocations);
+    }
+}
@@ -0,0 +1,25 @@
+#pragma once
+
+#include <furi.h>
+
+// Log-lineares Latenz-Histogramm (32 Unterteilungen pro Zweierpotenz,
+// relativer Fehler < 3%), konstanter Speicher unabhängig von der Laufzahl.
+#define BENCH_HIST_BUCKETS 1280
+
+typedef struct {
+    uint64_t buckets[BENCH_HIST_BUCKETS];
+    uint64_t count;
+    uint64_t total_ns;
+    uint64_t max_ns;
+} BenchHistogram;
+
+void bench_hist_reset(BenchHistogram* hist);
+void bench_hist_record(BenchHistogram* hist, uint64_t ns);
+uint64_t bench_hist_percentile(const BenchHistogram* hist, double percentile);
+
+// Ergebniszeile: Operationen/s, p50/p99/max
+void bench_print_header(void);
+void bench_print_result(const char* name, const BenchHistogram* hist, uint64_t wall_ns);
+
+// Heap-Spitzen pro Modul seit dem letzten host_heap_reset_peaks()
+void bench_print_heap(void);
@@ -0,0 +1,89 @@
+#include "game_replay.h"
+#include "host_shim.h"
+
+static void game_replay_check(
+    GameContext* context,
+    const GameLogCheckpoint* expected,
+    GameReplayResult* result) {
+    GameLogCheckpoint actual;
+    game_log_checkpoint(context, &actual);
+
+    result->checks++;
+    if(memcmp(&actual, expected, sizeof(GameLogCheckpoint)) != 0) {
+        if(result->mismatches == 0) {
+            result->expected = *expected;
+            result->actual = actual;
+        }
+        result->mismatches++;
+    }
+}
+
+static bool game_replay_relay(GameContext* context, const GameLogRecord* record) {
+    if(record->blob.size == 0) {
+        relay_route_reset(&context->relay);
+        return true;
+    }
+    // Route als Abbild; andere Struktur = anderer Build
+    if(record->blob.size != sizeof(RelayRoute)) return false;
+    memcpy(&context->relay, record->blob.data, sizeof(RelayRoute));
+    return true;
+}
+
+bool game_replay_run(
+    GameContext* context,
+    const uint8_t* data,
+    size_t size,
+    GameReplayResult* result) {
+    memset(result, 0, sizeof(GameReplayResult));
+
+    GameLogReader reader;
+    if(!game_log_reader_init(&reader, data, size)) return false;
+
+    host_clock_set(reader.tick);
+    game_state_init(context);
+
+    GameLogRecord record;
+    bool valid = true;
+    while(valid && game_log_read(&reader, &record)) {
+        host_clock_set(record.tick);
+        result->records++;
+
+        switch(record.type) {
+            case GameLogStart:
+                if(record.start.mode == GameModeCustom) {
+                    context->custom_mode = record.start.custom;
+                }
+                context->team_id = record.start.team_id;
+                valid = game_state_start(context, record.start.mode);
+                break;
+            case GameLogRelay:
+                valid = game_replay_relay(context, &record);
+                break;
+            case GameLogReset:
+                game_state_reset(context);
+                break;
+            case GameLogTick:
+                game_state_update(context);
+                break;
+            case GameLogScan:
+                game_state_process_tag(context, &record.scan);
+                break;
+            case GameLogPowerUp:
+                game_state_activate_power_up(context, record.power_up_id);
+                break;
+            case GameLogPoints:
+                game_state_add_points(context, record.points);
+                break;
+            case GameLogCheck:
+                game_replay_check(context, &record.check, result);
+                break;
+            default:
+                // Tasten, Standort und P2P ändern den Spielstand nicht
+                break;
+        }
+    }
+
+    result->offset = reader.offset;
+    result->complete = valid && reader.offset == reader.size;
+    return result->complete && result->mismatches == 0;
+}
@@ -0,0 +1,24 @@
+#pragma once
+
+// Replay eines game_log: alle Einträge laufen mit virtueller Uhr erneut durch
+// game_state_*, Check-Einträge werden mit dem nachgerechneten Spielstand
+// verglichen. Nur auf dem Host (braucht host_clock_set).
+
+#include "game_log.h"
+
+typedef struct {
+    uint32_t records;
+    uint32_t checks;
+    uint32_t mismatches;
+    size_t offset;                // Gelesene Bytes bzw. Fehlerstelle
+    bool complete;                // Log bis zum Ende gelesen
+    GameLogCheckpoint expected;   // Erste Abweichung
+    GameLogCheckpoint actual;
+} GameReplayResult;
+
+// context wird neu initialisiert. true = vollständig und ohne Abweichung
+bool game_replay_run(
+    GameContext* context,
+    const uint8_t* data,
+    size_t size,
+    GameReplayResult* result);
@@ -0,0 +1,82 @@
+#include <furi.h>
+#include <inttypes.h>
+#include <stdio.h>
+#include "host_shim.h"
+#include "game_replay.h"
+
+// Spielt Protokolle von der SD-Karte (apps_data/tagracer/logs/*.log) nach:
+//   tagracer_replay <datei> [<datei> ...]
+
+static uint8_t* replay_read_file(const char* path, size_t* size) {
+    FILE* file = fopen(path, "rb");
+    if(!file) return NULL;
+
+    fseek(file, 0, SEEK_END);
+    long length = ftell(file);
+    fseek(file, 0, SEEK_SET);
+
+    uint8_t* data = length > 0 ? malloc(length) : NULL;
+    if(data && fread(data, 1, length, file) != (size_t)length) {
+        free(data);
+        data = NULL;
+    }
+    fclose(file);
+
+    *size = data ? (size_t)length : 0;
+    return data;
+}
+
+static void replay_print_checkpoint(const char* label, const GameLogCheckpoint* check) {
+    printf(
+        "  %s score %" PRIu32 ", tags %" PRIu32 ", time %" PRIu32 ", combo %" PRIu32 ", last %08" PRIx32 ", state %d\n",
+        label,
+        check->score,
+        check->tag_count,
+        check->time_remaining,
+        check->combo_multiplier,
+        check->last_tag_key,
+        check->state);
+}
+
+int main(int argc, char** argv) {
+    if(argc < 2) {
+        printf("usage: %s <log> [<log> ...]\n", argv[0]);
+        return 1;
+    }
+
+    GameContext* context = malloc(sizeof(GameContext));
+    int failures = 0;
+
+    for(int i = 1; i < argc; i++) {
+        size_t size;
+        uint8_t* data = replay_read_file(argv[i], &size);
+        if(!data) {
+            printf("%s: nicht lesbar\n", argv[i]);
+            failures++;
+            continue;
+        }
+
+        GameReplayResult result;
+        bool ok = game_replay_run(context, data, size, &result);
+        printf(
+            "%s: %s, %" PRIu32 " records, %" PRIu32 " checks, %" PRIu32 " mismatches, score %" PRIu32 "\n",
+            argv[i],
+            ok ? "ok" : (result.complete ? "abweichend" : "beschädigt"),
+            result.records,
+            result.checks,
+            result.mismatches,
+            context->score);
+        if(!result.complete) {
+            printf("  Fehler bei Byte %zu von %zu\n", result.offset, size);
+        }
+        if(result.mismatches) {
+            replay_print_checkpoint("erwartet", &result.expected);
+            replay_print_checkpoint("replay  ", &result.actual);
+        }
+        if(!ok) failures++;
+        free(data);
+    }
+
+    free(context);
+    return failures ? 1 : 0;
+}
@@ -0,0 +1,85 @@
+#define HOST_SHIM_IMPL
+#include <furi.h>
+#include <toolbox/compression.h>
+
+// PackBits: Kontrollbyte n < 128 -> n+1 Literale, n >= 128 -> Byte 257-n mal wiederholen.
+// Nicht so stark wie der Firmware-Kompressor, aber deterministisch und
+// für Nullbereiche in den Offline-Strukturen ausreichend realistisch.
+
+void compression_init(void) {
+}
+
+void compression_free(void) {
+}
+
+bool compression_encode(
+    const void* in,
+    size_t in_size,
+    void* out,
+    size_t* out_size,
+    int level) {
+    UNUSED(level);
+    const uint8_t* src = in;
+    uint8_t* dst = out;
+    size_t capacity = *out_size;
+    size_t pos = 0;
+    size_t written = 0;
+
+    while(pos < in_size) {
+        size_t run = 1;
+        while(pos + run < in_size && run < 128 && src[pos + run] == src[pos]) run++;
+
+        if(run >= 3) {
+            if(written + 2 > capacity) return false;
+            dst[written++] = (uint8_t)(257 - run);
+            dst[written++] = src[pos];
+            pos += run;
+            continue;
+        }
+
+        size_t literal = 0;
+        while(pos + literal < in_size && literal < 128) {
+            if(pos + literal + 2 < in_size && src[pos + literal] == src[pos + literal + 1] &&
+               src[pos + literal] == src[pos + literal + 2]) {
+                break;
+            }
+            literal++;
+        }
+
+        if(written + 1 + literal > capacity) return false;
+        dst[written++] = (uint8_t)(literal - 1);
+        memcpy(dst + written, src + pos, literal);
+        written += literal;
+        pos += literal;
+    }
+
+    *out_size = written;
+    return true;
+}
+
+bool compression_decode(const void* in, size_t in_size, void* out, size_t* out_size) {
+    const uint8_t* src = in;
+    uint8_t* dst = out;
+    size_t capacity = *out_size;
+    size_t pos = 0;
+    size_t written = 0;
+
+    while(pos < in_size) {
+        uint8_t control = src[pos++];
+        if(control < 128) {
+            size_t literal = (size_t)control + 1;
+            if(pos + literal > in_size || written + literal > capacity) return false;
+            memcpy(dst + written, src + pos, literal);
+            pos += literal;
+            written += literal;
+        } else {
+            size_t run = 257 - (size_t)control;
+            if(pos >= in_size || written + run > capacity) return false;
+            memset(dst + written, src[pos++], run);
+            written += run;
+        }
+    }
+
+    *out_size = written;
+    return true;
+}
@@ -0,0 +1,591 @@
+#define HOST_SHIM_IMPL
+#include <furi.h>
+#include <furi_hal.h>
+#include <notification/notification_messages.h>
+#include <gui/gui.h>
+#include "host_shim.h"
+
+#include <pthread.h>
+#include <stdatomic.h>
+#include <time.h>
+#include <unistd.h>
+
+// Virtuelle Uhr
+static _Atomic uint32_t host_tick = 0;
+
+void host_clock_set(uint32_t tick) {
+    atomic_store(&host_tick, tick);
+}
+
+void host_clock_advance(uint32_t milliseconds) {
+    atomic_fetch_add(&host_tick, milliseconds);
+}
+
+uint32_t furi_get_tick(void) {
+    return atomic_load(&host_tick);
+}
+
+uint32_t furi_ms_to_ticks(uint32_t milliseconds) {
+    return milliseconds;
+}
+
+void furi_delay_ms(uint32_t milliseconds) {
+    // Worker-Threads sollen nicht spinnen, aber auch nicht die
+    // virtuelle Zeit verschieben: real wird ein Zehntel gewartet.
+    usleep(milliseconds * 100);
+}
+
+uint64_t host_time_ns(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000ULL + (uint64_t)ts.tv_nsec;
+}
+
+// Zyklenzähler
+#define HOST_CYCLES_PER_US 64
+
+static uint32_t host_cycle_count(void) {
+    return (uint32_t)(host_time_ns() * HOST_CYCLES_PER_US / 1000);
+}
+
+FuriHalCortexTimer furi_hal_cortex_timer_get(uint32_t timeout_us) {
+    FuriHalCortexTimer timer = {
+        .start = host_cycle_count(),
+        .value = timeout_us * HOST_CYCLES_PER_US,
+    };
+    return timer;
+}
+
+bool furi_hal_cortex_timer_is_expired(FuriHalCortexTimer cortex_timer) {
+    return host_cycle_count() - cortex_timer.start >= cortex_timer.value;
+}
+
+uint32_t furi_hal_cortex_instructions_per_microsecond(void) {
+    return HOST_CYCLES_PER_US;
+}
+
+// Mutex
+struct FuriMutex {
+    pthread_mutex_t mutex;
+};
+
+FuriMutex* furi_mutex_alloc(FuriMutexType type) {
+    FuriMutex* mutex = host_malloc(sizeof(FuriMutex), "furi");
+    pthread_mutexattr_t attr;
+    pthread_mutexattr_init(&attr);
+    pthread_mutexattr_settype(
+        &attr,
+        type == FuriMutexTypeRecursive ? PTHREAD_MUTEX_RECURSIVE : PTHREAD_MUTEX_NORMAL);
+    pthread_mutex_init(&mutex->mutex, &attr);
+    pthread_mutexattr_destroy(&attr);
+    return mutex;
+}
+
+void furi_mutex_free(FuriMutex* mutex) {
+    if(!mutex) return;
+    pthread_mutex_destroy(&mutex->mutex);
+    host_free(mutex);
+}
+
+FuriStatus furi_mutex_acquire(FuriMutex* mutex, uint32_t timeout) {
+    if(timeout == FuriWaitForever) {
+        return pthread_mutex_lock(&mutex->mutex) == 0 ? FuriStatusOk : FuriStatusError;
+    }
+    if(pthread_mutex_trylock(&mutex->mutex) == 0) return FuriStatusOk;
+    if(timeout == 0) return FuriStatusErrorTimeout;
+    furi_delay_ms(timeout);
+    return pthread_mutex_trylock(&mutex->mutex) == 0 ? FuriStatusOk : FuriStatusErrorTimeout;
+}
+
+FuriStatus furi_mutex_release(FuriMutex* mutex) {
+    return pthread_mutex_unlock(&mutex->mutex) == 0 ? FuriStatusOk : FuriStatusError;
+}
+
+// Threads
+struct FuriThread {
+    pthread_t handle;
+    char name[32];
+    size_t stack_size;
+    FuriThreadCallback callback;
+    void* context;
+    int32_t result;
+    bool started;
+};
+
+static void* host_thread_entry(void* arg) {
+    FuriThread* thread = arg;
+    thread->result = thread->callback(thread->context);
+    return NULL;
+}
+
+FuriThread* furi_thread_alloc(void) {
+    return host_calloc(1, sizeof(FuriThread), "furi");
+}
+
+FuriThread* furi_thread_alloc_ex(
+    const char* name,
+    uint32_t stack_size,
+    FuriThreadCallback callback,
+    void* context) {
+    FuriThread* thread = furi_thread_alloc();
+    furi_thread_set_name(thread, name);
+    furi_thread_set_stack_size(thread, stack_size);
+    furi_thread_set_callback(thread, callback);
+    furi_thread_set_context(thread, context);
+    return thread;
+}
+
+void furi_thread_free(FuriThread* thread) {
+    if(!thread) return;
+    furi_thread_join(thread);
+    host_free(thread);
+}
+
+void furi_thread_set_name(FuriThread* thread, const char* name) {
+    strncpy(thread->name, name ? name : "", sizeof(thread->name) - 1);
+}
+
+void furi_thread_set_stack_size(FuriThread* thread, size_t stack_size) {
+    thread->stack_size = stack_size;
+}
+
+void furi_thread_set_callback(FuriThread* thread, FuriThreadCallback callback) {
+    thread->callback = callback;
+}
+
+void furi_thread_set_context(FuriThread* thread, void* context) {
+    thread->context = context;
+}
+
+void furi_thread_set_priority(FuriThread* thread, int priority) {
+    UNUSED(thread);
+    UNUSED(priority);
+}
+
+void* furi_thread_get_context(FuriThread* thread) {
+    return thread->context;
+}
+
+void furi_thread_start(FuriThread* thread) {
+    if(thread->started || !thread->callback) return;
+    thread->started = true;
+    pthread_create(&thread->handle, NULL, host_thread_entry, thread);
+}
+
+bool furi_thread_join(FuriThread* thread) {
+    if(thread->started) {
+        pthread_join(thread->handle, NULL);
+        thread->started = false;
+    }
+    return true;
+}
+
+// Message Queue: Ringpuffer mit Mutex und Bedingungsvariablen. Timeouts
+// laufen wie furi_delay_ms real mit einem Zehntel der Dauer.
+struct FuriMessageQueue {
+    pthread_mutex_t lock;
+    pthread_cond_t not_empty;
+    pthread_cond_t not_full;
+    uint8_t* buffer;
+    uint32_t msg_count;
+    uint32_t msg_size;
+    uint32_t head;
+    uint32_t count;
+};
+
+FuriMessageQueue* furi_message_queue_alloc(uint32_t msg_count, uint32_t msg_size) {
+    FuriMessageQueue* queue = host_calloc(1, sizeof(FuriMessageQueue), "furi");
+    pthread_mutex_init(&queue->lock, NULL);
+    pthread_cond_init(&queue->not_empty, NULL);
+    pthread_cond_init(&queue->not_full, NULL);
+    queue->buffer = host_malloc(msg_count * msg_size, "furi");
+    queue->msg_count = msg_count;
+    queue->msg_size = msg_size;
+    return queue;
+}
+
+void furi_message_queue_free(FuriMessageQueue* queue) {
+    if(!queue) return;
+    pthread_cond_destroy(&queue->not_full);
+    pthread_cond_destroy(&queue->not_empty);
+    pthread_mutex_destroy(&queue->lock);
+    host_free(queue->buffer);
+    host_free(queue);
+}
+
+// Wartet auf cond, bis ready() gilt oder das Timeout abläuft
+static bool host_queue_wait(
+    FuriMessageQueue* queue,
+    pthread_cond_t* cond,
+    bool (*ready)(const FuriMessageQueue* queue),
+    uint32_t timeout) {
+    if(timeout == FuriWaitForever) {
+        while(!ready(queue)) {
+            pthread_cond_wait(cond, &queue->lock);
+        }
+        return true;
+    }
+
+    struct timespec deadline;
+    clock_gettime(CLOCK_REALTIME, &deadline);
+    uint64_t ns = (uint64_t)deadline.tv_nsec + (uint64_t)timeout * 100000ULL;
+    deadline.tv_sec += ns / 1000000000ULL;
+    deadline.tv_nsec = ns % 1000000000ULL;
+
+    while(!ready(queue)) {
+        if(timeout == 0 || pthread_cond_timedwait(cond, &queue->lock, &deadline) != 0) {
+            return ready(queue);
+        }
+    }
+    return true;
+}
+
+static bool host_queue_has_space(const FuriMessageQueue* queue) {
+    return queue->count < queue->msg_count;
+}
+
+static bool host_queue_has_message(const FuriMessageQueue* queue) {
+    return queue->count > 0;
+}
+
+FuriStatus furi_message_queue_put(FuriMessageQueue* queue, const void* msg, uint32_t timeout) {
+    pthread_mutex_lock(&queue->lock);
+    if(!host_queue_wait(queue, &queue->not_full, host_queue_has_space, timeout)) {
+        pthread_mutex_unlock(&queue->lock);
+        return FuriStatusErrorTimeout;
+    }
+
+    uint32_t tail = (queue->head + queue->count) % queue->msg_count;
+    memcpy(queue->buffer + tail * queue->msg_size, msg, queue->msg_size);
+    queue->count++;
+    pthread_cond_signal(&queue->not_empty);
+    pthread_mutex_unlock(&queue->lock);
+    return FuriStatusOk;
+}
+
+FuriStatus furi_message_queue_get(FuriMessageQueue* queue, void* msg, uint32_t timeout) {
+    pthread_mutex_lock(&queue->lock);
+    if(!host_queue_wait(queue, &queue->not_empty, host_queue_has_message, timeout)) {
+        pthread_mutex_unlock(&queue->lock);
+        return FuriStatusErrorTimeout;
+    }
+
+    memcpy(msg, queue->buffer + queue->head * queue->msg_size, queue->msg_size);
+    queue->head = (queue->head + 1) % queue->msg_count;
+    queue->count--;
+    pthread_cond_signal(&queue->not_full);
+    pthread_mutex_unlock(&queue->lock);
+    return FuriStatusOk;
+}
+
+uint32_t furi_message_queue_get_count(FuriMessageQueue* queue) {
+    pthread_mutex_lock(&queue->lock);
+    uint32_t count = queue->count;
+    pthread_mutex_unlock(&queue->lock);
+    return count;
+}
+
+// Records: jeder Name liefert einen stabilen Dummy-Zeiger
+typedef struct {
+    const char* name;
+    uint32_t open_count;
+} HostRecord;
+
+static HostRecord host_records[8];
+static pthread_mutex_t host_record_lock = PTHREAD_MUTEX_INITIALIZER;
+
+void* furi_record_open(const char* name) {
+    pthread_mutex_lock(&host_record_lock);
+    HostRecord* record = NULL;
+    for(size_t i = 0; i < COUNT_OF(host_records); i++) {
+        if(host_records[i].name && strcmp(host_records[i].name, name) == 0) {
+            record = &host_records[i];
+            break;
+        }
+        if(!host_records[i].name) {
+            record = &host_records[i];
+            record->name = name;
+            break;
+        }
+    }
+    if(record) record->open_count++;
+    pthread_mutex_unlock(&host_record_lock);
+    return record;
+}
+
+void furi_record_close(const char* name) {
+    UNUSED(name);
+}
+
+// Heap-Tracking
+typedef struct {
+    size_t size;
+    uint32_t module;
+    uint32_t magic;
+} HostBlockHeader;
+
+#define HOST_BLOCK_MAGIC 0x48454150U
+
+static HostHeapStats host_heap[HOST_HEAP_MAX_MODULES];
+static size_t host_heap_modules = 0;
+static pthread_mutex_t host_heap_lock = PTHREAD_MUTEX_INITIALIZER;
+
+static uint32_t host_heap_module_index(const char* module) {
+    for(size_t i = 0; i < host_heap_modules; i++) {
+        if(strcmp(host_heap[i].module, module) == 0) return i;
+    }
+    if(host_heap_modules == HOST_HEAP_MAX_MODULES) return HOST_HEAP_MAX_MODULES - 1;
+    host_heap[host_heap_modules].module = module;
+    return host_heap_modules++;
+}
+
+void* host_malloc(size_t size, const char* module) {
+    HostBlockHeader* header = malloc(sizeof(HostBlockHeader) + size);
+    if(!header) return NULL;
+
+    pthread_mutex_lock(&host_heap_lock);
+    uint32_t index = host_heap_module_index(module);
+    HostHeapStats* stats = &host_heap[index];
+    stats->current += size;
+    stats->allocations++;
+    if(stats->current > stats->peak) stats->peak = stats->current;
+    pthread_mutex_unlock(&host_heap_lock);
+
+    header->size = size;
+    header->module = index;
+    header->magic = HOST_BLOCK_MAGIC;
+    return header + 1;
+}
+
+void* host_calloc(size_t count, size_t size, const char* module) {
+    void* ptr = host_malloc(count * size, module);
+    if(ptr) memset(ptr, 0, count * size);
+    return ptr;
+}
+
+void* host_realloc(void* ptr, size_t size, const char* module) {
+    if(!ptr) return host_malloc(size, module);
+    HostBlockHeader* header = (HostBlockHeader*)ptr - 1;
+    void* new_ptr = host_malloc(size, host_heap[header->module].module);
+    if(new_ptr) {
+        memcpy(new_ptr, ptr, MIN(size, header->size));
+        host_free(ptr);
+    }
+    return new_ptr;
+}
+
+void host_free(void* ptr) {
+    if(!ptr) return;
+    HostBlockHeader* header = (HostBlockHeader*)ptr - 1;
+    furi_check(header->magic == HOST_BLOCK_MAGIC);
+
+    pthread_mutex_lock(&host_heap_lock);
+    host_heap[header->module].current -= header->size;
+    pthread_mutex_unlock(&host_heap_lock);
+
+    header->magic = 0;
+    free(header);
+}
+
+size_t host_heap_get_stats(HostHeapStats* stats, size_t max_count) {
+    pthread_mutex_lock(&host_heap_lock);
+    size_t count = MIN(max_count, host_heap_modules);
+    memcpy(stats, host_heap, count * sizeof(HostHeapStats));
+    pthread_mutex_unlock(&host_heap_lock);
+    return count;
+}
+
+void host_heap_reset_peaks(void) {
+    pthread_mutex_lock(&host_heap_lock);
+    for(size_t i = 0; i < host_heap_modules; i++) {
+        host_heap[i].peak = host_heap[i].current;
+        host_heap[i].allocations = 0;
+    }
+    pthread_mutex_unlock(&host_heap_lock);
+}
+
+// Zufall (xorshift32)
+static uint32_t host_random_state = 0x7A6E1234U;
+
+uint32_t furi_hal_random_get(void) {
+    uint32_t x = host_random_state;
+    x ^= x << 13;
+    x ^= x >> 17;
+    x ^= x << 5;
+    host_random_state = x;
+    return x;
+}
+
+void furi_hal_random_fill_buf(uint8_t* buf, uint32_t len) {
+    for(uint32_t i = 0; i < len; i++) {
+        buf[i] = (uint8_t)furi_hal_random_get();
+    }
+}
+
+// RTC: aus der virtuellen Uhr abgeleitet
+void furi_hal_rtc_get_datetime(FuriHalRtcDateTime* datetime) {
+    uint32_t seconds = furi_get_tick() / 1000;
+    datetime->second = seconds % 60;
+    datetime->minute = (seconds / 60) % 60;
+    datetime->hour = (seconds / 3600) % 24;
+    datetime->day = 1 + (seconds / 86400) % 28;
+    datetime->month = 1;
+    datetime->year = 2024;
+    datetime->weekday = 1;
+}
+
+uint32_t furi_hal_rtc_get_timestamp(void) {
+    return 1704067200U + furi_get_tick() / 1000;
+}
+
+// UART: Senke und RX-Callback pro Kanal, ohne Senke gehen Bytes verloren
+typedef struct {
+    HostUartSink sink;
+    void* sink_context;
+    void (*irq_callback)(UartIrqEvent event, uint8_t data, void* context);
+    void* irq_context;
+} HostUart;
+
+static HostUart host_uart[2];
+
+void furi_hal_uart_init(FuriHalUartId channel, uint32_t baud) {
+    UNUSED(channel);
+    UNUSED(baud);
+}
+
+void furi_hal_uart_deinit(FuriHalUartId channel) {
+    host_uart[channel].irq_callback = NULL;
+}
+
+void furi_hal_uart_set_br(FuriHalUartId channel, uint32_t baud) {
+    UNUSED(channel);
+    UNUSED(baud);
+}
+
+void furi_hal_uart_tx(FuriHalUartId channel, uint8_t* buffer, size_t buffer_size) {
+    HostUart* uart = &host_uart[channel];
+    if(uart->sink) {
+        uart->sink(buffer, buffer_size, uart->sink_context);
+    }
+}
+
+uint16_t furi_hal_uart_rx_available(FuriHalUartId channel) {
+    UNUSED(channel);
+    return 0;
+}
+
+size_t furi_hal_uart_rx(FuriHalUartId channel, uint8_t* buffer, size_t buffer_size) {
+    UNUSED(channel);
+    UNUSED(buffer);
+    UNUSED(buffer_size);
+    return 0;
+}
+
+void furi_hal_uart_set_irq_cb(
+    FuriHalUartId channel,
+    void (*callback)(UartIrqEvent event, uint8_t data, void* context),
+    void* context) {
+    host_uart[channel].irq_context = context;
+    host_uart[channel].irq_callback = callback;
+}
+
+void host_uart_set_sink(FuriHalUartId channel, HostUartSink sink, void* context) {
+    host_uart[channel].sink_context = context;
+    host_uart[channel].sink = sink;
+}
+
+void host_uart_receive(FuriHalUartId channel, const uint8_t* data, size_t size) {
+    HostUart* uart = &host_uart[channel];
+    if(!uart->irq_callback) return;
+    for(size_t i = 0; i < size; i++) {
+        uart->irq_callback(UartIrqEventRXNE, data[i], uart->irq_context);
+    }
+}
+
+// NFC: Tags kommen aus einer vom Benchmark gesetzten Quelle
+static HostNfcSource host_nfc_source = NULL;
+static void* host_nfc_context = NULL;
+
+void host_nfc_set_source(HostNfcSource source, void* context) {
+    host_nfc_context = context;
+    host_nfc_source = source;
+}
+
+void furi_hal_nfc_init(void) {
+}
+
+void furi_hal_nfc_deinit(void) {
+}
+
+bool furi_hal_nfc_detect(FuriHalNfcDevData* dev_data, uint32_t timeout) {
+    if(host_nfc_source) {
+        return host_nfc_source(dev_data, host_nfc_context);
+    }
+    furi_delay_ms(timeout);
+    return false;
+}
+
+// Benachrichtigungen: nur zählen
+static const NotificationMessage host_message_dummy = {.type = 0, .data = 0};
+
+const NotificationSequence sequence_success = {&host_message_dummy, NULL};
+const NotificationSequence sequence_error = {&host_message_dummy, NULL};
+const NotificationSequence sequence_warning = {&host_message_dummy, NULL};
+const NotificationSequence sequence_blink_green_100 = {&host_message_dummy, NULL};
+const NotificationSequence sequence_blink_yellow_100 = {&host_message_dummy, NULL};
+const NotificationSequence sequence_blink_magenta_100 = {&host_message_dummy, NULL};
+
+static _Atomic uint32_t host_notification_count = 0;
+
+void notification_message(NotificationApp* app, const NotificationSequence* sequence) {
+    UNUSED(app);
+    UNUSED(sequence);
+    atomic_fetch_add(&host_notification_count, 1);
+}
+
+void notification_message_block(NotificationApp* app, const NotificationSequence* sequence) {
+    notification_message(app, sequence);
+}
+
+uint32_t host_notification_get_count(void) {
+    return atomic_load(&host_notification_count);
+}
+
+// Canvas: zählt nur Zeichenaufrufe
+static _Atomic uint32_t host_canvas_draw_calls = 0;
+
+void canvas_clear(Canvas* canvas) {
+    UNUSED(canvas);
+    atomic_fetch_add(&host_canvas_draw_calls, 1);
+}
+
+void canvas_set_font(Canvas* canvas, Font font) {
+    UNUSED(canvas);
+    UNUSED(font);
+}
+
+void canvas_set_color(Canvas* canvas, Color color) {
+    UNUSED(canvas);
+    UNUSED(color);
+}
+
+void canvas_draw_str(Canvas* canvas, uint8_t x, uint8_t y, const char* str) {
+    UNUSED(canvas);
+    UNUSED(x);
+    UNUSED(y);
+    UNUSED(str);
+    atomic_fetch_add(&host_canvas_draw_calls, 1);
+}
+
+void canvas_draw_box(Canvas* canvas, uint8_t x, uint8_t y, uint8_t width, uint8_t height) {
+    UNUSED(canvas);
+    UNUSED(x);
+    UNUSED(y);
+    UNUSED(width);
+    UNUSED(height);
+    atomic_fetch_add(&host_canvas_draw_calls, 1);
+}
+
+uint32_t host_canvas_get_draw_calls(void) {
+    return atomic_load(&host_canvas_draw_calls);
+}
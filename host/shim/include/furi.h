@@ -0,0 +1,109 @@
+#pragma once
+
+// Host-Ersatz für die furi-API des Flipper Zero.
+// Deckt nur ab, was die Spiel-Module tatsächlich benutzen.
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdio.h>
+#include <stdarg.h>
+
+#ifndef UNUSED
+#define UNUSED(x) (void)(x)
+#endif
+
+#ifndef MIN
+#define MIN(a, b) ((a) < (b) ? (a) : (b))
+#endif
+
+#ifndef MAX
+#define MAX(a, b) ((a) > (b) ? (a) : (b))
+#endif
+
+#ifndef COUNT_OF
+#define COUNT_OF(x) (sizeof(x) / sizeof(x[0]))
+#endif
+
+#define furi_assert(x) ((void)(x))
+#define furi_check(x) ((void)(x))
+
+#define FuriWaitForever 0xFFFFFFFFU
+
+typedef enum {
+    FuriStatusOk = 0,
+    FuriStatusError = -1,
+    FuriStatusErrorTimeout = -2,
+    FuriStatusErrorResource = -3,
+} FuriStatus;
+
+// Zeit (virtuelle Uhr, siehe host_shim.h)
+uint32_t furi_get_tick(void);
+void furi_delay_ms(uint32_t milliseconds);
+uint32_t furi_ms_to_ticks(uint32_t milliseconds);
+
+// Mutex
+typedef enum {
+    FuriMutexTypeNormal,
+    FuriMutexTypeRecursive,
+} FuriMutexType;
+
+typedef struct FuriMutex FuriMutex;
+
+FuriMutex* furi_mutex_alloc(FuriMutexType type);
+void furi_mutex_free(FuriMutex* mutex);
+FuriStatus furi_mutex_acquire(FuriMutex* mutex, uint32_t timeout);
+FuriStatus furi_mutex_release(FuriMutex* mutex);
+
+// Threads
+typedef int32_t (*FuriThreadCallback)(void* context);
+typedef struct FuriThread FuriThread;
+
+FuriThread* furi_thread_alloc(void);
+FuriThread* furi_thread_alloc_ex(
+    const char* name,
+    uint32_t stack_size,
+    FuriThreadCallback callback,
+    void* context);
+void furi_thread_free(FuriThread* thread);
+void furi_thread_set_name(FuriThread* thread, const char* name);
+void furi_thread_set_stack_size(FuriThread* thread, size_t stack_size);
+void furi_thread_set_callback(FuriThread* thread, FuriThreadCallback callback);
+void furi_thread_set_context(FuriThread* thread, void* context);
+void furi_thread_set_priority(FuriThread* thread, int priority);
+void* furi_thread_get_context(FuriThread* thread);
+void furi_thread_start(FuriThread* thread);
+bool furi_thread_join(FuriThread* thread);
+
+// Message Queue
+typedef struct FuriMessageQueue FuriMessageQueue;
+
+FuriMessageQueue* furi_message_queue_alloc(uint32_t msg_count, uint32_t msg_size);
+void furi_message_queue_free(FuriMessageQueue* queue);
+FuriStatus furi_message_queue_put(FuriMessageQueue* queue, const void* msg, uint32_t timeout);
+FuriStatus furi_message_queue_get(FuriMessageQueue* queue, void* msg, uint32_t timeout);
+uint32_t furi_message_queue_get_count(FuriMessageQueue* queue);
+
+// Records
+void* furi_record_open(const char* name);
+void furi_record_close(const char* name);
+
+// Heap-Tracking: jedes Modul wird mit -DHOST_MODULE="name" übersetzt,
+// damit der Benchmark den Spitzenverbrauch pro Modul ausweisen kann.
+#ifndef HOST_MODULE
+#define HOST_MODULE "other"
+#endif
+
+void* host_malloc(size_t size, const char* module);
+void* host_calloc(size_t count, size_t size, const char* module);
+void* host_realloc(void* ptr, size_t size, const char* module);
+void host_free(void* ptr);
+
+#ifndef HOST_SHIM_IMPL
+#define malloc(size) host_malloc((size), HOST_MODULE)
+#define calloc(count, size) host_calloc((count), (size), HOST_MODULE)
+#define realloc(ptr, size) host_realloc((ptr), (size), HOST_MODULE)
+#define free(ptr) host_free(ptr)
+#endif
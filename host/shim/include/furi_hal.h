@@ -0,0 +1,8 @@
+#pragma once
+
+#include <furi.h>
+#include <furi_hal_rtc.h>
+#include <furi_hal_random.h>
+#include <furi_hal_uart.h>
+#include <furi_hal_nfc.h>
+#include <furi_hal_cortex.h>
@@ -0,0 +1,15 @@
+#pragma once
+
+#include <furi.h>
+
+// Zyklenzähler: auf dem Host aus der realen Zeit mit 64 Takten pro µs
+// nachgebildet, damit Messungen in Takten dieselben Einheiten liefern.
+
+typedef struct {
+    uint32_t start;
+    uint32_t value;
+} FuriHalCortexTimer;
+
+FuriHalCortexTimer furi_hal_cortex_timer_get(uint32_t timeout_us);
+bool furi_hal_cortex_timer_is_expired(FuriHalCortexTimer cortex_timer);
+uint32_t furi_hal_cortex_instructions_per_microsecond(void);
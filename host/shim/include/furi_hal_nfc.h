@@ -0,0 +1,17 @@
+#pragma once
+
+#include <furi.h>
+
+typedef struct {
+    uint8_t uid[10];
+    uint8_t uid_len;
+} FuriHalNfcDevData;
+
+typedef struct {
+    uint8_t tx_data[64];
+    uint8_t rx_data[64];
+} FuriHalNfcTxRxContext;
+
+void furi_hal_nfc_init(void);
+void furi_hal_nfc_deinit(void);
+bool furi_hal_nfc_detect(FuriHalNfcDevData* dev_data, uint32_t timeout);
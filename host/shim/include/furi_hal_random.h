@@ -0,0 +1,7 @@
+#pragma once
+
+#include <furi.h>
+
+// Deterministisch (fester Seed), damit Host-Läufe reproduzierbar sind
+uint32_t furi_hal_random_get(void);
+void furi_hal_random_fill_buf(uint8_t* buf, uint32_t len);
@@ -0,0 +1,24 @@
+#pragma once
+
+#include <furi.h>
+
+typedef enum {
+    FuriHalUartIdUSART1,
+    FuriHalUartIdLPUART1,
+} FuriHalUartId;
+
+typedef enum {
+    UartIrqEventRXNE,
+    UartIrqEventIDLE,
+} UartIrqEvent;
+
+void furi_hal_uart_init(FuriHalUartId channel, uint32_t baud);
+void furi_hal_uart_deinit(FuriHalUartId channel);
+void furi_hal_uart_set_br(FuriHalUartId channel, uint32_t baud);
+void furi_hal_uart_tx(FuriHalUartId channel, uint8_t* buffer, size_t buffer_size);
+uint16_t furi_hal_uart_rx_available(FuriHalUartId channel);
+size_t furi_hal_uart_rx(FuriHalUartId channel, uint8_t* buffer, size_t buffer_size);
+void furi_hal_uart_set_irq_cb(
+    FuriHalUartId channel,
+    void (*callback)(UartIrqEvent event, uint8_t data, void* context),
+    void* context);
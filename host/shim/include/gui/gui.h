@@ -0,0 +1,28 @@
+#pragma once
+
+#include <furi.h>
+
+// Minimaler GUI-Ersatz: Typen für Header, die gui.h einbinden, und ein
+// Canvas, das Zeichenaufrufe nur zählt
+typedef struct Gui Gui;
+typedef struct Canvas Canvas;
+typedef struct ViewPort ViewPort;
+
+typedef enum {
+    FontPrimary,
+    FontSecondary,
+    FontKeyboard,
+    FontBigNumbers,
+} Font;
+
+typedef enum {
+    ColorWhite,
+    ColorBlack,
+    ColorXOR,
+} Color;
+
+void canvas_clear(Canvas* canvas);
+void canvas_set_font(Canvas* canvas, Font font);
+void canvas_set_color(Canvas* canvas, Color color);
+void canvas_draw_str(Canvas* canvas, uint8_t x, uint8_t y, const char* str);
+void canvas_draw_box(Canvas* canvas, uint8_t x, uint8_t y, uint8_t width, uint8_t height);
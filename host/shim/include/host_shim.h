@@ -0,0 +1,58 @@
+#pragma once
+
+// Nur auf dem Host verfügbare Steuer- und Messfunktionen des Shims.
+
+#include <furi.h>
+#include <furi_hal_nfc.h>
+#include <furi_hal_uart.h>
+
+// Virtuelle Uhr: läuft nur, wenn der Aufrufer sie vorstellt.
+// furi_delay_ms() blockiert real, verändert die virtuelle Zeit aber nicht.
+void host_clock_set(uint32_t tick);
+void host_clock_advance(uint32_t milliseconds);
+
+// Reale Zeit in Nanosekunden für Latenzmessungen
+uint64_t host_time_ns(void);
+
+// Heap-Statistik pro Modul
+#define HOST_HEAP_MAX_MODULES 32
+
+typedef struct {
+    const char* module;
+    size_t current;
+    size_t peak;
+    uint32_t allocations;
+} HostHeapStats;
+
+size_t host_heap_get_stats(HostHeapStats* stats, size_t max_count);
+void host_heap_reset_peaks(void);
+
+// Speicherstatistik (SD-Karte)
+typedef struct {
+    uint64_t bytes_written;
+    uint64_t bytes_read;
+    uint32_t write_calls;
+    uint32_t read_calls;
+    uint32_t open_calls;
+} HostStorageStats;
+
+void host_storage_set_root(const char* path);
+void host_storage_get_stats(HostStorageStats* stats);
+void host_storage_reset_stats(void);
+
+// Anzahl abgespielter Benachrichtigungs-Sequenzen
+uint32_t host_notification_get_count(void);
+
+// Anzahl der Canvas-Zeichenaufrufe
+uint32_t host_canvas_get_draw_calls(void);
+
+// UART-Gegenstelle: furi_hal_uart_tx() übergibt die Bytes an die Senke,
+// host_uart_receive() liefert Bytes wie der RX-Interrupt an die App.
+typedef void (*HostUartSink)(const uint8_t* data, size_t size, void* context);
+void host_uart_set_sink(FuriHalUartId channel, HostUartSink sink, void* context);
+void host_uart_receive(FuriHalUartId channel, const uint8_t* data, size_t size);
+
+// NFC-Feld: die Quelle liefert bei jedem furi_hal_nfc_detect() den Tag im
+// Feld (true) oder nichts (false). Ohne Quelle wird nie ein Tag erkannt.
+typedef bool (*HostNfcSource)(FuriHalNfcDevData* dev_data, void* context);
+void host_nfc_set_source(HostNfcSource source, void* context);
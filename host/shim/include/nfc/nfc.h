@@ -0,0 +1,7 @@
+#pragma once
+
+#include <furi.h>
+
+// Minimaler NFC-Ersatz: Typen für Header, die nfc.h einbinden
+typedef struct Nfc Nfc;
+typedef struct NfcTag NfcTag;
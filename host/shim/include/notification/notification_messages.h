@@ -0,0 +1,24 @@
+#pragma once
+
+#include <furi.h>
+
+#define RECORD_NOTIFICATION "notification"
+
+typedef struct NotificationApp NotificationApp;
+
+typedef struct {
+    uint8_t type;
+    uint32_t data;
+} NotificationMessage;
+
+typedef const NotificationMessage* NotificationSequence[];
+
+extern const NotificationSequence sequence_success;
+extern const NotificationSequence sequence_error;
+extern const NotificationSequence sequence_warning;
+extern const NotificationSequence sequence_blink_green_100;
+extern const NotificationSequence sequence_blink_yellow_100;
+extern const NotificationSequence sequence_blink_magenta_100;
+
+void notification_message(NotificationApp* app, const NotificationSequence* sequence);
+void notification_message_block(NotificationApp* app, const NotificationSequence* sequence);
@@ -0,0 +1,15 @@
+#pragma once
+
+#include <furi.h>
+
+// Host-Ersatz für den Kompressor der Firmware (PackBits-RLE).
+// *out_size ist beim Aufruf die Kapazität von out, danach die Nutzlänge.
+void compression_init(void);
+void compression_free(void);
+bool compression_encode(
+    const void* in,
+    size_t in_size,
+    void* out,
+    size_t* out_size,
+    int level);
+bool compression_decode(const void* in, size_t in_size, void* out, size_t* out_size);
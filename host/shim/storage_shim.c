@@ -0,0 +1,198 @@
+#define HOST_SHIM_IMPL
+#include <furi.h>
+#include <storage/storage.h>
+#include "host_shim.h"
+
+#include <errno.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+// Die SD-Karte wird auf ein Host-Verzeichnis abgebildet:
+// "/ext/apps_data/x" -> "<root>/ext/apps_data/x"
+static char host_storage_root[256] = "_host_sd";
+static HostStorageStats host_storage_stats;
+
+struct File {
+    FILE* handle;
+};
+
+void host_storage_set_root(const char* path) {
+    strncpy(host_storage_root, path, sizeof(host_storage_root) - 1);
+}
+
+void host_storage_get_stats(HostStorageStats* stats) {
+    *stats = host_storage_stats;
+}
+
+void host_storage_reset_stats(void) {
+    memset(&host_storage_stats, 0, sizeof(host_storage_stats));
+}
+
+static void host_storage_map_path(const char* path, char* out, size_t out_size) {
+    snprintf(out, out_size, "%s%s%s", host_storage_root, path[0] == '/' ? "" : "/", path);
+}
+
+static bool host_mkdir_recursive(const char* host_path) {
+    char buffer[512];
+    strncpy(buffer, host_path, sizeof(buffer) - 1);
+    buffer[sizeof(buffer) - 1] = '\0';
+
+    for(char* p = buffer + 1; *p; p++) {
+        if(*p == '/') {
+            *p = '\0';
+            mkdir(buffer, 0755);
+            *p = '/';
+        }
+    }
+    return mkdir(buffer, 0755) == 0 || errno == EEXIST;
+}
+
+File* storage_file_alloc(Storage* storage) {
+    UNUSED(storage);
+    return host_calloc(1, sizeof(File), "storage");
+}
+
+void storage_file_free(File* file) {
+    if(!file) return;
+    storage_file_close(file);
+    host_free(file);
+}
+
+bool storage_file_open(
+    File* file,
+    const char* path,
+    FS_AccessMode access_mode,
+    FS_OpenMode mode) {
+    char host_path[512];
+    host_storage_map_path(path, host_path, sizeof(host_path));
+
+    storage_file_close(file);
+    host_storage_stats.open_calls++;
+
+    bool exists = access(host_path, F_OK) == 0;
+    const char* fmode = NULL;
+
+    switch(mode) {
+    case FSOM_OPEN_EXISTING:
+        if(!exists) return false;
+        fmode = (access_mode & FSAM_WRITE) ? "r+b" : "rb";
+        break;
+    case FSOM_OPEN_ALWAYS:
+        fmode = exists ? ((access_mode & FSAM_WRITE) ? "r+b" : "rb") : "w+b";
+        break;
+    case FSOM_OPEN_APPEND:
+        fmode = "a+b";
+        break;
+    case FSOM_CREATE_NEW:
+        if(exists) return false;
+        fmode = "w+b";
+        break;
+    case FSOM_CREATE_ALWAYS:
+        fmode = "w+b";
+        break;
+    }
+
+    file->handle = fopen(host_path, fmode);
+    return file->handle != NULL;
+}
+
+bool storage_file_close(File* file) {
+    if(!file || !file->handle) return false;
+    fclose(file->handle);
+    file->handle = NULL;
+    return true;
+}
+
+bool storage_file_is_open(File* file) {
+    return file && file->handle;
+}
+
+size_t storage_file_read(File* file, void* buff, size_t bytes_to_read) {
+    if(!file->handle) return 0;
+    size_t read = fread(buff, 1, bytes_to_read, file->handle);
+    host_storage_stats.read_calls++;
+    host_storage_stats.bytes_read += read;
+    return read;
+}
+
+size_t storage_file_write(File* file, const void* buff, size_t bytes_to_write) {
+    if(!file->handle) return 0;
+    size_t written = fwrite(buff, 1, bytes_to_write, file->handle);
+    host_storage_stats.write_calls++;
+    host_storage_stats.bytes_written += written;
+    return written;
+}
+
+bool storage_file_write_string(File* file, const char* str) {
+    size_t len = strlen(str);
+    return storage_file_write(file, str, len) == len;
+}
+
+bool storage_file_seek(File* file, uint32_t offset, bool from_start) {
+    if(!file->handle) return false;
+    return fseek(file->handle, (long)offset, from_start ? SEEK_SET : SEEK_CUR) == 0;
+}
+
+uint64_t storage_file_tell(File* file) {
+    if(!file->handle) return 0;
+    return (uint64_t)ftell(file->handle);
+}
+
+uint64_t storage_file_size(File* file) {
+    if(!file->handle) return 0;
+    long pos = ftell(file->handle);
+    fseek(file->handle, 0, SEEK_END);
+    long size = ftell(file->handle);
+    fseek(file->handle, pos, SEEK_SET);
+    return (uint64_t)size;
+}
+
+bool storage_file_truncate(File* file) {
+    if(!file->handle) return false;
+    fflush(file->handle);
+    return ftruncate(fileno(file->handle), ftell(file->handle)) == 0;
+}
+
+bool storage_file_sync(File* file) {
+    if(!file->handle) return false;
+    return fflush(file->handle) == 0;
+}
+
+bool storage_file_eof(File* file) {
+    if(!file->handle) return true;
+    return storage_file_tell(file) >= storage_file_size(file);
+}
+
+bool storage_file_exists(Storage* storage, const char* path) {
+    UNUSED(storage);
+    char host_path[512];
+    host_storage_map_path(path, host_path, sizeof(host_path));
+    return access(host_path, F_OK) == 0;
+}
+
+bool storage_file_delete(Storage* storage, const char* path) {
+    return storage_common_remove(storage, path) == FSE_OK;
+}
+
+bool storage_mkdir(Storage* storage, const char* path) {
+    UNUSED(storage);
+    char host_path[512];
+    host_storage_map_path(path, host_path, sizeof(host_path));
+    return host_mkdir_recursive(host_path);
+}
+
+FS_Error storage_common_remove(Storage* storage, const char* path) {
+    UNUSED(storage);
+    char host_path[512];
+    host_storage_map_path(path, host_path, sizeof(host_path));
+    return remove(host_path) == 0 ? FSE_OK : FSE_NOT_EXIST;
+}
+
+FS_Error storage_common_rename(Storage* storage, const char* old_path, const char* new_path) {
+    UNUSED(storage);
+    char host_old[512];
+    char host_new[512];
+    host_storage_map_path(old_path, host_old, sizeof(host_old));
+    host_storage_map_path(new_path, host_new, sizeof(host_new));
+    return rename(host_old, host_new) == 0 ? FSE_OK : FSE_NOT_EXIST;
+}
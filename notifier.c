@@ -0,0 +1,133 @@
+#include "notifier.h"
+#include <notification/notification_messages.h>
+
+#define NOTIFIER_STOP_TOKEN 0xFF
+
+typedef struct {
+    const NotificationSequence* sequences[2];
+} NotifyEntry;
+
+// Sequenzen pro Ereignis, Index = NotifyId
+static const NotifyEntry notify_table[NotifyCount] = {
+    [NotifyGameEnd] = {{&sequence_success}},
+    [NotifyAchievement] = {{&sequence_success, &sequence_blink_magenta_100}},
+    [NotifyChapter] = {{&sequence_success, &sequence_success}},
+    [NotifyTimeWarning] = {{&sequence_warning}},
+    [NotifyGameStart] = {{&sequence_success}},
+    [NotifyPowerUp] = {{&sequence_success, &sequence_blink_magenta_100}},
+    [NotifyPowerUpEnd] = {{&sequence_error}},
+    [NotifyScanOk] = {{&sequence_success}},
+    [NotifyScanRejected] = {{&sequence_error}},
+    [NotifyCombo] = {{&sequence_blink_yellow_100}},
+    [NotifySaved] = {{&sequence_blink_green_100}},
+};
+
+typedef struct {
+    NotificationApp* notifications;
+    FuriThread* thread;
+    FuriMessageQueue* wakeup;  // Ein Token pro neu gesetztem Bit
+    uint32_t pending;          // Bitmaske wartender NotifyIds
+    NotifierStats stats;
+} Notifier;
+
+// Ein Dienst pro App, wie der Record, den er offen hält
+static Notifier* notifier = NULL;
+
+static void notifier_play(Notifier* instance, uint32_t mask) {
+    // Niedrigstes Bit zuerst = höchste Priorität
+    while(mask) {
+        uint32_t id = __builtin_ctz(mask);
+        mask &= mask - 1;
+
+        const NotifyEntry* entry = &notify_table[id];
+        for(size_t i = 0; i < COUNT_OF(entry->sequences) && entry->sequences[i]; i++) {
+            notification_message_block(instance->notifications, entry->sequences[i]);
+        }
+        __atomic_fetch_add(&instance->stats.played, 1, __ATOMIC_RELAXED);
+    }
+}
+
+static int32_t notifier_task(void* context) {
+    Notifier* instance = context;
+    uint8_t token;
+
+    while(true) {
+        furi_message_queue_get(instance->wakeup, &token, FuriWaitForever);
+        if(token == NOTIFIER_STOP_TOKEN) break;
+
+        // Burst sammeln, dann alle wartenden Tokens verwerfen
+        furi_delay_ms(NOTIFIER_WINDOW_MS);
+        bool stop = false;
+        while(furi_message_queue_get(instance->wakeup, &token, 0) == FuriStatusOk) {
+            stop |= (token == NOTIFIER_STOP_TOKEN);
+        }
+
+        uint32_t mask = __atomic_exchange_n(&instance->pending, 0, __ATOMIC_ACQ_REL);
+        notifier_play(instance, mask);
+        if(stop) break;
+    }
+
+    return 0;
+}
+
+void notifier_start(void) {
+    if(notifier) return;
+
+    Notifier* instance = malloc(sizeof(Notifier));
+    memset(instance, 0, sizeof(Notifier));
+    instance->notifications = furi_record_open(RECORD_NOTIFICATION);
+    // Ein Token pro gesetztem Bit genügt, plus Stopp
+    instance->wakeup = furi_message_queue_alloc(NotifyCount + 1, sizeof(uint8_t));
+
+    instance->thread = furi_thread_alloc();
+    furi_thread_set_name(instance->thread, "NotifierTask");
+    furi_thread_set_stack_size(instance->thread, 1024);
+    furi_thread_set_context(instance->thread, instance);
+    furi_thread_set_callback(instance->thread, notifier_task);
+    furi_thread_start(instance->thread);
+
+    __atomic_store_n(&notifier, instance, __ATOMIC_RELEASE);
+}
+
+void notifier_stop(void) {
+    Notifier* instance = __atomic_exchange_n(&notifier, NULL, __ATOMIC_ACQ_REL);
+    if(!instance) return;
+
+    // Wartende Ereignisse werden noch abgespielt
+    uint8_t token = NOTIFIER_STOP_TOKEN;
+    furi_message_queue_put(instance->wakeup, &token, FuriWaitForever);
+    furi_thread_join(instance->thread);
+    furi_thread_free(instance->thread);
+
+    furi_message_queue_free(instance->wakeup);
+    furi_record_close(RECORD_NOTIFICATION);
+    free(instance);
+}
+
+void notifier_post(NotifyId id) {
+    Notifier* instance = __atomic_load_n(&notifier, __ATOMIC_ACQUIRE);
+    if(!instance || id >= NotifyCount) return;
+
+    __atomic_fetch_add(&instance->stats.posted, 1, __ATOMIC_RELAXED);
+
+    uint32_t bit = 1U << id;
+    uint32_t previous = __atomic_fetch_or(&instance->pending, bit, __ATOMIC_ACQ_REL);
+    if(previous & bit) {
+        __atomic_fetch_add(&instance->stats.coalesced, 1, __ATOMIC_RELAXED);
+        return;
+    }
+
+    // Nur beim ersten Setzen wecken. Ist die Queue voll, warten schon
+    // Tokens und der Dienst wacht ohnehin auf.
+    uint8_t token = id;
+    furi_message_queue_put(instance->wakeup, &token, 0);
+}
+
+void notifier_get_stats(NotifierStats* stats) {
+    Notifier* instance = __atomic_load_n(&notifier, __ATOMIC_ACQUIRE);
+    if(!instance) {
+        memset(stats, 0, sizeof(NotifierStats));
+        return;
+    }
+    *stats = instance->stats;
+}
@@ -0,0 +1,41 @@
+#pragma once
+
+#include <furi.h>
+
+// Zentraler Benachrichtigungsdienst: hält RECORD_NOTIFICATION für die
+// gesamte Laufzeit offen und spielt Sequenzen in einem eigenen Thread ab.
+// notifier_post blockiert nie; gleiche Ereignisse innerhalb eines Fensters
+// werden zusammengefasst und nach Priorität abgespielt.
+
+#define NOTIFIER_WINDOW_MS 50
+
+// Reihenfolge = Priorität (oben zuerst abgespielt)
+typedef enum {
+    NotifyGameEnd,
+    NotifyAchievement,
+    NotifyChapter,
+    NotifyTimeWarning,
+    NotifyGameStart,
+    NotifyPowerUp,
+    NotifyPowerUpEnd,
+    NotifyScanOk,
+    NotifyScanRejected,
+    NotifyCombo,
+    NotifySaved,
+    NotifyCount
+} NotifyId;
+
+typedef struct {
+    uint32_t posted;     // Alle notifier_post-Aufrufe
+    uint32_t coalesced;  // Mit einem wartenden gleichen Ereignis zusammengefasst
+    uint32_t played;     // Tatsächlich abgespielte Ereignisse
+} NotifierStats;
+
+// Dienst für die App-Laufzeit starten bzw. beenden
+void notifier_start(void);
+void notifier_stop(void);
+
+// Ereignis melden, aus jedem Thread, ohne zu blockieren
+void notifier_post(NotifyId id);
+
+void notifier_get_stats(NotifierStats* stats);
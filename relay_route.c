@@ -0,0 +1,240 @@
+#include "relay_route.h"
+#include "flipper_http/map_manager.h"
+
+#define RELAY_FILE_MAGIC 0x59414C52  // "RLAY"
+#define RELAY_FILE_VERSION 1
+
+// Dateiformat: Header, binding_count RelayBinding, route_count Route
+typedef struct {
+    uint32_t magic;
+    uint32_t version;
+    uint32_t binding_count;
+    uint32_t route_count;
+} RelayFileHeader;
+
+void relay_route_reset(RelayRoute* relay) {
+    memset(relay, 0, sizeof(RelayRoute));
+    // Zustand 0 ist der Start
+    relay->state_count = 1;
+}
+
+static bool relay_route_lookup(
+    const RelayBinding* bindings,
+    uint32_t binding_count,
+    uint32_t waypoint_id,
+    TagKey* key) {
+    for(uint32_t i = 0; i < binding_count; i++) {
+        if(bindings[i].waypoint_id == waypoint_id) {
+            *key = tag_id_hash(bindings[i].uid, bindings[i].uid_len);
+            return true;
+        }
+    }
+    return false;
+}
+
+bool relay_route_add_path(
+    RelayRoute* relay,
+    const uint32_t* waypoint_ids,
+    uint32_t count,
+    const RelayBinding* bindings,
+    uint32_t binding_count) {
+    if(!relay || !waypoint_ids || count == 0) return false;
+
+    uint8_t state = 0;
+    for(uint32_t i = 0; i < count; i++) {
+        TagKey key;
+        if(!relay_route_lookup(bindings, binding_count, waypoint_ids[i], &key)) {
+            return false;
+        }
+
+        // Gemeinsame Präfixe teilen sich die Zustände
+        bool found = false;
+        for(uint8_t e = 0; e < relay->edge_count; e++) {
+            if(relay->edges[e].from == state && relay->edges[e].key == key) {
+                state = relay->edges[e].to;
+                found = true;
+                break;
+            }
+        }
+        if(found) continue;
+
+        if(relay->state_count >= RELAY_MAX_STATES || relay->edge_count >= RELAY_MAX_EDGES) {
+            return false;
+        }
+
+        RelayEdge* edge = &relay->edges[relay->edge_count++];
+        edge->key = key;
+        edge->from = state;
+        edge->to = relay->state_count++;
+        state = edge->to;
+    }
+
+    relay->states[state].accepting = true;
+    return true;
+}
+
+bool relay_route_finalize(RelayRoute* relay) {
+    if(!relay || relay->edge_count == 0) return false;
+
+    // Kanten nach Startzustand sortieren (stabil, nur beim Laden)
+    for(uint8_t i = 1; i < relay->edge_count; i++) {
+        RelayEdge edge = relay->edges[i];
+        uint8_t j = i;
+        while(j > 0 && relay->edges[j - 1].from > edge.from) {
+            relay->edges[j] = relay->edges[j - 1];
+            j--;
+        }
+        relay->edges[j] = edge;
+    }
+
+    for(uint8_t s = 0; s < relay->state_count; s++) {
+        relay->states[s].edge_count = 0;
+    }
+    for(uint8_t e = relay->edge_count; e > 0; e--) {
+        RelayState* state = &relay->states[relay->edges[e - 1].from];
+        state->edge_start = e - 1;
+        state->edge_count++;
+    }
+
+    // Eine einzige Kette 0 -> 1 -> ... -> n wird zum flachen Array
+    relay->linear = true;
+    for(uint8_t e = 0; e < relay->edge_count; e++) {
+        if(relay->edges[e].from != e || relay->edges[e].to != e + 1) {
+            relay->linear = false;
+            break;
+        }
+        relay->steps[e] = relay->edges[e].key;
+    }
+    relay->step_count = relay->linear ? relay->edge_count : 0;
+
+    relay->cursor = 0;
+    relay->laps = 0;
+    relay->loaded = true;
+    return true;
+}
+
+bool relay_route_load(RelayRoute* relay, const char* path) {
+    if(!relay || !path) return false;
+
+    relay_route_reset(relay);
+
+    Storage* storage = furi_record_open(RECORD_STORAGE);
+    if(!storage) return false;
+
+    File* file = storage_file_alloc(storage);
+    RelayBinding* bindings = NULL;
+    Route* route = NULL;
+    bool success = false;
+
+    do {
+        if(!storage_file_open(file, path, FSAM_READ, FSOM_OPEN_EXISTING)) break;
+
+        RelayFileHeader header;
+        if(storage_file_read(file, &header, sizeof(header)) != sizeof(header)) break;
+        if(header.magic != RELAY_FILE_MAGIC || header.version != RELAY_FILE_VERSION) break;
+        if(header.binding_count > RELAY_MAX_BINDINGS || header.route_count == 0) break;
+
+        // Nur beim Spielstart, nicht auf dem Scan-Pfad
+        size_t bindings_size = header.binding_count * sizeof(RelayBinding);
+        bindings = malloc(bindings_size);
+        route = malloc(sizeof(Route));
+        if(storage_file_read(file, bindings, bindings_size) != bindings_size) break;
+
+        success = true;
+        for(uint32_t i = 0; i < header.route_count && success; i++) {
+            success = storage_file_read(file, route, sizeof(Route)) == sizeof(Route) &&
+                      route->waypoint_count <= MAX_WAYPOINTS &&
+                      relay_route_add_path(
+                          relay,
+                          route->waypoints,
+                          route->waypoint_count,
+                          bindings,
+                          header.binding_count);
+        }
+        success = success && relay_route_finalize(relay);
+    } while(false);
+
+    storage_file_close(file);
+    storage_file_free(file);
+    furi_record_close(RECORD_STORAGE);
+    free(bindings);
+    free(route);
+
+    if(!success) {
+        relay_route_reset(relay);
+    }
+    return success;
+}
+
+bool relay_route_save(
+    const char* path,
+    const RelayBinding* bindings,
+    uint32_t binding_count,
+    const Route* routes,
+    uint32_t route_count) {
+    if(!path || !bindings || !routes || binding_count > RELAY_MAX_BINDINGS) return false;
+
+    Storage* storage = furi_record_open(RECORD_STORAGE);
+    if(!storage) return false;
+
+    RelayFileHeader header = {
+        .magic = RELAY_FILE_MAGIC,
+        .version = RELAY_FILE_VERSION,
+        .binding_count = binding_count,
+        .route_count = route_count,
+    };
+
+    bool success = false;
+    storage_mkdir(storage, RELAY_ROUTE_DIR);
+    File* file = storage_file_alloc(storage);
+    if(storage_file_open(file, path, FSAM_WRITE, FSOM_CREATE_ALWAYS)) {
+        size_t bindings_size = binding_count * sizeof(RelayBinding);
+        size_t routes_size = route_count * sizeof(Route);
+        success = storage_file_write(file, &header, sizeof(header)) == sizeof(header) &&
+                  storage_file_write(file, bindings, bindings_size) == bindings_size &&
+                  storage_file_write(file, routes, routes_size) == routes_size;
+    }
+    storage_file_close(file);
+    storage_file_free(file);
+
+    furi_record_close(RECORD_STORAGE);
+    return success;
+}
+
+RelayStep relay_route_check(RelayRoute* relay, TagKey key) {
+    if(relay->linear) {
+        if(relay->steps[relay->cursor] != key) {
+            return RelayStepWrong;
+        }
+        if(++relay->cursor == relay->step_count) {
+            relay->cursor = 0;
+            relay->laps++;
+            return RelayStepLap;
+        }
+        return RelayStepOk;
+    }
+
+    const RelayState* state = &relay->states[relay->cursor];
+    const RelayEdge* edge = &relay->edges[state->edge_start];
+    for(uint8_t i = 0; i < state->edge_count; i++, edge++) {
+        if(edge->key != key) continue;
+
+        relay->cursor = edge->to;
+        if(relay->states[edge->to].accepting) {
+            relay->laps++;
+            // Endzustand ohne Fortsetzung: neue Runde
+            if(relay->states[edge->to].edge_count == 0) {
+                relay->cursor = 0;
+            }
+            return RelayStepLap;
+        }
+        return RelayStepOk;
+    }
+
+    return RelayStepWrong;
+}
+
+void relay_route_restart(RelayRoute* relay) {
+    relay->cursor = 0;
+    relay->laps = 0;
+}
@@ -0,0 +1,84 @@
+#pragma once
+
+#include <furi.h>
+#include <storage/storage.h>
+#include "tag_id.h"
+
+// Staffel-Route als kleiner DFA über Tag-Schlüsseln. Eine einzelne Route wird
+// zu einem flachen Array mit Cursor, mehrere Routen (Verzweigungen) zu einem
+// Präfixbaum. Geprüft wird ohne Allokation in O(Verzweigungsgrad).
+
+#define RELAY_ROUTE_DIR EXT_PATH("apps_data/tagracer")
+#define RELAY_ROUTE_FILE RELAY_ROUTE_DIR "/relay.bin"
+#define RELAY_MAX_STATES 64
+#define RELAY_MAX_EDGES 64
+#define RELAY_MAX_BINDINGS 64
+
+struct Route;
+
+// Zuordnung Wegpunkt-ID (map_manager) zu Tag-UID
+typedef struct {
+    uint32_t waypoint_id;
+    uint8_t uid_len;
+    uint8_t uid[TAG_UID_MAX_LEN];
+} RelayBinding;
+
+typedef enum {
+    RelayStepWrong,  // Tag ist an dieser Stelle nicht erlaubt
+    RelayStepOk,     // Nächster Abschnitt erreicht
+    RelayStepLap     // Route vollständig gelaufen
+} RelayStep;
+
+typedef struct {
+    TagKey key;
+    uint8_t from;
+    uint8_t to;
+} RelayEdge;
+
+typedef struct {
+    uint8_t edge_start;
+    uint8_t edge_count;
+    bool accepting;
+} RelayState;
+
+typedef struct {
+    bool loaded;
+    bool linear;  // Nur eine Route: steps[] statt Kantensuche
+
+    // Linear: Schlüssel des Abschnitts i ist steps[i]
+    TagKey steps[RELAY_MAX_EDGES];
+    uint8_t step_count;
+
+    // Verzweigt: Kanten nach Startzustand sortiert
+    RelayState states[RELAY_MAX_STATES];
+    RelayEdge edges[RELAY_MAX_EDGES];
+    uint8_t state_count;
+    uint8_t edge_count;
+
+    uint8_t cursor;  // Abschnitt bzw. Zustand
+    uint32_t laps;
+} RelayRoute;
+
+void relay_route_reset(RelayRoute* relay);
+
+// Route aus Wegpunkt-IDs einfügen, danach einmal relay_route_finalize()
+bool relay_route_add_path(
+    RelayRoute* relay,
+    const uint32_t* waypoint_ids,
+    uint32_t count,
+    const RelayBinding* bindings,
+    uint32_t binding_count);
+bool relay_route_finalize(RelayRoute* relay);
+
+// Definition von der SD-Karte laden und übersetzen
+bool relay_route_load(RelayRoute* relay, const char* path);
+bool relay_route_save(
+    const char* path,
+    const RelayBinding* bindings,
+    uint32_t binding_count,
+    const struct Route* routes,
+    uint32_t route_count);
+
+// Hot Path: Scan prüfen und Cursor weiterschalten
+RelayStep relay_route_check(RelayRoute* relay, TagKey key);
+void relay_route_restart(RelayRoute* relay);
@@ -2,13 +2,15 @@ from flask import Flask, request, jsonify
 from flask_socketio import SocketIO, emit, join_room, leave_room
 from flask_cors import CORS
 from datetime import datetime, timedelta
+import hashlib
 import json
 
 from database import init_db, get_db
 from models import Player, Game, GamePlayer, Tag, GameTag, Achievement, PlayerAchievement
 from config import (
     HOST, PORT, DEBUG, SECRET_KEY, CORS_ORIGINS,
-    GAME_DURATION, MAX_PLAYERS, TAG_COOLDOWN, BASE_POINTS
+    GAME_DURATION, MAX_PLAYERS, TAG_COOLDOWN, BASE_POINTS,
+    LEADERBOARD_MAX_AGE, TAG_REGISTRY_MAX_AGE
 )
 
 # Flask und SocketIO Setup
@@ -82,6 +84,16 @@ def check_achievements(player_id, game_id=None):
                     }
                 }, room=f'player_{player_id}')
 
+def cached_json(payload, max_age):
+    """JSON-Antwort mit ETag über den Inhalt und Cache-Control. Passt
+    If-None-Match, geht nur ein 304 ohne Body zurück; die Flipper sparen
+    sich damit die Übertragung über den UART"""
+    response = jsonify(payload)
+    # Kurz gehalten, der ETag geht bei jeder Nachfrage über die Leitung
+    response.set_etag(hashlib.sha1(response.get_data()).hexdigest()[:16])
+    response.cache_control.max_age = max_age
+    return response.make_conditional(request)
+
 # API-Endpunkte
 
 @app.route('/api/players', methods=['POST'])
@@ -309,7 +321,7 @@ def get_leaderboard():
     """Bestenliste abrufen"""
     with get_db() as db:
         players = db.query(Player).order_by(Player.total_score.desc()).limit(100).all()
-        return jsonify({
+        return cached_json({
             'status': 'success',
             'leaderboard': [{
                 'username': p.username,
@@ -317,7 +329,21 @@ def get_leaderboard():
                 'total_games': p.total_games,
                 'achievements': len(p.achievements)
             } for p in players]
-        })
+        }, LEADERBOARD_MAX_AGE)
+
+@app.route('/api/tags', methods=['GET'])
+def get_tag_registry():
+    """Tag-Register: Punkte und Typ aller bekannten Tags"""
+    with get_db() as db:
+        tags = db.query(Tag).order_by(Tag.uid).all()
+        return cached_json({
+            'status': 'success',
+            'tags': [{
+                'uid': t.uid,
+                'points': t.points,
+                'type': t.type
+            } for t in tags]
+        }, TAG_REGISTRY_MAX_AGE)
 
 # WebSocket Events
 
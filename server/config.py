@@ -22,6 +22,10 @@ MAX_PLAYERS = int(os.getenv('MAX_PLAYERS', 4))
 TAG_COOLDOWN = int(os.getenv('TAG_COOLDOWN', 2))  # 2 Sekunden
 BASE_POINTS = int(os.getenv('BASE_POINTS', 10))
 
+# Antwort-Cache der Flipper: ETag und max-age für lesende Endpunkte (Sekunden)
+LEADERBOARD_MAX_AGE = int(os.getenv('LEADERBOARD_MAX_AGE', 5))
+TAG_REGISTRY_MAX_AGE = int(os.getenv('TAG_REGISTRY_MAX_AGE', 60))
+
 # WebSocket-Konfiguration
 SOCKET_PING_INTERVAL = int(os.getenv('SOCKET_PING_INTERVAL', 25))
 SOCKET_PING_TIMEOUT = int(os.getenv('SOCKET_PING_TIMEOUT', 120))
@@ -134,6 +134,33 @@ class TestGameLogic(unittest.TestCase):
             'tag_uid': 'test_tag'
         })
         self.assertEqual(response.status_code, 400)
+    
+    def test_leaderboard_etag(self):
+        """Test: Bestenliste mit ETag, unverändert nur 304 ohne Body"""
+        response = self.app.get('/api/leaderboard')
+        self.assertEqual(response.status_code, 200)
+        etag = response.headers['ETag']
+        self.assertIn('max-age', response.headers['Cache-Control'])
+        
+        response = self.app.get('/api/leaderboard', headers={'If-None-Match': etag})
+        self.assertEqual(response.status_code, 304)
+        self.assertEqual(response.get_data(), b'')
+        
+        # Neuer Spieler ändert die Liste und damit den ETag
+        with get_db() as db:
+            db.add(Player(username='second_player', device_id='second_device', total_score=50))
+        response = self.app.get('/api/leaderboard', headers={'If-None-Match': etag})
+        self.assertEqual(response.status_code, 200)
+        self.assertNotEqual(response.headers['ETag'], etag)
+    
+    def test_tag_registry_etag(self):
+        """Test: Tag-Register mit ETag"""
+        response = self.app.get('/api/tags')
+        self.assertEqual(response.status_code, 200)
+        self.assertEqual(response.get_json()['status'], 'success')
+        
+        response = self.app.get('/api/tags', headers={'If-None-Match': response.headers['ETag']})
+        self.assertEqual(response.status_code, 304)
 
 if __name__ == '__main__':
     unittest.main()
@@ -0,0 +1,114 @@
+#include "tag_id.h"
+
+#define FNV_OFFSET_BASIS 2166136261U
+#define FNV_PRIME 16777619U
+
+static const char hex_digits[] = "0123456789ABCDEF";
+
+TagKey tag_id_hash(const uint8_t* uid, uint8_t uid_len) {
+    uint32_t hash = FNV_OFFSET_BASIS;
+
+    hash ^= uid_len;
+    hash *= FNV_PRIME;
+    for(uint8_t i = 0; i < uid_len; i++) {
+        hash ^= uid[i];
+        hash *= FNV_PRIME;
+    }
+
+    // 0 ist für "kein Tag" reserviert
+    return hash == TAG_KEY_NONE ? 1 : hash;
+}
+
+void tag_id_table_init(TagIdTable* table) {
+    memset(table, 0, sizeof(TagIdTable));
+    table->generation = 1;
+}
+
+void tag_id_table_clear(TagIdTable* table) {
+    table->count = 0;
+    table->generation++;
+
+    // Nach Überlauf wären alte Einträge wieder gültig
+    if(table->generation == 0) {
+        tag_id_table_init(table);
+    }
+}
+
+// Slot mit dem Schlüssel oder der erste freie Slot der Sondierungskette
+static TagIdEntry* tag_id_table_probe(const TagIdTable* table, TagKey key) {
+    uint32_t mask = TAG_ID_TABLE_SIZE - 1;
+    uint32_t index = key & mask;
+
+    for(uint32_t i = 0; i < TAG_ID_TABLE_SIZE; i++) {
+        TagIdEntry* entry = (TagIdEntry*)&table->entries[index];
+        if(entry->generation != table->generation || entry->key == key) {
+            return entry;
+        }
+        index = (index + 1) & mask;
+    }
+
+    return NULL;
+}
+
+const TagIdEntry* tag_id_table_find(const TagIdTable* table, TagKey key) {
+    TagIdEntry* entry = tag_id_table_probe(table, key);
+    if(entry && entry->generation == table->generation) {
+        return entry;
+    }
+    return NULL;
+}
+
+const TagIdEntry* tag_id_table_intern(
+    TagIdTable* table,
+    TagKey key,
+    const uint8_t* uid,
+    uint8_t uid_len) {
+    TagIdEntry* entry = tag_id_table_probe(table, key);
+    if(!entry) return NULL;
+
+    if(entry->generation == table->generation) {
+        return entry;
+    }
+
+    if(table->count >= TAG_ID_TABLE_MAX_LOAD) {
+        return NULL;
+    }
+
+    entry->key = key;
+    entry->generation = table->generation;
+    entry->uid_len = MIN(uid_len, TAG_UID_MAX_LEN);
+    if(entry->uid_len > 0) memcpy(entry->uid, uid, entry->uid_len);
+    table->count++;
+
+    return entry;
+}
+
+bool tag_id_table_mark(TagIdTable* table, TagKey key, const uint8_t* uid, uint8_t uid_len) {
+    if(tag_id_table_find(table, key)) {
+        return false;
+    }
+
+    tag_id_table_intern(table, key, uid, uid_len);
+    return true;
+}
+
+size_t tag_id_format_hex(const uint8_t* uid, uint8_t uid_len, char* out, size_t out_size) {
+    if(out_size == 0) return 0;
+
+    size_t len = MIN((size_t)uid_len, (out_size - 1) / 2);
+    for(size_t i = 0; i < len; i++) {
+        out[i * 2] = hex_digits[uid[i] >> 4];
+        out[i * 2 + 1] = hex_digits[uid[i] & 0x0F];
+    }
+    out[len * 2] = '\0';
+
+    return len * 2;
+}
+
+bool tag_id_table_format(const TagIdTable* table, TagKey key, char* out, size_t out_size) {
+    const TagIdEntry* entry = tag_id_table_find(table, key);
+    if(!entry) return false;
+
+    tag_id_format_hex(entry->uid, entry->uid_len, out, out_size);
+    return true;
+}
@@ -0,0 +1,53 @@
+#pragma once
+
+#include <furi.h>
+
+// Kompakte Tag-Identität: die UID wird einmal beim Scan zu einem 32-Bit-Schlüssel
+// gehasht. Spiellogik, Story-Modus und P2P arbeiten nur mit dem Schlüssel,
+// der Hex-String entsteht erst für Anzeige oder HTTP.
+
+typedef uint32_t TagKey;
+
+#define TAG_KEY_NONE 0
+#define TAG_UID_MAX_LEN 10
+#define TAG_ID_HEX_SIZE (TAG_UID_MAX_LEN * 2 + 1)
+
+// Zweierpotenz; maximal 3/4 davon werden belegt
+#define TAG_ID_TABLE_SIZE 256
+#define TAG_ID_TABLE_MAX_LOAD (TAG_ID_TABLE_SIZE * 3 / 4)
+
+typedef struct {
+    TagKey key;
+    uint16_t generation;
+    uint8_t uid_len;
+    uint8_t uid[TAG_UID_MAX_LEN];
+} TagIdEntry;
+
+// Open-Addressing-Tabelle ohne Heap. Leeren ist O(1): Einträge einer
+// älteren Generation gelten als frei.
+typedef struct {
+    TagIdEntry entries[TAG_ID_TABLE_SIZE];
+    uint16_t generation;
+    uint16_t count;
+} TagIdTable;
+
+// Schlüssel berechnen (FNV-1a, nie TAG_KEY_NONE)
+TagKey tag_id_hash(const uint8_t* uid, uint8_t uid_len);
+
+// Tabelle
+void tag_id_table_init(TagIdTable* table);
+void tag_id_table_clear(TagIdTable* table);
+const TagIdEntry* tag_id_table_find(const TagIdTable* table, TagKey key);
+const TagIdEntry* tag_id_table_intern(
+    TagIdTable* table,
+    TagKey key,
+    const uint8_t* uid,
+    uint8_t uid_len);
+
+// true, wenn der Tag in dieser Generation zum ersten Mal gesehen wird.
+// Bei voller Tabelle wird der Tag nicht gemerkt und als neu gemeldet.
+bool tag_id_table_mark(TagIdTable* table, TagKey key, const uint8_t* uid, uint8_t uid_len);
+
+// Hex-Darstellung (Großbuchstaben), liefert die Länge ohne Nullterminator
+size_t tag_id_format_hex(const uint8_t* uid, uint8_t uid_len, char* out, size_t out_size);
+bool tag_id_table_format(const TagIdTable* table, TagKey key, char* out, size_t out_size);
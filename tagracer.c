@@ -1,10 +1,35 @@
 #include <furi.h>
+#include <furi_hal.h>
 #include <gui/gui.h>
 #include <input/input.h>
 #include <notification/notification_messages.h>
 #include "tagracer_nfc.h"
 #include "game_state.h"
+#include "game_view.h"
+#include "game_log.h"
+#include "notifier.h"
 #include "flipper_http/flipper_http.h"
+#include "flipper_http/wire_protocol.h"
+#include "flipper_http/json_writer.h"
+#include "flipper_http/offline_data.h"
+
+#define TAGRACER_TAG_URL "http://localhost:5000/api/tag"
+// Jede Antwort unterwegs kann ein Punkte-Event schicken, dazu Platz für
+// Eingaben und Scan-Weckrufe
+#define TAGRACER_EVENT_QUEUE_SIZE (FLIPPER_HTTP_QUEUE_SIZE + 8)
+
+typedef enum {
+    TagRacerEventTypeInput,
+    TagRacerEventTypeScan,    // Scanner hat neue Einträge im Ring
+    TagRacerEventTypePoints,  // Punkte vom Server, aus dem HTTP-Worker
+} TagRacerEventType;
+
+typedef struct {
+    TagRacerEventType type;
+    InputEvent input;
+    uint32_t points;
+    FlipperHTTPRequestId request;  // Scan, dem die Punkte gelten
+} TagRacerEvent;
 
 typedef struct {
     Gui* gui;
@@ -13,127 +38,277 @@ typedef struct {
     NFCScanner* nfc_scanner;
     FlipperHTTP* http;
     GameContext* game;
-    FuriTimer* timer;
+    GameView view;
+    GameLog* log;  // Eingabeprotokoll des laufenden Spiels
+    // Erster Scan-Request des laufenden Spiels; Antworten auf ältere
+    // gehören zu einem früheren Spiel
+    FlipperHTTPRequestId game_request;
+    char http_body[32];  // Server-Antwort, nur im HTTP-Worker
+    size_t http_body_len;
+    uint32_t points_dropped;  // Punkte-Events ohne Platz in der Queue, nur im HTTP-Worker
 } TagRacer;
 
+// Body-Ausschnitte der Server-Antwort sammeln (läuft im HTTP-Worker)
+static void http_body_callback(const uint8_t* data, size_t size, size_t offset, void* context) {
+    TagRacer* tagracer = context;
+    if(offset == 0) tagracer->http_body_len = 0;
+    size_t space = sizeof(tagracer->http_body) - 1 - tagracer->http_body_len;
+    size_t count = MIN(size, space);
+    memcpy(tagracer->http_body + tagracer->http_body_len, data, count);
+    tagracer->http_body_len += count;
+}
+
+// Punkte an den Hauptthread geben: nur dort ändern sich Spielstand und
+// Protokoll, in fester Reihenfolge mit Scans und Ticks. Läuft im HTTP-Worker;
+// beim Beenden leert niemand mehr die Queue, daher nicht ewig warten. Die
+// Queue fasst alle Antworten unterwegs, voll ist sie nur beim Beenden
+static void tagracer_post_points(TagRacer* tagracer, FlipperHTTPRequestId request, uint32_t points) {
+    TagRacerEvent event = {.type = TagRacerEventTypePoints, .points = points, .request = request};
+    if(furi_message_queue_put(tagracer->event_queue, &event, 100) != FuriStatusOk) {
+        tagracer->points_dropped++;
+    }
+}
+
 // HTTP-Callback für Server-Antworten
 static void http_callback(FlipperHTTPResponse* response, void* context) {
     TagRacer* tagracer = context;
-    if(response->status_code == 200) {
-        // Parse JSON response und aktualisiere Score
+    
+    // status_code 0 = Timeout
+    if(response->status_code == 200 && response->body_size > 0) {
+        // Parse JSON response, Score ändert der Hauptthread
         uint32_t points;
-        if(sscanf(response->body, "{\"points\":%ld}", &points) == 1) {
-            tagracer->game->score += points;
+        tagracer->http_body[tagracer->http_body_len] = '\0';
+        if(sscanf(tagracer->http_body, "{\"points\":%ld}", &points) == 1) {
+            tagracer_post_points(tagracer, response->id, points);
         }
     }
 }
 
-// Callback für gescannte NFC-Tags
-static void tag_callback(TagData* tag_data, void* context) {
+// Binäre Antwort auf einen TagScan (WireScanResult)
+static void wire_scan_callback(FlipperHTTPResponse* response, void* context) {
     TagRacer* tagracer = context;
     
+    if(response->status_code == 200 && response->body_size == sizeof(WireScanResult)) {
+        WireScanResult result;
+        memcpy(&result, tagracer->http_body, sizeof(result));
+        tagracer_post_points(tagracer, response->id, result.points);
+    }
+}
+
+// Punkte im Hauptthread vergeben, nur für Scans aus dem laufenden Spiel.
+// IDs steigen fortlaufend, der Vergleich übersteht den Überlauf
+static void tagracer_apply_points(TagRacer* tagracer, const TagRacerEvent* event) {
+    if(tagracer->game_request == FLIPPER_HTTP_REQUEST_NONE ||
+       (int32_t)(event->request - tagracer->game_request) < 0) {
+        return;
+    }
+    game_state_add_points(tagracer->game, event->points);
+}
+
+// Ersten Scan-Request des laufenden Spiels merken
+static void tagracer_track_request(TagRacer* tagracer, FlipperHTTPRequestId id) {
+    if(tagracer->game->state == GameStateRunning && tagracer->game_request == FLIPPER_HTTP_REQUEST_NONE) {
+        tagracer->game_request = id;
+    }
+}
+
+// Body für /api/tag. Hex-String nur für den Server erzeugen, das Spiel
+// nutzt den Schlüssel; player_id wird maskiert
+static void tagracer_write_tag_json(
+    JsonWriter* json,
+    const uint8_t* uid,
+    size_t uid_len,
+    const char* player_id) {
+    json_writer_begin_object(json);
+    json_writer_key(json, "tag_id");
+    json_writer_hex(json, uid, uid_len);
+    json_writer_add_string(json, "player_id", player_id);
+    json_writer_end_object(json);
+}
+
+static void tagracer_write_undelivered(JsonWriter* json, void* context) {
+    const FlipperHTTPUndelivered* request = context;
+    if(request->wire_type == WireTypeTagScan) {
+        const WireTagScan* scan = request->payload;
+        char player_id[sizeof(scan->player_id) + 1];
+        memcpy(player_id, scan->player_id, sizeof(scan->player_id));
+        player_id[sizeof(scan->player_id)] = '\0';
+        tagracer_write_tag_json(
+            json, scan->uid, MIN((size_t)scan->uid_len, sizeof(scan->uid)), player_id);
+    } else if(request->body[0]) {
+        json_writer_raw(json, request->body);
+    } else {
+        json_writer_null(json);
+    }
+}
+
+// Nicht zugestellte Scans für den späteren Sync auf die SD-Karte (HTTP-Worker).
+// Punkte sind lokal schon vergeben, nur der Serverdatensatz fehlt
+static void http_undelivered_callback(const FlipperHTTPUndelivered* request, void* context) {
+    UNUSED(context);
+    if(request->wire_type == WireTypeTagScan) {
+        offline_data_queue_upload("POST", TAGRACER_TAG_URL, tagracer_write_undelivered, (void*)request);
+    } else if(!request->wire_type) {
+        offline_data_queue_upload(
+            request->method, request->url, tagracer_write_undelivered, (void*)request);
+    }
+}
+
+// Tag als festen Binärrahmen senden, die Bridge übersetzt für den Server
+static FlipperHTTPRequestId tagracer_send_wire_scan(TagRacer* tagracer, const TagData* tag_data) {
+    WireTagScan scan = {
+        .timestamp = furi_hal_rtc_get_timestamp(),
+        .uid_len = tag_data->uid_len,
+    };
+    memcpy(scan.uid, tag_data->uid, MIN((size_t)tag_data->uid_len, sizeof(scan.uid)));
+    strncpy(scan.player_id, tagracer->game->player_id, sizeof(scan.player_id));
+    
+    FlipperHTTPMessage message = {
+        .type = WireTypeTagScan,
+        .payload = &scan,
+        .size = sizeof(scan),
+        .callback = wire_scan_callback,
+        .body_callback = http_body_callback,
+        .context = tagracer
+    };
+    return flipper_http_send_message(tagracer->http, &message);
+}
+
+// Gescannten Tag im Hauptthread verarbeiten
+static void tagracer_process_tag(TagRacer* tagracer, TagData* tag_data) {
     // Tag im Spielzustand verarbeiten
     game_state_process_tag(tagracer->game, tag_data);
     
-    // Tag-Daten an Server senden
-    if(tagracer->http) {
-        char tag_id[32];
-        for(uint8_t i = 0; i < tag_data->uid_len; i++) {
-            snprintf(tag_id + (i * 2), 3, "%02X", tag_data->uid[i]);
+    // Bridge hat Binärrahmen ausgehandelt
+    if(tagracer->http && flipper_http_get_mode(tagracer->http) == FlipperHTTPModeWire) {
+        FlipperHTTPRequestId id = tagracer_send_wire_scan(tagracer, tag_data);
+        if(id == FLIPPER_HTTP_REQUEST_NONE) {
+            game_state_set_status(tagracer->game, "Server ausgelastet");
         }
-        
-        // HTTP-Request vorbereiten
+        tagracer_track_request(tagracer, id);
+    } else if(tagracer->http) {
+        // Tag-Daten als JSON an Server senden
         char body[128];
-        snprintf(body, sizeof(body),
-                "{\"tag_id\":\"%s\",\"player_id\":\"%s\"}",
-                tag_id,
-                tagracer->game->player_id);
+        JsonWriter json;
+        json_writer_init(&json, body, sizeof(body));
+        tagracer_write_tag_json(&json, tag_data->uid, tag_data->uid_len, tagracer->game->player_id);
+        if(!json_writer_finish(&json)) return;
         
         FlipperHTTPRequest request = {
             .method = "POST",
-            .url = "http://localhost:5000/api/tag",
+            .url = TAGRACER_TAG_URL,
             .body = body,
             .callback = http_callback,
+            .body_callback = http_body_callback,
             .context = tagracer
         };
         
-        flipper_http_send_request(tagracer->http, &request);
+        // Warteschlange voll: Spielstand ist schon vergeben, nur melden
+        FlipperHTTPRequestId id = flipper_http_send_request(tagracer->http, &request);
+        if(id == FLIPPER_HTTP_REQUEST_NONE) {
+            game_state_set_status(tagracer->game, "Server ausgelastet");
+        }
+        tagracer_track_request(tagracer, id);
+    }
+}
+
+// Alle wartenden Scans aus dem Ring abarbeiten
+static void tagracer_drain_scans(TagRacer* tagracer) {
+    NfcScanRecord record;
+    while(nfc_scanner_pop(tagracer->nfc_scanner, &record)) {
+        tagracer_process_tag(tagracer, &record.tag);
+        nfc_scanner_record_processed(tagracer->nfc_scanner, &record);
     }
 }
 
-// Timer-Callback für Spielzeit
-static void timer_callback(void* context) {
+// Läuft im Scanner-Thread: nur den Hauptthread wecken
+static void scan_ready_callback(void* context) {
     TagRacer* tagracer = context;
-    game_state_update(tagracer->game);
-    view_port_update(tagracer->view_port);
+    TagRacerEvent event = {.type = TagRacerEventTypeScan};
+    // Nicht blockieren; bei voller Queue leert die nächste Runde den Ring
+    furi_message_queue_put(tagracer->event_queue, &event, 0);
+}
+
+// Protokoll des letzten Spiels abschließen, ein neues pro Spiel anlegen
+static void tagracer_open_log(TagRacer* tagracer) {
+    if(tagracer->game->log) {
+        game_log_check(tagracer->log, tagracer->game);
+        game_log_close(tagracer->log);
+    }
+    
+    char path[64];
+    snprintf(path, sizeof(path), GAME_LOG_DIR "/%lu.log", furi_hal_rtc_get_timestamp());
+    tagracer->game->log = game_log_open_file(tagracer->log, path) ? tagracer->log : NULL;
 }
 
 // Render callback für die GUI
 static void render_callback(Canvas* canvas, void* ctx) {
     TagRacer* tagracer = ctx;
-    GameContext* game = tagracer->game;
-    
-    canvas_clear(canvas);
-    
-    // Titel
-    canvas_set_font(canvas, FontPrimary);
-    canvas_draw_str(canvas, 2, 10, "TagRacer");
-    
-    // Spielstatus
-    canvas_set_font(canvas, FontSecondary);
-    canvas_draw_str(canvas, 2, 22, game->status_text);
-    
-    // Hauptinformationen
-    canvas_set_font(canvas, FontPrimary);
-    
-    // Score
-    char score_str[32];
-    snprintf(score_str, sizeof(score_str), "Score: %ld", game->score);
-    canvas_draw_str(canvas, 2, 36, score_str);
-    
-    // Zeit
-    char time_str[32];
-    snprintf(time_str, sizeof(time_str), "Zeit: %ld:%02ld", 
-             game->time_remaining / 60, game->time_remaining % 60);
-    canvas_draw_str(canvas, 2, 50, time_str);
-    
-    // Tag-Zähler
-    char tags_str[32];
-    snprintf(tags_str, sizeof(tags_str), "Tags: %ld", game->tag_count);
-    canvas_draw_str(canvas, 2, 64, tags_str);
+    game_view_draw(&tagracer->view, tagracer->game, canvas);
+}
+
+// Link-Seite der Debug-Anzeige (GUI-Thread)
+static size_t tagracer_link_lines(char lines[][GAME_VIEW_DEBUG_LINE_SIZE], size_t count, void* ctx) {
+    TagRacer* tagracer = ctx;
+    if(count < 5) return 0;
+
+    FlipperHTTPLinkStats link;
+    FlipperHTTPStats stats;
+    flipper_http_get_link_stats(tagracer->http, &link);
+    flipper_http_get_stats(tagracer->http, &stats);
+    bool wire = flipper_http_get_mode(tagracer->http) == FlipperHTTPModeWire;
+
+    snprintf(lines[0], GAME_VIEW_DEBUG_LINE_SIZE, "%s q%lu f%lu idle %lus",
+             wire ? "Wire" : "HTTP", link.queue_depth, link.in_flight, link.idle_ms / 1000);
+    snprintf(lines[1], GAME_VIEW_DEBUG_LINE_SIZE, "RTT %lu/%lu/%lu ms",
+             link.rtt_p50, link.rtt_p90, link.rtt_p99);
+    snprintf(lines[2], GAME_VIEW_DEBUG_LINE_SIZE, "Queue %lu/%lu ms",
+             link.queue_p50, link.queue_p99);
+    snprintf(lines[3], GAME_VIEW_DEBUG_LINE_SIZE, "TX %lu RX %lu B/s",
+             link.tx_rate, link.rx_rate);
+    static const char* breaker[] = {"", " OFFEN", " PROBE"};
+    snprintf(lines[4], GAME_VIEW_DEBUG_LINE_SIZE, "TO %lu Rt %lu Off %lu%s",
+             stats.timeouts, stats.retries, stats.undelivered, breaker[link.breaker]);
+    return 5;
 }
 
 // Input callback für Benutzereingaben
 static void input_callback(InputEvent* input_event, void* ctx) {
     TagRacer* tagracer = ctx;
-    furi_message_queue_put(tagracer->event_queue, input_event, FuriWaitForever);
+    TagRacerEvent event = {.type = TagRacerEventTypeInput, .input = *input_event};
+    furi_message_queue_put(tagracer->event_queue, &event, FuriWaitForever);
 }
 
 // Haupteinstiegspunkt der Anwendung
 int32_t tagracer_app_main(void* p) {
     UNUSED(p);
     TagRacer* tagracer = malloc(sizeof(TagRacer));
+    memset(tagracer, 0, sizeof(TagRacer));
+    
+    // Benachrichtigungen laufen über einen Dienst, der den Record offen hält
+    notifier_start();
 
     // Komponenten initialisieren
     tagracer->gui = furi_record_open(RECORD_GUI);
     tagracer->view_port = view_port_alloc();
-    tagracer->event_queue = furi_message_queue_alloc(8, sizeof(InputEvent));
+    tagracer->event_queue = furi_message_queue_alloc(TAGRACER_EVENT_QUEUE_SIZE, sizeof(TagRacerEvent));
     tagracer->game = malloc(sizeof(GameContext));
+    tagracer->log = game_log_alloc();
+    tagracer->game_request = FLIPPER_HTTP_REQUEST_NONE;
     
     // Spielzustand initialisieren
     game_state_init(tagracer->game);
+    game_view_init(&tagracer->view);
     
     // NFC Scanner initialisieren
     tagracer->nfc_scanner = nfc_scanner_alloc();
-    nfc_scanner_start(tagracer->nfc_scanner, tag_callback, tagracer);
+    nfc_scanner_start(tagracer->nfc_scanner, scan_ready_callback, tagracer);
     
     // HTTP Client initialisieren
     tagracer->http = flipper_http_alloc();
     flipper_http_init(tagracer->http);
-    
-    // Timer für Spielzeit einrichten
-    tagracer->timer = furi_timer_alloc(timer_callback, FuriTimerTypePeriodic, tagracer);
-    furi_timer_start(tagracer->timer, 1000);
+    flipper_http_set_undelivered_callback(tagracer->http, http_undelivered_callback, tagracer);
+    game_view_set_debug_source(&tagracer->view, tagracer_link_lines, tagracer);
     
     // GUI einrichten
     view_port_draw_callback_set(tagracer->view_port, render_callback, tagracer);
@@ -141,19 +316,36 @@ int32_t tagracer_app_main(void* p) {
     gui_add_view_port(tagracer->gui, tagracer->view_port, GuiLayerFullscreen);
     
     // Hauptschleife
-    InputEvent event;
+    TagRacerEvent event;
     while(1) {
-        if(furi_message_queue_get(tagracer->event_queue, &event, 100) == FuriStatusOk) {
-            if(event.type == InputTypeShort) {
-                switch(event.key) {
+        // Bis zum nächsten Spielereignis oder fälligen Frame schlafen
+        uint32_t timeout = game_view_next_frame(
+            &tagracer->view, game_state_next_update(tagracer->game, 1000));
+        bool received = furi_message_queue_get(tagracer->event_queue, &event, timeout) == FuriStatusOk;
+        if(received && event.type == TagRacerEventTypePoints) {
+            tagracer_apply_points(tagracer, &event);
+        } else if(received && event.type == TagRacerEventTypeInput) {
+            if(tagracer->game->log) {
+                game_log_input(tagracer->log, event.input.key, event.input.type);
+            }
+            if(event.input.type == InputTypeShort) {
+                switch(event.input.key) {
                     case InputKeyOk:
                         // Spiel starten/neustarten
                         if(tagracer->game->state == GameStateIdle ||
                            tagracer->game->state == GameStateFinished) {
-                            game_state_start(tagracer->game);
+                            tagracer_open_log(tagracer);
+                            tagracer->game_request = FLIPPER_HTTP_REQUEST_NONE;
+                            game_state_reset(tagracer->game);
+                            game_state_start(tagracer->game, tagracer->game->mode);
                         }
                         break;
                         
+                    case InputKeyUp:
+                        // Debug-Anzeige: Frame-Statistik, Link-Seite, aus
+                        game_view_toggle_debug(&tagracer->view);
+                        break;
+                        
                     case InputKeyBack:
                         // Spiel beenden
                         goto exit;
@@ -164,12 +356,20 @@ int32_t tagracer_app_main(void* p) {
             }
         }
         
-        view_port_update(tagracer->view_port);
+        // Fällige Timer (Countdown, Combo, Power-ups) auslösen
+        game_state_update(tagracer->game);
+        
+        // Scans unabhängig vom Ereignistyp abholen
+        tagracer_drain_scans(tagracer);
+        
+        // Nur neu zeichnen, wenn sich etwas geändert hat
+        if(game_view_poll(&tagracer->view, tagracer->game)) {
+            view_port_update(tagracer->view_port);
+        }
     }
 
 exit:
     // Aufräumen
-    furi_timer_free(tagracer->timer);
     nfc_scanner_stop(tagracer->nfc_scanner);
     nfc_scanner_free(tagracer->nfc_scanner);
     flipper_http_deinit(tagracer->http);
@@ -179,6 +379,11 @@ exit:
     view_port_free(tagracer->view_port);
     furi_message_queue_free(tagracer->event_queue);
     furi_record_close(RECORD_GUI);
+    notifier_stop();
+    if(tagracer->game->log) {
+        game_log_check(tagracer->log, tagracer->game);
+    }
+    game_log_free(tagracer->log);
     free(tagracer->game);
     free(tagracer);
 
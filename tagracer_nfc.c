@@ -1,59 +1,151 @@
 #include "tagracer_nfc.h"
 
+#define NFC_SCAN_RING_MASK (NFC_SCAN_RING_SIZE - 1)
+
 NFCScanner* nfc_scanner_alloc() {
     NFCScanner* scanner = malloc(sizeof(NFCScanner));
+    memset(scanner, 0, sizeof(NFCScanner));
     scanner->running = false;
     return scanner;
 }
 
 void nfc_scanner_free(NFCScanner* scanner) {
     furi_assert(scanner);
+    nfc_scanner_stop(scanner);
     free(scanner);
 }
 
-static void nfc_scan_task(void* context) {
+// true, wenn die UID kürzlich schon gemeldet wurde. Ein liegender Tag
+// frischt seinen Zeitstempel auf und wird erst nach dem Entfernen wieder gemeldet.
+static bool nfc_scanner_debounce(NFCScanner* scanner, TagKey key, uint32_t now) {
+    uint32_t oldest = 0;
+
+    for(uint32_t i = 0; i < NFC_DEBOUNCE_SLOTS; i++) {
+        if(scanner->debounce_keys[i] == key) {
+            bool recent = now - scanner->debounce_ticks[i] < NFC_DEBOUNCE_MS;
+            scanner->debounce_ticks[i] = now;
+            return recent;
+        }
+        if(now - scanner->debounce_ticks[i] > now - scanner->debounce_ticks[oldest]) {
+            oldest = i;
+        }
+    }
+
+    scanner->debounce_keys[oldest] = key;
+    scanner->debounce_ticks[oldest] = now;
+    return false;
+}
+
+static bool nfc_scanner_push(NFCScanner* scanner, const NfcScanRecord* record) {
+    uint32_t head = scanner->ring_head;
+    uint32_t tail = __atomic_load_n(&scanner->ring_tail, __ATOMIC_ACQUIRE);
+
+    if(((head + 1) & NFC_SCAN_RING_MASK) == tail) {
+        return false;
+    }
+
+    scanner->ring[head] = *record;
+    __atomic_store_n(&scanner->ring_head, (head + 1) & NFC_SCAN_RING_MASK, __ATOMIC_RELEASE);
+    return true;
+}
+
+bool nfc_scanner_pop(NFCScanner* scanner, NfcScanRecord* record) {
+    furi_assert(scanner);
+
+    uint32_t tail = scanner->ring_tail;
+    uint32_t head = __atomic_load_n(&scanner->ring_head, __ATOMIC_ACQUIRE);
+
+    if(tail == head) {
+        return false;
+    }
+
+    *record = scanner->ring[tail];
+    __atomic_store_n(&scanner->ring_tail, (tail + 1) & NFC_SCAN_RING_MASK, __ATOMIC_RELEASE);
+    return true;
+}
+
+void nfc_scanner_record_processed(NFCScanner* scanner, const NfcScanRecord* record) {
+    furi_assert(scanner);
+
+    uint32_t latency = furi_get_tick() - record->tick;
+    scanner->stats.processed++;
+    scanner->stats.latency_sum += latency;
+    if(latency > scanner->stats.latency_max) {
+        scanner->stats.latency_max = latency;
+    }
+}
+
+void nfc_scanner_get_stats(NFCScanner* scanner, NfcScannerStats* stats) {
+    furi_assert(scanner);
+    *stats = scanner->stats;
+}
+
+static int32_t nfc_scan_task(void* context) {
     NFCScanner* scanner = context;
-    
+
     while(scanner->running) {
-        // NFC-Karte erkennen
-        if(furi_hal_nfc_detect(&scanner->nfc_data, 200)) {
-            TagData tag_data;
-            memcpy(tag_data.uid, scanner->nfc_data.uid, scanner->nfc_data.uid_len);
-            tag_data.uid_len = scanner->nfc_data.uid_len;
-            
-            // Callback mit Tag-Daten aufrufen
-            if(scanner->callback) {
-                scanner->callback(&tag_data, scanner->callback_context);
-            }
-            
-            // Warte kurz, um mehrfaches Scannen zu vermeiden
-            furi_delay_ms(500);
+        // Blockiert bis ein Tag im Feld ist oder das Timeout abläuft
+        if(!furi_hal_nfc_detect(&scanner->nfc_data, NFC_DETECT_TIMEOUT_MS)) {
+            continue;
+        }
+
+        NfcScanRecord record;
+        record.tick = furi_get_tick();
+        record.tag.uid_len = MIN(scanner->nfc_data.uid_len, TAG_UID_MAX_LEN);
+        memcpy(record.tag.uid, scanner->nfc_data.uid, record.tag.uid_len);
+        record.tag.key = tag_id_hash(record.tag.uid, record.tag.uid_len);
+        scanner->stats.detected++;
+
+        if(nfc_scanner_debounce(scanner, record.tag.key, record.tick)) {
+            scanner->stats.debounced++;
+            continue;
+        }
+
+        if(!nfc_scanner_push(scanner, &record)) {
+            scanner->stats.overflows++;
+            continue;
+        }
+
+        // Hauptthread wecken
+        if(scanner->callback) {
+            scanner->callback(scanner->callback_context);
         }
-        furi_delay_ms(100);
     }
+
+    return 0;
 }
 
-void nfc_scanner_start(NFCScanner* scanner, TagCallback callback, void* context) {
+void nfc_scanner_start(NFCScanner* scanner, NfcScanReadyCallback callback, void* context) {
     furi_assert(scanner);
-    
+    if(scanner->running) return;
+
     scanner->callback = callback;
     scanner->callback_context = context;
+    scanner->ring_head = 0;
+    scanner->ring_tail = 0;
+    memset(scanner->debounce_keys, 0, sizeof(scanner->debounce_keys));
+    memset(&scanner->stats, 0, sizeof(scanner->stats));
     scanner->running = true;
-    
+
     // NFC-Hardware initialisieren
     furi_hal_nfc_init();
-    
+
     // Scan-Task starten
-    FuriThread* thread = furi_thread_alloc();
-    furi_thread_set_name(thread, "NFCScanTask");
-    furi_thread_set_stack_size(thread, 1024);
-    furi_thread_set_context(thread, scanner);
-    furi_thread_set_callback(thread, nfc_scan_task);
-    furi_thread_start(thread);
+    scanner->thread = furi_thread_alloc();
+    furi_thread_set_name(scanner->thread, "NFCScanTask");
+    furi_thread_set_stack_size(scanner->thread, 1024);
+    furi_thread_set_context(scanner->thread, scanner);
+    furi_thread_set_callback(scanner->thread, nfc_scan_task);
+    furi_thread_start(scanner->thread);
 }
 
 void nfc_scanner_stop(NFCScanner* scanner) {
     furi_assert(scanner);
+    if(!scanner->thread) return;
+
     scanner->running = false;
+    furi_thread_join(scanner->thread);
+    furi_thread_free(scanner->thread);
+    scanner->thread = NULL;
     furi_hal_nfc_deinit();
 }
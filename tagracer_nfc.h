@@ -3,23 +3,68 @@
 #include <furi.h>
 #include <furi_hal_nfc.h>
 #include <gui/gui.h>
+#include "tag_id.h"
+
+// Zweierpotenz, eine Stelle bleibt frei (voll/leer unterscheidbar)
+#define NFC_SCAN_RING_SIZE 16
+// Gleiche UID innerhalb dieser Zeit nicht erneut melden
+#define NFC_DEBOUNCE_MS 1500
+#define NFC_DEBOUNCE_SLOTS 8
+#define NFC_DETECT_TIMEOUT_MS 100
 
 typedef struct {
-    uint8_t uid[10];
+    uint8_t uid[TAG_UID_MAX_LEN];
     uint8_t uid_len;
+    TagKey key;  // Einmal beim Scan aus der UID berechnet
 } TagData;
 
-typedef void (*TagCallback)(TagData* tag_data, void* context);
+// Eintrag im Scan-Ring: Tag plus Zeitpunkt der Erkennung
+typedef struct {
+    TagData tag;
+    uint32_t tick;
+} NfcScanRecord;
+
+typedef struct {
+    uint32_t detected;     // Erkannte Tags vor dem Entprellen
+    uint32_t debounced;    // Wegen Entprellung verworfen
+    uint32_t overflows;    // Ring voll, Scan verloren
+    uint32_t processed;    // Vom Hauptthread verarbeitet
+    uint32_t latency_max;  // Scan bis Punktevergabe in ms
+    uint32_t latency_sum;
+} NfcScannerStats;
+
+// Wird im Scanner-Thread aufgerufen, sobald ein Scan im Ring liegt.
+// Darf nur den Hauptthread wecken, die Verarbeitung läuft dort.
+typedef void (*NfcScanReadyCallback)(void* context);
 
 typedef struct {
     FuriHalNfcDevData nfc_data;
     FuriHalNfcTxRxContext tx_rx;
-    TagCallback callback;
+    FuriThread* thread;
+    NfcScanReadyCallback callback;
     void* callback_context;
-    bool running;
+    volatile bool running;
+
+    // Single-Producer (Scanner-Thread) / Single-Consumer (Hauptthread)
+    NfcScanRecord ring[NFC_SCAN_RING_SIZE];
+    uint32_t ring_head;  // Nur vom Scanner geschrieben
+    uint32_t ring_tail;  // Nur vom Hauptthread geschrieben
+
+    // Entprellung pro UID, nur im Scanner-Thread benutzt
+    TagKey debounce_keys[NFC_DEBOUNCE_SLOTS];
+    uint32_t debounce_ticks[NFC_DEBOUNCE_SLOTS];
+
+    NfcScannerStats stats;
 } NFCScanner;
 
 NFCScanner* nfc_scanner_alloc();
 void nfc_scanner_free(NFCScanner* scanner);
-void nfc_scanner_start(NFCScanner* scanner, TagCallback callback, void* context);
+void nfc_scanner_start(NFCScanner* scanner, NfcScanReadyCallback callback, void* context);
 void nfc_scanner_stop(NFCScanner* scanner);
+
+// Hauptthread: nächsten Scan aus dem Ring holen
+bool nfc_scanner_pop(NFCScanner* scanner, NfcScanRecord* record);
+
+// Hauptthread: Verarbeitung eines Scans abgeschlossen (Latenz erfassen)
+void nfc_scanner_record_processed(NFCScanner* scanner, const NfcScanRecord* record);
+void nfc_scanner_get_stats(NFCScanner* scanner, NfcScannerStats* stats);
@@ -0,0 +1,87 @@
+#include "territory.h"
+
+#define TERRITORY_INDEX_MASK (TERRITORY_INDEX_SIZE - 1)
+
+void territory_reset(Territory* territory) {
+    memset(territory, 0, sizeof(Territory));
+}
+
+// Slot im Index für den Schlüssel (belegt oder erster freier)
+static uint32_t territory_probe(const Territory* territory, TagKey key) {
+    uint32_t slot = key & TERRITORY_INDEX_MASK;
+
+    while(territory->index[slot] != 0) {
+        if(territory->keys[territory->index[slot] - 1] == key) break;
+        slot = (slot + 1) & TERRITORY_INDEX_MASK;
+    }
+
+    return slot;
+}
+
+TerritoryCapture
+    territory_capture(Territory* territory, TagKey key, uint8_t team, uint32_t now) {
+    if(team >= TERRITORY_MAX_TEAMS) return TerritoryCaptureFailed;
+
+    uint32_t slot = territory_probe(territory, key);
+    uint16_t point;
+
+    if(territory->index[slot] == 0) {
+        // Index ist nie mehr als halb voll, die Sondierung endet also immer
+        if(territory->count >= TERRITORY_MAX_POINTS) return TerritoryCaptureFailed;
+
+        point = territory->count++;
+        territory->keys[point] = key;
+        territory->owner[point] = TERRITORY_NO_TEAM;
+        territory->hold_ms[point] = 0;
+        territory->index[slot] = point + 1;
+    } else {
+        point = territory->index[slot] - 1;
+    }
+
+    uint8_t previous = territory->owner[point];
+    if(previous == team) return TerritoryCaptureHeld;
+
+    // Haltezeit des bisherigen Besitzers abschließen
+    if(previous != TERRITORY_NO_TEAM) {
+        TerritoryTeam* loser = &territory->teams[previous];
+        uint32_t held = now - territory->capture_tick[point];
+        loser->owned--;
+        loser->hold_closed_ms += held;
+        loser->since_sum -= territory->capture_tick[point];
+        territory->hold_ms[point] += held;
+    }
+
+    TerritoryTeam* winner = &territory->teams[team];
+    winner->owned++;
+    winner->captures++;
+    winner->since_sum += now;
+    territory->owner[point] = team;
+    territory->capture_tick[point] = now;
+
+    return previous == TERRITORY_NO_TEAM ? TerritoryCaptureNew : TerritoryCaptureStolen;
+}
+
+uint8_t territory_get_owner(const Territory* territory, TagKey key) {
+    uint32_t slot = territory_probe(territory, key);
+    if(territory->index[slot] == 0) return TERRITORY_NO_TEAM;
+    return territory->owner[territory->index[slot] - 1];
+}
+
+uint16_t territory_team_owned(const Territory* territory, uint8_t team) {
+    if(team >= TERRITORY_MAX_TEAMS) return 0;
+    return territory->teams[team].owned;
+}
+
+uint32_t territory_team_hold_ms(const Territory* territory, uint8_t team, uint32_t now) {
+    if(team >= TERRITORY_MAX_TEAMS) return 0;
+
+    // Laufende Haltezeiten: owned * now - Summe der Eroberungszeitpunkte
+    const TerritoryTeam* summary = &territory->teams[team];
+    uint64_t running = (uint64_t)summary->owned * now - summary->since_sum;
+    return summary->hold_closed_ms + (uint32_t)running;
+}
+
+uint32_t territory_team_score(const Territory* territory, uint8_t team, uint32_t now) {
+    // Ein Punkt pro gehaltener Gebietssekunde
+    return territory_team_hold_ms(territory, team, now) / 1000;
+}
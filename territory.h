@@ -0,0 +1,53 @@
+#pragma once
+
+#include <furi.h>
+#include "tag_id.h"
+
+// Capture-Gebiete als Struct-of-Arrays. Haltezeiten der Teams werden bei
+// jeder Eroberung inkrementell fortgeschrieben; die Abfrage pro Team ist
+// O(1) und unabhängig von der Anzahl der Capture-Punkte.
+
+#define TERRITORY_MAX_POINTS 256
+#define TERRITORY_INDEX_SIZE (TERRITORY_MAX_POINTS * 2)  // Zweierpotenz
+#define TERRITORY_MAX_TEAMS 8
+#define TERRITORY_NO_TEAM 0xFF
+
+typedef struct {
+    uint16_t owned;          // Aktuell gehaltene Punkte
+    uint16_t captures;       // Eroberungen insgesamt
+    uint32_t hold_closed_ms; // Abgeschlossene Haltezeiten
+    uint64_t since_sum;      // Summe der capture_tick aller gehaltenen Punkte
+} TerritoryTeam;
+
+typedef struct {
+    TagKey keys[TERRITORY_MAX_POINTS];
+    uint8_t owner[TERRITORY_MAX_POINTS];
+    uint32_t capture_tick[TERRITORY_MAX_POINTS];
+    uint32_t hold_ms[TERRITORY_MAX_POINTS];  // Gesamte Haltezeit früherer Besitzer
+    uint16_t count;
+
+    // Schlüssel -> Punkt+1 (0 = frei)
+    uint16_t index[TERRITORY_INDEX_SIZE];
+
+    TerritoryTeam teams[TERRITORY_MAX_TEAMS];
+} Territory;
+
+typedef enum {
+    TerritoryCaptureFailed,   // Tabelle voll oder Team ungültig
+    TerritoryCaptureHeld,     // Gehörte schon dem Team
+    TerritoryCaptureNew,      // Neutraler Punkt übernommen
+    TerritoryCaptureStolen    // Einem anderen Team abgenommen
+} TerritoryCapture;
+
+void territory_reset(Territory* territory);
+
+// Punkt für ein Team erobern, unbekannte Tags werden neue Capture-Punkte
+TerritoryCapture
+    territory_capture(Territory* territory, TagKey key, uint8_t team, uint32_t now);
+
+uint8_t territory_get_owner(const Territory* territory, TagKey key);
+
+// O(1)-Zusammenfassung pro Team
+uint16_t territory_team_owned(const Territory* territory, uint8_t team);
+uint32_t territory_team_hold_ms(const Territory* territory, uint8_t team, uint32_t now);
+uint32_t territory_team_score(const Territory* territory, uint8_t team, uint32_t now);
@@ -0,0 +1,228 @@
+#include "timer_wheel.h"
+
+#define TIMER_WHEEL_MASK (TIMER_WHEEL_SLOTS - 1)
+#define TIMER_WHEEL_RANGE (1U << (TIMER_WHEEL_BITS * TIMER_WHEEL_LEVELS))
+
+static bool timer_wheel_before(uint32_t a, uint32_t b) {
+    return (int32_t)(a - b) < 0;
+}
+
+void timer_wheel_init(TimerWheel* wheel, uint32_t now, void* context) {
+    memset(wheel, 0, sizeof(TimerWheel));
+    memset(wheel->slots, TIMER_WHEEL_NONE, sizeof(wheel->slots));
+    wheel->now = now;
+    wheel->context = context;
+}
+
+void timer_wheel_clear(TimerWheel* wheel) {
+    timer_wheel_init(wheel, wheel->now, wheel->context);
+}
+
+static void timer_wheel_link(TimerWheel* wheel, uint8_t id) {
+    TimerWheelEntry* entry = &wheel->timers[id];
+
+    if(timer_wheel_before(entry->expires, wheel->now)) {
+        entry->expires = wheel->now;
+    }
+    uint32_t delta = entry->expires - wheel->now;
+    uint32_t when = entry->expires;
+
+    uint8_t level = 0;
+    while(level < TIMER_WHEEL_LEVELS - 1 && delta >= (1U << (TIMER_WHEEL_BITS * (level + 1)))) {
+        level++;
+    }
+    // Weiter als das Rad reicht: an den Rand legen, beim Kaskadieren neu einsortieren
+    if(delta >= TIMER_WHEEL_RANGE) {
+        when = wheel->now + TIMER_WHEEL_RANGE - 1;
+    }
+
+    uint8_t slot = (when >> (TIMER_WHEEL_BITS * level)) & TIMER_WHEEL_MASK;
+    uint8_t head = wheel->slots[level][slot];
+
+    entry->prev = TIMER_WHEEL_NONE;
+    entry->next = head;
+    if(head != TIMER_WHEEL_NONE) {
+        wheel->timers[head].prev = id;
+    }
+    wheel->slots[level][slot] = id;
+    wheel->occupied[level] |= 1ULL << slot;
+
+    entry->level = level;
+    entry->slot = slot;
+    entry->active = true;
+}
+
+static void timer_wheel_unlink(TimerWheel* wheel, uint8_t id) {
+    TimerWheelEntry* entry = &wheel->timers[id];
+
+    if(entry->prev != TIMER_WHEEL_NONE) {
+        wheel->timers[entry->prev].next = entry->next;
+    } else {
+        wheel->slots[entry->level][entry->slot] = entry->next;
+    }
+    if(entry->next != TIMER_WHEEL_NONE) {
+        wheel->timers[entry->next].prev = entry->prev;
+    }
+    if(wheel->slots[entry->level][entry->slot] == TIMER_WHEEL_NONE) {
+        wheel->occupied[entry->level] &= ~(1ULL << entry->slot);
+    }
+
+    entry->active = false;
+}
+
+// Slot aus der Liste lösen und die IDs in ids[] ablegen
+static uint8_t timer_wheel_detach(TimerWheel* wheel, uint8_t level, uint8_t slot, uint8_t* ids) {
+    uint8_t count = 0;
+    uint8_t id = wheel->slots[level][slot];
+
+    while(id != TIMER_WHEEL_NONE) {
+        ids[count++] = id;
+        wheel->timers[id].active = false;
+        id = wheel->timers[id].next;
+    }
+
+    wheel->slots[level][slot] = TIMER_WHEEL_NONE;
+    wheel->occupied[level] &= ~(1ULL << slot);
+    return count;
+}
+
+void timer_wheel_schedule(
+    TimerWheel* wheel,
+    uint8_t id,
+    uint32_t expires,
+    TimerWheelCallback callback,
+    uint32_t arg) {
+    furi_assert(id < TIMER_WHEEL_MAX_TIMERS);
+
+    TimerWheelEntry* entry = &wheel->timers[id];
+    if(entry->active) {
+        timer_wheel_unlink(wheel, id);
+    }
+
+    entry->expires = expires;
+    entry->callback = callback;
+    entry->arg = arg;
+    timer_wheel_link(wheel, id);
+}
+
+void timer_wheel_cancel(TimerWheel* wheel, uint8_t id) {
+    furi_assert(id < TIMER_WHEEL_MAX_TIMERS);
+
+    TimerWheelEntry* entry = &wheel->timers[id];
+    if(entry->active) {
+        timer_wheel_unlink(wheel, id);
+    }
+    // Auch im laufenden Tick schon gelöst, aber noch nicht ausgelöst:
+    // ohne Callback überspringt ihn timer_wheel_advance
+    entry->callback = NULL;
+}
+
+bool timer_wheel_is_active(const TimerWheel* wheel, uint8_t id) {
+    return id < TIMER_WHEEL_MAX_TIMERS && wheel->timers[id].active;
+}
+
+// Erster belegter Slot einer Ebene ab from (rotiert gesucht) und der
+// Zeitpunkt, an dem er an der Reihe ist
+static uint8_t timer_wheel_first_slot(
+    const TimerWheel* wheel,
+    uint8_t level,
+    uint32_t from,
+    uint32_t* when) {
+    uint64_t occupied = wheel->occupied[level];
+    uint32_t shift = TIMER_WHEEL_BITS * level;
+    uint32_t unit = 1U << shift;
+    uint32_t index = ((from + unit - 1) & ~(unit - 1)) >> shift;
+
+    uint32_t rotate = index & TIMER_WHEEL_MASK;
+    uint64_t ahead = rotate ? (occupied >> rotate) | (occupied << (64 - rotate)) : occupied;
+    uint32_t distance = (uint32_t)__builtin_ctzll(ahead);
+
+    *when = (index + distance) << shift;
+    return (rotate + distance) & TIMER_WHEEL_MASK;
+}
+
+// Frühester Zeitpunkt ab from, an dem ein belegter Slot an der Reihe ist:
+// Ebene 0 löst aus, höhere Ebenen kaskadieren an ihrer Slot-Grenze
+static uint32_t timer_wheel_next_point(const TimerWheel* wheel, uint32_t from, uint32_t limit) {
+    uint32_t best = limit;
+
+    for(uint8_t level = 0; level < TIMER_WHEEL_LEVELS; level++) {
+        if(wheel->occupied[level] == 0) continue;
+
+        uint32_t candidate;
+        timer_wheel_first_slot(wheel, level, from, &candidate);
+        if(timer_wheel_before(candidate, best)) {
+            best = candidate;
+        }
+    }
+
+    return best;
+}
+
+void timer_wheel_advance(TimerWheel* wheel, uint32_t now) {
+    uint8_t ids[TIMER_WHEEL_MAX_TIMERS];
+
+    while(!timer_wheel_before(now, wheel->now)) {
+        uint32_t tick = wheel->now;
+
+        // Höhere Ebenen an ihren Grenzen nach unten verteilen
+        for(uint8_t level = TIMER_WHEEL_LEVELS - 1; level > 0; level--) {
+            uint32_t shift = TIMER_WHEEL_BITS * level;
+            if((tick & ((1U << shift) - 1)) != 0) continue;
+
+            uint8_t slot = (tick >> shift) & TIMER_WHEEL_MASK;
+            if(!(wheel->occupied[level] & (1ULL << slot))) continue;
+
+            uint8_t count = timer_wheel_detach(wheel, level, slot, ids);
+            for(uint8_t i = 0; i < count; i++) {
+                timer_wheel_link(wheel, ids[i]);
+            }
+        }
+
+        // Fällige Timer lösen; Callbacks dürfen Timer neu stellen oder
+        // abbrechen, neue Timer landen frühestens im nächsten Tick
+        uint8_t count = timer_wheel_detach(wheel, 0, tick & TIMER_WHEEL_MASK, ids);
+        wheel->now = tick + 1;
+
+        for(uint8_t i = 0; i < count; i++) {
+            TimerWheelEntry* entry = &wheel->timers[ids[i]];
+            // Vom vorherigen Callback neu gestellt (active) oder verworfen
+            // (timer_wheel_cancel löscht den Callback)
+            if(entry->active) continue;
+            if(entry->callback) {
+                entry->callback(wheel->context, entry->arg);
+            }
+        }
+
+        wheel->now = timer_wheel_next_point(wheel, wheel->now, now + 1);
+    }
+}
+
+uint32_t timer_wheel_next_wakeup(const TimerWheel* wheel, uint32_t limit) {
+    uint32_t best = limit;
+
+    for(uint8_t level = 0; level < TIMER_WHEEL_LEVELS; level++) {
+        if(wheel->occupied[level] == 0) continue;
+
+        uint32_t candidate;
+        uint8_t slot = timer_wheel_first_slot(wheel, level, wheel->now, &candidate);
+
+        // Für Ebenenwechsel muss niemand aufwachen, timer_wheel_advance holt
+        // sie nach. Entscheidend ist der früheste Ablauf im ersten Slot.
+        if(level > 0) {
+            candidate = limit;
+            for(uint8_t id = wheel->slots[level][slot]; id != TIMER_WHEEL_NONE;
+                id = wheel->timers[id].next) {
+                if(timer_wheel_before(wheel->timers[id].expires, candidate)) {
+                    candidate = wheel->timers[id].expires;
+                }
+            }
+        }
+
+        if(timer_wheel_before(candidate, best)) {
+            best = candidate;
+        }
+    }
+
+    return best;
+}
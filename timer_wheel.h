@@ -0,0 +1,57 @@
+#pragma once
+
+#include <furi.h>
+
+// Hierarchisches Timer-Rad mit 1 ms Auflösung: 4 Ebenen zu je 64 Slots
+// (64 ms, 4 s, 4,4 min, 4,6 h). Timer haben feste IDs, es wird nichts
+// allokiert. Weiterschalten kostet O(abgelaufene Timer + Ebenenwechsel).
+
+#define TIMER_WHEEL_BITS 6
+#define TIMER_WHEEL_SLOTS (1 << TIMER_WHEEL_BITS)
+#define TIMER_WHEEL_LEVELS 4
+#define TIMER_WHEEL_MAX_TIMERS 16
+#define TIMER_WHEEL_NONE 0xFF
+
+typedef void (*TimerWheelCallback)(void* context, uint32_t arg);
+
+typedef struct {
+    uint32_t expires;
+    uint32_t arg;
+    TimerWheelCallback callback;
+    uint8_t next;
+    uint8_t prev;
+    uint8_t level;
+    uint8_t slot;
+    bool active;
+} TimerWheelEntry;
+
+typedef struct {
+    uint32_t now;  // Nächster noch nicht verarbeiteter Zeitpunkt
+    void* context;
+    uint64_t occupied[TIMER_WHEEL_LEVELS];
+    uint8_t slots[TIMER_WHEEL_LEVELS][TIMER_WHEEL_SLOTS];
+    TimerWheelEntry timers[TIMER_WHEEL_MAX_TIMERS];
+} TimerWheel;
+
+void timer_wheel_init(TimerWheel* wheel, uint32_t now, void* context);
+
+// Timer (neu) stellen; liegt expires in der Vergangenheit, feuert er beim
+// nächsten Weiterschalten
+void timer_wheel_schedule(
+    TimerWheel* wheel,
+    uint8_t id,
+    uint32_t expires,
+    TimerWheelCallback callback,
+    uint32_t arg);
+// Auch aus einem Callback heraus für Timer, die im selben Tick fällig sind
+void timer_wheel_cancel(TimerWheel* wheel, uint8_t id);
+// Alle Timer verwerfen, auch die im laufenden Tick noch ausstehenden
+void timer_wheel_clear(TimerWheel* wheel);
+bool timer_wheel_is_active(const TimerWheel* wheel, uint8_t id);
+
+// Alle Timer bis einschließlich now auslösen
+void timer_wheel_advance(TimerWheel* wheel, uint32_t now);
+
+// Nächster Ablaufzeitpunkt, höchstens limit. Ebenenwechsel dazwischen
+// erledigt timer_wheel_advance selbst.
+uint32_t timer_wheel_next_wakeup(const TimerWheel* wheel, uint32_t limit);